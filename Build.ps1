@@ -35,3 +35,9 @@ Pop-Location												# Exit the build directory
 
 glslangValidator.exe .\triangle.vert.glsl -V -o .\triangle.vert.spirv
 glslangValidator.exe .\triangle.frag.glsl -V -o .\triangle.frag.spirv
+glslangValidator.exe .\triangle_pull.vert.glsl -V -o .\triangle_pull.vert.spirv
+glslangValidator.exe .\triangle_cluster.vert.glsl -V -o .\triangle_cluster.vert.spirv
+glslangValidator.exe .\cluster_cull.comp.glsl -V -o .\cluster_cull.comp.spirv
+glslangValidator.exe .\depth_pyramid.comp.glsl -V -o .\depth_pyramid.comp.spirv
+glslangValidator.exe .\light_cull.comp.glsl -V -o .\light_cull.comp.spirv
+glslangValidator.exe .\shadow.vert.glsl -V -o .\shadow.vert.spirv
@@ -0,0 +1,168 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(local_size_x = 64) in;
+
+struct Cluster {
+	vec3 Center;
+	float Radius;
+	vec3 ConeAxis;
+	float ConeCutoff;
+	uint IndexOffset;
+	uint IndexCount;
+	uvec2 Padding;
+};
+
+struct ClusterInstance {
+	uint ClusterIndex;
+	uint ObjectIndex;
+};
+
+struct DrawCommand {
+	uint IndexCount;
+	uint InstanceCount;
+	uint FirstIndex;
+	int VertexOffset;
+	uint FirstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer UniformBuffer {
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+} UniformBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer ClusterBuffer {
+	Cluster Clusters[];
+} ClusterBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceBuffer {
+	ClusterInstance Instances[];
+} InstanceBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+	mat4 ModelMatrices[];
+} ObjectBuffers[];
+
+layout(std430, set = 0, binding = 0) buffer DrawBuffer {
+	uint DrawCount;
+	uint Padding[3];
+	DrawCommand Draws[];
+} DrawBuffers[];
+
+layout(set = 0, binding = 1) uniform texture2D Textures[];
+layout(set = 0, binding = 2) uniform sampler Samplers[];
+
+layout(push_constant) uniform PushConstants {
+	vec4 Viewer; // xyz world position, or the world view direction for orthographic projections when w is 0
+	uint UniformBufferHandle;
+	uint ClusterBufferHandle;
+	uint InstanceBufferHandle;
+	uint ObjectBufferHandle;
+	uint DrawBufferHandle;
+	uint InstanceCount;
+	uint PyramidHandle; // ~0u while there is no pyramid from a previous frame
+	uint SamplerHandle;
+	uvec2 DepthSize; // The part of the depth buffer that was drawn to, which may be smaller than the buffer with dynamic resolution
+	uint PyramidLevelCount;
+};
+
+// NOTE: Every triangle of the cluster faces away from the viewer
+bool IsBackfacing(Cluster cluster, vec3 center, vec3 axis, float radius) {
+	if (Viewer.w == 0.0) {
+		return dot(Viewer.xyz, axis) >= cluster.ConeCutoff;
+	}
+
+	vec3 toCenter = center - Viewer.xyz;
+	return dot(toCenter, axis) >= cluster.ConeCutoff * length(toCenter) + radius;
+}
+
+void main() {
+	uint instanceIndex = gl_GlobalInvocationID.x;
+	if (instanceIndex >= InstanceCount) {
+		return;
+	}
+
+	ClusterInstance instance = InstanceBuffers[InstanceBufferHandle].Instances[instanceIndex];
+	Cluster cluster = ClusterBuffers[ClusterBufferHandle].Clusters[instance.ClusterIndex];
+	mat4 modelMatrix = ObjectBuffers[ObjectBufferHandle].ModelMatrices[instance.ObjectIndex];
+	mat4 viewProjectionMatrix = UniformBuffers[UniformBufferHandle].ProjectionMatrix * UniformBuffers[UniformBufferHandle].ViewMatrix;
+
+	// NOTE: The largest axis scale keeps the sphere conservative under non uniform scaling
+	float scale = max(length(modelMatrix[0].xyz), max(length(modelMatrix[1].xyz), length(modelMatrix[2].xyz)));
+	vec3 center = (modelMatrix * vec4(cluster.Center, 1.0)).xyz;
+	float radius = cluster.Radius * scale;
+	vec3 axis = normalize(mat3(modelMatrix) * cluster.ConeAxis);
+
+	if (IsBackfacing(cluster, center, axis, radius)) {
+		return;
+	}
+
+	// NOTE: The corners of the sphere's bounding box are tested against the clip volume, the cluster is outside when every corner
+	// is outside the same plane. The same corners give the screen rectangle and the closest depth for the occlusion test
+	vec2 minUv = vec2(1.0);
+	vec2 maxUv = vec2(0.0);
+	float closestDepth = 1.0;
+	bool behindViewer = false;
+	uvec3 outsideLow = uvec3(0);
+	uvec3 outsideHigh = uvec3(0);
+	for (uint i = 0; i < 8; i++) {
+		vec3 offset = vec3((i & 1) != 0 ? radius : -radius, (i & 2) != 0 ? radius : -radius, (i & 4) != 0 ? radius : -radius);
+		vec4 clip = viewProjectionMatrix * vec4(center + offset, 1.0);
+
+		outsideLow += uvec3(lessThan(clip.xyz, vec3(-clip.w, -clip.w, 0.0)));
+		outsideHigh += uvec3(greaterThan(clip.xyz, vec3(clip.w)));
+
+		if (clip.w <= 0.0) {
+			behindViewer = true;
+			continue;
+		}
+
+		vec3 ndc = clip.xyz / clip.w;
+		// NOTE: The viewport is flipped, so ndc y = 1 is the top of the depth buffer
+		vec2 uv = vec2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+		minUv = min(minUv, uv);
+		maxUv = max(maxUv, uv);
+		closestDepth = min(closestDepth, ndc.z);
+	}
+
+	if (any(equal(outsideLow, uvec3(8))) || any(equal(outsideHigh, uvec3(8)))) {
+		return;
+	}
+
+	if (PyramidHandle != ~0u && !behindViewer) {
+		minUv = clamp(minUv, 0.0, 1.0);
+		maxUv = clamp(maxUv, 0.0, 1.0);
+
+		// NOTE: Texel x of pyramid level l covers depth pixels [x * 2^(l + 1), (x + 1) * 2^(l + 1)), picking the level where the
+		// rectangle spans at most two texels per axis means four texels cover all of it
+		vec2 minPixel = minUv * vec2(DepthSize);
+		vec2 maxPixel = maxUv * vec2(DepthSize);
+		float span = max(max(maxPixel.x - minPixel.x, maxPixel.y - minPixel.y), 1.0);
+		int level = max(int(ceil(log2(span))) - 1, 0);
+
+		if (level < int(PyramidLevelCount)) {
+			// NOTE: The pyramid only covers the drawn part, each level halves it rounded down like the pyramid pass does
+			ivec2 levelSize = max(ivec2(DepthSize) >> (level + 1), ivec2(1));
+			ivec2 minTexel = min(ivec2(minPixel) >> (level + 1), levelSize - 1);
+			ivec2 maxTexel = min(ivec2(maxPixel) >> (level + 1), levelSize - 1);
+
+			float farthestDepth = max(
+				max(
+					texelFetch(sampler2D(Textures[PyramidHandle], Samplers[SamplerHandle]), minTexel, level).r,
+					texelFetch(sampler2D(Textures[PyramidHandle], Samplers[SamplerHandle]), ivec2(maxTexel.x, minTexel.y), level).r
+				),
+				max(
+					texelFetch(sampler2D(Textures[PyramidHandle], Samplers[SamplerHandle]), ivec2(minTexel.x, maxTexel.y), level).r,
+					texelFetch(sampler2D(Textures[PyramidHandle], Samplers[SamplerHandle]), maxTexel, level).r
+				)
+			);
+
+			if (closestDepth > farthestDepth) {
+				return;
+			}
+		}
+	}
+
+	uint drawIndex = atomicAdd(DrawBuffers[DrawBufferHandle].DrawCount, 1);
+	DrawBuffers[DrawBufferHandle].Draws[drawIndex] = DrawCommand(cluster.IndexCount, 1, cluster.IndexOffset, 0, instance.ObjectIndex);
+}
@@ -0,0 +1,44 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(set = 0, binding = 1) uniform texture2D Textures[];
+layout(set = 0, binding = 2) uniform sampler Samplers[];
+layout(set = 0, binding = 3, r32f) uniform writeonly image2D StorageImages[];
+
+// NOTE: Every level keeps the farthest depth under each of its texels, level 0 is half the depth buffer
+layout(push_constant) uniform PushConstants {
+	uint SourceHandle; // The depth buffer for level 0, the pyramid otherwise
+	uint SourceLevel;
+	uint DestinationHandle; // Storage view of the level being written
+	uint SamplerHandle;
+	uvec2 SourceSize;
+	uvec2 DestinationSize;
+};
+
+void main() {
+	uvec2 texel = gl_GlobalInvocationID.xy;
+	if (texel.x >= DestinationSize.x || texel.y >= DestinationSize.y) {
+		return;
+	}
+
+	// NOTE: With odd source sizes the last row and column also cover the texel that has no pair
+	uvec2 begin = texel * 2;
+	uvec2 end = min(begin + 2, SourceSize);
+	if (texel.x == DestinationSize.x - 1) {
+		end.x = SourceSize.x;
+	}
+	if (texel.y == DestinationSize.y - 1) {
+		end.y = SourceSize.y;
+	}
+
+	float depth = 0.0;
+	for (uint y = begin.y; y < end.y; y++) {
+		for (uint x = begin.x; x < end.x; x++) {
+			depth = max(depth, texelFetch(sampler2D(Textures[SourceHandle], Samplers[SamplerHandle]), ivec2(x, y), int(SourceLevel)).r);
+		}
+	}
+
+	imageStore(StorageImages[DestinationHandle], ivec2(texel), vec4(depth));
+}
@@ -0,0 +1,113 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(local_size_x = 64) in;
+
+// NOTE: Matches VULKAN_LIGHT_CULLER_MAX_CLUSTER_LIGHTS in VulkanLightCuller.h
+const uint MaxClusterLights = 255;
+
+struct Light {
+	vec3 Position;
+	float Range;
+	vec3 Color;
+	float SpotCosOuter; // -1 for point lights
+	vec3 Direction;
+	float SpotCosInner;
+};
+
+struct ClusterBounds {
+	vec4 Min;
+	vec4 Max;
+};
+
+struct LightCluster {
+	uint Count;
+	uint Indices[MaxClusterLights];
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer LightBuffer {
+	Light Lights[];
+} LightBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer BoundsBuffer {
+	ClusterBounds Bounds[];
+} BoundsBuffers[];
+
+// NOTE: The counts in front are from before clamping, for the stats
+layout(std430, set = 0, binding = 0) buffer GridBuffer {
+	uint TotalCount;
+	uint MaxCount;
+	uint OverflowCount;
+	uint Padding;
+	LightCluster Clusters[];
+} GridBuffers[];
+
+layout(push_constant) uniform PushConstants {
+	mat4 ViewMatrix;
+	uint LightBufferHandle;
+	uint BoundsBufferHandle;
+	uint GridBufferHandle;
+	uint LightCount;
+};
+
+shared uint s_LightCount;
+
+// NOTE: Tests the cone against the sphere around the froxel, which is looser than its box but cheap
+bool IsOutsideCone(Light light, vec3 position, vec3 direction, vec3 boundsCenter, float boundsRadius) {
+	vec3 toBounds = boundsCenter - position;
+	float distanceSquared = dot(toBounds, toBounds);
+	float alongAxis = dot(toBounds, direction);
+	float sinOuter = sqrt(max(1.0 - light.SpotCosOuter * light.SpotCosOuter, 0.0));
+	float distanceToCone = light.SpotCosOuter * sqrt(max(distanceSquared - alongAxis * alongAxis, 0.0)) - alongAxis * sinOuter;
+	return distanceToCone > boundsRadius || alongAxis > boundsRadius + light.Range || alongAxis < -boundsRadius;
+}
+
+void main() {
+	uint clusterIndex = gl_WorkGroupID.x;
+	if (gl_LocalInvocationIndex == 0) {
+		s_LightCount = 0;
+	}
+	memoryBarrierShared();
+	barrier();
+
+	ClusterBounds bounds = BoundsBuffers[BoundsBufferHandle].Bounds[clusterIndex];
+	vec3 boundsCenter = (bounds.Min.xyz + bounds.Max.xyz) * 0.5;
+	float boundsRadius = length(bounds.Max.xyz - bounds.Min.xyz) * 0.5;
+
+	for (uint i = gl_LocalInvocationIndex; i < LightCount; i += gl_WorkGroupSize.x) {
+		Light light = LightBuffers[LightBufferHandle].Lights[i];
+		vec3 position = (ViewMatrix * vec4(light.Position, 1.0)).xyz;
+
+		vec3 closest = clamp(position, bounds.Min.xyz, bounds.Max.xyz);
+		vec3 offset = closest - position;
+		if (dot(offset, offset) > light.Range * light.Range) {
+			continue;
+		}
+
+		if (light.SpotCosOuter > -1.0) {
+			vec3 direction = normalize(mat3(ViewMatrix) * light.Direction);
+			if (IsOutsideCone(light, position, direction, boundsCenter, boundsRadius)) {
+				continue;
+			}
+		}
+
+		uint slot = atomicAdd(s_LightCount, 1);
+		if (slot < MaxClusterLights) {
+			GridBuffers[GridBufferHandle].Clusters[clusterIndex].Indices[slot] = i;
+		}
+	}
+
+	memoryBarrierShared();
+	barrier();
+
+	if (gl_LocalInvocationIndex == 0) {
+		uint count = s_LightCount;
+		GridBuffers[GridBufferHandle].Clusters[clusterIndex].Count = min(count, MaxClusterLights);
+
+		atomicAdd(GridBuffers[GridBufferHandle].TotalCount, count);
+		atomicMax(GridBuffers[GridBufferHandle].MaxCount, count);
+		if (count > MaxClusterLights) {
+			atomicAdd(GridBuffers[GridBufferHandle].OverflowCount, 1);
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 a_Position;
+
+// NOTE: Matches VULKAN_SHADOW_MAP_CASCADE_COUNT in VulkanShadowMap.h
+const uint ShadowCascadeCount = 4;
+
+struct ShadowCascade {
+	mat4 ViewProjection;
+	vec4 AtlasRect;
+	float TexelSize;
+	float Padding0;
+	float Padding1;
+	float Padding2;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer ShadowBuffer {
+	ShadowCascade Cascades[ShadowCascadeCount];
+} ShadowBuffers[];
+
+// NOTE: The model matrix is pushed for every draw, the handle and cascade once per cascade
+layout(push_constant) uniform PushConstants {
+	mat4 ModelMatrix;
+	uint ShadowBufferHandle;
+	uint CascadeIndex;
+};
+
+void main() {
+	gl_Position = ShadowBuffers[ShadowBufferHandle].Cascades[CascadeIndex].ViewProjection * ModelMatrix * vec4(a_Position, 1.0);
+}
@@ -0,0 +1,790 @@
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "Timer.h"
+#include "Scene.h"
+#include "Mesh.h"
+#include "VulkanUtil.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindless.h"
+#include "VulkanFrameTimer.h"
+#include "VulkanLightCuller.h"
+#include "RenderGraph.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_ITERATIONS 10
+
+static b8 Benchmark_JobSystem() {
+	const u64 SceneNodeCount = 1000000;
+	const u64 SceneRootCount = 1000;
+	const u64 MeshObjectCount = 1024;
+	const u64 MeshGridSize = 16;
+
+	Scene scene = {};
+	if (!Scene_Create(&scene, SceneNodeCount)) {
+		return false;
+	}
+
+	SceneNode* roots = malloc(SceneRootCount * sizeof(roots[0]));
+	if (!roots) {
+		Scene_Destroy(&scene);
+		return false;
+	}
+
+	for (u64 i = 0; i < SceneRootCount; i++) {
+		roots[i] = Scene_AddNode(&scene, SCENE_NODE_NONE, Matrix4_Translation((Vector3){ cast(f32) i, 0.0f, 0.0f }));
+	}
+
+	// NOTE: Each root gets a shallow tree so every level is wide enough to split
+	for (u64 i = SceneRootCount; i < SceneNodeCount; i++) {
+		SceneNode parent = cast(SceneNode) ((i - SceneRootCount) / 4);
+		Scene_AddNode(&scene, parent, Matrix4_Translation((Vector3){ 0.0f, 1.0f, 0.0f }));
+	}
+
+	// NOTE: Every object is a grid of quads over positions of its own, so each one has real work in the weld, the LODs
+	// and the clusters
+	const u64 ObjectPositionCount = (MeshGridSize + 1) * (MeshGridSize + 1);
+	const u64 ObjectFaceCount = MeshGridSize * MeshGridSize * 2;
+
+	ObjMesh objMesh = {
+		.PositionCount = MeshObjectCount * ObjectPositionCount,
+		.Normals = (Vector3[1]){ { 0.0f, 0.0f, 1.0f } },
+		.NormalCount = 1,
+		.TexCoords = (Vector2[1]){ { 0.0f, 0.0f } },
+		.TexCoordCount = 1,
+		.Materials = (ObjMaterial[4]){},
+		.MaterialCount = 4,
+		.FaceCount = MeshObjectCount * ObjectFaceCount,
+		.ObjectCount = MeshObjectCount,
+	};
+
+	objMesh.Positions = malloc(objMesh.PositionCount * sizeof(objMesh.Positions[0]));
+	objMesh.Faces = calloc(objMesh.FaceCount, sizeof(objMesh.Faces[0]));
+	objMesh.Objects = calloc(objMesh.ObjectCount, sizeof(objMesh.Objects[0]));
+	if (!objMesh.Positions || !objMesh.Faces || !objMesh.Objects) {
+		free(objMesh.Objects);
+		free(objMesh.Faces);
+		free(objMesh.Positions);
+		free(roots);
+		Scene_Destroy(&scene);
+		return false;
+	}
+
+	for (u64 i = 0; i < MeshObjectCount; i++) {
+		u64 positionOffset = i * ObjectPositionCount;
+		for (u64 y = 0; y <= MeshGridSize; y++) {
+			for (u64 x = 0; x <= MeshGridSize; x++) {
+				// NOTE: A little height keeps the simplifier from collapsing a flat grid for free
+				f32 height = cast(f32) ((x * 7 + y * 13 + i) % 5) * 0.1f;
+				objMesh.Positions[positionOffset + y * (MeshGridSize + 1) + x] = (Vector3){
+					cast(f32) (i % 32) * cast(f32) MeshGridSize + cast(f32) x,
+					height,
+					cast(f32) (i / 32) * cast(f32) MeshGridSize + cast(f32) y,
+				};
+			}
+		}
+
+		objMesh.Objects[i] = (ObjObject){
+			.FaceOffset = i * ObjectFaceCount,
+			.FaceCount = ObjectFaceCount,
+		};
+
+		ObjFace* faces = &objMesh.Faces[i * ObjectFaceCount];
+		for (u64 y = 0; y < MeshGridSize; y++) {
+			for (u64 x = 0; x < MeshGridSize; x++) {
+				u64 corner = positionOffset + y * (MeshGridSize + 1) + x;
+				u64 quad[4] = { corner, corner + 1, corner + MeshGridSize + 2, corner + MeshGridSize + 1 };
+				u32 materialIndex = cast(u32) (i % objMesh.MaterialCount);
+
+				*faces++ = (ObjFace){ .PositionIndices = { quad[0], quad[1], quad[2] }, .MaterialIndex = materialIndex };
+				*faces++ = (ObjFace){ .PositionIndices = { quad[0], quad[2], quad[3] }, .MaterialIndex = materialIndex };
+			}
+		}
+	}
+
+	printf(
+		"Job system scaling, %llu scene nodes, %llu mesh objects, %llu mesh faces\n",
+		SceneNodeCount, objMesh.ObjectCount, objMesh.FaceCount
+	);
+	printf("%8s %14s %9s %14s %9s\n", "Threads", "Scene (ms)", "Speedup", "Mesh (ms)", "Speedup");
+
+	f64 baseSceneTime = 0.0;
+	f64 baseMeshTime = 0.0;
+
+	u32 processorCount = JobSystem_GetProcessorCount();
+	for (u32 threadCount = 1; ; threadCount *= 2) {
+		if (threadCount > processorCount) {
+			threadCount = processorCount;
+		}
+
+		if (!JobSystem_Init(threadCount - 1)) {
+			break;
+		}
+
+		Scene_Update(&scene);
+
+		f64 sceneTime = 0.0;
+		for (u32 i = 0; i < BENCHMARK_ITERATIONS; i++) {
+			for (u64 j = 0; j < SceneRootCount; j++) {
+				Scene_SetLocalMatrix(&scene, roots[j], Matrix4_Translation((Vector3){ cast(f32) j, cast(f32) i, 0.0f }));
+			}
+
+			f64 start = Timer_GetSeconds();
+			Scene_Update(&scene);
+			sceneTime += Timer_GetSeconds() - start;
+		}
+		sceneTime /= BENCHMARK_ITERATIONS;
+
+		f64 meshTime = 0.0;
+		for (u32 i = 0; i < BENCHMARK_ITERATIONS; i++) {
+			Mesh mesh = {};
+
+			f64 start = Timer_GetSeconds();
+			b8 built = Mesh_CreateFromObj(&mesh, &objMesh);
+			meshTime += Timer_GetSeconds() - start;
+
+			Mesh_Destroy(&mesh);
+			if (!built) {
+				break;
+			}
+		}
+		meshTime /= BENCHMARK_ITERATIONS;
+
+		JobSystem_Shutdown();
+
+		if (threadCount == 1) {
+			baseSceneTime = sceneTime;
+			baseMeshTime = meshTime;
+		}
+
+		printf(
+			"%8u %14.3f %8.2fx %14.3f %8.2fx\n",
+			threadCount,
+			sceneTime * 1000.0, baseSceneTime / sceneTime,
+			meshTime * 1000.0, baseMeshTime / meshTime
+		);
+
+		if (threadCount == processorCount) {
+			break;
+		}
+	}
+
+	free(objMesh.Objects);
+	free(objMesh.Faces);
+	free(objMesh.Positions);
+	free(roots);
+	Scene_Destroy(&scene);
+	return true;
+}
+
+// NOTE: Benchmarks that only record commands do not need a window, so they run on a device without a surface
+static b8 Benchmark_CreateHeadlessDevice(
+	VkInstance* instance,
+	VkPhysicalDevice* physicalDevice,
+	VkDevice* device,
+	u32* queueFamilyIndex,
+	const VkPhysicalDeviceVulkan12Features* features12
+) {
+	if (!CreateVulkanInstance(instance, VK_API_VERSION_1_2, NULL, 0, NULL, 0)) {
+		return false;
+	}
+
+	u32 physicalDeviceCount = 0;
+	VkCheck(vkEnumeratePhysicalDevices(*instance, &physicalDeviceCount, NULL));
+	if (physicalDeviceCount == 0) {
+		return false;
+	}
+
+	VkPhysicalDevice physicalDevices[physicalDeviceCount];
+	VkCheck(vkEnumeratePhysicalDevices(*instance, &physicalDeviceCount, physicalDevices));
+
+	*physicalDevice = VK_NULL_HANDLE;
+	*queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	for (u32 i = 0; i < physicalDeviceCount; i++) {
+		u32 queueFamilyPropertiesCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &queueFamilyPropertiesCount, NULL);
+		VkQueueFamilyProperties queueFamilyProperties[queueFamilyPropertiesCount];
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[i], &queueFamilyPropertiesCount, queueFamilyProperties);
+
+		for (u32 j = 0; j < queueFamilyPropertiesCount; j++) {
+			if (queueFamilyProperties[j].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+				*physicalDevice = physicalDevices[i];
+				*queueFamilyIndex = j;
+				break;
+			}
+		}
+
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(physicalDevices[i], &properties);
+		if (*physicalDevice == physicalDevices[i] && properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
+			break;
+		}
+	}
+
+	if (*physicalDevice == VK_NULL_HANDLE) {
+		return false;
+	}
+
+	return CreateVulkanDevice(device, *physicalDevice, NULL, 0, NULL, 0, NULL, features12, *queueFamilyIndex, *queueFamilyIndex, VK_QUEUE_FAMILY_IGNORED, 0);
+}
+
+static b8 Benchmark_Transforms() {
+	const u64 DrawCount = 100000;
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	u32 queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	if (!Benchmark_CreateHeadlessDevice(&instance, &physicalDevice, &device, &queueFamilyIndex, NULL)) {
+		printf("Unable to create a vulkan device for the benchmark!\n");
+		return false;
+	}
+
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	// NOTE: The UBO path gives every draw its own aligned slice of one dynamic uniform buffer
+	u64 alignment = properties.limits.minUniformBufferOffsetAlignment;
+	u64 stride = (sizeof(Matrix4) + alignment - 1) / alignment * alignment;
+
+	VulkanBuffer uniformBuffer = {};
+	ASSERT(VulkanBuffer_Create(&uniformBuffer, device, physicalDevice, DrawCount * stride, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT));
+
+	VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+	VkCall(vkCreateDescriptorSetLayout(device, &(VkDescriptorSetLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+		.bindingCount = 1,
+		.pBindings = &(VkDescriptorSetLayoutBinding){
+			.binding = 0,
+			.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			.descriptorCount = 1,
+			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+		},
+	}, NULL, &setLayout));
+
+	VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+	VkCall(vkCreateDescriptorPool(device, &(VkDescriptorPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+		.maxSets = 1,
+		.poolSizeCount = 1,
+		.pPoolSizes = &(VkDescriptorPoolSize){
+			.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			.descriptorCount = 1,
+		},
+	}, NULL, &descriptorPool));
+
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+	VkCall(vkAllocateDescriptorSets(device, &(VkDescriptorSetAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+		.descriptorPool = descriptorPool,
+		.descriptorSetCount = 1,
+		.pSetLayouts = &setLayout,
+	}, &descriptorSet));
+
+	vkUpdateDescriptorSets(device, 1, &(VkWriteDescriptorSet){
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = descriptorSet,
+		.dstBinding = 0,
+		.descriptorCount = 1,
+		.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+		.pBufferInfo = &(VkDescriptorBufferInfo){
+			.buffer = uniformBuffer.Buffer,
+			.offset = 0,
+			.range = sizeof(Matrix4),
+		},
+	}, 0, NULL);
+
+	VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+	VkCall(vkCreatePipelineLayout(device, &(VkPipelineLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		.setLayoutCount = 1,
+		.pSetLayouts = &setLayout,
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = &(VkPushConstantRange){
+			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+			.offset = 0,
+			.size = sizeof(Matrix4),
+		},
+	}, NULL, &pipelineLayout));
+
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCall(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = queueFamilyIndex,
+	}, NULL, &commandPool));
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkCall(vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		.commandPool = commandPool,
+		.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		.commandBufferCount = 1,
+	}, &commandBuffer));
+
+	Matrix4* modelMatrices = malloc(DrawCount * sizeof(modelMatrices[0]));
+	ASSERT(modelMatrices);
+	for (u64 i = 0; i < DrawCount; i++) {
+		modelMatrices[i] = Matrix4_Translation((Vector3){ cast(f32) i, 0.0f, 0.0f });
+	}
+
+	const VkCommandBufferBeginInfo BeginInfo = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	};
+
+	// NOTE: Only the per draw data path is timed, the draw calls themselves cost the same either way
+	f64 uniformTime = 0.0;
+	f64 pushTime = 0.0;
+	for (u32 i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		VkCall(vkResetCommandPool(device, commandPool, 0));
+		VkCall(vkBeginCommandBuffer(commandBuffer, &BeginInfo));
+
+		f64 start = Timer_GetSeconds();
+		for (u64 j = 0; j < DrawCount; j++) {
+			u32 offset = cast(u32) (j * stride);
+			memcpy(cast(u8*) uniformBuffer.Data + offset, &modelMatrices[j], sizeof(modelMatrices[j]));
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &offset);
+		}
+		uniformTime += Timer_GetSeconds() - start;
+
+		VkCall(vkEndCommandBuffer(commandBuffer));
+
+		VkCall(vkResetCommandPool(device, commandPool, 0));
+		VkCall(vkBeginCommandBuffer(commandBuffer, &BeginInfo));
+
+		start = Timer_GetSeconds();
+		for (u64 j = 0; j < DrawCount; j++) {
+			vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(modelMatrices[j]), &modelMatrices[j]);
+		}
+		pushTime += Timer_GetSeconds() - start;
+
+		VkCall(vkEndCommandBuffer(commandBuffer));
+	}
+
+	f64 drawsTimed = cast(f64) DrawCount * BENCHMARK_ITERATIONS;
+	printf("Per draw transform cost, %llu draws, %s\n", DrawCount, properties.deviceName);
+	printf("%24s %12s\n", "Path", "ns / draw");
+	printf("%24s %12.2f\n", "Dynamic uniform buffer", uniformTime * 1e9 / drawsTimed);
+	printf("%24s %12.2f\n", "Push constants", pushTime * 1e9 / drawsTimed);
+	printf("Push constants are %.2fx faster\n", uniformTime / pushTime);
+
+	free(modelMatrices);
+	vkDestroyCommandPool(device, commandPool, NULL);
+	vkDestroyPipelineLayout(device, pipelineLayout, NULL);
+	vkDestroyDescriptorPool(device, descriptorPool, NULL);
+	vkDestroyDescriptorSetLayout(device, setLayout, NULL);
+	VulkanBuffer_Destroy(&uniformBuffer);
+	vkDestroyDevice(device, NULL);
+	vkDestroyInstance(instance, NULL);
+	return true;
+}
+
+// NOTE: Bins the same kind of lights the renderer's -lights option scatters into the froxel grid. Every fragment loops over the
+// lights of its froxel, so the lights per froxel is what the shading cost scales with instead of the total
+static b8 Benchmark_Lights() {
+	const u64 LightCounts[] = { 10, 100, 1000, 10000 };
+	const u64 MaxLightCount = 10000;
+
+	VkPhysicalDeviceVulkan12Features features12 = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+	};
+	VulkanBindless_RequireFeatures(&features12);
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	u32 queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	if (!Benchmark_CreateHeadlessDevice(&instance, &physicalDevice, &device, &queueFamilyIndex, &features12)) {
+		printf("Unable to create a vulkan device for the benchmark!\n");
+		return false;
+	}
+
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	VkQueue queue = VK_NULL_HANDLE;
+	vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+
+	VulkanBindless bindless = {};
+	ASSERT(VulkanBindless_Create(&bindless, device, physicalDevice));
+
+	VkShaderModule cullShader = VK_NULL_HANDLE;
+	if (!CreateVulkanShaderModuleFromFile(&cullShader, device, "light_cull.comp.spirv")) {
+		printf("Unable to load light culling shader!\n");
+		VulkanBindless_Destroy(&bindless);
+		vkDestroyDevice(device, NULL);
+		vkDestroyInstance(instance, NULL);
+		return false;
+	}
+
+	VulkanLightCuller culler = {};
+	ASSERT(VulkanLightCuller_Create(&culler, device, physicalDevice, &bindless, 1, cullShader));
+
+	// NOTE: Without timestamps the submit and wait are timed instead, which includes the driver overhead
+	VulkanFrameTimer timer = {};
+	b8 hasTimer = VulkanFrameTimer_Create(&timer, device, physicalDevice, queueFamilyIndex, 1);
+
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCall(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = queueFamilyIndex,
+	}, NULL, &commandPool));
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkCall(vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		.commandPool = commandPool,
+		.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		.commandBufferCount = 1,
+	}, &commandBuffer));
+
+	VkFence fence = VK_NULL_HANDLE;
+	VkCall(vkCreateFence(device, &(VkFenceCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+	}, NULL, &fence));
+
+	GpuLight* lights = malloc(MaxLightCount * sizeof(lights[0]));
+	ASSERT(lights);
+
+	Matrix4 viewMatrix = Matrix4_Identity();
+	Matrix4 projectionMatrix = Matrix4_Identity();
+
+	printf("Clustered light culling, %u froxels, %s\n", VULKAN_LIGHT_CULLER_CLUSTER_COUNT, properties.deviceName);
+	printf("%8s %12s %16s %14s %11s\n", "Lights", "Cull (ms)", "Lights / froxel", "Most / froxel", "Overflows");
+
+	for (u64 i = 0; i < sizeof(LightCounts) / sizeof(LightCounts[0]); i++) {
+		u64 lightCount = LightCounts[i];
+		GpuLight_Scatter(lights, lightCount, (Vector3){ -1.0f, -1.0f, 0.0f }, (Vector3){ 1.0f, 1.0f, 1.0f }, 0.05f, 0.15f, 1);
+
+		f64 cullTime = 0.0;
+		LightGridStats stats = {};
+		for (u32 j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			ASSERT(VulkanLightCuller_BeginFrame(&culler, 0, lightCount, &projectionMatrix));
+			memcpy(culler.Frames[0].Lights.Data, lights, lightCount * sizeof(lights[0]));
+
+			VkCall(vkResetCommandPool(device, commandPool, 0));
+			VkCall(vkBeginCommandBuffer(commandBuffer, &(VkCommandBufferBeginInfo){
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+				.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+			}));
+
+			if (hasTimer) {
+				VulkanFrameTimer_RecordBegin(&timer, commandBuffer, 0);
+			}
+
+			VulkanLightCuller_RecordCull(&culler, commandBuffer, 0, &viewMatrix);
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &(VkMemoryBarrier){
+				.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+			}, 0, NULL, 0, NULL);
+
+			if (hasTimer) {
+				VulkanFrameTimer_RecordEnd(&timer, commandBuffer, 0);
+			}
+
+			VkCall(vkEndCommandBuffer(commandBuffer));
+
+			f64 start = Timer_GetSeconds();
+			VkCall(vkQueueSubmit(queue, 1, &(VkSubmitInfo){
+				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+				.commandBufferCount = 1,
+				.pCommandBuffers = &commandBuffer,
+			}, fence));
+			VkCall(vkWaitForFences(device, 1, &fence, VK_TRUE, ~0ull));
+			VkCall(vkResetFences(device, 1, &fence));
+			f64 seconds = Timer_GetSeconds() - start;
+
+			if (hasTimer) {
+				VulkanFrameTimer_Read(&timer, 0, &seconds);
+			}
+			cullTime += seconds;
+			stats = VulkanLightCuller_GetStats(&culler, 0);
+		}
+		cullTime /= BENCHMARK_ITERATIONS;
+
+		printf(
+			"%8llu %12.3f %16.2f %14u %11u\n",
+			lightCount,
+			cullTime * 1000.0,
+			cast(f64) stats.TotalCount / VULKAN_LIGHT_CULLER_CLUSTER_COUNT,
+			stats.MaxCount,
+			stats.OverflowCount
+		);
+	}
+
+	if (!hasTimer) {
+		printf("The queue has no timestamps, the times include submitting and waiting\n");
+	}
+
+	free(lights);
+	vkDestroyFence(device, fence, NULL);
+	vkDestroyCommandPool(device, commandPool, NULL);
+	if (hasTimer) {
+		VulkanFrameTimer_Destroy(&timer);
+	}
+	VulkanLightCuller_Destroy(&culler);
+	vkDestroyShaderModule(device, cullShader, NULL);
+	VulkanBindless_Destroy(&bindless);
+	vkDestroyDevice(device, NULL);
+	vkDestroyInstance(instance, NULL);
+	return true;
+}
+
+typedef struct GraphCheckPass_t {
+	const RenderGraph* Graph;
+	RenderGraphResource Image;
+	VkBuffer Buffer;
+	u32 Value;
+	u64 Offset;
+} GraphCheckPass;
+
+static void Benchmark_RecordGraphClear(VkCommandBuffer commandBuffer, void* data) {
+	GraphCheckPass* pass = data;
+	vkCmdClearColorImage(
+		commandBuffer,
+		RenderGraph_GetImage(pass->Graph, pass->Image),
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		&(VkClearColorValue){ .uint32 = { pass->Value, pass->Value, pass->Value, pass->Value } },
+		1,
+		&(VkImageSubresourceRange){
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.levelCount = 1,
+			.layerCount = 1,
+		}
+	);
+}
+
+static void Benchmark_RecordGraphCopy(VkCommandBuffer commandBuffer, void* data) {
+	GraphCheckPass* pass = data;
+	vkCmdCopyImageToBuffer(commandBuffer, RenderGraph_GetImage(pass->Graph, pass->Image), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pass->Buffer, 1, &(VkBufferImageCopy){
+		.bufferOffset = pass->Offset,
+		.imageSubresource = (VkImageSubresourceLayers){
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.layerCount = 1,
+		},
+		.imageExtent = (VkExtent3D){ 1, 1, 1 },
+	});
+}
+
+// NOTE: Not a timing, a check of the transient image aliasing nothing in the renderer uses yet. Two images whose lifetimes
+// do not overlap have to end up in one allocation, and the second one taking the memory over must not see or disturb what
+// the first one's passes read before it
+static b8 Benchmark_RenderGraph() {
+	const u32 ImageSize = 256;
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	u32 queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	if (!Benchmark_CreateHeadlessDevice(&instance, &physicalDevice, &device, &queueFamilyIndex, NULL)) {
+		printf("Unable to create a vulkan device for the benchmark!\n");
+		return false;
+	}
+
+	VkQueue queue = VK_NULL_HANDLE;
+	vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+
+	VulkanBuffer readback = {};
+	ASSERT(VulkanBuffer_CreateReadback(&readback, device, physicalDevice, 2 * sizeof(u32), VK_BUFFER_USAGE_TRANSFER_DST_BIT));
+	memset(readback.Data, 0, readback.Size);
+
+	RenderGraph graph = {};
+	ASSERT(RenderGraph_Create(&graph, device, physicalDevice));
+
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	RenderGraphResource first = RenderGraph_CreateImage(&graph, "First", VK_FORMAT_R32_UINT, ImageSize, ImageSize, usage);
+	RenderGraphResource second = RenderGraph_CreateImage(&graph, "Second", VK_FORMAT_R32_UINT, ImageSize, ImageSize, usage);
+	RenderGraphResource readbackTarget = RenderGraph_ImportBuffer(&graph, "Readback");
+	RenderGraph_SetFinalState(&graph, readbackTarget, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+	GraphCheckPass passes[2] = {
+		{ .Graph = &graph, .Image = first, .Buffer = readback.Buffer, .Value = 0x1234, .Offset = 0 },
+		{ .Graph = &graph, .Image = second, .Buffer = readback.Buffer, .Value = 0x5678, .Offset = sizeof(u32) },
+	};
+	for (u32 i = 0; i < 2; i++) {
+		ASSERT(RenderGraph_AddPass(&graph, "Clear", &(RenderGraphAccess){
+			.Resource = passes[i].Image,
+			.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+			.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			.Discard = true,
+		}, 1, Benchmark_RecordGraphClear, &passes[i]));
+
+		ASSERT(RenderGraph_AddPass(&graph, "Copy", (RenderGraphAccess[2]){
+			{
+				.Resource = passes[i].Image,
+				.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+				.Access = VK_ACCESS_TRANSFER_READ_BIT,
+				.Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			},
+			{
+				.Resource = readbackTarget,
+				.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+				.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+			},
+		}, 2, Benchmark_RecordGraphCopy, &passes[i]));
+	}
+
+	ASSERT(RenderGraph_Compile(&graph));
+	b8 shared = graph.MemoryCount == 1 && graph.Resources[first].MemoryIndex == graph.Resources[second].MemoryIndex;
+
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCall(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = queueFamilyIndex,
+	}, NULL, &commandPool));
+
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkCall(vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		.commandPool = commandPool,
+		.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		.commandBufferCount = 1,
+	}, &commandBuffer));
+
+	VkCall(vkBeginCommandBuffer(commandBuffer, &(VkCommandBufferBeginInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+	}));
+	RenderGraph_Execute(&graph, commandBuffer);
+	VkCall(vkEndCommandBuffer(commandBuffer));
+
+	VkCall(vkQueueSubmit(queue, 1, &(VkSubmitInfo){
+		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+		.commandBufferCount = 1,
+		.pCommandBuffers = &commandBuffer,
+	}, VK_NULL_HANDLE));
+	VkCall(vkQueueWaitIdle(queue));
+
+	const u32* values = readback.Data;
+	b8 correct = values[0] == passes[0].Value && values[1] == passes[1].Value;
+
+	printf("Render graph transient aliasing, 2 images of %ux%u\n", ImageSize, ImageSize);
+	printf("%-12s %u, %s\n", "Allocations", graph.MemoryCount, shared ? "shared" : "NOT SHARED");
+	printf("%-12s %u\n", "Barriers", graph.BarrierCount);
+	printf("%-12s 0x%x 0x%x, %s\n", "Read back", values[0], values[1], correct ? "correct" : "WRONG");
+
+	vkDestroyCommandPool(device, commandPool, NULL);
+	RenderGraph_Destroy(&graph);
+	VulkanBuffer_Destroy(&readback);
+	vkDestroyDevice(device, NULL);
+	vkDestroyInstance(instance, NULL);
+	return shared && correct;
+}
+
+// NOTE: Writes an OBJ that switches between 10K materials on every face, loads it and then compares the hashed
+// lookup to the linear strcmp search usemtl used to do
+static b8 Benchmark_Materials() {
+	const u64 MaterialCount = 10000;
+	const u64 SwitchCount = 100000;
+	const char* MaterialPath = "benchmark_materials.mtl";
+	const char* ObjPath = "benchmark_materials.obj";
+
+	FILE* materialFile = fopen(MaterialPath, "wb");
+	if (!materialFile) {
+		return false;
+	}
+	for (u64 i = 0; i < MaterialCount; i++) {
+		fprintf(materialFile, "newmtl Material.%llu\nKd %f 0.5 0.5\nillum 2\n\n", i, cast(f32) i / cast(f32) MaterialCount);
+	}
+	fclose(materialFile);
+
+	FILE* objFile = fopen(ObjPath, "wb");
+	if (!objFile) {
+		remove(MaterialPath);
+		return false;
+	}
+	fprintf(objFile, "mtllib %s\no Benchmark\nv 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n", MaterialPath);
+	u64 random = 1;
+	for (u64 i = 0; i < SwitchCount; i++) {
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		fprintf(objFile, "usemtl Material.%llu\nf 1/1/1 2/1/1 3/1/1\n", (random >> 33) % MaterialCount);
+	}
+	fclose(objFile);
+
+	printf("OBJ loading, %llu materials, %llu material switches\n", MaterialCount, SwitchCount);
+
+	ObjMesh objMesh = {};
+	f64 loadTime = 0.0;
+	b8 result = true;
+	for (u32 i = 0; result && i < BENCHMARK_ITERATIONS; i++) {
+		ObjMesh_Destory(&objMesh);
+
+		f64 start = Timer_GetSeconds();
+		result = ObjMesh_Create(&objMesh, ObjPath);
+		loadTime += Timer_GetSeconds() - start;
+	}
+	loadTime /= BENCHMARK_ITERATIONS;
+
+	remove(ObjPath);
+	remove(MaterialPath);
+	if (!result) {
+		printf("Unable to load %s\n", ObjPath);
+		return false;
+	}
+
+	// NOTE: Every material is looked up once by name, both ways have to agree on the index
+	f64 start = Timer_GetSeconds();
+	u64 hashedFound = 0;
+	for (u64 i = 0; i < objMesh.MaterialCount; i++) {
+		hashedFound += ObjMesh_FindMaterial(&objMesh, objMesh.Materials[i].Name) == i;
+	}
+	f64 hashedTime = Timer_GetSeconds() - start;
+
+	start = Timer_GetSeconds();
+	u64 linearFound = 0;
+	for (u64 i = 0; i < objMesh.MaterialCount; i++) {
+		for (u64 j = 0; j < objMesh.MaterialCount; j++) {
+			if (strcmp(objMesh.Materials[j].Name, objMesh.Materials[i].Name) == 0) {
+				linearFound += j == i;
+				break;
+			}
+		}
+	}
+	f64 linearTime = Timer_GetSeconds() - start;
+
+	printf("%-12s %12.3f ms\n", "Load", loadTime * 1000.0);
+	printf("%-12s %12.3f ms, %llu/%llu found\n", "Hashed", hashedTime * 1000.0, hashedFound, objMesh.MaterialCount);
+	printf("%-12s %12.3f ms, %llu/%llu found, %.1fx slower\n", "Linear", linearTime * 1000.0, linearFound, objMesh.MaterialCount, linearTime / hashedTime);
+
+	result = hashedFound == objMesh.MaterialCount && linearFound == objMesh.MaterialCount;
+	ObjMesh_Destory(&objMesh);
+	return result;
+}
+
+b8 Benchmark_Run(const char* name) {
+	if (strcmp(name, "jobs") == 0) {
+		return Benchmark_JobSystem();
+	}
+
+	if (strcmp(name, "transforms") == 0) {
+		return Benchmark_Transforms();
+	}
+
+	if (strcmp(name, "lights") == 0) {
+		return Benchmark_Lights();
+	}
+
+	if (strcmp(name, "graph") == 0) {
+		return Benchmark_RenderGraph();
+	}
+
+	if (strcmp(name, "materials") == 0) {
+		return Benchmark_Materials();
+	}
+
+	printf("Unknown benchmark '%s', available benchmarks are:\n", name);
+	printf("  jobs\n");
+	printf("  transforms\n");
+	printf("  lights\n");
+	printf("  graph\n");
+	printf("  materials\n");
+	return false;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "Typedefs.h"
+
+b8 Benchmark_Run(const char* name);
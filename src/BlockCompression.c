@@ -0,0 +1,420 @@
+#include "BlockCompression.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static f32 Clamp(f32 value, f32 min, f32 max) {
+	return value < min ? min : (value > max ? max : value);
+}
+
+// NOTE: Mean and dominant direction of the texels, found with a few power iterations on the covariance matrix.
+// The axis is left at zero when every texel is the same color
+static void BlockCompression_PrincipalAxis(const u8* texels, u32 channelCount, f32 mean[4], f32 axis[4]) {
+	for (u32 c = 0; c < 4; c++) {
+		mean[c] = 0.0f;
+		axis[c] = 0.0f;
+	}
+
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		for (u32 c = 0; c < channelCount; c++) {
+			mean[c] += texels[i * 4 + c];
+		}
+	}
+
+	for (u32 c = 0; c < channelCount; c++) {
+		mean[c] /= BLOCK_COMPRESSION_BLOCK_TEXELS;
+	}
+
+	f32 covariance[4][4] = {};
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		for (u32 a = 0; a < channelCount; a++) {
+			for (u32 b = 0; b < channelCount; b++) {
+				covariance[a][b] += (texels[i * 4 + a] - mean[a]) * (texels[i * 4 + b] - mean[b]);
+			}
+		}
+	}
+
+	// NOTE: The row of the channel with the largest variance is a good starting guess
+	u32 largest = 0;
+	for (u32 c = 1; c < channelCount; c++) {
+		if (covariance[c][c] > covariance[largest][largest]) {
+			largest = c;
+		}
+	}
+
+	if (covariance[largest][largest] < 1e-4f) {
+		return;
+	}
+
+	f32 vector[4] = {};
+	for (u32 c = 0; c < channelCount; c++) {
+		vector[c] = covariance[largest][c];
+	}
+
+	for (u32 iteration = 0; iteration < 8; iteration++) {
+		f32 next[4] = {};
+		f32 length = 0.0f;
+		for (u32 a = 0; a < channelCount; a++) {
+			for (u32 b = 0; b < channelCount; b++) {
+				next[a] += covariance[a][b] * vector[b];
+			}
+			length += next[a] * next[a];
+		}
+
+		if (length < 1e-12f) {
+			break;
+		}
+
+		length = sqrtf(length);
+		for (u32 c = 0; c < channelCount; c++) {
+			vector[c] = next[c] / length;
+		}
+	}
+
+	for (u32 c = 0; c < channelCount; c++) {
+		axis[c] = vector[c];
+	}
+}
+
+// NOTE: Endpoints at the extremes of the texels projected onto the principal axis
+static void BlockCompression_AxisEndpoints(const u8* texels, u32 channelCount, f32 e0[4], f32 e1[4]) {
+	f32 mean[4];
+	f32 axis[4];
+	BlockCompression_PrincipalAxis(texels, channelCount, mean, axis);
+
+	f32 minT = 0.0f;
+	f32 maxT = 0.0f;
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		f32 t = 0.0f;
+		for (u32 c = 0; c < channelCount; c++) {
+			t += (texels[i * 4 + c] - mean[c]) * axis[c];
+		}
+
+		minT = t < minT ? t : minT;
+		maxT = t > maxT ? t : maxT;
+	}
+
+	for (u32 c = 0; c < 4; c++) {
+		e0[c] = Clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+		e1[c] = Clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+	}
+}
+
+// NOTE: Solves for the endpoints that minimize the error of the chosen weights, a weight of 0 is e0 and 1 is e1.
+// Returns false when every texel uses the same weight and the system is singular
+static b8 BlockCompression_LeastSquares(const u8* texels, u32 channelCount, const f32* weights, f32 e0[4], f32 e1[4]) {
+	f32 aa = 0.0f;
+	f32 ab = 0.0f;
+	f32 bb = 0.0f;
+	f32 ax[4] = {};
+	f32 bx[4] = {};
+
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		f32 b = weights[i];
+		f32 a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (u32 c = 0; c < channelCount; c++) {
+			ax[c] += a * texels[i * 4 + c];
+			bx[c] += b * texels[i * 4 + c];
+		}
+	}
+
+	f32 determinant = aa * bb - ab * ab;
+	if (fabsf(determinant) < 1e-6f) {
+		return false;
+	}
+
+	for (u32 c = 0; c < channelCount; c++) {
+		e0[c] = Clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+		e1[c] = Clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+	}
+
+	return true;
+}
+
+static u16 Rgb565_Pack(const f32 color[3]) {
+	u32 r = cast(u32) (Clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+	u32 g = cast(u32) (Clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+	u32 b = cast(u32) (Clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+	return cast(u16) ((r << 11) | (g << 5) | b);
+}
+
+static void Rgb565_Unpack(u16 value, f32 color[3]) {
+	u32 r = (value >> 11) & 31;
+	u32 g = (value >> 5) & 63;
+	u32 b = value & 31;
+	color[0] = cast(f32) ((r << 3) | (r >> 2));
+	color[1] = cast(f32) ((g << 2) | (g >> 4));
+	color[2] = cast(f32) ((b << 3) | (b >> 2));
+}
+
+// NOTE: Quantizes the endpoints and picks the closest palette entry for each texel, returns the squared error
+static f32 BC1_Fit(const u8* texels, const f32 e0[4], const f32 e1[4], u8 output[8], u8 indices[BLOCK_COMPRESSION_BLOCK_TEXELS]) {
+	u16 color0 = Rgb565_Pack(e1);
+	u16 color1 = Rgb565_Pack(e0);
+
+	// NOTE: color0 must be greater than color1 for the four color mode, equal endpoints only ever use index 0
+	b8 swapped = false;
+	if (color0 < color1) {
+		u16 temp = color0;
+		color0 = color1;
+		color1 = temp;
+		swapped = true;
+	}
+
+	f32 palette[4][3];
+	Rgb565_Unpack(color0, palette[0]);
+	Rgb565_Unpack(color1, palette[1]);
+	for (u32 c = 0; c < 3; c++) {
+		palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+		palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+	}
+
+	u32 paletteCount = color0 == color1 ? 1 : 4;
+	u32 bits = 0;
+	f32 totalError = 0.0f;
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		u32 bestIndex = 0;
+		f32 bestError = INFINITY;
+		for (u32 p = 0; p < paletteCount; p++) {
+			f32 error = 0.0f;
+			for (u32 c = 0; c < 3; c++) {
+				f32 delta = texels[i * 4 + c] - palette[p][c];
+				error += delta * delta;
+			}
+
+			if (error < bestError) {
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+
+		bits |= bestIndex << (i * 2);
+		totalError += bestError;
+
+		// NOTE: Reported as 0 for e0, 1 for e1, then the thirds in order, independent of the swap
+		indices[i] = swapped || color0 == color1 ? bestIndex : bestIndex ^ 1;
+	}
+
+	output[0] = cast(u8) color0;
+	output[1] = cast(u8) (color0 >> 8);
+	output[2] = cast(u8) color1;
+	output[3] = cast(u8) (color1 >> 8);
+	output[4] = cast(u8) bits;
+	output[5] = cast(u8) (bits >> 8);
+	output[6] = cast(u8) (bits >> 16);
+	output[7] = cast(u8) (bits >> 24);
+	return totalError;
+}
+
+void BlockCompression_EncodeBC1(const u8* texels, u8 output[8]) {
+	// NOTE: Weight towards e1 of each index reported by BC1_Fit
+	const f32 Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	f32 e0[4];
+	f32 e1[4];
+	BlockCompression_AxisEndpoints(texels, 3, e0, e1);
+
+	u8 indices[BLOCK_COMPRESSION_BLOCK_TEXELS];
+	f32 error = BC1_Fit(texels, e0, e1, output, indices);
+
+	for (u32 iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+		f32 weights[BLOCK_COMPRESSION_BLOCK_TEXELS];
+		for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+			weights[i] = Weights[indices[i]];
+		}
+
+		if (!BlockCompression_LeastSquares(texels, 3, weights, e0, e1)) {
+			break;
+		}
+
+		u8 refined[8];
+		u8 refinedIndices[BLOCK_COMPRESSION_BLOCK_TEXELS];
+		f32 refinedError = BC1_Fit(texels, e0, e1, refined, refinedIndices);
+		if (refinedError >= error) {
+			break;
+		}
+
+		error = refinedError;
+		memcpy(output, refined, sizeof(refined));
+		memcpy(indices, refinedIndices, sizeof(refinedIndices));
+	}
+}
+
+void BlockCompression_EncodeBC4(const u8* texels, u32 channel, u8 output[8]) {
+	u8 min = 255;
+	u8 max = 0;
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		u8 value = texels[i * 4 + channel];
+		min = value < min ? value : min;
+		max = value > max ? value : max;
+	}
+
+	// NOTE: max > min selects the eight value mode, equal endpoints only ever use index 0
+	u32 palette[8] = { max, min };
+	for (u32 p = 2; p < 8; p++) {
+		palette[p] = ((8 - p) * max + (p - 1) * min + 3) / 7;
+	}
+
+	u32 paletteCount = max == min ? 1 : 8;
+	u64 bits = 0;
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		s32 value = texels[i * 4 + channel];
+		u32 bestIndex = 0;
+		s32 bestError = 256;
+		for (u32 p = 0; p < paletteCount; p++) {
+			s32 error = abs(value - cast(s32) palette[p]);
+			if (error < bestError) {
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+
+		bits |= cast(u64) bestIndex << (i * 3);
+	}
+
+	output[0] = max;
+	output[1] = min;
+	for (u32 i = 0; i < 6; i++) {
+		output[2 + i] = cast(u8) (bits >> (i * 8));
+	}
+}
+
+void BlockCompression_EncodeBC5(const u8* texels, u8 output[16]) {
+	BlockCompression_EncodeBC4(texels, 0, output);
+	BlockCompression_EncodeBC4(texels, 1, output + 8);
+}
+
+typedef struct BC7Endpoint_t {
+	u8 Values[4]; // 7 bits each
+	u8 PBit;
+} BC7Endpoint;
+
+static const u32 BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// NOTE: Mode 6 endpoints are 7 bits per channel plus one shared low bit, both choices for that bit are tried
+static BC7Endpoint BC7_QuantizeEndpoint(const f32 endpoint[4]) {
+	BC7Endpoint best = {};
+	f32 bestError = INFINITY;
+	for (u8 pBit = 0; pBit < 2; pBit++) {
+		BC7Endpoint candidate = { .PBit = pBit };
+		f32 error = 0.0f;
+		for (u32 c = 0; c < 4; c++) {
+			f32 value = Clamp(roundf((endpoint[c] - pBit) / 2.0f), 0.0f, 127.0f);
+			candidate.Values[c] = cast(u8) value;
+
+			f32 delta = cast(f32) ((candidate.Values[c] << 1) | pBit) - endpoint[c];
+			error += delta * delta;
+		}
+
+		if (error < bestError) {
+			bestError = error;
+			best = candidate;
+		}
+	}
+
+	return best;
+}
+
+static void BC7_WriteBits(u8 output[16], u32* position, u32 value, u32 count) {
+	for (u32 i = 0; i < count; i++, (*position)++) {
+		if (value & (1u << i)) {
+			output[*position / 8] |= cast(u8) (1u << (*position % 8));
+		}
+	}
+}
+
+static f32 BC7_Fit(const u8* texels, const f32 e0[4], const f32 e1[4], u8 output[16], u8 indices[BLOCK_COMPRESSION_BLOCK_TEXELS]) {
+	BC7Endpoint endpoints[2] = { BC7_QuantizeEndpoint(e0), BC7_QuantizeEndpoint(e1) };
+
+	u32 palette[16][4];
+	for (u32 c = 0; c < 4; c++) {
+		u32 a = (endpoints[0].Values[c] << 1) | endpoints[0].PBit;
+		u32 b = (endpoints[1].Values[c] << 1) | endpoints[1].PBit;
+		for (u32 p = 0; p < 16; p++) {
+			palette[p][c] = ((64 - BC7Weights[p]) * a + BC7Weights[p] * b + 32) >> 6;
+		}
+	}
+
+	f32 totalError = 0.0f;
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		u32 bestIndex = 0;
+		s32 bestError = 0x7FFFFFFF;
+		for (u32 p = 0; p < 16; p++) {
+			s32 error = 0;
+			for (u32 c = 0; c < 4; c++) {
+				s32 delta = cast(s32) texels[i * 4 + c] - cast(s32) palette[p][c];
+				error += delta * delta;
+			}
+
+			if (error < bestError) {
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+
+		indices[i] = cast(u8) bestIndex;
+		totalError += bestError;
+	}
+
+	// NOTE: The first index is stored with 3 bits, so its top bit has to be zero
+	u8 stored[BLOCK_COMPRESSION_BLOCK_TEXELS];
+	memcpy(stored, indices, sizeof(stored));
+	if (stored[0] >= 8) {
+		BC7Endpoint temp = endpoints[0];
+		endpoints[0] = endpoints[1];
+		endpoints[1] = temp;
+		for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+			stored[i] = 15 - stored[i];
+		}
+	}
+
+	memset(output, 0, 16);
+	u32 position = 0;
+	BC7_WriteBits(output, &position, 1 << 6, 7);
+	for (u32 c = 0; c < 4; c++) {
+		BC7_WriteBits(output, &position, endpoints[0].Values[c], 7);
+		BC7_WriteBits(output, &position, endpoints[1].Values[c], 7);
+	}
+	BC7_WriteBits(output, &position, endpoints[0].PBit, 1);
+	BC7_WriteBits(output, &position, endpoints[1].PBit, 1);
+	for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+		BC7_WriteBits(output, &position, stored[i], i == 0 ? 3 : 4);
+	}
+
+	return totalError;
+}
+
+void BlockCompression_EncodeBC7(const u8* texels, u8 output[16]) {
+	f32 e0[4];
+	f32 e1[4];
+	BlockCompression_AxisEndpoints(texels, 4, e0, e1);
+
+	u8 indices[BLOCK_COMPRESSION_BLOCK_TEXELS];
+	f32 error = BC7_Fit(texels, e0, e1, output, indices);
+
+	for (u32 iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+		f32 weights[BLOCK_COMPRESSION_BLOCK_TEXELS];
+		for (u32 i = 0; i < BLOCK_COMPRESSION_BLOCK_TEXELS; i++) {
+			weights[i] = BC7Weights[indices[i]] / 64.0f;
+		}
+
+		if (!BlockCompression_LeastSquares(texels, 4, weights, e0, e1)) {
+			break;
+		}
+
+		u8 refined[16];
+		u8 refinedIndices[BLOCK_COMPRESSION_BLOCK_TEXELS];
+		f32 refinedError = BC7_Fit(texels, e0, e1, refined, refinedIndices);
+		if (refinedError >= error) {
+			break;
+		}
+
+		error = refinedError;
+		memcpy(output, refined, sizeof(refined));
+		memcpy(indices, refinedIndices, sizeof(refinedIndices));
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Typedefs.h"
+
+// NOTE: Every encoder takes a 4x4 block of RGBA8 texels in row order
+#define BLOCK_COMPRESSION_BLOCK_TEXELS 16
+
+// NOTE: Opaque only, the alpha channel is ignored and the block is always in four color mode
+void BlockCompression_EncodeBC1(const u8* texels, u8 output[8]);
+// NOTE: Encodes a single channel of the block, channel is the byte offset inside each RGBA8 texel
+void BlockCompression_EncodeBC4(const u8* texels, u32 channel, u8 output[8]);
+// NOTE: Red and green as two BC4 blocks, meant for tangent space normal maps
+void BlockCompression_EncodeBC5(const u8* texels, u8 output[16]);
+// NOTE: Only mode 6 (one subset, RGBA endpoints with 4 bit indices) is searched, it is the best single mode for most blocks
+void BlockCompression_EncodeBC7(const u8* texels, u8 output[16]);
@@ -0,0 +1,369 @@
+#include "Cooker.h"
+#include "ImageLoader.h"
+#include "TextureFile.h"
+#include "ObjLoader.h"
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "JobSystem.h"
+#include "Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static b8 Cooker_CookTexture(const char* filepath, TextureFormat format, b8 srgb) {
+	Image image = {};
+	if (!Image_Load(&image, filepath)) {
+		printf("Unable to load image %s\n", filepath);
+		return false;
+	}
+
+	f64 startTime = Timer_GetSeconds();
+
+	TextureFile file = {};
+	if (!TextureFile_Cook(&file, &image, format, srgb)) {
+		printf("Unable to cook %s\n", filepath);
+		Image_Destroy(&image);
+		return false;
+	}
+
+	f64 cookTime = Timer_GetSeconds() - startTime;
+
+	char outputPath[1024];
+	snprintf(outputPath, sizeof(outputPath), "%s%s", filepath, TEXTURE_FILE_EXTENSION);
+
+	b8 result = TextureFile_Save(&file, outputPath);
+	if (result) {
+		u64 uncompressedSize = 0;
+		for (u32 i = 0; i < file.LevelCount; i++) {
+			uncompressedSize += TextureFormat_GetLevelSize(TextureFormat_RGBA8, file.Levels[i].Width, file.Levels[i].Height);
+		}
+
+		printf(
+			"%s: %ux%u, %u levels, %s%s, %llu -> %llu bytes (%.1fx) in %.2f ms\n",
+			outputPath,
+			file.Width, file.Height, file.LevelCount,
+			TextureFormat_GetName(file.Format), file.Srgb ? " srgb" : "",
+			uncompressedSize, file.DataSize, cast(f64) uncompressedSize / cast(f64) file.DataSize,
+			cookTime * 1000.0
+		);
+	} else {
+		printf("Unable to write %s\n", outputPath);
+	}
+
+	TextureFile_Destroy(&file);
+	Image_Destroy(&image);
+	return result;
+}
+
+typedef enum MeshCookResult_t {
+	MeshCookResult_Failed,
+	MeshCookResult_UpToDate,
+	MeshCookResult_Cooked,
+} MeshCookResult;
+
+typedef struct MeshCookJob_t {
+	const char* Filepath;
+	b8 Force;
+	b8 Compress;
+
+	MeshCookResult Result;
+	const char* Error;
+	char OutputPath[1024];
+	u64 VertexCount;
+	u64 IndexCount;
+	u64 ObjectCount;
+	u64 ClusterCount;
+	u64 MaterialCount;
+	f64 CookTime;
+	u64 GeometrySize; // Of the vertices, indices, objects and clusters as the renderer uses them
+	u64 FileSize;
+	f64 LoadTime;
+} MeshCookJob;
+
+// NOTE: FNV-1a
+static u64 Cooker_Hash(u64 hash, const void* data, u64 size) {
+	const u8* bytes = data;
+	for (u64 i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// NOTE: Returns the contents null terminated, or NULL when the file can not be read
+static char* Cooker_ReadFile(const char* filepath, u64* size) {
+	FILE* input = fopen(filepath, "rb");
+	if (!input) {
+		return NULL;
+	}
+
+	fseek(input, 0, SEEK_END);
+	*size = ftell(input);
+	fseek(input, 0, SEEK_SET);
+
+	char* data = malloc(*size + 1);
+	if (data) {
+		*size = fread(data, 1, *size, input);
+		data[*size] = '\0';
+	}
+	fclose(input);
+	return data;
+}
+
+// NOTE: Hashes the OBJ and every MTL it references, the same files ObjMesh_Create reads
+static b8 Cooker_HashMeshSources(const char* filepath, u64* hash) {
+	u64 size = 0;
+	char* source = Cooker_ReadFile(filepath, &size);
+	if (!source) {
+		return false;
+	}
+
+	*hash = Cooker_Hash(0xcbf29ce484222325ull, source, size);
+
+	b8 result = true;
+	for (char* line = source; result && *line != '\0';) {
+		char* end = line;
+		while (*end != '\n' && *end != '\0') {
+			end++;
+		}
+
+		if (strncmp(line, "mtllib ", 7) == 0) {
+			char saved = *end;
+			*end = '\0';
+			u64 materialSize = 0;
+			char* materialSource = Cooker_ReadFile(line + 7, &materialSize);
+			*end = saved;
+
+			result = materialSource != NULL;
+			if (result) {
+				*hash = Cooker_Hash(*hash, materialSource, materialSize);
+				free(materialSource);
+			}
+		}
+
+		line = *end == '\n' ? end + 1 : end;
+	}
+
+	free(source);
+	return result;
+}
+
+// NOTE: Loads the cooked file back from memory a few times and keeps the fastest, so the time is the decode and not the disk
+static b8 Cooker_MeasureMeshLoad(MeshCookJob* job) {
+	u64 size = 0;
+	u8* data = cast(u8*) Cooker_ReadFile(job->OutputPath, &size);
+	if (!data) {
+		return false;
+	}
+	job->FileSize = size;
+
+	b8 result = true;
+	job->LoadTime = 0.0;
+	for (u32 i = 0; result && i < 4; i++) {
+		f64 startTime = Timer_GetSeconds();
+		MeshFile file = {};
+		result = MeshFile_LoadFromMemory(&file, data, size);
+		f64 loadTime = Timer_GetSeconds() - startTime;
+		MeshFile_Destroy(&file);
+
+		if (i == 0 || loadTime < job->LoadTime) {
+			job->LoadTime = loadTime;
+		}
+	}
+
+	free(data);
+	return result;
+}
+
+// NOTE: Every file is cooked by its own job, the objects of each mesh are built in parallel by Mesh_CreateFromObj
+static void Cooker_CookMeshJob(void* data, u64 index) {
+	MeshCookJob* job = data;
+	snprintf(job->OutputPath, sizeof(job->OutputPath), "%s%s", job->Filepath, MESH_FILE_EXTENSION);
+
+	u64 sourceHash = 0;
+	if (!Cooker_HashMeshSources(job->Filepath, &sourceHash)) {
+		job->Error = "Unable to read";
+		return;
+	}
+
+	u64 cookedHash = 0;
+	if (!job->Force && MeshFile_ReadSourceHash(job->OutputPath, &cookedHash) && cookedHash == sourceHash) {
+		job->Result = MeshCookResult_UpToDate;
+		return;
+	}
+
+	f64 startTime = Timer_GetSeconds();
+
+	ObjMesh objMesh = {};
+	if (!ObjMesh_Create(&objMesh, job->Filepath)) {
+		job->Error = "Unable to load";
+		return;
+	}
+
+	Mesh mesh = {};
+	if (!Mesh_CreateFromObj(&mesh, &objMesh)) {
+		job->Error = "Unable to build";
+		ObjMesh_Destory(&objMesh);
+		return;
+	}
+
+	b8 saved = MeshFile_Save(&mesh, objMesh.Materials, objMesh.MaterialCount, sourceHash, job->Compress, job->OutputPath);
+	job->CookTime = Timer_GetSeconds() - startTime;
+
+	if (!saved) {
+		job->Error = "Unable to write";
+	} else if (!Cooker_MeasureMeshLoad(job)) {
+		job->Error = "Unable to read back";
+	} else {
+		job->Result = MeshCookResult_Cooked;
+		job->VertexCount = mesh.VertexCount;
+		job->IndexCount = mesh.IndexCount;
+		job->ObjectCount = mesh.ObjectCount;
+		job->ClusterCount = mesh.ClusterCount;
+		job->MaterialCount = objMesh.MaterialCount;
+		job->GeometrySize = mesh.VertexCount * sizeof(mesh.Vertices[0]) + mesh.IndexCount * sizeof(mesh.Indices[0]) +
+			mesh.ObjectCount * sizeof(mesh.Objects[0]) + mesh.ClusterCount * sizeof(mesh.Clusters[0]);
+	}
+
+	Mesh_Destroy(&mesh);
+	ObjMesh_Destory(&objMesh);
+}
+
+static b8 Cooker_CookMeshes(const char** filepaths, u64 count, b8 force, b8 compress) {
+	MeshCookJob* cooks = calloc(count, sizeof(cooks[0]));
+	Job* jobs = malloc(count * sizeof(jobs[0]));
+	if (!cooks || !jobs) {
+		free(cooks);
+		free(jobs);
+		return false;
+	}
+
+	for (u64 i = 0; i < count; i++) {
+		cooks[i] = (MeshCookJob){
+			.Filepath = filepaths[i],
+			.Force = force,
+			.Compress = compress,
+		};
+		jobs[i] = (Job){ .Function = Cooker_CookMeshJob, .Data = &cooks[i] };
+	}
+
+	f64 startTime = Timer_GetSeconds();
+	JobCounter counter = {};
+	JobSystem_Run(jobs, count, &counter);
+	JobSystem_Wait(&counter);
+	f64 totalTime = Timer_GetSeconds() - startTime;
+
+	u64 cookedCount = 0;
+	u64 upToDateCount = 0;
+	u64 geometrySize = 0;
+	u64 fileSize = 0;
+	for (u64 i = 0; i < count; i++) {
+		const MeshCookJob* cook = &cooks[i];
+		switch (cook->Result) {
+			case MeshCookResult_Failed: {
+				printf("%s %s\n", cook->Error, cook->Filepath);
+			} break;
+
+			case MeshCookResult_UpToDate: {
+				printf("%s: up to date\n", cook->OutputPath);
+				upToDateCount++;
+			} break;
+
+			case MeshCookResult_Cooked: {
+				printf(
+					"%s: %llu vertices, %llu triangles, %llu objects, %llu clusters, %llu materials in %.2f ms\n",
+					cook->OutputPath,
+					cook->VertexCount, cook->IndexCount / 3, cook->ObjectCount, cook->ClusterCount, cook->MaterialCount,
+					cook->CookTime * 1000.0
+				);
+				printf(
+					"    %llu -> %llu bytes (%.1fx), loads in %.2f ms (%.2f GB/s)\n",
+					cook->GeometrySize, cook->FileSize, cast(f64) cook->GeometrySize / cast(f64) cook->FileSize,
+					cook->LoadTime * 1000.0, cook->LoadTime > 0.0 ? cook->GeometrySize / cook->LoadTime / 1e9 : 0.0
+				);
+				cookedCount++;
+				geometrySize += cook->GeometrySize;
+				fileSize += cook->FileSize;
+			} break;
+		}
+	}
+
+	printf("%llu cooked, %llu up to date, %llu failed in %.2f ms\n", cookedCount, upToDateCount, count - cookedCount - upToDateCount, totalTime * 1000.0);
+	if (cookedCount > 0) {
+		printf("%llu -> %llu bytes of geometry (%.1fx)\n", geometrySize, fileSize, cast(f64) geometrySize / cast(f64) fileSize);
+	}
+
+	free(jobs);
+	free(cooks);
+	return cookedCount + upToDateCount == count;
+}
+
+static b8 Cooker_RunMeshes(int argc, char** argv) {
+	const char** filepaths = malloc(argc * sizeof(filepaths[0]));
+	if (!filepaths) {
+		return false;
+	}
+
+	u64 count = 0;
+	b8 force = false;
+	b8 compress = true;
+	for (int i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "-force") == 0) {
+			force = true;
+		} else if (strcmp(argv[i], "-uncompressed") == 0) {
+			compress = false;
+		} else {
+			filepaths[count++] = argv[i];
+		}
+	}
+
+	b8 result = count > 0;
+	if (!result) {
+		printf("Usage: %s -cook-mesh <filepath>... [-force] [-uncompressed]\n", argv[0]);
+	}
+
+	if (result && !JobSystem_Init(JOB_SYSTEM_DEFAULT_WORKER_COUNT)) {
+		printf("Unable to start job system!\n");
+		result = false;
+	} else if (result) {
+		result = Cooker_CookMeshes(filepaths, count, force, compress);
+		JobSystem_Shutdown();
+	}
+
+	free(filepaths);
+	return result;
+}
+
+b8 Cooker_Run(int argc, char** argv) {
+	if (argc >= 2 && strcmp(argv[1], "-cook-mesh") == 0) {
+		return Cooker_RunMeshes(argc, argv);
+	}
+
+	if (argc < 3 || strcmp(argv[1], "-cook-texture") != 0) {
+		printf("Usage: %s -cook-texture <filepath> [rgba8|bc1|bc5|bc7] [-linear]\n", argv[0]);
+		printf("       %s -cook-mesh <filepath>... [-force] [-uncompressed]\n", argv[0]);
+		return false;
+	}
+
+	// NOTE: BC7 keeps alpha and has the best quality, BC1 halves the size again for opaque color maps
+	TextureFormat format = TextureFormat_BC7;
+	b8 srgb = true;
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "-linear") == 0) {
+			srgb = false;
+		} else if (!TextureFormat_FromName(&format, argv[i])) {
+			printf("Unknown argument '%s'\n", argv[i]);
+			return false;
+		}
+	}
+
+	if (!JobSystem_Init(JOB_SYSTEM_DEFAULT_WORKER_COUNT)) {
+		printf("Unable to start job system!\n");
+		return false;
+	}
+
+	b8 result = Cooker_CookTexture(argv[2], format, srgb);
+	JobSystem_Shutdown();
+	return result;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Typedefs.h"
+
+// NOTE: Offline asset processing, run with -cook-texture <filepath> [format] [-linear] or
+// -cook-mesh <filepath>... [-force] [-uncompressed]. The output is written next to the input with TEXTURE_FILE_EXTENSION or
+// MESH_FILE_EXTENSION appended, which is where the renderer looks for it. Meshes are cooked in parallel and skipped while the
+// hash of their OBJ and MTL files is unchanged, so switching -uncompressed on or off needs -force to take effect
+b8 Cooker_Run(int argc, char** argv);
@@ -0,0 +1,294 @@
+#include "DrawList.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define DRAW_SORT_RADIX_BITS 8
+#define DRAW_SORT_RADIX_SIZE (1 << DRAW_SORT_RADIX_BITS)
+#define DRAW_SORT_PASS_COUNT (64 / DRAW_SORT_RADIX_BITS)
+
+u64 DrawSortKey_Make(u32 pipelineId, u32 materialId, u32 vertexBufferId, f32 depth) {
+	ASSERT(pipelineId < (1u << DRAW_SORT_KEY_PIPELINE_BITS));
+	ASSERT(materialId < (1u << DRAW_SORT_KEY_MATERIAL_BITS));
+	ASSERT(vertexBufferId < (1u << DRAW_SORT_KEY_VERTEX_BUFFER_BITS));
+
+	if (depth < 0.0f) {
+		depth = 0.0f;
+	} else if (depth > 1.0f) {
+		depth = 1.0f;
+	}
+
+	u64 depthBucket = cast(u64) (depth * cast(f32) ((1u << DRAW_SORT_KEY_DEPTH_BITS) - 1));
+
+	u64 key = pipelineId;
+	key = (key << DRAW_SORT_KEY_MATERIAL_BITS) | materialId;
+	key = (key << DRAW_SORT_KEY_VERTEX_BUFFER_BITS) | vertexBufferId;
+	key = (key << DRAW_SORT_KEY_DEPTH_BITS) | depthBucket;
+	return key;
+}
+
+b8 DrawList_Create(DrawList* drawList, u64 capacity) {
+	*drawList = (DrawList){};
+
+	if (capacity == 0) {
+		capacity = 64;
+	}
+
+	drawList->Draws = malloc(capacity * sizeof(drawList->Draws[0]));
+	if (!drawList->Draws) {
+		return false;
+	}
+
+	drawList->Capacity = capacity;
+	return true;
+}
+
+void DrawList_Destroy(DrawList* drawList) {
+	free(drawList->Draws);
+	free(drawList->SortedDraws);
+	free(drawList->SortKeys[0]);
+	free(drawList->SortKeys[1]);
+	free(drawList->SortIndices[0]);
+	free(drawList->SortIndices[1]);
+	free(drawList->PipelineIds.Handles);
+	free(drawList->MaterialIds.Handles);
+	free(drawList->VertexBufferIds.Handles);
+	*drawList = (DrawList){};
+}
+
+void DrawList_Clear(DrawList* drawList) {
+	drawList->Count = 0;
+	drawList->PipelineIds.Count = 0;
+	drawList->MaterialIds.Count = 0;
+	drawList->VertexBufferIds.Count = 0;
+}
+
+b8 DrawList_Push(DrawList* drawList, const Draw* draw) {
+	if (drawList->Count == drawList->Capacity) {
+		u64 capacity = drawList->Capacity ? drawList->Capacity * 2 : 64;
+		Draw* draws = realloc(drawList->Draws, capacity * sizeof(draws[0]));
+		if (!draws) {
+			return false;
+		}
+
+		drawList->Draws = draws;
+		drawList->Capacity = capacity;
+	}
+
+	drawList->Draws[drawList->Count++] = *draw;
+	return true;
+}
+
+// NOTE: A frame binds only a handful of distinct handles, so a linear search beats hashing them
+static b8 DrawSortIds_Get(DrawSortIds* ids, u64 handle, u32 maxBits, u32* id) {
+	for (u32 i = 0; i < ids->Count; i++) {
+		if (ids->Handles[i] == handle) {
+			*id = i;
+			return true;
+		}
+	}
+
+	if (ids->Count == (1u << maxBits)) {
+		return false;
+	}
+
+	if (ids->Count == ids->Capacity) {
+		u32 capacity = ids->Capacity ? ids->Capacity * 2 : 16;
+		u64* handles = realloc(ids->Handles, capacity * sizeof(handles[0]));
+		if (!handles) {
+			return false;
+		}
+
+		ids->Handles = handles;
+		ids->Capacity = capacity;
+	}
+
+	*id = ids->Count;
+	ids->Handles[ids->Count++] = handle;
+	return true;
+}
+
+b8 DrawList_MakeSortKey(DrawList* drawList, const Draw* draw, f32 depth, u64* sortKey) {
+	u32 pipelineId = 0;
+	u32 materialId = 0;
+	u32 vertexBufferId = 0;
+	if (
+		!DrawSortIds_Get(&drawList->PipelineIds, cast(u64) draw->Pipeline, DRAW_SORT_KEY_PIPELINE_BITS, &pipelineId) ||
+		!DrawSortIds_Get(&drawList->MaterialIds, cast(u64) draw->DescriptorSet, DRAW_SORT_KEY_MATERIAL_BITS, &materialId) ||
+		!DrawSortIds_Get(&drawList->VertexBufferIds, cast(u64) draw->VertexBuffer, DRAW_SORT_KEY_VERTEX_BUFFER_BITS, &vertexBufferId)
+	) {
+		return false;
+	}
+
+	*sortKey = DrawSortKey_Make(pipelineId, materialId, vertexBufferId, depth);
+	return true;
+}
+
+static b8 DrawList_ReserveSortScratch(DrawList* drawList) {
+	if (drawList->Capacity <= drawList->SortCapacity) {
+		return true;
+	}
+
+	u64 capacity = drawList->Capacity;
+
+	Draw* sortedDraws = realloc(drawList->SortedDraws, capacity * sizeof(sortedDraws[0]));
+	if (!sortedDraws) {
+		return false;
+	}
+	drawList->SortedDraws = sortedDraws;
+
+	for (u32 i = 0; i < 2; i++) {
+		u64* keys = realloc(drawList->SortKeys[i], capacity * sizeof(keys[0]));
+		if (!keys) {
+			return false;
+		}
+		drawList->SortKeys[i] = keys;
+
+		u32* indices = realloc(drawList->SortIndices[i], capacity * sizeof(indices[0]));
+		if (!indices) {
+			return false;
+		}
+		drawList->SortIndices[i] = indices;
+	}
+
+	drawList->SortCapacity = capacity;
+	return true;
+}
+
+b8 DrawList_Sort(DrawList* drawList) {
+	u64 count = drawList->Count;
+	if (count < 2) {
+		return true;
+	}
+
+	ASSERT(count <= ~0u);
+	if (!DrawList_ReserveSortScratch(drawList)) {
+		return false;
+	}
+
+	u64* keys = drawList->SortKeys[0];
+	u32* indices = drawList->SortIndices[0];
+	u64* tempKeys = drawList->SortKeys[1];
+	u32* tempIndices = drawList->SortIndices[1];
+
+	// NOTE: Build all histograms in one read of the keys
+	u32 histograms[DRAW_SORT_PASS_COUNT][DRAW_SORT_RADIX_SIZE];
+	memset(histograms, 0, sizeof(histograms));
+
+	for (u64 i = 0; i < count; i++) {
+		u64 key = drawList->Draws[i].SortKey;
+		keys[i] = key;
+		indices[i] = cast(u32) i;
+
+		for (u32 pass = 0; pass < DRAW_SORT_PASS_COUNT; pass++) {
+			histograms[pass][(key >> (pass * DRAW_SORT_RADIX_BITS)) & (DRAW_SORT_RADIX_SIZE - 1)]++;
+		}
+	}
+
+	b8 reordered = false;
+	for (u32 pass = 0; pass < DRAW_SORT_PASS_COUNT; pass++) {
+		u32* histogram = histograms[pass];
+		u32 shift = pass * DRAW_SORT_RADIX_BITS;
+
+		// NOTE: Every key has the same digit, this pass would not move anything
+		if (histogram[(keys[0] >> shift) & (DRAW_SORT_RADIX_SIZE - 1)] == count) {
+			continue;
+		}
+
+		u32 offset = 0;
+		for (u32 i = 0; i < DRAW_SORT_RADIX_SIZE; i++) {
+			u32 bucketCount = histogram[i];
+			histogram[i] = offset;
+			offset += bucketCount;
+		}
+
+		for (u64 i = 0; i < count; i++) {
+			u32 destination = histogram[(keys[i] >> shift) & (DRAW_SORT_RADIX_SIZE - 1)]++;
+			tempKeys[destination] = keys[i];
+			tempIndices[destination] = indices[i];
+		}
+
+		u64* swapKeys = keys;
+		keys = tempKeys;
+		tempKeys = swapKeys;
+
+		u32* swapIndices = indices;
+		indices = tempIndices;
+		tempIndices = swapIndices;
+
+		reordered = true;
+	}
+
+	if (!reordered) {
+		return true;
+	}
+
+	for (u64 i = 0; i < count; i++) {
+		drawList->SortedDraws[i] = drawList->Draws[indices[i]];
+	}
+
+	Draw* draws = drawList->Draws;
+	drawList->Draws = drawList->SortedDraws;
+	drawList->SortedDraws = draws;
+
+	return true;
+}
+
+void DrawList_CountStateChanges(const DrawList* drawList, u64 batchSize, DrawStats* stats) {
+	*stats = (DrawStats){};
+
+	if (batchSize == 0) {
+		batchSize = drawList->Count;
+	}
+
+	const Draw* previous = NULL;
+	for (u64 i = 0; i < drawList->Count; i++) {
+		const Draw* draw = &drawList->Draws[i];
+
+		// NOTE: Every batch starts recording with no state bound
+		if (i % batchSize == 0) {
+			previous = NULL;
+		}
+
+		stats->PipelineBinds += !previous || previous->Pipeline != draw->Pipeline;
+		stats->DescriptorSetBinds += !previous || previous->DescriptorSet != draw->DescriptorSet;
+		stats->VertexBufferBinds += !previous || previous->VertexBuffer != draw->VertexBuffer;
+		stats->IndexBufferBinds += !previous || previous->IndexBuffer != draw->IndexBuffer;
+
+		previous = draw;
+	}
+}
+
+void DrawList_Record(VkCommandBuffer commandBuffer, const Draw* draws, u64 begin, u64 end) {
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+	VkBuffer vertexBuffer = VK_NULL_HANDLE;
+	VkBuffer indexBuffer = VK_NULL_HANDLE;
+
+	for (u64 i = begin; i < end; i++) {
+		const Draw* draw = &draws[i];
+
+		if (draw->Pipeline != pipeline) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw->Pipeline);
+			pipeline = draw->Pipeline;
+		}
+
+		if (draw->DescriptorSet != descriptorSet) {
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw->PipelineLayout, 0, 1, &draw->DescriptorSet, 0, NULL);
+			descriptorSet = draw->DescriptorSet;
+		}
+
+		if (draw->VertexBuffer != vertexBuffer) {
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw->VertexBuffer, &(VkDeviceSize){ 0 });
+			vertexBuffer = draw->VertexBuffer;
+		}
+
+		if (draw->IndexBuffer != indexBuffer) {
+			vkCmdBindIndexBuffer(commandBuffer, draw->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+			indexBuffer = draw->IndexBuffer;
+		}
+
+		vkCmdPushConstants(commandBuffer, draw->PipelineLayout, DRAW_PUSH_CONSTANT_STAGES, 0, sizeof(draw->ModelMatrix), &draw->ModelMatrix);
+		vkCmdDrawIndexed(commandBuffer, draw->IndexCount, 1, draw->FirstIndex, draw->VertexOffset, 0);
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Matrix.h"
+
+#include <vulkan/vulkan.h>
+
+// NOTE: Sort key layout, most significant first:
+// 12 bits pipeline, 16 bits material or descriptor set, 16 bits vertex buffer, 20 bits depth bucket
+#define DRAW_SORT_KEY_PIPELINE_BITS 12
+#define DRAW_SORT_KEY_MATERIAL_BITS 16
+#define DRAW_SORT_KEY_VERTEX_BUFFER_BITS 16
+#define DRAW_SORT_KEY_DEPTH_BITS 20
+
+// NOTE: DrawList_Record pushes each draw's model matrix at offset 0, so pipeline layouts used with it
+// need a push constant range that starts with a mat4 visible to these stages
+#define DRAW_PUSH_CONSTANT_STAGES (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+
+typedef struct Draw_t {
+	u64 SortKey;
+
+	VkPipeline Pipeline;
+	VkPipelineLayout PipelineLayout;
+	VkDescriptorSet DescriptorSet;
+	VkBuffer VertexBuffer;
+	VkBuffer IndexBuffer;
+
+	u32 IndexCount;
+	u32 FirstIndex;
+	s32 VertexOffset;
+	u32 ObjectIndex;
+
+	Matrix4 ModelMatrix;
+} Draw;
+
+typedef struct DrawStats_t {
+	u64 PipelineBinds;
+	u64 DescriptorSetBinds;
+	u64 VertexBufferBinds;
+	u64 IndexBufferBinds;
+} DrawStats;
+
+// NOTE: Numbers handles in the order they are first seen, so the ids fit the narrow sort key fields however large the
+// handle values are
+typedef struct DrawSortIds_t {
+	u64* Handles;
+	u32 Count;
+	u32 Capacity;
+} DrawSortIds;
+
+typedef struct DrawList_t {
+	Draw* Draws;
+	u64 Count;
+	u64 Capacity;
+
+	// NOTE: Reset by DrawList_Clear, so the ids only have to be unique within one frame's draws
+	DrawSortIds PipelineIds;
+	DrawSortIds MaterialIds;
+	DrawSortIds VertexBufferIds;
+
+	// NOTE: Scratch memory for DrawList_Sort
+	Draw* SortedDraws;
+	u64* SortKeys[2];
+	u32* SortIndices[2];
+	u64 SortCapacity;
+} DrawList;
+
+// NOTE: depth is expected to be normalized to [0, 1], closer draws sort first
+u64 DrawSortKey_Make(u32 pipelineId, u32 materialId, u32 vertexBufferId, f32 depth);
+
+b8 DrawList_Create(DrawList* drawList, u64 capacity);
+void DrawList_Destroy(DrawList* drawList);
+void DrawList_Clear(DrawList* drawList);
+b8 DrawList_Push(DrawList* drawList, const Draw* draw);
+
+// NOTE: Builds the key from the draw's pipeline, descriptor set and vertex buffer. Draws have no material of their own,
+// the descriptor set is what a material switch would rebind, so it fills the material field
+b8 DrawList_MakeSortKey(DrawList* drawList, const Draw* draw, f32 depth, u64* sortKey);
+
+// NOTE: Stable radix sort on Draw::SortKey
+b8 DrawList_Sort(DrawList* drawList);
+
+// NOTE: Counts the binds DrawList_Record would issue when the draws are recorded in batches of batchSize
+void DrawList_CountStateChanges(const DrawList* drawList, u64 batchSize, DrawStats* stats);
+
+// NOTE: Only binds state that differs from the previous draw in the range
+void DrawList_Record(VkCommandBuffer commandBuffer, const Draw* draws, u64 begin, u64 end);
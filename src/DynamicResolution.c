@@ -0,0 +1,60 @@
+#include "DynamicResolution.h"
+
+#include <math.h>
+
+// NOTE: How much of a new measurement goes into the smoothed cost, and the largest scale change per update. Dropping
+// is allowed to be faster than rising so a spike is handled within a few frames without oscillating afterwards
+#define DYNAMIC_RESOLUTION_SMOOTHING 0.1f
+#define DYNAMIC_RESOLUTION_MAX_DROP 0.1f
+#define DYNAMIC_RESOLUTION_MAX_RISE 0.02f
+
+void DynamicResolution_Create(DynamicResolution* resolution, f32 targetSeconds, f32 minScale, f32 maxScale) {
+	ASSERT(targetSeconds > 0.0f);
+	ASSERT(minScale > 0.0f && minScale <= maxScale);
+
+	*resolution = (DynamicResolution){
+		.TargetSeconds = targetSeconds,
+		.MinScale = minScale,
+		.MaxScale = maxScale,
+		.Scale = maxScale,
+		.FullScaleSeconds = 0.0f,
+	};
+}
+
+void DynamicResolution_Update(DynamicResolution* resolution, f32 gpuSeconds, f32 frameScale) {
+	f32 fullScaleSeconds = gpuSeconds / (frameScale * frameScale);
+	if (resolution->FullScaleSeconds == 0.0f) {
+		resolution->FullScaleSeconds = fullScaleSeconds;
+	} else {
+		resolution->FullScaleSeconds += (fullScaleSeconds - resolution->FullScaleSeconds) * DYNAMIC_RESOLUTION_SMOOTHING;
+	}
+
+	f32 scale = sqrtf(resolution->TargetSeconds / resolution->FullScaleSeconds);
+	if (scale < resolution->Scale - DYNAMIC_RESOLUTION_MAX_DROP) {
+		scale = resolution->Scale - DYNAMIC_RESOLUTION_MAX_DROP;
+	} else if (scale > resolution->Scale + DYNAMIC_RESOLUTION_MAX_RISE) {
+		scale = resolution->Scale + DYNAMIC_RESOLUTION_MAX_RISE;
+	}
+
+	if (scale < resolution->MinScale) {
+		scale = resolution->MinScale;
+	} else if (scale > resolution->MaxScale) {
+		scale = resolution->MaxScale;
+	}
+	resolution->Scale = scale;
+}
+
+static u32 DynamicResolution_ScaleSize(u32 size, f32 scale) {
+	u32 scaledSize = cast(u32) (cast(f32) size * scale + 0.5f);
+	if (scaledSize < 1) {
+		return 1;
+	} else if (scaledSize > size) {
+		return size;
+	}
+	return scaledSize;
+}
+
+void DynamicResolution_GetSize(const DynamicResolution* resolution, u32 width, u32 height, u32* scaledWidth, u32* scaledHeight) {
+	*scaledWidth = DynamicResolution_ScaleSize(width, resolution->Scale);
+	*scaledHeight = DynamicResolution_ScaleSize(height, resolution->Scale);
+}
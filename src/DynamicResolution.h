@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Typedefs.h"
+
+// NOTE: Picks the render scale, the fraction of the output size rendered along each axis, that keeps the GPU frame
+// time at the target. The cost of a frame is assumed to grow with its pixel count, which overestimates it for the parts
+// that do not depend on the resolution, so the scale errs on the low side
+typedef struct DynamicResolution_t {
+	f32 TargetSeconds;
+	f32 MinScale;
+	f32 MaxScale;
+	f32 Scale;
+	f32 FullScaleSeconds; // Smoothed estimate of what a frame would cost at scale 1
+} DynamicResolution;
+
+void DynamicResolution_Create(DynamicResolution* resolution, f32 targetSeconds, f32 minScale, f32 maxScale);
+// NOTE: gpuSeconds was measured for a frame rendered at frameScale, which lags Scale by the frames in flight
+void DynamicResolution_Update(DynamicResolution* resolution, f32 gpuSeconds, f32 frameScale);
+// NOTE: Never returns a size of 0
+void DynamicResolution_GetSize(const DynamicResolution* resolution, u32 width, u32 height, u32* scaledWidth, u32* scaledHeight);
@@ -0,0 +1,843 @@
+#include "ImageLoader.h"
+#include "JobSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define IMAGE_MAX_DIMENSION 16384
+#define IMAGE_MIP_BATCH_SIZE 16
+
+// NOTE: Inflate, the huffman decoding is canonical and bit at a time like zlib's puff
+
+#define INFLATE_MAX_BITS 15
+#define INFLATE_MAX_LENGTH_CODES 288
+#define INFLATE_MAX_DISTANCE_CODES 30
+
+typedef struct InflateState_t {
+	const u8* Input;
+	u64 InputSize;
+	u64 InputPosition;
+
+	u32 BitBuffer;
+	u32 BitCount;
+
+	u8* Output;
+	u64 OutputSize;
+	u64 OutputCapacity;
+} InflateState;
+
+typedef struct InflateHuffman_t {
+	u16 Counts[INFLATE_MAX_BITS + 1];
+	u16 Symbols[INFLATE_MAX_LENGTH_CODES];
+} InflateHuffman;
+
+static const u16 InflateLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const u8 InflateLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const u16 InflateDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const u8 InflateDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static b8 Inflate_Bits(InflateState* state, u32 count, u32* value) {
+	u32 bits = state->BitBuffer;
+	while (state->BitCount < count) {
+		if (state->InputPosition >= state->InputSize) {
+			return false;
+		}
+
+		bits |= cast(u32) state->Input[state->InputPosition++] << state->BitCount;
+		state->BitCount += 8;
+	}
+
+	*value = bits & ((1u << count) - 1);
+	state->BitBuffer = bits >> count;
+	state->BitCount -= count;
+	return true;
+}
+
+static b8 InflateHuffman_Build(InflateHuffman* huffman, const u8* lengths, u32 count) {
+	memset(huffman->Counts, 0, sizeof(huffman->Counts));
+	for (u32 i = 0; i < count; i++) {
+		huffman->Counts[lengths[i]]++;
+	}
+
+	// NOTE: Over subscribed codes are invalid, incomplete ones are allowed since a single distance code is legal
+	s32 left = 1;
+	for (u32 length = 1; length <= INFLATE_MAX_BITS; length++) {
+		left <<= 1;
+		left -= huffman->Counts[length];
+		if (left < 0) {
+			return false;
+		}
+	}
+
+	u16 offsets[INFLATE_MAX_BITS + 1] = {};
+	for (u32 length = 1; length < INFLATE_MAX_BITS; length++) {
+		offsets[length + 1] = offsets[length] + huffman->Counts[length];
+	}
+
+	for (u32 i = 0; i < count; i++) {
+		if (lengths[i] != 0) {
+			huffman->Symbols[offsets[lengths[i]]++] = cast(u16) i;
+		}
+	}
+
+	return true;
+}
+
+static b8 Inflate_Decode(InflateState* state, const InflateHuffman* huffman, u32* symbol) {
+	s32 code = 0;
+	s32 first = 0;
+	s32 index = 0;
+	for (u32 length = 1; length <= INFLATE_MAX_BITS; length++) {
+		u32 bit = 0;
+		if (!Inflate_Bits(state, 1, &bit)) {
+			return false;
+		}
+
+		code |= bit;
+		s32 count = huffman->Counts[length];
+		if (code - count < first) {
+			*symbol = huffman->Symbols[index + (code - first)];
+			return true;
+		}
+
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+
+	return false;
+}
+
+static b8 Inflate_Stored(InflateState* state) {
+	state->BitBuffer = 0;
+	state->BitCount = 0;
+
+	if (state->InputPosition + 4 > state->InputSize) {
+		return false;
+	}
+
+	const u8* header = &state->Input[state->InputPosition];
+	u32 length = header[0] | (header[1] << 8);
+	u32 inverseLength = header[2] | (header[3] << 8);
+	state->InputPosition += 4;
+
+	if (length != (~inverseLength & 0xFFFF) ||
+		state->InputPosition + length > state->InputSize ||
+		state->OutputSize + length > state->OutputCapacity
+	) {
+		return false;
+	}
+
+	memcpy(&state->Output[state->OutputSize], &state->Input[state->InputPosition], length);
+	state->InputPosition += length;
+	state->OutputSize += length;
+	return true;
+}
+
+static b8 Inflate_Codes(InflateState* state, const InflateHuffman* lengthCodes, const InflateHuffman* distanceCodes) {
+	for (;;) {
+		u32 symbol = 0;
+		if (!Inflate_Decode(state, lengthCodes, &symbol)) {
+			return false;
+		}
+
+		if (symbol < 256) {
+			if (state->OutputSize == state->OutputCapacity) {
+				return false;
+			}
+
+			state->Output[state->OutputSize++] = cast(u8) symbol;
+		} else if (symbol == 256) {
+			return true;
+		} else {
+			symbol -= 257;
+			if (symbol >= 29) {
+				return false;
+			}
+
+			u32 extra = 0;
+			if (!Inflate_Bits(state, InflateLengthExtra[symbol], &extra)) {
+				return false;
+			}
+			u64 length = InflateLengthBase[symbol] + extra;
+
+			if (!Inflate_Decode(state, distanceCodes, &symbol) || symbol >= 30) {
+				return false;
+			}
+
+			if (!Inflate_Bits(state, InflateDistanceExtra[symbol], &extra)) {
+				return false;
+			}
+			u64 distance = InflateDistanceBase[symbol] + extra;
+
+			if (distance > state->OutputSize || state->OutputSize + length > state->OutputCapacity) {
+				return false;
+			}
+
+			// NOTE: The source and destination can overlap, so this has to go a byte at a time
+			u8* output = &state->Output[state->OutputSize];
+			for (u64 i = 0; i < length; i++) {
+				output[i] = output[cast(s64) i - cast(s64) distance];
+			}
+			state->OutputSize += length;
+		}
+	}
+}
+
+static b8 Inflate_Fixed(InflateState* state) {
+	u8 lengths[INFLATE_MAX_LENGTH_CODES + INFLATE_MAX_DISTANCE_CODES];
+
+	u32 i = 0;
+	for (; i < 144; i++) lengths[i] = 8;
+	for (; i < 256; i++) lengths[i] = 9;
+	for (; i < 280; i++) lengths[i] = 7;
+	for (; i < INFLATE_MAX_LENGTH_CODES; i++) lengths[i] = 8;
+	for (; i < INFLATE_MAX_LENGTH_CODES + INFLATE_MAX_DISTANCE_CODES; i++) lengths[i] = 5;
+
+	InflateHuffman lengthCodes;
+	InflateHuffman distanceCodes;
+	if (!InflateHuffman_Build(&lengthCodes, lengths, INFLATE_MAX_LENGTH_CODES) ||
+		!InflateHuffman_Build(&distanceCodes, &lengths[INFLATE_MAX_LENGTH_CODES], INFLATE_MAX_DISTANCE_CODES)
+	) {
+		return false;
+	}
+
+	return Inflate_Codes(state, &lengthCodes, &distanceCodes);
+}
+
+static b8 Inflate_Dynamic(InflateState* state) {
+	static const u8 CodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	u32 lengthCount = 0;
+	u32 distanceCount = 0;
+	u32 codeLengthCount = 0;
+	if (!Inflate_Bits(state, 5, &lengthCount) || !Inflate_Bits(state, 5, &distanceCount) || !Inflate_Bits(state, 4, &codeLengthCount)) {
+		return false;
+	}
+
+	lengthCount += 257;
+	distanceCount += 1;
+	codeLengthCount += 4;
+	if (lengthCount > 286 || distanceCount > INFLATE_MAX_DISTANCE_CODES) {
+		return false;
+	}
+
+	u8 lengths[INFLATE_MAX_LENGTH_CODES + INFLATE_MAX_DISTANCE_CODES] = {};
+	for (u32 i = 0; i < codeLengthCount; i++) {
+		u32 length = 0;
+		if (!Inflate_Bits(state, 3, &length)) {
+			return false;
+		}
+		lengths[CodeLengthOrder[i]] = cast(u8) length;
+	}
+
+	InflateHuffman lengthCodes;
+	if (!InflateHuffman_Build(&lengthCodes, lengths, 19)) {
+		return false;
+	}
+
+	u32 index = 0;
+	while (index < lengthCount + distanceCount) {
+		u32 symbol = 0;
+		if (!Inflate_Decode(state, &lengthCodes, &symbol)) {
+			return false;
+		}
+
+		if (symbol < 16) {
+			lengths[index++] = cast(u8) symbol;
+			continue;
+		}
+
+		u8 length = 0;
+		u32 repeat = 0;
+		if (symbol == 16) {
+			if (index == 0 || !Inflate_Bits(state, 2, &repeat)) {
+				return false;
+			}
+			length = lengths[index - 1];
+			repeat += 3;
+		} else if (symbol == 17) {
+			if (!Inflate_Bits(state, 3, &repeat)) {
+				return false;
+			}
+			repeat += 3;
+		} else {
+			if (!Inflate_Bits(state, 7, &repeat)) {
+				return false;
+			}
+			repeat += 11;
+		}
+
+		if (index + repeat > lengthCount + distanceCount) {
+			return false;
+		}
+
+		while (repeat--) {
+			lengths[index++] = length;
+		}
+	}
+
+	// NOTE: Without an end of block code the block could never finish
+	if (lengths[256] == 0) {
+		return false;
+	}
+
+	InflateHuffman distanceCodes;
+	if (!InflateHuffman_Build(&lengthCodes, lengths, lengthCount) ||
+		!InflateHuffman_Build(&distanceCodes, &lengths[lengthCount], distanceCount)
+	) {
+		return false;
+	}
+
+	return Inflate_Codes(state, &lengthCodes, &distanceCodes);
+}
+
+// NOTE: Decompresses a zlib stream into output, fails if the data does not fit
+static b8 Inflate_Zlib(const u8* input, u64 inputSize, u8* output, u64 outputCapacity, u64* outputSize) {
+	if (inputSize < 2) {
+		return false;
+	}
+
+	u32 header = (input[0] << 8) | input[1];
+	if ((input[0] & 0x0F) != 8 || header % 31 != 0 || (input[1] & 0x20) != 0) {
+		return false;
+	}
+
+	InflateState state = {
+		.Input = input,
+		.InputSize = inputSize,
+		.InputPosition = 2,
+		.Output = output,
+		.OutputCapacity = outputCapacity,
+	};
+
+	u32 last = 0;
+	do {
+		u32 type = 0;
+		if (!Inflate_Bits(&state, 1, &last) || !Inflate_Bits(&state, 2, &type)) {
+			return false;
+		}
+
+		b8 result = false;
+		switch (type) {
+			case 0: result = Inflate_Stored(&state); break;
+			case 1: result = Inflate_Fixed(&state); break;
+			case 2: result = Inflate_Dynamic(&state); break;
+			default: result = false; break;
+		}
+
+		if (!result) {
+			return false;
+		}
+	} while (!last);
+
+	*outputSize = state.OutputSize;
+	return true;
+}
+
+static u32 ReadBigEndian32(const u8* data) {
+	return (cast(u32) data[0] << 24) | (cast(u32) data[1] << 16) | (cast(u32) data[2] << 8) | cast(u32) data[3];
+}
+
+static u8 Png_Paeth(u8 a, u8 b, u8 c) {
+	s32 p = cast(s32) a + cast(s32) b - cast(s32) c;
+	s32 pa = abs(p - a);
+	s32 pb = abs(p - b);
+	s32 pc = abs(p - c);
+	if (pa <= pb && pa <= pc) {
+		return a;
+	}
+	return pb <= pc ? b : c;
+}
+
+static b8 Png_Unfilter(u8* scanlines, const u8* raw, u32 height, u64 rowBytes, u32 bytesPerPixel) {
+	for (u32 y = 0; y < height; y++) {
+		const u8* source = &raw[y * (rowBytes + 1)];
+		u8* row = &scanlines[y * rowBytes];
+		const u8* previous = y > 0 ? &scanlines[(y - 1) * rowBytes] : NULL;
+
+		u8 filter = source[0];
+		source++;
+
+		for (u64 x = 0; x < rowBytes; x++) {
+			u8 a = x >= bytesPerPixel ? row[x - bytesPerPixel] : 0;
+			u8 b = previous ? previous[x] : 0;
+			u8 c = previous && x >= bytesPerPixel ? previous[x - bytesPerPixel] : 0;
+
+			switch (filter) {
+				case 0: row[x] = source[x]; break;
+				case 1: row[x] = source[x] + a; break;
+				case 2: row[x] = source[x] + b; break;
+				case 3: row[x] = source[x] + cast(u8) ((cast(u32) a + cast(u32) b) / 2); break;
+				case 4: row[x] = source[x] + Png_Paeth(a, b, c); break;
+				default: return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static b8 Image_LoadPng(Image* image, const u8* data, u64 size) {
+	static const u8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (size < sizeof(Signature) || memcmp(data, Signature, sizeof(Signature)) != 0) {
+		return false;
+	}
+
+	u32 width = 0;
+	u32 height = 0;
+	u8 bitDepth = 0;
+	u8 colorType = 0;
+	u8 palette[256][4] = {};
+	u32 paletteCount = 0;
+
+	u8* compressed = NULL;
+	u64 compressedSize = 0;
+	u64 compressedCapacity = 0;
+
+	b8 ended = false;
+	u64 position = sizeof(Signature);
+	while (!ended) {
+		if (position + 12 > size) {
+			free(compressed);
+			return false;
+		}
+
+		u32 chunkLength = ReadBigEndian32(&data[position]);
+		const u8* chunkType = &data[position + 4];
+		const u8* chunk = &data[position + 8];
+		if (chunkLength > size - position - 12) {
+			free(compressed);
+			return false;
+		}
+
+		if (memcmp(chunkType, "IHDR", 4) == 0) {
+			if (chunkLength < 13) {
+				free(compressed);
+				return false;
+			}
+
+			width = ReadBigEndian32(&chunk[0]);
+			height = ReadBigEndian32(&chunk[4]);
+			bitDepth = chunk[8];
+			colorType = chunk[9];
+
+			// NOTE: Compression and filter method 0 are the only ones defined, interlaced images are not supported
+			if (chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0) {
+				free(compressed);
+				return false;
+			}
+		} else if (memcmp(chunkType, "PLTE", 4) == 0) {
+			paletteCount = chunkLength / 3;
+			if (paletteCount > 256) {
+				free(compressed);
+				return false;
+			}
+
+			for (u32 i = 0; i < paletteCount; i++) {
+				palette[i][0] = chunk[i * 3 + 0];
+				palette[i][1] = chunk[i * 3 + 1];
+				palette[i][2] = chunk[i * 3 + 2];
+				palette[i][3] = 255;
+			}
+		} else if (memcmp(chunkType, "tRNS", 4) == 0) {
+			if (colorType == 3) {
+				for (u32 i = 0; i < chunkLength && i < 256; i++) {
+					palette[i][3] = chunk[i];
+				}
+			}
+		} else if (memcmp(chunkType, "IDAT", 4) == 0) {
+			if (compressedSize + chunkLength > compressedCapacity) {
+				u64 newCapacity = compressedCapacity ? compressedCapacity * 2 : 65536;
+				while (newCapacity < compressedSize + chunkLength) {
+					newCapacity *= 2;
+				}
+
+				u8* newCompressed = realloc(compressed, newCapacity);
+				if (!newCompressed) {
+					free(compressed);
+					return false;
+				}
+
+				compressed = newCompressed;
+				compressedCapacity = newCapacity;
+			}
+
+			memcpy(&compressed[compressedSize], chunk, chunkLength);
+			compressedSize += chunkLength;
+		} else if (memcmp(chunkType, "IEND", 4) == 0) {
+			ended = true;
+		}
+
+		position += 12 + cast(u64) chunkLength;
+	}
+
+	u32 channels = 0;
+	switch (colorType) {
+		case 0: channels = 1; break;
+		case 2: channels = 3; break;
+		case 3: channels = 1; break;
+		case 4: channels = 2; break;
+		case 6: channels = 4; break;
+		default: channels = 0; break;
+	}
+
+	if (channels == 0 ||
+		!(bitDepth == 8 || (bitDepth == 16 && colorType != 3)) ||
+		width == 0 || height == 0 || width > IMAGE_MAX_DIMENSION || height > IMAGE_MAX_DIMENSION ||
+		(colorType == 3 && paletteCount == 0) ||
+		compressed == NULL
+	) {
+		free(compressed);
+		return false;
+	}
+
+	u32 bytesPerPixel = channels * bitDepth / 8;
+	u64 rowBytes = cast(u64) width * bytesPerPixel;
+	u64 rawCapacity = (rowBytes + 1) * height;
+
+	u8* raw = malloc(rawCapacity);
+	u8* scanlines = malloc(rowBytes * height);
+	u8* pixels = malloc(cast(u64) width * height * 4);
+	if (!raw || !scanlines || !pixels) {
+		free(compressed);
+		free(raw);
+		free(scanlines);
+		free(pixels);
+		return false;
+	}
+
+	u64 rawSize = 0;
+	b8 decoded = Inflate_Zlib(compressed, compressedSize, raw, rawCapacity, &rawSize) &&
+		rawSize == rawCapacity &&
+		Png_Unfilter(scanlines, raw, height, rowBytes, bytesPerPixel);
+
+	free(compressed);
+	free(raw);
+
+	if (!decoded) {
+		free(scanlines);
+		free(pixels);
+		return false;
+	}
+
+	// NOTE: 16 bit samples are big endian, so the first byte is the most significant one
+	u32 sampleStride = bitDepth / 8;
+	for (u32 y = 0; y < height; y++) {
+		const u8* row = &scanlines[y * rowBytes];
+		u8* output = &pixels[cast(u64) y * width * 4];
+
+		for (u32 x = 0; x < width; x++) {
+			const u8* sample = &row[cast(u64) x * bytesPerPixel];
+			u8* pixel = &output[x * 4];
+
+			switch (colorType) {
+				case 0: {
+					pixel[0] = pixel[1] = pixel[2] = sample[0];
+					pixel[3] = 255;
+				} break;
+
+				case 2: {
+					pixel[0] = sample[0];
+					pixel[1] = sample[sampleStride];
+					pixel[2] = sample[sampleStride * 2];
+					pixel[3] = 255;
+				} break;
+
+				case 3: {
+					u8 index = sample[0];
+					if (index >= paletteCount) {
+						index = 0;
+					}
+					memcpy(pixel, palette[index], 4);
+				} break;
+
+				case 4: {
+					pixel[0] = pixel[1] = pixel[2] = sample[0];
+					pixel[3] = sample[sampleStride];
+				} break;
+
+				case 6: {
+					pixel[0] = sample[0];
+					pixel[1] = sample[sampleStride];
+					pixel[2] = sample[sampleStride * 2];
+					pixel[3] = sample[sampleStride * 3];
+				} break;
+			}
+		}
+	}
+
+	free(scanlines);
+
+	image->Width = width;
+	image->Height = height;
+	image->Pixels = pixels;
+	return true;
+}
+
+static b8 Image_LoadTga(Image* image, const u8* data, u64 size) {
+	if (size < 18) {
+		return false;
+	}
+
+	u8 idLength = data[0];
+	u8 colorMapType = data[1];
+	u8 imageType = data[2];
+	u32 width = data[12] | (data[13] << 8);
+	u32 height = data[14] | (data[15] << 8);
+	u8 pixelDepth = data[16];
+	u8 descriptor = data[17];
+
+	// NOTE: 2 and 3 are uncompressed true color and grayscale, 10 and 11 are their RLE versions. Color mapped images are not supported
+	b8 rle = imageType == 10 || imageType == 11;
+	b8 grayscale = imageType == 3 || imageType == 11;
+	if (colorMapType != 0 || !(imageType == 2 || imageType == 3 || rle)) {
+		return false;
+	}
+
+	u32 bytesPerPixel = pixelDepth / 8;
+	if (grayscale ? (bytesPerPixel != 1 && bytesPerPixel != 2) : (bytesPerPixel != 3 && bytesPerPixel != 4)) {
+		return false;
+	}
+
+	if (width == 0 || height == 0 || width > IMAGE_MAX_DIMENSION || height > IMAGE_MAX_DIMENSION) {
+		return false;
+	}
+
+	u8* pixels = malloc(cast(u64) width * height * 4);
+	if (!pixels) {
+		return false;
+	}
+
+	b8 topToBottom = (descriptor & 0x20) != 0;
+	u64 position = 18 + cast(u64) idLength;
+	u64 pixelCount = cast(u64) width * height;
+	u64 index = 0;
+
+	while (index < pixelCount) {
+		u32 count = 1;
+		b8 repeat = false;
+		if (rle) {
+			if (position >= size) {
+				free(pixels);
+				return false;
+			}
+
+			u8 header = data[position++];
+			count = (header & 0x7F) + 1;
+			repeat = (header & 0x80) != 0;
+		}
+
+		for (u32 i = 0; i < count && index < pixelCount; i++, index++) {
+			// NOTE: A repeated packet only stores its pixel once
+			const u8* source = &data[position];
+			if (!repeat || i == 0) {
+				if (position + bytesPerPixel > size) {
+					free(pixels);
+					return false;
+				}
+				position += bytesPerPixel;
+			} else {
+				source -= bytesPerPixel;
+			}
+
+			u64 x = index % width;
+			u64 y = index / width;
+			if (!topToBottom) {
+				y = height - 1 - y;
+			}
+
+			u8* pixel = &pixels[(y * width + x) * 4];
+			if (grayscale) {
+				pixel[0] = pixel[1] = pixel[2] = source[0];
+				pixel[3] = bytesPerPixel == 2 ? source[1] : 255;
+			} else {
+				pixel[0] = source[2];
+				pixel[1] = source[1];
+				pixel[2] = source[0];
+				pixel[3] = bytesPerPixel == 4 ? source[3] : 255;
+			}
+		}
+	}
+
+	image->Width = width;
+	image->Height = height;
+	image->Pixels = pixels;
+	return true;
+}
+
+b8 Image_LoadFromMemory(Image* image, const u8* data, u64 size) {
+	*image = (Image){};
+
+	// NOTE: TGA has no signature, so anything that is not a PNG is tried as one
+	if (Image_LoadPng(image, data, size)) {
+		return true;
+	}
+
+	return Image_LoadTga(image, data, size);
+}
+
+b8 Image_Load(Image* image, const char* filepath) {
+	*image = (Image){};
+
+	FILE* file = fopen(filepath, "rb");
+	if (!file) {
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	u64 size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (size == 0) {
+		fclose(file);
+		return false;
+	}
+
+	u8* data = malloc(size);
+	if (!data) {
+		fclose(file);
+		return false;
+	}
+
+	size = fread(data, 1, size, file);
+	fclose(file);
+
+	b8 result = Image_LoadFromMemory(image, data, size);
+	free(data);
+	return result;
+}
+
+// NOTE: Uncompressed 32 bit with the rows from the top, so Image_Load reads it back unchanged
+b8 Image_SaveTga(const Image* image, const char* filepath) {
+	if (image->Width == 0 || image->Height == 0 || image->Width > 0xFFFF || image->Height > 0xFFFF) {
+		return false;
+	}
+
+	FILE* file = fopen(filepath, "wb");
+	if (!file) {
+		return false;
+	}
+
+	u8 header[18] = {};
+	header[2] = 2;
+	header[12] = cast(u8) (image->Width & 0xFF);
+	header[13] = cast(u8) (image->Width >> 8);
+	header[14] = cast(u8) (image->Height & 0xFF);
+	header[15] = cast(u8) (image->Height >> 8);
+	header[16] = 32;
+	header[17] = 0x20 | 8; // Top to bottom, 8 alpha bits
+
+	b8 written = fwrite(header, sizeof(header), 1, file) == 1;
+
+	// NOTE: TGA stores its pixels as BGRA, one row is swizzled at a time
+	u8* row = malloc(cast(u64) image->Width * 4);
+	written = written && row;
+	for (u32 y = 0; written && y < image->Height; y++) {
+		const u8* source = &image->Pixels[cast(u64) y * image->Width * 4];
+		for (u32 x = 0; x < image->Width; x++) {
+			row[x * 4 + 0] = source[x * 4 + 2];
+			row[x * 4 + 1] = source[x * 4 + 1];
+			row[x * 4 + 2] = source[x * 4 + 0];
+			row[x * 4 + 3] = source[x * 4 + 3];
+		}
+		written = fwrite(row, cast(u64) image->Width * 4, 1, file) == 1;
+	}
+
+	free(row);
+	return fclose(file) == 0 && written;
+}
+
+void Image_Destroy(Image* image) {
+	free(image->Pixels);
+	*image = (Image){};
+}
+
+u32 Image_GetMipCount(u32 width, u32 height) {
+	u32 mipCount = 1;
+	while (width > 1 || height > 1) {
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		mipCount++;
+	}
+	return mipCount;
+}
+
+static u8 LinearToSrgb(f32 value) {
+	value = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+	s32 result = cast(s32) (value * 255.0f + 0.5f);
+	return cast(u8) (result < 0 ? 0 : result > 255 ? 255 : result);
+}
+
+typedef struct ImageMipData_t {
+	const Image* Source;
+	Image* Destination;
+	const f32* SrgbToLinear; // NULL for linear images
+} ImageMipData;
+
+static void Image_DownsampleRows(void* data, u64 begin, u64 end) {
+	ImageMipData* mip = data;
+	const Image* source = mip->Source;
+	Image* destination = mip->Destination;
+
+	for (u64 y = begin; y < end; y++) {
+		u64 y0 = y * 2 < source->Height ? y * 2 : source->Height - 1;
+		u64 y1 = y * 2 + 1 < source->Height ? y * 2 + 1 : source->Height - 1;
+		const u8* row0 = &source->Pixels[y0 * source->Width * 4];
+		const u8* row1 = &source->Pixels[y1 * source->Width * 4];
+		u8* output = &destination->Pixels[y * destination->Width * 4];
+
+		for (u64 x = 0; x < destination->Width; x++) {
+			u64 x0 = (x * 2 < source->Width ? x * 2 : source->Width - 1) * 4;
+			u64 x1 = (x * 2 + 1 < source->Width ? x * 2 + 1 : source->Width - 1) * 4;
+
+			for (u32 c = 0; c < 4; c++) {
+				if (mip->SrgbToLinear && c < 3) {
+					const f32* toLinear = mip->SrgbToLinear;
+					f32 sum =
+						toLinear[row0[x0 + c]] + toLinear[row0[x1 + c]] +
+						toLinear[row1[x0 + c]] + toLinear[row1[x1 + c]];
+					output[x * 4 + c] = LinearToSrgb(sum * 0.25f);
+				} else {
+					u32 sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					output[x * 4 + c] = cast(u8) ((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+b8 Image_GenerateMips(const Image* image, Image* mips, u32 mipCount, b8 srgb) {
+	f32 srgbToLinear[256];
+	for (u32 i = 0; i < 256; i++) {
+		f32 value = i / 255.0f;
+		srgbToLinear[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	const Image* source = image;
+	for (u32 i = 0; i < mipCount; i++) {
+		Image* mip = &mips[i];
+		mip->Width = source->Width > 1 ? source->Width / 2 : 1;
+		mip->Height = source->Height > 1 ? source->Height / 2 : 1;
+		mip->Pixels = malloc(cast(u64) mip->Width * mip->Height * 4);
+		if (!mip->Pixels) {
+			for (u32 j = 0; j < i; j++) {
+				Image_Destroy(&mips[j]);
+			}
+			return false;
+		}
+
+		JobSystem_ParallelFor(mip->Height, IMAGE_MIP_BATCH_SIZE, Image_DownsampleRows, &(ImageMipData){
+			.Source = source,
+			.Destination = mip,
+			.SrgbToLinear = srgb ? srgbToLinear : NULL,
+		});
+
+		source = mip;
+	}
+
+	return true;
+}
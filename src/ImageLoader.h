@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Typedefs.h"
+
+typedef struct Image_t {
+	u32 Width;
+	u32 Height;
+	u8* Pixels; // RGBA8, rows are tightly packed and start at the top
+} Image;
+
+// NOTE: Supports 8 and 16 bit non interlaced PNG and uncompressed or RLE TGA, everything is converted to RGBA8
+b8 Image_Load(Image* image, const char* filepath);
+b8 Image_LoadFromMemory(Image* image, const u8* data, u64 size);
+b8 Image_SaveTga(const Image* image, const char* filepath);
+void Image_Destroy(Image* image);
+
+u32 Image_GetMipCount(u32 width, u32 height);
+// NOTE: Fills mips with the mipCount levels below image using a box filter, srgb images are filtered in linear space.
+// The rows of each level are split across the job system
+b8 Image_GenerateMips(const Image* image, Image* mips, u32 mipCount, b8 srgb);
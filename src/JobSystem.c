@@ -0,0 +1,436 @@
+#include "JobSystem.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <Windows.h>
+#include <malloc.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define JOB_QUEUE_CAPACITY 4096
+#define JOB_QUEUE_MASK (JOB_QUEUE_CAPACITY - 1)
+STATIC_ASSERT((JOB_QUEUE_CAPACITY & JOB_QUEUE_MASK) == 0, "Job queue capacity must be a power of 2");
+
+// NOTE: Chase-Lev work stealing deque, only the owning thread pushes and pops at the bottom,
+// every other thread steals from the top
+typedef struct JobQueue_t {
+	_Atomic s64 Top;
+	u8 Padding0[64 - sizeof(s64)];
+	_Atomic s64 Bottom;
+	u8 Padding1[64 - sizeof(s64)];
+	Job Jobs[JOB_QUEUE_CAPACITY];
+} JobQueue;
+
+typedef struct JobWorker_t {
+	u32 Index;
+	HANDLE Thread;
+} JobWorker;
+
+static struct {
+	b8 Initialized;
+	_Atomic b32 ShuttingDown;
+
+	u32 ThreadCount; // Including the thread that called JobSystem_Init
+	JobQueue* Queues;
+	JobWorker* Workers;
+	HANDLE WakeSemaphore;
+
+	// NOTE: Jobs submitted from threads outside the pool
+	SRWLOCK GlobalLock;
+	Job* GlobalJobs;
+	u64 GlobalJobCount;
+	u64 GlobalJobCapacity;
+} JobSystemState;
+
+static _Thread_local u32 JobSystemThreadIndex = ~0u;
+
+static b8 JobQueue_Push(JobQueue* queue, const Job* job) {
+	s64 bottom = atomic_load_explicit(&queue->Bottom, memory_order_relaxed);
+	s64 top = atomic_load_explicit(&queue->Top, memory_order_acquire);
+	if (bottom - top >= JOB_QUEUE_CAPACITY) {
+		return false;
+	}
+
+	queue->Jobs[bottom & JOB_QUEUE_MASK] = *job;
+	atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_release);
+	return true;
+}
+
+static b8 JobQueue_Pop(JobQueue* queue, Job* job) {
+	s64 bottom = atomic_load_explicit(&queue->Bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&queue->Bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	s64 top = atomic_load_explicit(&queue->Top, memory_order_relaxed);
+
+	if (top > bottom) {
+		atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_relaxed);
+		return false;
+	}
+
+	*job = queue->Jobs[bottom & JOB_QUEUE_MASK];
+	if (top != bottom) {
+		return true;
+	}
+
+	// NOTE: Last job, race the thieves for it
+	b8 won = atomic_compare_exchange_strong_explicit(&queue->Top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+	atomic_store_explicit(&queue->Bottom, bottom + 1, memory_order_relaxed);
+	return won;
+}
+
+static b8 JobQueue_Steal(JobQueue* queue, Job* job) {
+	s64 top = atomic_load_explicit(&queue->Top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	s64 bottom = atomic_load_explicit(&queue->Bottom, memory_order_acquire);
+
+	if (top >= bottom) {
+		return false;
+	}
+
+	*job = queue->Jobs[top & JOB_QUEUE_MASK];
+	return atomic_compare_exchange_strong_explicit(&queue->Top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+static void JobSystem_Push(const Job* job);
+
+static void JobCounter_Lock(JobCounter* counter) {
+	while (atomic_flag_test_and_set_explicit(&counter->Lock, memory_order_acquire)) {
+		YieldProcessor();
+	}
+}
+
+static void JobCounter_Unlock(JobCounter* counter) {
+	atomic_flag_clear_explicit(&counter->Lock, memory_order_release);
+}
+
+static void JobCounter_Decrement(JobCounter* counter) {
+	// NOTE: Busy keeps JobSystem_Wait from returning, and the owner from freeing the counter,
+	// until the waiting list has been handed off
+	atomic_fetch_add(&counter->Busy, 1);
+
+	if (atomic_fetch_sub(&counter->Value, 1) == 1) {
+		JobCounter_Lock(counter);
+		Job* waiting = counter->Waiting;
+		u64 waitingCount = counter->WaitingCount;
+		counter->Waiting = NULL;
+		counter->WaitingCount = 0;
+		JobCounter_Unlock(counter);
+
+		for (u64 i = 0; i < waitingCount; i++) {
+			JobSystem_Push(&waiting[i]);
+		}
+
+		free(waiting);
+	}
+
+	atomic_fetch_sub(&counter->Busy, 1);
+}
+
+static void JobSystem_Execute(const Job* job) {
+	job->Function(job->Data, job->Index);
+
+	if (job->Counter) {
+		JobCounter_Decrement(job->Counter);
+	}
+}
+
+static void JobSystem_Push(const Job* job) {
+	if (!JobSystemState.Initialized) {
+		JobSystem_Execute(job);
+		return;
+	}
+
+	u32 threadIndex = JobSystemThreadIndex;
+	if (threadIndex < JobSystemState.ThreadCount) {
+		if (!JobQueue_Push(&JobSystemState.Queues[threadIndex], job)) {
+			// NOTE: Queue is full, doing the work now is always correct
+			JobSystem_Execute(job);
+			return;
+		}
+	} else {
+		AcquireSRWLockExclusive(&JobSystemState.GlobalLock);
+		if (JobSystemState.GlobalJobCount == JobSystemState.GlobalJobCapacity) {
+			u64 capacity = JobSystemState.GlobalJobCapacity ? JobSystemState.GlobalJobCapacity * 2 : 64;
+			Job* jobs = realloc(JobSystemState.GlobalJobs, capacity * sizeof(jobs[0]));
+			if (!jobs) {
+				ReleaseSRWLockExclusive(&JobSystemState.GlobalLock);
+				JobSystem_Execute(job);
+				return;
+			}
+
+			JobSystemState.GlobalJobs = jobs;
+			JobSystemState.GlobalJobCapacity = capacity;
+		}
+		JobSystemState.GlobalJobs[JobSystemState.GlobalJobCount++] = *job;
+		ReleaseSRWLockExclusive(&JobSystemState.GlobalLock);
+	}
+
+	ReleaseSemaphore(JobSystemState.WakeSemaphore, 1, NULL); // NOTE: Fails when every worker is already awake
+}
+
+static b8 JobSystem_TryRunOne() {
+	Job job;
+	u32 threadIndex = JobSystemThreadIndex;
+
+	if (threadIndex < JobSystemState.ThreadCount && JobQueue_Pop(&JobSystemState.Queues[threadIndex], &job)) {
+		JobSystem_Execute(&job);
+		return true;
+	}
+
+	if (JobSystemState.GlobalJobCount > 0) {
+		b8 found = false;
+		AcquireSRWLockExclusive(&JobSystemState.GlobalLock);
+		if (JobSystemState.GlobalJobCount > 0) {
+			job = JobSystemState.GlobalJobs[--JobSystemState.GlobalJobCount];
+			found = true;
+		}
+		ReleaseSRWLockExclusive(&JobSystemState.GlobalLock);
+
+		if (found) {
+			JobSystem_Execute(&job);
+			return true;
+		}
+	}
+
+	u32 start = threadIndex < JobSystemState.ThreadCount ? threadIndex + 1 : 0;
+	for (u32 i = 0; i < JobSystemState.ThreadCount; i++) {
+		u32 victim = (start + i) % JobSystemState.ThreadCount;
+		if (victim == threadIndex) {
+			continue;
+		}
+
+		if (JobQueue_Steal(&JobSystemState.Queues[victim], &job)) {
+			JobSystem_Execute(&job);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static DWORD WINAPI JobSystem_WorkerMain(LPVOID parameter) {
+	JobWorker* worker = parameter;
+	JobSystemThreadIndex = worker->Index;
+
+	u32 idleCount = 0;
+	while (!atomic_load(&JobSystemState.ShuttingDown)) {
+		if (JobSystem_TryRunOne()) {
+			idleCount = 0;
+			continue;
+		}
+
+		if (++idleCount < 64) {
+			YieldProcessor();
+		} else {
+			WaitForSingleObject(JobSystemState.WakeSemaphore, INFINITE);
+			idleCount = 0;
+		}
+	}
+
+	return 0;
+}
+
+b8 JobSystem_Init(u32 workerCount) {
+	ASSERT(!JobSystemState.Initialized);
+
+	if (workerCount == JOB_SYSTEM_DEFAULT_WORKER_COUNT) {
+		u32 processorCount = JobSystem_GetProcessorCount();
+		workerCount = processorCount > 1 ? processorCount - 1 : 0;
+	}
+
+	JobSystemState.ThreadCount = workerCount + 1;
+	atomic_store(&JobSystemState.ShuttingDown, false);
+	InitializeSRWLock(&JobSystemState.GlobalLock);
+
+	JobSystemState.Queues = _aligned_malloc(JobSystemState.ThreadCount * sizeof(JobSystemState.Queues[0]), 64);
+	JobSystemState.Workers = calloc(JobSystemState.ThreadCount, sizeof(JobSystemState.Workers[0]));
+	if (!JobSystemState.Queues || !JobSystemState.Workers) {
+		_aligned_free(JobSystemState.Queues);
+		free(JobSystemState.Workers);
+		return false;
+	}
+
+	for (u32 i = 0; i < JobSystemState.ThreadCount; i++) {
+		atomic_init(&JobSystemState.Queues[i].Top, 0);
+		atomic_init(&JobSystemState.Queues[i].Bottom, 0);
+	}
+
+	JobSystemState.WakeSemaphore = CreateSemaphoreA(NULL, 0, workerCount > 0 ? workerCount : 1, NULL);
+	if (!JobSystemState.WakeSemaphore) {
+		_aligned_free(JobSystemState.Queues);
+		free(JobSystemState.Workers);
+		return false;
+	}
+
+	JobSystemThreadIndex = 0;
+	JobSystemState.Initialized = true;
+
+	for (u32 i = 1; i < JobSystemState.ThreadCount; i++) {
+		JobSystemState.Workers[i].Index = i;
+		JobSystemState.Workers[i].Thread = CreateThread(NULL, 0, JobSystem_WorkerMain, &JobSystemState.Workers[i], 0, NULL);
+		if (!JobSystemState.Workers[i].Thread) {
+			JobSystem_Shutdown();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void JobSystem_Shutdown() {
+	if (!JobSystemState.Initialized) {
+		return;
+	}
+
+	// NOTE: Drain whatever is still queued before stopping the workers
+	while (JobSystem_TryRunOne()) {}
+
+	atomic_store(&JobSystemState.ShuttingDown, true);
+
+	for (u32 i = 1; i < JobSystemState.ThreadCount; i++) {
+		ReleaseSemaphore(JobSystemState.WakeSemaphore, 1, NULL);
+	}
+
+	for (u32 i = 1; i < JobSystemState.ThreadCount; i++) {
+		if (JobSystemState.Workers[i].Thread) {
+			WaitForSingleObject(JobSystemState.Workers[i].Thread, INFINITE);
+			CloseHandle(JobSystemState.Workers[i].Thread);
+		}
+	}
+
+	CloseHandle(JobSystemState.WakeSemaphore);
+	_aligned_free(JobSystemState.Queues);
+	free(JobSystemState.Workers);
+	free(JobSystemState.GlobalJobs);
+
+	memset(&JobSystemState, 0, sizeof(JobSystemState));
+	JobSystemThreadIndex = ~0u;
+}
+
+u32 JobSystem_GetThreadCount() {
+	return JobSystemState.Initialized ? JobSystemState.ThreadCount : 1;
+}
+
+u32 JobSystem_GetThreadIndex() {
+	return JobSystemThreadIndex;
+}
+
+u32 JobSystem_GetProcessorCount() {
+	SYSTEM_INFO systemInfo = {};
+	GetSystemInfo(&systemInfo);
+	return systemInfo.dwNumberOfProcessors;
+}
+
+void JobSystem_Run(const Job* jobs, u64 jobCount, JobCounter* counter) {
+	if (counter) {
+		atomic_fetch_add(&counter->Value, cast(s64) jobCount);
+	}
+
+	for (u64 i = 0; i < jobCount; i++) {
+		Job job = jobs[i];
+		job.Counter = counter;
+		JobSystem_Push(&job);
+	}
+}
+
+void JobSystem_RunAfter(JobCounter* dependency, const Job* jobs, u64 jobCount, JobCounter* counter) {
+	if (counter) {
+		atomic_fetch_add(&counter->Value, cast(s64) jobCount);
+	}
+
+	JobCounter_Lock(dependency);
+	if (atomic_load(&dependency->Value) != 0) {
+		Job* waiting = realloc(dependency->Waiting, (dependency->WaitingCount + jobCount) * sizeof(waiting[0]));
+		if (waiting) {
+			for (u64 i = 0; i < jobCount; i++) {
+				waiting[dependency->WaitingCount + i] = jobs[i];
+				waiting[dependency->WaitingCount + i].Counter = counter;
+			}
+
+			dependency->Waiting = waiting;
+			dependency->WaitingCount += jobCount;
+			JobCounter_Unlock(dependency);
+			return;
+		}
+	}
+	JobCounter_Unlock(dependency);
+
+	// NOTE: Either the dependency is already done or we could not defer, so wait for it here
+	JobSystem_Wait(dependency);
+	for (u64 i = 0; i < jobCount; i++) {
+		Job job = jobs[i];
+		job.Counter = counter;
+		JobSystem_Push(&job);
+	}
+}
+
+void JobSystem_Wait(JobCounter* counter) {
+	while (atomic_load(&counter->Value) != 0 || atomic_load(&counter->Busy) != 0) {
+		if (!JobSystemState.Initialized || !JobSystem_TryRunOne()) {
+			YieldProcessor();
+		}
+	}
+}
+
+typedef struct ParallelForData_t {
+	ParallelForFunction Function;
+	void* Data;
+	u64 Count;
+	u64 BatchSize;
+} ParallelForData;
+
+static void ParallelFor_Job(void* data, u64 index) {
+	ParallelForData* parallelFor = data;
+
+	u64 begin = index * parallelFor->BatchSize;
+	u64 end = begin + parallelFor->BatchSize;
+	if (end > parallelFor->Count) {
+		end = parallelFor->Count;
+	}
+
+	parallelFor->Function(parallelFor->Data, begin, end);
+}
+
+void JobSystem_ParallelFor(u64 count, u64 batchSize, ParallelForFunction function, void* data) {
+	if (count == 0) {
+		return;
+	}
+
+	if (batchSize == 0) {
+		batchSize = 1;
+	}
+
+	u64 batchCount = (count + batchSize - 1) / batchSize;
+	if (batchCount == 1 || !JobSystemState.Initialized) {
+		function(data, 0, count);
+		return;
+	}
+
+	ParallelForData parallelFor = {
+		.Function = function,
+		.Data = data,
+		.Count = count,
+		.BatchSize = batchSize,
+	};
+
+	JobCounter counter = {};
+	atomic_fetch_add(&counter.Value, cast(s64) (batchCount - 1));
+
+	// NOTE: The calling thread takes the first batch itself instead of queueing it
+	for (u64 i = 1; i < batchCount; i++) {
+		JobSystem_Push(&(Job){
+			.Function = ParallelFor_Job,
+			.Data = &parallelFor,
+			.Index = i,
+			.Counter = &counter,
+		});
+	}
+
+	ParallelFor_Job(&parallelFor, 0);
+	JobSystem_Wait(&counter);
+}
+
+#else
+	#error This platform is not supported
+#endif
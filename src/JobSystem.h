@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <stdatomic.h>
+
+typedef void (*JobFunction)(void* data, u64 index);
+
+typedef struct JobCounter_t JobCounter;
+
+typedef struct Job_t {
+	JobFunction Function;
+	void* Data;
+	u64 Index;
+	JobCounter* Counter;
+} Job;
+
+// NOTE: A zero initialized counter is ready to use, it must outlive every job that references it
+typedef struct JobCounter_t {
+	_Atomic s64 Value;
+	_Atomic s64 Busy;
+	atomic_flag Lock;
+	Job* Waiting;
+	u64 WaitingCount;
+} JobCounter;
+
+typedef void (*ParallelForFunction)(void* data, u64 begin, u64 end);
+
+#define JOB_SYSTEM_DEFAULT_WORKER_COUNT (~0u)
+
+// NOTE: workerCount does not include the calling thread, JOB_SYSTEM_DEFAULT_WORKER_COUNT picks one worker per remaining core
+b8 JobSystem_Init(u32 workerCount);
+void JobSystem_Shutdown();
+
+u32 JobSystem_GetThreadCount();
+u32 JobSystem_GetThreadIndex(); // ~0u for threads that are not part of the pool
+u32 JobSystem_GetProcessorCount();
+
+void JobSystem_Run(const Job* jobs, u64 jobCount, JobCounter* counter);
+// NOTE: The jobs are only queued once dependency reaches zero, counter is incremented immediately
+void JobSystem_RunAfter(JobCounter* dependency, const Job* jobs, u64 jobCount, JobCounter* counter);
+// NOTE: Runs other jobs while waiting, so it is safe to call from inside a job
+void JobSystem_Wait(JobCounter* counter);
+
+void JobSystem_ParallelFor(u64 count, u64 batchSize, ParallelForFunction function, void* data);
@@ -0,0 +1,57 @@
+#include "Light.h"
+
+#include <math.h>
+
+// NOTE: xorshift32, seed must not be 0
+static f32 GpuLight_Random(u32* state) {
+	u32 x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return cast(f32) (x >> 8) / cast(f32) (1u << 24);
+}
+
+static f32 GpuLight_Lerp(f32 a, f32 b, f32 t) {
+	return a + (b - a) * t;
+}
+
+void GpuLight_Scatter(GpuLight* lights, u64 count, Vector3 min, Vector3 max, f32 minRange, f32 maxRange, u32 seed) {
+	u32 state = seed != 0 ? seed : 1;
+	f32 intensity = count > 10 ? sqrtf(10.0f / cast(f32) count) : 1.0f;
+
+	const f32 SpotCosInner = 0.866f; // 30 degrees
+	const f32 SpotCosOuter = 0.766f; // 40 degrees
+
+	for (u64 i = 0; i < count; i++) {
+		GpuLight* light = &lights[i];
+		light->Position = (Vector3){
+			GpuLight_Lerp(min.x, max.x, GpuLight_Random(&state)),
+			GpuLight_Lerp(min.y, max.y, GpuLight_Random(&state)),
+			GpuLight_Lerp(min.z, max.z, GpuLight_Random(&state)),
+		};
+		light->Range = GpuLight_Lerp(minRange, maxRange, GpuLight_Random(&state));
+		light->Color = (Vector3){
+			GpuLight_Random(&state) * intensity,
+			GpuLight_Random(&state) * intensity,
+			GpuLight_Random(&state) * intensity,
+		};
+
+		// NOTE: Every other light is a spot light pointing away from the viewer, into the scene
+		if (i % 2 == 1) {
+			Vector3 direction = {
+				GpuLight_Random(&state) * 2.0f - 1.0f,
+				GpuLight_Random(&state) * 2.0f - 1.0f,
+				GpuLight_Random(&state) + 0.1f,
+			};
+			f32 length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+			light->Direction = (Vector3){ direction.x / length, direction.y / length, direction.z / length };
+			light->SpotCosInner = SpotCosInner;
+			light->SpotCosOuter = SpotCosOuter;
+		} else {
+			light->Direction = (Vector3){ 0.0f, 0.0f, 1.0f };
+			light->SpotCosInner = 1.0f;
+			light->SpotCosOuter = -1.0f;
+		}
+	}
+}
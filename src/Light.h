@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+
+// NOTE: Matches the std430 Light struct in light_cull.comp.glsl and triangle.frag.glsl. Point lights have a SpotCosOuter of -1,
+// spot lights fade out between SpotCosInner and SpotCosOuter around Direction
+typedef struct GpuLight_t {
+	Vector3 Position;  // World space
+	f32 Range;         // The light fades out smoothly and reaches 0 here
+	Vector3 Color;     // Already scaled by the intensity
+	f32 SpotCosOuter;
+	Vector3 Direction; // World space, the way a spot light points
+	f32 SpotCosInner;
+} GpuLight;
+
+STATIC_ASSERT(sizeof(GpuLight) == 48, "GpuLight must match the std430 layout");
+
+// NOTE: Fills lights with a repeatable mix of point and spot lights inside the box from min to max. The intensity drops as
+// the count grows, so the total brightness stays about the same however many lights there are
+void GpuLight_Scatter(GpuLight* lights, u64 count, Vector3 min, Vector3 max, f32 minRange, f32 maxRange, u32 seed);
@@ -3,10 +3,21 @@
 #include "ObjLoader.h"
 #include "Vector.h"
 #include "Matrix.h"
+#include "Scene.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Light.h"
+#include "JobSystem.h"
+#include "Benchmark.h"
+#include "Cooker.h"
+#include "MeshFile.h"
+#include "Timer.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <math.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 	#define VK_USE_PLATFORM_WIN32_KHR
@@ -19,6 +30,29 @@
 
 #include "VulkanUtil.h"
 #include "VulkanSwapchain.h"
+#include "VulkanBuffer.h"
+#include "VulkanCommandRecorder.h"
+#include "VulkanBindless.h"
+#include "VulkanStreamer.h"
+#include "VulkanMemoryBudget.h"
+#include "VulkanImagePool.h"
+#include "VulkanClusterCuller.h"
+#include "RenderGraph.h"
+#include "VulkanDeletionQueue.h"
+#include "VulkanFrameTimer.h"
+#include "VulkanLightCuller.h"
+#include "VulkanShadowMap.h"
+#include "VulkanCapturePool.h"
+#include "DynamicResolution.h"
+#include "DrawList.h"
+
+#define FRAMES_IN_FLIGHT 2
+#define DRAW_RECORD_BATCH_SIZE 256
+// NOTE: How far in pixels a lod may move the surface on screen before the next finer one is used
+#define MESH_LOD_ERROR_PIXELS 1.0f
+// NOTE: Of one shadow cascade
+#define SHADOW_MAP_RESOLUTION 1024
+#define CAPTURE_SLOT_COUNT 4
 
 #if defined(_DEBUG)
 
@@ -41,105 +75,483 @@ VkBool32 VKAPI_CALL DebugMessengerCallback(VkDebugUtilsMessageSeverityFlagBitsEX
 
 #endif
 
-typedef struct Vertex_t {
-	Vector3 Position;
-	Vector3 Normal;
-	Vector2 TexCoord;
-} Vertex;
-
-typedef struct Mesh_t {
-	Vertex* Vertices;
-	u64 VertexCount;
-	u32* Indices;
-	u64 IndexCount;
-} Mesh;
-
 typedef struct UniformBuffer_t {
-	Matrix4 ModelMatrix;
 	Matrix4 ViewMatrix;
 	Matrix4 ProjectionMatrix;
+
+	// NOTE: Only read by the fragment shader, the frame's light grid and what it needs to find a fragment's froxel in it
+	BindlessHandle LightBufferHandle;
+	BindlessHandle LightGridHandle; // BINDLESS_HANDLE_NONE without lights
+	f32 LightDepthNear;
+	f32 LightDepthFar;
+	f32 RenderWidth;
+	f32 RenderHeight;
+
+	// NOTE: The frame's ShadowData, BINDLESS_HANDLE_NONE without shadows
+	BindlessHandle ShadowBufferHandle;
+	u32 Padding;
+	Vector4 LightDirection; // xyz towards the directional light
 } UniformBuffer;
 
-typedef struct VulkanBuffer_t {
-	VkBuffer Buffer;
-	VkDevice Device;
-	VkPhysicalDevice PhysicalDevice;
-	VkDeviceMemory Memory;
-	void* Data;
-	u64 Size;
+// NOTE: Matches the PushConstants block in the shaders
+typedef struct MeshPushConstants_t {
+	Matrix4 ModelMatrix; // NOTE: Pushed per draw by DrawList_Record, the rest once per command buffer
+
+	BindlessHandle UniformBufferHandle;
+	BindlessHandle MaterialBufferHandle;
+
+	// NOTE: Only read by the vertex pulling shader, strides and offsets are in 4 byte words
+	VkDeviceAddress VertexAddress;
+	u32 VertexStride;
+	u32 PositionOffset;
+	u32 NormalOffset;
+	u32 TexCoordOffset;
+	u32 MaterialIndexOffset;
+
+	// NOTE: Only read by the cluster shader, the model matrices of the indirect draws
+	BindlessHandle ObjectBufferHandle;
+} MeshPushConstants;
+
+STATIC_ASSERT(sizeof(MeshPushConstants) <= 128, "Vulkan only guarantees 128 bytes of push constants");
+
+typedef struct FrameData_t {
+	VkSemaphore ImageAvailableSemaphore;
+	VkSemaphore RenderFinishedSemaphore;
+	VkFence InFlightFence;
+	VkCommandPool CommandPool;
+	VkCommandBuffer CommandBuffer;
+	VulkanBuffer UniformBuffer;
+	BindlessHandle UniformBufferHandle;
+	f64 InputTime; // When the input the frame was built from was polled, 0 before the first submit
+	f32 RenderScale;
+} FrameData;
+
+typedef struct DrawRecordData_t {
+	const Draw* Draws;
+	VkExtent2D Extent;
+	VkPipelineLayout PipelineLayout;
+	MeshPushConstants PushConstants;
+} DrawRecordData;
+
+static void RecordDraws(VkCommandBuffer commandBuffer, void* data, u64 begin, u64 end) {
+	DrawRecordData* record = data;
+
+	// NOTE: Dynamic state is not inherited by secondary command buffers
+	vkCmdSetViewport(commandBuffer, 0, 1, &(VkViewport){
+		.x = 0.0f,
+		.y = record->Extent.height,
+		.width = record->Extent.width,
+		.height = -cast(float) record->Extent.height,
+		.minDepth = 0.0f,
+		.maxDepth = 1.0f,
+	});
+	vkCmdSetScissor(commandBuffer, 0, 1, &(VkRect2D){
+		.offset = (VkOffset2D){
+			.x = 0,
+			.y = 0,
+		},
+		.extent = record->Extent,
+	});
+
+	// NOTE: The handles are the same for every draw in the frame, so they are pushed once per command buffer
+	const u64 FrameOffset = offsetof(MeshPushConstants, UniformBufferHandle);
+	vkCmdPushConstants(
+		commandBuffer,
+		record->PipelineLayout,
+		DRAW_PUSH_CONSTANT_STAGES,
+		FrameOffset,
+		sizeof(record->PushConstants) - FrameOffset,
+		&record->PushConstants.UniformBufferHandle
+	);
+
+	DrawList_Record(commandBuffer, record->Draws, begin, end);
+}
 
-	VkBufferUsageFlags UsageFlags;
-} VulkanBuffer;
+typedef struct ClusterRecordData_t {
+	VulkanClusterCuller* ClusterCuller;
+	u32 FrameIndex;
+	VkExtent2D Extent;
+	VkPipeline Pipeline;
+	VkPipelineLayout PipelineLayout;
+	VkDescriptorSet DescriptorSet;
+	VkBuffer VertexBuffer;
+	VkBuffer IndexBuffer;
+	MeshPushConstants PushConstants;
+} ClusterRecordData;
+
+// NOTE: The surviving clusters are one indirect draw, so this is always a single item
+static void RecordClusterDraws(VkCommandBuffer commandBuffer, void* data, u64 begin, u64 end) {
+	ClusterRecordData* record = data;
+
+	vkCmdSetViewport(commandBuffer, 0, 1, &(VkViewport){
+		.x = 0.0f,
+		.y = record->Extent.height,
+		.width = record->Extent.width,
+		.height = -cast(float) record->Extent.height,
+		.minDepth = 0.0f,
+		.maxDepth = 1.0f,
+	});
+	vkCmdSetScissor(commandBuffer, 0, 1, &(VkRect2D){
+		.offset = (VkOffset2D){
+			.x = 0,
+			.y = 0,
+		},
+		.extent = record->Extent,
+	});
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, record->Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, record->PipelineLayout, 0, 1, &record->DescriptorSet, 0, NULL);
+	vkCmdPushConstants(commandBuffer, record->PipelineLayout, DRAW_PUSH_CONSTANT_STAGES, 0, sizeof(record->PushConstants), &record->PushConstants);
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &record->VertexBuffer, &(VkDeviceSize){ 0 });
+	vkCmdBindIndexBuffer(commandBuffer, record->IndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+	VulkanClusterCuller_RecordDraws(record->ClusterCuller, commandBuffer, record->FrameIndex);
+}
 
-static u32 VulkanBuffer_SelectMemoryType(const VkPhysicalDeviceMemoryProperties* memoryProperties, u32 memoryTypeBits, VkMemoryPropertyFlags propertyFlags) {
-	for (u32 i = 0; i < memoryProperties->memoryTypeCount; i++) {
-		if ((memoryTypeBits & (1 << i)) != 0 && (memoryProperties->memoryTypes[i].propertyFlags & propertyFlags) == propertyFlags) {
-			return i;
-		}
-	}
+// NOTE: Everything the render graph passes need to record a frame, refreshed before every RenderGraph_Execute
+typedef struct FrameRecordData_t {
+	u32 FrameIndex;
+	VkExtent2D Extent;
+	VkExtent2D RenderExtent; // The top left part of the color and depth targets that is drawn to, and the only part cleared
+
+	// NOTE: With dynamic resolution the scene is drawn to SceneImage and scaled up to SwapchainImage
+	VkImage SceneImage;
+	VkImage SwapchainImage;
+	VkFilter UpscaleFilter;
+
+	// NOTE: RenderPass is VK_NULL_HANDLE when drawing with dynamic rendering, which uses the views and formats instead
+	VkRenderPass RenderPass;
+	VkFramebuffer Framebuffer;
+	const VulkanDynamicRendering* DynamicRendering;
+	VkImageView ColorView;
+	VkImageView DepthView;
+	VkFormat ColorFormat;
+	VkFormat DepthFormat;
+
+	VulkanCommandRecorder* CommandRecorder;
+	u64 DrawCount;
+	DrawRecordData Draws;
+	b8 DrawClusters;
+	ClusterRecordData Clusters;
+
+	VulkanClusterCuller* ClusterCuller;
+	VulkanLightCuller* LightCuller;
+	VulkanShadowMap* ShadowMap;
+	VulkanCapturePool* CapturePool;
+	VkBuffer VertexBuffer; // The mesh's, for the shadow pass
+	VkBuffer IndexBuffer;
+	BindlessHandle UniformBufferHandle;
+	BindlessHandle ClusterBufferHandle;
+	const Matrix4* ViewMatrix;
+	const Matrix4* ProjectionMatrix;
+} FrameRecordData;
+
+static void RecordClusterCullPass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	VulkanClusterCuller_RecordCull(
+		record->ClusterCuller,
+		commandBuffer,
+		record->FrameIndex,
+		record->UniformBufferHandle,
+		record->ClusterBufferHandle,
+		record->ViewMatrix,
+		record->ProjectionMatrix
+	);
+}
 
-	return ~0u;
+static void RecordLightCullPass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	VulkanLightCuller_RecordCull(record->LightCuller, commandBuffer, record->FrameIndex, record->ViewMatrix);
 }
 
-b8 VulkanBuffer_Create(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags) {
-	buffer->Buffer = VK_NULL_HANDLE;
-	buffer->Device = device;
-	buffer->PhysicalDevice = physicalDevice;
-	buffer->Memory = VK_NULL_HANDLE;
-	buffer->Data = NULL;
-	buffer->Size = size;
-	buffer->UsageFlags = usageFlags;
+static void RecordShadowPass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	VulkanShadowMap_RecordDraws(record->ShadowMap, commandBuffer, record->FrameIndex, record->VertexBuffer, record->IndexBuffer);
+}
 
-	VkCheck(vkCreateBuffer(device, &(VkBufferCreateInfo){
-		.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-		.size = size,
-		.usage = buffer->UsageFlags,
-		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-	}, NULL, &buffer->Buffer));
+static void RecordMainPass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
 
-	if (buffer->Buffer == VK_NULL_HANDLE) {
-		return false;
-	}
+	const VkClearColorValue ClearColor = (VkClearColorValue){
+		{ 0.9f, 0.3f, 0.1f, 1.0f },
+	};
+
+	const VkClearValue Clears[2] = {
+		(VkClearValue){
+			.color = ClearColor,
+		},
+		(VkClearValue){
+			.depthStencil = (VkClearDepthStencilValue){ .depth = 1.0f, .stencil = 0 },
+		},
+	};
+
+	VkCommandBufferInheritanceRenderingInfoKHR renderingInheritanceInfo = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR,
+		.colorAttachmentCount = 1,
+		.pColorAttachmentFormats = &record->ColorFormat,
+		.depthAttachmentFormat = record->DepthFormat,
+		.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+	};
 
-	VkPhysicalDeviceMemoryProperties memoryProperties = {};
-	vkGetPhysicalDeviceMemoryProperties(buffer->PhysicalDevice, &memoryProperties);
+	VkCommandBufferInheritanceInfo inheritanceInfo = {
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+		.renderPass = record->RenderPass,
+		.subpass = 0,
+		.framebuffer = record->Framebuffer,
+	};
+
+	if (record->RenderPass != VK_NULL_HANDLE) {
+		vkCmdBeginRenderPass(commandBuffer, &(VkRenderPassBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+			.renderPass = record->RenderPass,
+			.framebuffer = record->Framebuffer,
+			.renderArea = (VkRect2D){
+				.offset = (VkOffset2D){ .x = 0, .y = 0 },
+				.extent = record->RenderExtent,
+			},
+			.clearValueCount = 2,
+			.pClearValues = Clears,
+		}, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+	} else {
+		// NOTE: Same load and store ops as the render pass, the render graph has already put the images in these layouts
+		record->DynamicRendering->CmdBeginRendering(commandBuffer, &(VkRenderingInfoKHR){
+			.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+			.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR,
+			.renderArea = (VkRect2D){
+				.offset = (VkOffset2D){ .x = 0, .y = 0 },
+				.extent = record->RenderExtent,
+			},
+			.layerCount = 1,
+			.colorAttachmentCount = 1,
+			.pColorAttachments = &(VkRenderingAttachmentInfoKHR){
+				.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+				.imageView = record->ColorView,
+				.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+				.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+				.clearValue = Clears[0],
+			},
+			.pDepthAttachment = &(VkRenderingAttachmentInfoKHR){
+				.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+				.imageView = record->DepthView,
+				.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+				.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+				.clearValue = Clears[1],
+			},
+		});
 
-	VkMemoryRequirements memoryRequirements = {};
-	vkGetBufferMemoryRequirements(buffer->Device, buffer->Buffer, &memoryRequirements);
-	
-	u32 memoryTypeIndex = VulkanBuffer_SelectMemoryType(&memoryProperties, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-	ASSERT(memoryTypeIndex != ~0u);
+		inheritanceInfo.pNext = &renderingInheritanceInfo;
+	}
 
-	VkCheck(vkAllocateMemory(buffer->Device, &(VkMemoryAllocateInfo){
-		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		.allocationSize = memoryRequirements.size,
-		.memoryTypeIndex = memoryTypeIndex,
-	}, NULL, &buffer->Memory));
+	ASSERT(VulkanCommandRecorder_Record(
+		record->CommandRecorder,
+		record->FrameIndex,
+		commandBuffer,
+		&inheritanceInfo,
+		record->DrawCount,
+		DRAW_RECORD_BATCH_SIZE,
+		RecordDraws,
+		&record->Draws
+	));
+
+	if (record->DrawClusters) {
+		ASSERT(VulkanCommandRecorder_Record(
+			record->CommandRecorder,
+			record->FrameIndex,
+			commandBuffer,
+			&inheritanceInfo,
+			1,
+			1,
+			RecordClusterDraws,
+			&record->Clusters
+		));
+	}
 
-	if (buffer->Memory == VK_NULL_HANDLE) {
-		return false;
+	if (record->RenderPass != VK_NULL_HANDLE) {
+		vkCmdEndRenderPass(commandBuffer);
+	} else {
+		record->DynamicRendering->CmdEndRendering(commandBuffer);
 	}
+}
+
+static void RecordUpscalePass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	vkCmdBlitImage(
+		commandBuffer,
+		record->SceneImage,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		record->SwapchainImage,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		1,
+		&(VkImageBlit){
+			.srcSubresource = (VkImageSubresourceLayers){
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.layerCount = 1,
+			},
+			.srcOffsets = {
+				(VkOffset3D){ 0, 0, 0 },
+				(VkOffset3D){ record->RenderExtent.width, record->RenderExtent.height, 1 },
+			},
+			.dstSubresource = (VkImageSubresourceLayers){
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.layerCount = 1,
+			},
+			.dstOffsets = {
+				(VkOffset3D){ 0, 0, 0 },
+				(VkOffset3D){ record->Extent.width, record->Extent.height, 1 },
+			},
+		},
+		record->UpscaleFilter
+	);
+}
 
-	VkCheck(vkBindBufferMemory(buffer->Device, buffer->Buffer, buffer->Memory, 0));
+static void RecordDepthPyramidPass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	VulkanClusterCuller_RecordPyramid(record->ClusterCuller, commandBuffer, record->RenderExtent);
+}
+
+static void RecordCapturePass(VkCommandBuffer commandBuffer, void* data) {
+	FrameRecordData* record = data;
+	VulkanCapturePool_RecordCopy(record->CapturePool, commandBuffer, record->SwapchainImage);
+}
 
-	VkCheck(vkMapMemory(buffer->Device, buffer->Memory, 0, buffer->Size, 0, &buffer->Data));
-	
-	if (buffer->Data == NULL) {
-		return false;
+// NOTE: Runs on the job system, a few frames after the captured frame was presented
+static void SaveCapture(const Image* image, u64 frame, void* userData) {
+	(void)userData;
+	char filepath[64];
+	snprintf(filepath, sizeof(filepath), "capture_%llu.tga", frame);
+	if (!Image_SaveTga(image, filepath)) {
+		printf("Unable to save '%s'\n", filepath);
 	}
+}
 
+// NOTE: The render pass path needs its own framebuffer for the scene target, the swapchain's only point at its images
+static b8 CreateSceneFramebuffer(VkFramebuffer* framebuffer, VkDevice device, VkRenderPass renderPass, const VulkanImage* colorImage, const VulkanImage* depthImage) {
+	*framebuffer = VK_NULL_HANDLE;
+	VkCheck(vkCreateFramebuffer(device, &(VkFramebufferCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+		.renderPass = renderPass,
+		.attachmentCount = 2,
+		.pAttachments = (VkImageView[2]){ colorImage->View, depthImage->View },
+		.width = colorImage->Width,
+		.height = colorImage->Height,
+		.layers = 1,
+	}, NULL, framebuffer));
 	return true;
 }
 
-void VulkanBuffer_Destroy(VulkanBuffer* buffer) {
-	vkUnmapMemory(buffer->Device, buffer->Memory);
-	vkFreeMemory(buffer->Device, buffer->Memory, NULL);
-	vkDestroyBuffer(buffer->Device, buffer->Buffer, NULL);
+// NOTE: Only the materials of ObjMesh are used once the mesh is built, a cooked mesh fills in just those
+typedef struct MeshLoadJob_t {
+	const char* Filepath;
+	ObjMesh ObjMesh;
+	Mesh Mesh;
+	b8 Loaded;
+	b8 Built;
+	b8 Cooked;
+} MeshLoadJob;
+
+// NOTE: Prefers the cooked mesh next to the OBJ, which skips parsing and building entirely
+static void MeshLoadJob_Load(void* data, u64 index) {
+	MeshLoadJob* job = data;
+
+	char cookedPath[1024];
+	snprintf(cookedPath, sizeof(cookedPath), "%s%s", job->Filepath, MESH_FILE_EXTENSION);
+	MeshFile file = {};
+	if (MeshFile_Load(&file, cookedPath)) {
+		job->Mesh = file.Mesh;
+		job->ObjMesh = (ObjMesh){
+			.Materials = file.Materials,
+			.MaterialCount = file.MaterialCount,
+			.Strings = file.Strings,
+		};
+		job->Loaded = true;
+		job->Built = true;
+		job->Cooked = true;
+		return;
+	}
+
+	job->Loaded = ObjMesh_Create(&job->ObjMesh, job->Filepath);
+}
+
+static void MeshLoadJob_Build(void* data, u64 index) {
+	MeshLoadJob* job = data;
+	if (job->Loaded && !job->Cooked) {
+		job->Built = Mesh_CreateFromObj(&job->Mesh, &job->ObjMesh);
+	}
 }
 
 int main(int argc, char** argv) {
+	if (argc == 3 && strcmp(argv[1], "-benchmark") == 0) {
+		return Benchmark_Run(argv[2]) ? 0 : -1;
+	}
+
+	if (argc >= 2 && (strcmp(argv[1], "-cook-texture") == 0 || strcmp(argv[1], "-cook-mesh") == 0)) {
+		return Cooker_Run(argc, argv) ? 0 : -1;
+	}
+
+	b8 vertexPulling = false;
+	b8 clusterCulling = false;
+	b8 forceRenderPass = false;
+	VkPresentModeKHR presentMode = VULKAN_SWAPCHAIN_PRESENT_MODE_DEFAULT;
+	u32 swapchainImageCount = 0;
+	f64 frameLimit = 0.0;
+	f32 dynamicResolutionTarget = 0.0f;
+	u64 lightCount = 0;
+	b8 shadows = false;
+	u64 captureInterval = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-vertex-pulling") == 0) {
+			vertexPulling = true;
+		} else if (strcmp(argv[i], "-cluster-culling") == 0) {
+			clusterCulling = true;
+		} else if (strcmp(argv[i], "-render-pass") == 0) {
+			forceRenderPass = true;
+		} else if (strcmp(argv[i], "-present-mode") == 0 && i + 1 < argc) {
+			if (!VulkanSwapchain_ParsePresentMode(argv[++i], &presentMode)) {
+				printf("Unknown present mode '%s', expected fifo, fifo-relaxed, mailbox or immediate\n", argv[i]);
+				return -1;
+			}
+		} else if (strcmp(argv[i], "-swapchain-images") == 0 && i + 1 < argc) {
+			swapchainImageCount = cast(u32) strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "-frame-limit") == 0 && i + 1 < argc) {
+			frameLimit = strtod(argv[++i], NULL);
+		} else if (strcmp(argv[i], "-dynamic-resolution") == 0 && i + 1 < argc) {
+			dynamicResolutionTarget = strtof(argv[++i], NULL) / 1000.0f;
+		} else if (strcmp(argv[i], "-lights") == 0 && i + 1 < argc) {
+			lightCount = strtoull(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "-shadows") == 0) {
+			shadows = true;
+		} else if (strcmp(argv[i], "-capture") == 0 && i + 1 < argc) {
+			captureInterval = strtoull(argv[++i], NULL, 10);
+		} else {
+			printf("Unknown argument '%s'\n", argv[i]);
+			return -1;
+		}
+	}
+
+	// NOTE: The cluster draws fetch their vertices through the vertex input state
+	if (vertexPulling && clusterCulling) {
+		printf("-vertex-pulling and -cluster-culling can not be used together\n");
+		return -1;
+	}
+
 	const u32 VulkanAPIVersion = VK_API_VERSION_1_2;
 
+	if (!JobSystem_Init(JOB_SYSTEM_DEFAULT_WORKER_COUNT)) {
+		printf("Unable to start job system!\n");
+		return -1;
+	}
+
+	// NOTE: The mesh is loaded and built on the job system while vulkan is being initialized
+	MeshLoadJob meshLoadJob = {
+		.Filepath = "Cube.obj",
+	};
+	JobCounter meshLoadCounter = {};
+	JobCounter meshBuildCounter = {};
+	JobSystem_Run(&(Job){ .Function = MeshLoadJob_Load, .Data = &meshLoadJob }, 1, &meshLoadCounter);
+	JobSystem_RunAfter(&meshLoadCounter, &(Job){ .Function = MeshLoadJob_Build, .Data = &meshLoadJob }, 1, &meshBuildCounter);
+
 	{
 		u32 apiVersion = 0;
 		VkCall(vkEnumerateInstanceVersion(&apiVersion));
@@ -225,9 +637,18 @@ int main(int argc, char** argv) {
 		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 	};
 
+	VkPhysicalDeviceVulkan12Features deviceFeatures12 = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+	};
+	VulkanBindless_RequireFeatures(&deviceFeatures12);
+	VulkanStreamer_RequireFeatures(&deviceFeatures12);
+	deviceFeatures12.bufferDeviceAddress = vertexPulling;
+
 	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
 	u32 graphicsQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 	u32 presentQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	u32 transferQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	u32 transferQueueIndex = 0;
 	if (!ChooseVulkanPhysicalDevice(
 			&physicalDevice,
 			instance,
@@ -235,34 +656,95 @@ int main(int argc, char** argv) {
 			VulkanAPIVersion,
 			DeviceLayers, sizeof(DeviceLayers) / sizeof(DeviceLayers[0]),
 			DeviceExtensions, sizeof(DeviceExtensions) / sizeof(DeviceExtensions[0]),
+			&deviceFeatures12,
 			&graphicsQueueFamilyIndex,
-			&presentQueueFamilyIndex)
+			&presentQueueFamilyIndex,
+			&transferQueueFamilyIndex,
+			&transferQueueIndex)
 	) {
 		printf("Unable to find suitable physical device!\n");
 		return -1;
 	}
 
+	// NOTE: Block compressed textures are optional, cooked textures fall back to their source image without them
+	VkPhysicalDeviceFeatures deviceFeatures = {};
+	{
+		VkPhysicalDeviceFeatures supportedFeatures = {};
+		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+		deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+	}
+
+	if (clusterCulling && !VulkanClusterCuller_RequireFeatures(physicalDevice, &deviceFeatures, &deviceFeatures12)) {
+		printf("Cluster culling needs indirect count draws, which this device does not support!\n");
+		return -1;
+	}
+
+	// NOTE: Without the budget extension the budgets are a fixed share of each heap
+	const u32 RequiredDeviceExtensionCount = sizeof(DeviceExtensions) / sizeof(DeviceExtensions[0]);
+	const char* enabledDeviceExtensions[RequiredDeviceExtensionCount + 2];
+	memcpy(enabledDeviceExtensions, DeviceExtensions, sizeof(DeviceExtensions));
+	u32 enabledDeviceExtensionCount = RequiredDeviceExtensionCount;
+
+	b8 hasMemoryBudget = HasVulkanDeviceExtension(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (hasMemoryBudget) {
+		enabledDeviceExtensions[enabledDeviceExtensionCount++] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+	}
+
+	// NOTE: Dynamic rendering draws straight to image views, so there is no render pass and no framebuffers to recreate
+	// with the swapchain. Without it, or with -render-pass, the render pass path is used
+	b8 useDynamicRendering = !forceRenderPass && HasVulkanDynamicRendering(physicalDevice);
+	VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+		.dynamicRendering = VK_TRUE,
+	};
+	if (useDynamicRendering) {
+		enabledDeviceExtensions[enabledDeviceExtensionCount++] = VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+		deviceFeatures12.pNext = &dynamicRenderingFeatures;
+	}
+
 	VkDevice device = VK_NULL_HANDLE;
 	if (!CreateVulkanDevice(
 			&device,
 			physicalDevice,
 			DeviceLayers, sizeof(DeviceLayers) / sizeof(DeviceLayers[0]),
-			DeviceExtensions, sizeof(DeviceExtensions) / sizeof(DeviceExtensions[0]),
+			enabledDeviceExtensions, enabledDeviceExtensionCount,
+			&deviceFeatures,
+			&deviceFeatures12,
 			graphicsQueueFamilyIndex,
-			presentQueueFamilyIndex)
+			presentQueueFamilyIndex,
+			transferQueueFamilyIndex,
+			transferQueueIndex)
 	) {
 		printf("Unable to create device!\n");
 		return -1;
 	}
 
+	VulkanDynamicRendering dynamicRendering = {};
+	if (useDynamicRendering && !LoadVulkanDynamicRendering(&dynamicRendering, device)) {
+		printf("Unable to load dynamic rendering commands!\n");
+		return -1;
+	}
+
 	VkQueue graphicsQueue = VK_NULL_HANDLE;
 	VkQueue presentQueue = VK_NULL_HANDLE;
+	VkQueue transferQueue = VK_NULL_HANDLE;
 	{
 		vkGetDeviceQueue(device, graphicsQueueFamilyIndex, 0, &graphicsQueue);
 		vkGetDeviceQueue(device, presentQueueFamilyIndex, 0, &presentQueue);
+		vkGetDeviceQueue(device, transferQueueFamilyIndex, transferQueueIndex, &transferQueue);
 	}
 	ASSERT(graphicsQueue != VK_NULL_HANDLE);
 	ASSERT(presentQueue != VK_NULL_HANDLE);
+	ASSERT(transferQueue != VK_NULL_HANDLE);
+
+	VulkanMemoryBudget memoryBudget = {};
+	VulkanMemoryBudget_Create(&memoryBudget, physicalDevice, hasMemoryBudget);
+
+	VulkanStreamer streamer = {};
+	if (!VulkanStreamer_Create(&streamer, device, physicalDevice, transferQueue, transferQueueFamilyIndex, graphicsQueue, graphicsQueueFamilyIndex)) {
+		printf("Unable to create streamer!\n");
+		return -1;
+	}
 
 	VkSurfaceFormatKHR surfaceFormat = {};
 	if (!ChooseVulkanSurfaceFormat(&surfaceFormat, physicalDevice, surface)) {
@@ -270,20 +752,53 @@ int main(int argc, char** argv) {
 		return -1;
 	}
 
+	VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+	if (!ChooseVulkanDepthFormat(&depthFormat, physicalDevice)) {
+		printf("Unable to find a suitable depth format!\n");
+		return -1;
+	}
+
+	// NOTE: Render targets get their own pool so they never share blocks with streamed textures
+	VulkanImagePool renderTargetPool = {};
+	if (!VulkanImagePool_Create(&renderTargetPool, device, physicalDevice, VULKAN_IMAGE_POOL_DEFAULT_BLOCK_SIZE)) {
+		printf("Unable to create render target pool!\n");
+		return -1;
+	}
+
+	VulkanDeletionQueue deletionQueue = {};
+	if (!VulkanDeletionQueue_Create(&deletionQueue, device)) {
+		printf("Unable to create deletion queue!\n");
+		return -1;
+	}
+
 	VkRenderPass renderPass = VK_NULL_HANDLE;
-	{
+	if (!useDynamicRendering) {
+		// NOTE: The attachments stay in their attachment layouts, the render graph transitions them around the pass and
+		// orders it against the passes before and after it, so the render pass needs no external dependencies
 		VkCall(vkCreateRenderPass(device, &(VkRenderPassCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-			.attachmentCount = 1,
-			.pAttachments = &(VkAttachmentDescription){
-				.format = surfaceFormat.format,
-				.samples = VK_SAMPLE_COUNT_1_BIT,
-				.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-				.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-				.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-				.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-				.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			.attachmentCount = 2,
+			.pAttachments = (VkAttachmentDescription[2]){
+				{
+					.format = surfaceFormat.format,
+					.samples = VK_SAMPLE_COUNT_1_BIT,
+					.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+					.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+					.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+					.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+					.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				},
+				{
+					.format = depthFormat,
+					.samples = VK_SAMPLE_COUNT_1_BIT,
+					.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+					.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+					.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+					.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+					.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+					.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				},
 			},
 			.subpassCount = 1,
 			.pSubpasses = &(VkSubpassDescription){
@@ -293,10 +808,14 @@ int main(int argc, char** argv) {
 					.attachment = 0,
     				.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
 				},
+				.pDepthStencilAttachment = &(VkAttachmentReference){
+					.attachment = 1,
+					.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				},
 			},
 		}, NULL, &renderPass));
 	}
-	ASSERT(renderPass != VK_NULL_HANDLE);
+	ASSERT(useDynamicRendering || renderPass != VK_NULL_HANDLE);
 
 	u32 windowWidth = 0, windowHeight = 0;
 	Window_GetSize(window, &windowWidth, &windowHeight);
@@ -309,6 +828,10 @@ int main(int argc, char** argv) {
 		surface,
 		renderPass,
 		surfaceFormat,
+		&renderTargetPool,
+		depthFormat,
+		presentMode,
+		swapchainImageCount,
 		window,
 		graphicsQueueFamilyIndex,
 		presentQueueFamilyIndex,
@@ -318,72 +841,65 @@ int main(int argc, char** argv) {
 		printf("Unable to create swapchain!\n");
 		return -1;
 	}
+	printf("Present mode: %s, %u swapchain images\n", VulkanSwapchain_GetPresentModeName(swapchain.PresentMode), swapchain.ImageCount);
 
+	// NOTE: The vertex pulling shader fetches the vertices through a buffer device address instead of the vertex input state
 	VkShaderModule vertexShader = VK_NULL_HANDLE;
-	{
-		FILE* file = fopen("triangle.vert.spirv", "rb");
-		ASSERT(file);
-
-		fseek(file, 0, SEEK_END);
-		u64 length = ftell(file);
-		ASSERT(length > 0);
-		fseek(file, 0, SEEK_SET);
-
-		char code[length];
-		ASSERT(fread(code, sizeof(code[0]), length, file) == length);
-		fclose(file);
-
-		VkCall(vkCreateShaderModule(device, &(VkShaderModuleCreateInfo){
-			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-			.codeSize = length,
-			.pCode = cast(u32*) code,
-		}, NULL, &vertexShader));
+	if (!CreateVulkanShaderModuleFromFile(&vertexShader, device, vertexPulling ? "triangle_pull.vert.spirv" : "triangle.vert.spirv")) {
+		printf("Unable to load vertex shader!\n");
+		return -1;
 	}
-	ASSERT(vertexShader != VK_NULL_HANDLE);
 
 	VkShaderModule fragmentShader = VK_NULL_HANDLE;
-	{
-		FILE* file = fopen("triangle.frag.spirv", "rb");
-		ASSERT(file);
+	if (!CreateVulkanShaderModuleFromFile(&fragmentShader, device, "triangle.frag.spirv")) {
+		printf("Unable to load fragment shader!\n");
+		return -1;
+	}
 
-		fseek(file, 0, SEEK_END);
-		u64 length = ftell(file);
-		ASSERT(length > 0);
-		fseek(file, 0, SEEK_SET);
+	VkShaderModule clusterVertexShader = VK_NULL_HANDLE;
+	VkShaderModule clusterCullShader = VK_NULL_HANDLE;
+	VkShaderModule depthPyramidShader = VK_NULL_HANDLE;
+	if (clusterCulling && (
+		!CreateVulkanShaderModuleFromFile(&clusterVertexShader, device, "triangle_cluster.vert.spirv") ||
+		!CreateVulkanShaderModuleFromFile(&clusterCullShader, device, "cluster_cull.comp.spirv") ||
+		!CreateVulkanShaderModuleFromFile(&depthPyramidShader, device, "depth_pyramid.comp.spirv"))
+	) {
+		printf("Unable to load cluster culling shaders!\n");
+		return -1;
+	}
 
-		u8 code[length];
-		ASSERT(fread(code, sizeof(code[0]), length, file) == length);
-		fclose(file);
+	// NOTE: Without lights the fragment shader only has its fixed directional light and the light grid is never built
+	b8 lightCulling = lightCount > 0;
+	VkShaderModule lightCullShader = VK_NULL_HANDLE;
+	if (lightCulling && !CreateVulkanShaderModuleFromFile(&lightCullShader, device, "light_cull.comp.spirv")) {
+		printf("Unable to load light culling shader!\n");
+		return -1;
+	}
 
-		VkCall(vkCreateShaderModule(device, &(VkShaderModuleCreateInfo){
-			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-			.codeSize = length,
-			.pCode = cast(u32*) code,
-		}, NULL, &fragmentShader));
+	VkShaderModule shadowVertexShader = VK_NULL_HANDLE;
+	if (shadows && !CreateVulkanShaderModuleFromFile(&shadowVertexShader, device, "shadow.vert.spirv")) {
+		printf("Unable to load shadow shader!\n");
+		return -1;
 	}
-	ASSERT(fragmentShader != VK_NULL_HANDLE);
 
-	VkDescriptorSetLayout meshDescriptorSetLayout = VK_NULL_HANDLE;
-	{
-		VkCall(vkCreateDescriptorSetLayout(device, &(VkDescriptorSetLayoutCreateInfo){
-			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-			.bindingCount = 1,
-			.pBindings = &(VkDescriptorSetLayoutBinding){
-				.binding = 0,
-				.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-				.descriptorCount = 1,
-				.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-			},
-		}, NULL, &meshDescriptorSetLayout));
+	VulkanBindless bindless = {};
+	if (!VulkanBindless_Create(&bindless, device, physicalDevice)) {
+		printf("Unable to create bindless descriptor set!\n");
+		return -1;
 	}
-	ASSERT(meshDescriptorSetLayout != VK_NULL_HANDLE);
 
 	VkPipelineLayout meshPipelineLayout = VK_NULL_HANDLE;
 	{
 		VkCall(vkCreatePipelineLayout(device, &(VkPipelineLayoutCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
 			.setLayoutCount = 1,
-    		.pSetLayouts = &meshDescriptorSetLayout,
+    		.pSetLayouts = &bindless.SetLayout,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &(VkPushConstantRange){
+				.stageFlags = DRAW_PUSH_CONSTANT_STAGES,
+				.offset = 0,
+				.size = sizeof(MeshPushConstants),
+			},
 		}, NULL, &meshPipelineLayout));
 	}
 	ASSERT(meshPipelineLayout != VK_NULL_HANDLE);
@@ -397,54 +913,80 @@ int main(int argc, char** argv) {
 	ASSERT(meshPipelineCache != VK_NULL_HANDLE);
 
 	VkPipeline meshPipeline = VK_NULL_HANDLE;
+	VkPipeline clusterPipeline = VK_NULL_HANDLE;
 	{
-		VkCall(vkCreateGraphicsPipelines(device, meshPipelineCache, 1, &(VkGraphicsPipelineCreateInfo){
-			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-			.stageCount = 2,
-			.pStages = (VkPipelineShaderStageCreateInfo[2]){
+		VkPipelineVertexInputStateCreateInfo vertexInputState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.vertexBindingDescriptionCount = 1,
+			.pVertexBindingDescriptions = &(VkVertexInputBindingDescription){
+				.binding = 0,
+				.stride = sizeof(Vertex),
+				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+			},
+			.vertexAttributeDescriptionCount = 4,
+			.pVertexAttributeDescriptions = (VkVertexInputAttributeDescription[4]){
 				{
-					.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-					.stage = VK_SHADER_STAGE_VERTEX_BIT,
-					.module = vertexShader,
-					.pName = "main",
+					.location = 0,
+					.binding = 0,
+					.format = VK_FORMAT_R32G32B32_SFLOAT,
+					.offset = 0,
 				},
 				{
-					.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-					.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-					.module = fragmentShader,
-					.pName = "main",
+					.location = 1,
+					.binding = 0,
+					.format = VK_FORMAT_R32G32B32_SFLOAT,
+					.offset = sizeof(Vector3),
 				},
-			},
-			.pVertexInputState = &(VkPipelineVertexInputStateCreateInfo){
-				.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-				.vertexBindingDescriptionCount = 1,
-				.pVertexBindingDescriptions = &(VkVertexInputBindingDescription){
+				{
+					.location = 2,
 					.binding = 0,
-					.stride = sizeof(Vertex),
-					.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+					.format = VK_FORMAT_R32G32_SFLOAT,
+					.offset = sizeof(Vector3) * 2,
 				},
-				.vertexAttributeDescriptionCount = 3,
-				.pVertexAttributeDescriptions = (VkVertexInputAttributeDescription[3]){
-					{
-						.location = 0,
-						.binding = 0,
-						.format = VK_FORMAT_R32G32B32_SFLOAT,
-						.offset = 0,
-					},
-					{
-						.location = 1,
-						.binding = 0,
-						.format = VK_FORMAT_R32G32B32_SFLOAT,
-						.offset = sizeof(Vector3),
-					},
-					{
-						.location = 2,
-						.binding = 0,
-						.format = VK_FORMAT_R32G32_SFLOAT,
-						.offset = sizeof(Vector3) * 2,
-					},
+				{
+					.location = 3,
+					.binding = 0,
+					.format = VK_FORMAT_R32_UINT,
+					.offset = offsetof(Vertex, MaterialIndex),
 				},
 			},
+		};
+
+		if (vertexPulling) {
+			vertexInputState = (VkPipelineVertexInputStateCreateInfo){
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			};
+		}
+
+		VkPipelineShaderStageCreateInfo stages[2] = {
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_VERTEX_BIT,
+				.module = vertexShader,
+				.pName = "main",
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+				.module = fragmentShader,
+				.pName = "main",
+			},
+		};
+
+		// NOTE: Without a render pass the pipelines only need to know the attachment formats
+		VkPipelineRenderingCreateInfoKHR renderingInfo = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
+			.colorAttachmentCount = 1,
+			.pColorAttachmentFormats = &surfaceFormat.format,
+			.depthAttachmentFormat = depthFormat,
+		};
+
+		VkGraphicsPipelineCreateInfo pipelineInfo = {
+			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext = useDynamicRendering ? &renderingInfo : NULL,
+			.stageCount = 2,
+			.pStages = stages,
+			.pVertexInputState = &vertexInputState,
 			.pInputAssemblyState = &(VkPipelineInputAssemblyStateCreateInfo){
 				.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
 				.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
@@ -466,6 +1008,9 @@ int main(int argc, char** argv) {
 			},
 			.pDepthStencilState = &(VkPipelineDepthStencilStateCreateInfo){
 				.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+				.depthTestEnable = VK_TRUE,
+				.depthWriteEnable = VK_TRUE,
+				.depthCompareOp = VK_COMPARE_OP_LESS,
 			},
 			.pColorBlendState = &(VkPipelineColorBlendStateCreateInfo){
 				.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
@@ -484,322 +1029,1108 @@ int main(int argc, char** argv) {
 			},
 			.layout = meshPipelineLayout,
 			.renderPass = renderPass,
-		}, NULL, &meshPipeline));
+		};
+		VkCall(vkCreateGraphicsPipelines(device, meshPipelineCache, 1, &pipelineInfo, NULL, &meshPipeline));
+
+		// NOTE: Same state, only the model matrix is read from the object buffer instead of the push constants
+		if (clusterCulling) {
+			stages[0].module = clusterVertexShader;
+			VkCall(vkCreateGraphicsPipelines(device, meshPipelineCache, 1, &pipelineInfo, NULL, &clusterPipeline));
+			ASSERT(clusterPipeline != VK_NULL_HANDLE);
+		}
 	}
 	ASSERT(meshPipeline != VK_NULL_HANDLE);
 
-	VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
-	VkSemaphore renderFinishedSemaphore = VK_NULL_HANDLE;
-	{
+	FrameData frames[FRAMES_IN_FLIGHT] = {};
+	for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
+		FrameData* frame = &frames[i];
+
 		VkCall(vkCreateSemaphore(device, &(VkSemaphoreCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
-		}, NULL, &imageAvailableSemaphore));
+		}, NULL, &frame->ImageAvailableSemaphore));
+		ASSERT(frame->ImageAvailableSemaphore != VK_NULL_HANDLE);
 
 		VkCall(vkCreateSemaphore(device, &(VkSemaphoreCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
-		}, NULL, &renderFinishedSemaphore));
-	}
-	ASSERT(imageAvailableSemaphore != VK_NULL_HANDLE);
-	ASSERT(renderFinishedSemaphore != VK_NULL_HANDLE);
+		}, NULL, &frame->RenderFinishedSemaphore));
+		ASSERT(frame->RenderFinishedSemaphore != VK_NULL_HANDLE);
+
+		VkCall(vkCreateFence(device, &(VkFenceCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+			.flags = VK_FENCE_CREATE_SIGNALED_BIT,
+		}, NULL, &frame->InFlightFence));
+		ASSERT(frame->InFlightFence != VK_NULL_HANDLE);
 
-	VkCommandPool graphicsCommandPool = VK_NULL_HANDLE;
-	{
 		VkCall(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
 			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
 			.queueFamilyIndex = graphicsQueueFamilyIndex,
-		}, NULL, &graphicsCommandPool));
-	}
-	ASSERT(graphicsCommandPool != VK_NULL_HANDLE);
+		}, NULL, &frame->CommandPool));
+		ASSERT(frame->CommandPool != VK_NULL_HANDLE);
 
-	VkCommandBuffer graphicsCommandBuffer = VK_NULL_HANDLE;
-	{
 		VkCall(vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
 			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-			.commandPool = graphicsCommandPool,
+			.commandPool = frame->CommandPool,
 			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
 			.commandBufferCount = 1,
-		}, &graphicsCommandBuffer));
+		}, &frame->CommandBuffer));
+		ASSERT(frame->CommandBuffer != VK_NULL_HANDLE);
+
+		if (!VulkanBuffer_Create(&frame->UniformBuffer, device, physicalDevice, sizeof(UniformBuffer), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+			printf("Unable to create uniform buffer!\n");
+			return -1;
+		}
+
+		frame->UniformBufferHandle = VulkanBindless_AddStorageBuffer(&bindless, frame->UniformBuffer.Buffer, 0, frame->UniformBuffer.Size);
+		ASSERT(frame->UniformBufferHandle != BINDLESS_HANDLE_NONE);
 	}
-	ASSERT(graphicsCommandBuffer != VK_NULL_HANDLE);
 
-	VkDescriptorPool meshDescriptorPool = VK_NULL_HANDLE;
-	{
-		VkCall(vkCreateDescriptorPool(device, &(VkDescriptorPoolCreateInfo){
-			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-			.maxSets = 1,
-			.poolSizeCount = 1,
-			.pPoolSizes = &(VkDescriptorPoolSize){
-				.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-				.descriptorCount = 1,
-			},
-		}, NULL, &meshDescriptorPool));
+	VulkanCommandRecorder commandRecorder = {};
+	if (!VulkanCommandRecorder_Create(&commandRecorder, device, graphicsQueueFamilyIndex, JobSystem_GetThreadCount(), FRAMES_IN_FLIGHT)) {
+		printf("Unable to create command recorder!\n");
+		return -1;
 	}
-	ASSERT(meshDescriptorPool != VK_NULL_HANDLE);
 
-	VkDescriptorSet meshDescriptorSet = VK_NULL_HANDLE;
-	{
-		VkCall(vkAllocateDescriptorSets(device, &(VkDescriptorSetAllocateInfo){
-			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-			.descriptorPool = meshDescriptorPool,
-			.descriptorSetCount = 1,
-			.pSetLayouts = &meshDescriptorSetLayout,
-		}, &meshDescriptorSet));
+	VulkanClusterCuller clusterCuller = {};
+	if (clusterCulling) {
+		if (!VulkanClusterCuller_Create(&clusterCuller, device, physicalDevice, &bindless, &renderTargetPool, FRAMES_IN_FLIGHT, clusterCullShader, depthPyramidShader) ||
+			!VulkanClusterCuller_SetDepth(&clusterCuller, &swapchain.DepthImage, &deletionQueue, 0)
+		) {
+			printf("Unable to create cluster culler!\n");
+			return -1;
+		}
 	}
-	ASSERT(meshDescriptorSet != VK_NULL_HANDLE);
 
-	Mesh mesh = {};
-	{
-		ObjMesh objMesh = {};
-		if (!ObjMesh_Create(&objMesh, "Cube.obj")) {
-			printf("Unable to load Cube.obj\n");
+	// NOTE: The lights are scattered through the part of the scene the identity view and projection show
+	VulkanLightCuller lightCuller = {};
+	GpuLight* lights = NULL;
+	if (lightCulling) {
+		lights = malloc(lightCount * sizeof(lights[0]));
+		if (!lights || !VulkanLightCuller_Create(&lightCuller, device, physicalDevice, &bindless, FRAMES_IN_FLIGHT, lightCullShader)) {
+			printf("Unable to create light culler!\n");
 			return -1;
 		}
+		GpuLight_Scatter(lights, lightCount, (Vector3){ -1.0f, -1.0f, 0.0f }, (Vector3){ 1.0f, 1.0f, 1.0f }, 0.05f, 0.15f, 1);
+	}
 
-		for (u64 i = 0; i < objMesh.FaceCount; i++) {
-			mesh.VertexCount += 3;
-			mesh.Vertices = realloc(mesh.Vertices, mesh.VertexCount * sizeof(mesh.Vertices[0]));
-			ASSERT(mesh.Vertices);
+	VulkanShadowMap shadowMap = {};
+	if (shadows && !VulkanShadowMap_Create(&shadowMap, device, physicalDevice, &bindless, &renderTargetPool, FRAMES_IN_FLIGHT, depthFormat, SHADOW_MAP_RESOLUTION, shadowVertexShader)) {
+		printf("Unable to create shadow map!\n");
+		return -1;
+	}
 
-			mesh.Vertices[mesh.VertexCount - 3].Position = objMesh.Positions[objMesh.Faces[i].PositionIndices[0]];
-			mesh.Vertices[mesh.VertexCount - 2].Position = objMesh.Positions[objMesh.Faces[i].PositionIndices[1]];
-			mesh.Vertices[mesh.VertexCount - 1].Position = objMesh.Positions[objMesh.Faces[i].PositionIndices[2]];
-			
-			mesh.Vertices[mesh.VertexCount - 3].Normal = objMesh.Normals[objMesh.Faces[i].NormalIndices[0]];
-			mesh.Vertices[mesh.VertexCount - 2].Normal = objMesh.Normals[objMesh.Faces[i].NormalIndices[1]];
-			mesh.Vertices[mesh.VertexCount - 1].Normal = objMesh.Normals[objMesh.Faces[i].NormalIndices[2]];
-			
-			mesh.Vertices[mesh.VertexCount - 3].TexCoord = objMesh.TexCoords[objMesh.Faces[i].TexCoordIndices[0]];
-			mesh.Vertices[mesh.VertexCount - 2].TexCoord = objMesh.TexCoords[objMesh.Faces[i].TexCoordIndices[1]];
-			mesh.Vertices[mesh.VertexCount - 1].TexCoord = objMesh.TexCoords[objMesh.Faces[i].TexCoordIndices[2]];
-		}
+	// NOTE: Every captureInterval-th frame is copied out of the swapchain after it has been drawn and saved to
+	// capture_<frame>.tga a few frames later
+	b8 capture = captureInterval > 0;
+	if (capture && !(swapchain.ImageUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+		printf("Capturing needs a swapchain that can be copied from, no frames are captured\n");
+		capture = false;
+	}
 
-		for (u64 i = 0; i < mesh.VertexCount; i++) {
-			mesh.IndexCount++;
-			mesh.Indices = realloc(mesh.Indices, mesh.IndexCount * sizeof(mesh.Indices[0]));
-			ASSERT(mesh.Indices);
+	VulkanCapturePool capturePool = {};
+	if (capture && !VulkanCapturePool_Create(&capturePool, device, physicalDevice, CAPTURE_SLOT_COUNT, SaveCapture, NULL)) {
+		printf("Unable to create capture pool!\n");
+		return -1;
+	}
 
-			mesh.Indices[mesh.IndexCount - 1] = i;
-		}
+	// NOTE: Towards the light, the fragment shader lights the scene with it with or without shadows
+	Vector3 lightDirection = (Vector3){ 0.4f, 0.8f, 0.6f };
+	{
+		f32 length = sqrtf(lightDirection.x * lightDirection.x + lightDirection.y * lightDirection.y + lightDirection.z * lightDirection.z);
+		lightDirection = (Vector3){ lightDirection.x / length, lightDirection.y / length, lightDirection.z / length };
+	}
 
-		ObjMesh_Destory(&objMesh);
+	DrawList drawList = {};
+	if (!DrawList_Create(&drawList, 0)) {
+		printf("Unable to create draw list!\n");
+		return -1;
 	}
 
-	VulkanBuffer vertexBuffer = {};
-	if (!VulkanBuffer_Create(&vertexBuffer, device, physicalDevice, mesh.VertexCount * sizeof(mesh.Vertices[0]), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
-		printf("Unable to create vertex buffer!\n");
+	Scene scene = {};
+	if (!Scene_Create(&scene, 0)) {
+		printf("Unable to create scene!\n");
 		return -1;
 	}
 
-	memcpy(vertexBuffer.Data, mesh.Vertices, mesh.VertexCount * sizeof(mesh.Vertices[0]));
+	SceneNode meshNode = Scene_AddNode(&scene, SCENE_NODE_NONE, Matrix4_Scale((Vector3){ 0.8f, 0.8f, 0.8f }));
+	ASSERT(meshNode != SCENE_NODE_NONE);
 
-	VulkanBuffer indexBuffer = {};
-	if (!VulkanBuffer_Create(&indexBuffer, device, physicalDevice, mesh.IndexCount * sizeof(mesh.Indices[0]), VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
-		printf("Unable to create index buffer!\n");
+	JobSystem_Wait(&meshBuildCounter);
+	if (!meshLoadJob.Loaded || !meshLoadJob.Built) {
+		printf("Unable to load %s\n", meshLoadJob.Filepath);
 		return -1;
 	}
 
-	memcpy(indexBuffer.Data, mesh.Indices, mesh.IndexCount * sizeof(mesh.Indices[0]));
+	VkSampler textureSampler = VK_NULL_HANDLE;
+	{
+		VkCall(vkCreateSampler(device, &(VkSamplerCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+			.magFilter = VK_FILTER_LINEAR,
+			.minFilter = VK_FILTER_LINEAR,
+			.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+			.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+			.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+			.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+			.minLod = 0.0f,
+			.maxLod = VK_LOD_CLAMP_NONE,
+		}, NULL, &textureSampler));
+	}
+	ASSERT(textureSampler != VK_NULL_HANDLE);
+
+	BindlessHandle textureSamplerHandle = VulkanBindless_AddSampler(&bindless, textureSampler);
+	ASSERT(textureSamplerHandle != BINDLESS_HANDLE_NONE);
+
+	Mesh mesh = meshLoadJob.Mesh;
+	MaterialTable materialTable = {};
+	u64 textureCount = meshLoadJob.ObjMesh.MaterialCount;
+	StreamRequest** textureRequests = calloc(textureCount, sizeof(textureRequests[0]));
+	BindlessHandle* diffuseTextures = malloc(textureCount * sizeof(diffuseTextures[0]));
+	ASSERT(textureCount == 0 || (textureRequests && diffuseTextures));
+	SceneNode* objectNodes = malloc(mesh.ObjectCount * sizeof(objectNodes[0]));
+	u32* objectLods = malloc(mesh.ObjectCount * sizeof(objectLods[0]));
+	Matrix4* objectMatrices = malloc(mesh.ObjectCount * sizeof(objectMatrices[0]));
+	ASSERT(mesh.ObjectCount == 0 || (objectNodes && objectLods && objectMatrices));
+	{
+		for (u64 i = 0; i < mesh.ObjectCount; i++) {
+			objectNodes[i] = Scene_AddNode(&scene, meshNode, Matrix4_Identity());
+			ASSERT(objectNodes[i] != SCENE_NODE_NONE);
+		}
+
+		// NOTE: The textures are decoded and uploaded in the background, the materials are untextured until they are Ready
+		for (u64 i = 0; i < textureCount; i++) {
+			diffuseTextures[i] = BINDLESS_HANDLE_NONE;
+
+			const char* filepath = meshLoadJob.ObjMesh.Materials[i].DiffuseMap;
+			if (filepath) {
+				textureRequests[i] = VulkanStreamer_RequestTexture(&streamer, filepath, true);
+			}
+		}
+
+		if (!MaterialTable_Create(
+				&materialTable,
+				device,
+				physicalDevice,
+				meshLoadJob.ObjMesh.Materials,
+				meshLoadJob.ObjMesh.MaterialCount,
+				NULL,
+				textureSamplerHandle)
+		) {
+			printf("Unable to create material table!\n");
+			return -1;
+		}
+
+		ObjMesh_Destory(&meshLoadJob.ObjMesh);
+	}
+
+	// NOTE: The material table is shared by every frame, only streamed in textures rewrite it
+	BindlessHandle materialBufferHandle = VulkanBindless_AddStorageBuffer(&bindless, materialTable.Buffer.Buffer, 0, materialTable.Buffer.Size);
+	ASSERT(materialBufferHandle != BINDLESS_HANDLE_NONE);
+
+	VkBufferUsageFlags vertexBufferUsage = vertexPulling
+		? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+		: VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 
-	VulkanBuffer uniformBuffer = {};
-	if (!VulkanBuffer_Create(&uniformBuffer, device, physicalDevice, sizeof(UniformBuffer), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)) {
-		printf("Unable to create uniform buffer!\n");
+	// NOTE: The shadow pass always reads the positions through the vertex input state
+	if (shadows) {
+		vertexBufferUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+	}
+
+	StreamRequest* meshRequest = VulkanStreamer_RequestMesh(&streamer, &mesh, vertexBufferUsage);
+	if (!meshRequest) {
+		printf("Unable to request mesh upload!\n");
 		return -1;
 	}
 
-	UniformBuffer* uniformData = uniformBuffer.Data;
-	uniformData->ModelMatrix = Matrix4_Scale((Vector3){ 0.8f, 0.8f, 0.8f });
-	uniformData->ViewMatrix = Matrix4_Identity();
-	uniformData->ProjectionMatrix = Matrix4_Identity();
+	// NOTE: Added once the mesh is Ready, like the textures
+	BindlessHandle clusterBufferHandle = BINDLESS_HANDLE_NONE;
+
+	// NOTE: The GPU frame time drives dynamic resolution, without timestamps or a swapchain that can be blitted to the
+	// scene is rendered straight to the swapchain at full size
+	VulkanFrameTimer frameTimer = {};
+	b8 hasFrameTimer = VulkanFrameTimer_Create(&frameTimer, device, physicalDevice, graphicsQueueFamilyIndex, FRAMES_IN_FLIGHT);
+
+	// NOTE: The scene target has the swapchain's format, so one query covers both ends of the blit. Without linear filtering
+	// the upscale falls back to nearest
+	VkFormatProperties surfaceFormatProperties = {};
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, surfaceFormat.format, &surfaceFormatProperties);
+	VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+	b8 canBlit = (surfaceFormatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+	VkFilter upscaleFilter = (surfaceFormatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+		? VK_FILTER_LINEAR
+		: VK_FILTER_NEAREST;
+
+	b8 useDynamicResolution = dynamicResolutionTarget > 0.0f;
+	if (useDynamicResolution && (!hasFrameTimer || !canBlit || !(swapchain.ImageUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))) {
+		printf("Dynamic resolution needs GPU timestamps and a swapchain that can be blitted to, rendering at full resolution\n");
+		useDynamicResolution = false;
+	}
 
-	while (Window_PollEvents()) {
-		if (VulkanSwapchain_TryResize(&swapchain)) {
-			uniformData->ProjectionMatrix = Matrix4_Identity();
+	// NOTE: The scene target is as large as the swapchain and only its top left RenderExtent is drawn to, so changing the
+	// scale never reallocates anything
+	DynamicResolution dynamicResolution = {};
+	VulkanImage sceneColor = {};
+	VkFramebuffer sceneFramebuffer = VK_NULL_HANDLE;
+	if (useDynamicResolution) {
+		DynamicResolution_Create(&dynamicResolution, dynamicResolutionTarget, 0.5f, 1.0f);
+
+		if (!VulkanImagePool_CreateImage(
+				&renderTargetPool,
+				&sceneColor,
+				swapchain.Extent.width,
+				swapchain.Extent.height,
+				1,
+				surfaceFormat.format,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT) ||
+			(!useDynamicRendering && !CreateSceneFramebuffer(&sceneFramebuffer, device, renderPass, &sceneColor, &swapchain.DepthImage))
+		) {
+			printf("Unable to create scene target!\n");
+			return -1;
 		}
+	}
 
-		vkUpdateDescriptorSets(device, 1, &(VkWriteDescriptorSet){
-			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-			.dstSet = meshDescriptorSet,
-			.dstBinding = 0,
-			.descriptorCount = 1,
-			.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-			.pBufferInfo = &(VkDescriptorBufferInfo){
-				.buffer = uniformBuffer.Buffer,
-				.offset = 0,
-				.range = uniformBuffer.Size,
-			},
-		}, 0, NULL);
+	// NOTE: The passes are declared once and read the frame they record from frameRecord. The swapchain image is set every
+	// frame, the depth buffer and pyramid whenever the swapchain is resized
+	FrameRecordData frameRecord = {};
+	RenderGraph renderGraph = {};
+	RenderGraphResource swapchainTarget = RENDER_GRAPH_RESOURCE_NONE;
+	RenderGraphResource depthTarget = RENDER_GRAPH_RESOURCE_NONE;
+	RenderGraphResource pyramidTarget = RENDER_GRAPH_RESOURCE_NONE;
+	RenderGraphResource sceneTarget = RENDER_GRAPH_RESOURCE_NONE;
+	RenderGraphResource shadowTarget = RENDER_GRAPH_RESOURCE_NONE;
+	{
+		if (!RenderGraph_Create(&renderGraph, device, physicalDevice)) {
+			printf("Unable to create render graph!\n");
+			return -1;
+		}
 
-		u32 swapchainImageIndex = 0;
-		VkCall(vkAcquireNextImageKHR(device, swapchain.Swapchain, ~0ull, imageAvailableSemaphore, NULL, &swapchainImageIndex));
+		swapchainTarget = RenderGraph_ImportImage(&renderGraph, "Swapchain", VK_IMAGE_ASPECT_COLOR_BIT);
+		depthTarget = RenderGraph_ImportImage(&renderGraph, "Depth", GetVulkanFormatAspect(depthFormat));
+		RenderGraph_SetFinalState(&renderGraph, swapchainTarget, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
-		VkCall(vkResetCommandPool(device, graphicsCommandPool, 0));
+		b8 added = swapchainTarget != RENDER_GRAPH_RESOURCE_NONE && depthTarget != RENDER_GRAPH_RESOURCE_NONE;
 
-		VkCall(vkBeginCommandBuffer(graphicsCommandBuffer, &(VkCommandBufferBeginInfo){
-			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-		}));
+		RenderGraphResource colorTarget = swapchainTarget;
+		if (useDynamicResolution) {
+			sceneTarget = RenderGraph_ImportImage(&renderGraph, "SceneColor", VK_IMAGE_ASPECT_COLOR_BIT);
+			colorTarget = sceneTarget;
+			added = added && sceneTarget != RENDER_GRAPH_RESOURCE_NONE;
+		}
 
-		vkCmdPipelineBarrier(
-			graphicsCommandBuffer,
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-			VK_DEPENDENCY_BY_REGION_BIT,
-			0,
-			NULL,
-			0,
-			NULL,
-			1,
-			&(VkImageMemoryBarrier){
-				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-				.srcAccessMask = 0,
-				.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-				.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-				.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-				.image = swapchain.Images[swapchainImageIndex],
-				.subresourceRange = (VkImageSubresourceRange){
-					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-					.levelCount = VK_REMAINING_MIP_LEVELS,
-					.layerCount = VK_REMAINING_ARRAY_LAYERS,
+		RenderGraphResource clusterDraws = RENDER_GRAPH_RESOURCE_NONE;
+		if (clusterCulling) {
+			// NOTE: The pyramid is read by the next frame's cull pass, so it is exported to keep the pass that builds it.
+			// The stats are read back by the CPU once the frame's fence signals
+			pyramidTarget = RenderGraph_ImportImage(&renderGraph, "DepthPyramid", VK_IMAGE_ASPECT_COLOR_BIT);
+			clusterDraws = RenderGraph_ImportBuffer(&renderGraph, "ClusterDraws");
+			RenderGraphResource clusterStats = RenderGraph_ImportBuffer(&renderGraph, "ClusterStats");
+			RenderGraph_ExportResource(&renderGraph, pyramidTarget);
+			RenderGraph_SetFinalState(&renderGraph, clusterStats, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+			added = added && pyramidTarget != RENDER_GRAPH_RESOURCE_NONE && clusterDraws != RENDER_GRAPH_RESOURCE_NONE && clusterStats != RENDER_GRAPH_RESOURCE_NONE;
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"ClusterCull",
+				(RenderGraphAccess[3]){
+					{
+						.Resource = clusterDraws,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+						.Discard = true,
+					},
+					{
+						.Resource = clusterStats,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+						.Discard = true,
+					},
+					{
+						.Resource = pyramidTarget,
+						.Stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+						.Access = VK_ACCESS_SHADER_READ_BIT,
+						.Layout = VK_IMAGE_LAYOUT_GENERAL,
+					},
 				},
-			}
-		);
+				3,
+				RecordClusterCullPass,
+				&frameRecord
+			);
+		}
 
-		const VkClearColorValue ClearColor = (VkClearColorValue){
-			{ 0.9f, 0.3f, 0.1f, 1.0f },
-		};
+		RenderGraphResource lightGrid = RENDER_GRAPH_RESOURCE_NONE;
+		if (lightCulling) {
+			lightGrid = RenderGraph_ImportBuffer(&renderGraph, "LightGrid");
+			RenderGraphResource lightStats = RenderGraph_ImportBuffer(&renderGraph, "LightStats");
+			RenderGraph_SetFinalState(&renderGraph, lightStats, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+			added = added && lightGrid != RENDER_GRAPH_RESOURCE_NONE && lightStats != RENDER_GRAPH_RESOURCE_NONE;
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"LightCull",
+				(RenderGraphAccess[2]){
+					{
+						.Resource = lightGrid,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+						.Discard = true,
+					},
+					{
+						.Resource = lightStats,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+						.Discard = true,
+					},
+				},
+				2,
+				RecordLightCullPass,
+				&frameRecord
+			);
+		}
 
-		const VkClearValue Clear = (VkClearValue){
-			.color = ClearColor,
-		};
+		if (shadows) {
+			// NOTE: The atlas keeps the cached cascades from earlier frames, so the pass loads it instead of discarding it
+			shadowTarget = RenderGraph_ImportImage(&renderGraph, "ShadowAtlas", GetVulkanFormatAspect(depthFormat));
+
+			added = added && shadowTarget != RENDER_GRAPH_RESOURCE_NONE;
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"Shadows",
+				&(RenderGraphAccess){
+					.Resource = shadowTarget,
+					.Stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+					.Access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+					.Layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				},
+				1,
+				RecordShadowPass,
+				&frameRecord
+			);
+		}
 
-		vkCmdBeginRenderPass(graphicsCommandBuffer, &(VkRenderPassBeginInfo){
-			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-			.renderPass = renderPass,
-			.framebuffer = swapchain.Framebuffers[swapchainImageIndex],
-			.renderArea = (VkRect2D){
-				.offset = (VkOffset2D){ .x = 0, .y = 0 },
-				.extent = swapchain.Extent,
-			},
-			.clearValueCount = 1,
-			.pClearValues = &Clear,
-		}, VK_SUBPASS_CONTENTS_INLINE);
-
-		vkCmdSetViewport(graphicsCommandBuffer, 0, 1, &(VkViewport){
-			.x = 0.0f,
-			.y = swapchain.Extent.height,
-			.width = swapchain.Extent.width,
-			.height = -cast(float) swapchain.Extent.height,
-			.minDepth = 0.0f,
-			.maxDepth = 1.0f,
-		});
-		vkCmdSetScissor(graphicsCommandBuffer, 0, 1, &(VkRect2D){
-			.offset = (VkOffset2D){
-				.x = 0,
-				.y = 0,
+		RenderGraphAccess mainAccesses[5] = {
+			{
+				.Resource = colorTarget,
+				.Stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+				.Access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+				.Layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+				.Discard = true,
 			},
-			.extent = (VkExtent2D){
-				.width = swapchain.Extent.width,
-				.height = swapchain.Extent.height,
+			{
+				.Resource = depthTarget,
+				.Stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				.Access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				.Layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				.Discard = true,
 			},
-		});
+		};
+		u32 mainAccessCount = 2;
+		if (clusterCulling) {
+			mainAccesses[mainAccessCount++] = (RenderGraphAccess){
+				.Resource = clusterDraws,
+				.Stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+				.Access = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+			};
+		}
+		if (lightCulling) {
+			mainAccesses[mainAccessCount++] = (RenderGraphAccess){
+				.Resource = lightGrid,
+				.Stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				.Access = VK_ACCESS_SHADER_READ_BIT,
+			};
+		}
+		if (shadows) {
+			mainAccesses[mainAccessCount++] = (RenderGraphAccess){
+				.Resource = shadowTarget,
+				.Stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				.Access = VK_ACCESS_SHADER_READ_BIT,
+				.Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			};
+		}
 
-		vkCmdBindPipeline(graphicsCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipeline);
+		added = added && RenderGraph_AddPass(&renderGraph, "Main", mainAccesses, mainAccessCount, RecordMainPass, &frameRecord);
 
-		vkCmdBindDescriptorSets(graphicsCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipelineLayout, 0, 1, &meshDescriptorSet, 0, NULL);
-		vkCmdBindVertexBuffers(graphicsCommandBuffer, 0, 1, &vertexBuffer.Buffer, &(VkDeviceSize){ 0 });
-		vkCmdBindIndexBuffer(graphicsCommandBuffer, indexBuffer.Buffer, 0, VK_INDEX_TYPE_UINT32);
-		vkCmdDrawIndexed(graphicsCommandBuffer, mesh.IndexCount, 1, 0, 0, 0);
+		if (useDynamicResolution) {
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"Upscale",
+				(RenderGraphAccess[2]){
+					{
+						.Resource = sceneTarget,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_READ_BIT,
+						.Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					},
+					{
+						.Resource = swapchainTarget,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+						.Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+						.Discard = true,
+					},
+				},
+				2,
+				RecordUpscalePass,
+				&frameRecord
+			);
+		}
 
-		vkCmdEndRenderPass(graphicsCommandBuffer);
+		if (capture) {
+			// NOTE: Declared after everything that draws to the swapchain. The readback buffers are only read by the host once the
+			// frame's fence signals, the final state makes the copy visible to it
+			RenderGraphResource captureBuffer = RenderGraph_ImportBuffer(&renderGraph, "Capture");
+			RenderGraph_SetFinalState(&renderGraph, captureBuffer, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+			added = added && captureBuffer != RENDER_GRAPH_RESOURCE_NONE;
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"Capture",
+				(RenderGraphAccess[2]){
+					{
+						.Resource = swapchainTarget,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_READ_BIT,
+						.Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					},
+					{
+						.Resource = captureBuffer,
+						.Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+						.Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+					},
+				},
+				2,
+				RecordCapturePass,
+				&frameRecord
+			);
+		}
 
-		vkCmdPipelineBarrier(
-			graphicsCommandBuffer,
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-			VK_DEPENDENCY_BY_REGION_BIT,
-			0,
-			NULL,
-			0,
-			NULL,
-			1,
-			&(VkImageMemoryBarrier){
-				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-				.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-				.dstAccessMask = 0,
-				.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-				.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-				.image = swapchain.Images[swapchainImageIndex],
-				.subresourceRange = (VkImageSubresourceRange){
-					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-					.levelCount = VK_REMAINING_MIP_LEVELS,
-					.layerCount = VK_REMAINING_ARRAY_LAYERS,
+		if (clusterCulling) {
+			added = added && RenderGraph_AddPass(
+				&renderGraph,
+				"DepthPyramid",
+				(RenderGraphAccess[2]){
+					{
+						.Resource = depthTarget,
+						.Stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+						.Access = VK_ACCESS_SHADER_READ_BIT,
+						.Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					},
+					{
+						.Resource = pyramidTarget,
+						.Stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+						.Access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+						.Layout = VK_IMAGE_LAYOUT_GENERAL,
+						.Discard = true,
+					},
 				},
+				2,
+				RecordDepthPyramidPass,
+				&frameRecord
+			);
+		}
+
+		if (!added || !RenderGraph_Compile(&renderGraph)) {
+			printf("Unable to build render graph!\n");
+			return -1;
+		}
+
+		RenderGraph_SetImage(&renderGraph, depthTarget, swapchain.DepthImage.Image, swapchain.DepthImage.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+		if (clusterCulling) {
+			RenderGraph_SetImage(&renderGraph, pyramidTarget, clusterCuller.Pyramid.Image, clusterCuller.Pyramid.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+		}
+		if (useDynamicResolution) {
+			RenderGraph_SetImage(&renderGraph, sceneTarget, sceneColor.Image, sceneColor.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+		}
+		// NOTE: Set once, the graph carries the atlas' state over from one frame to the next
+		if (shadows) {
+			RenderGraph_SetImage(&renderGraph, shadowTarget, shadowMap.Atlas.Image, shadowMap.Atlas.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+		}
+	}
+
+	Matrix4 projectionMatrix = Matrix4_Identity();
+
+	u32 frameIndex = 0;
+	u64 frameNumber = 0;
+	b8 swapchainOutOfDate = false;
+	f64 lastStatsTime = Timer_GetSeconds();
+	f64 nextFrameTime = lastStatsTime;
+
+	// NOTE: Input to present is measured up to the vkQueuePresentKHR call, input to done up to the fence wait that sees
+	// the frame finished, which can be later than the GPU finished it. Summed over the stats interval
+	f64 presentLatencySum = 0.0;
+	f64 completeLatencySum = 0.0;
+	u64 presentLatencyCount = 0;
+	u64 completeLatencyCount = 0;
+	while (true) {
+		FrameData* frame = &frames[frameIndex];
+		VkCall(vkWaitForFences(device, 1, &frame->InFlightFence, VK_TRUE, ~0ull));
+
+		// NOTE: Input is polled after the fence wait, so the time the CPU spends waiting for the GPU to catch up is not
+		// added to the input latency
+		f64 inputTime = Timer_GetSeconds();
+		if (frame->InputTime > 0.0) {
+			completeLatencySum += inputTime - frame->InputTime;
+			completeLatencyCount++;
+			frame->InputTime = 0.0;
+		}
+
+		if (!Window_PollEvents()) {
+			break;
+		}
+
+		// NOTE: A minimized window has no area, so the swapchain stays out of date until it is restored. Blocking on the next
+		// message instead of retrying keeps the loop from spinning a core. The fence was not reset, waiting on it again is free
+		u32 clientWidth = 0;
+		u32 clientHeight = 0;
+		Window_GetSize(window, &clientWidth, &clientHeight);
+		if (clientWidth == 0 || clientHeight == 0) {
+			Window_WaitEvents();
+			continue;
+		}
+
+		// NOTE: Frame numbers start at 1 so a LastUsedFrame of 0 means never drawn. After the fence wait every frame
+		// before the last FRAMES_IN_FLIGHT - 1 ones has finished
+		frameNumber++;
+		u64 safeFrame = frameNumber >= FRAMES_IN_FLIGHT ? frameNumber - FRAMES_IN_FLIGHT + 1 : 0;
+		VulkanMemoryBudget_Update(&memoryBudget);
+		VulkanStreamer_UpdateResidency(&streamer, &memoryBudget, safeFrame);
+		VulkanDeletionQueue_Flush(&deletionQueue, safeFrame);
+		if (capture) {
+			VulkanCapturePool_Update(&capturePool, safeFrame);
+		}
+
+		// NOTE: The frame that just finished was rendered at the scale it recorded, which is what its GPU time is normalized by
+		f64 gpuSeconds = 0.0;
+		if (hasFrameTimer && VulkanFrameTimer_Read(&frameTimer, frameIndex, &gpuSeconds) && useDynamicResolution) {
+			DynamicResolution_Update(&dynamicResolution, cast(f32) gpuSeconds, frame->RenderScale);
+		}
+
+		// NOTE: The previous frame is the last one that can use the old swapchain, depth buffer and pyramid, they are
+		// destroyed once it has finished. The new images start out undefined
+		VulkanSwapchainResize resize = VulkanSwapchain_TryResize(&swapchain, &deletionQueue, frameNumber - 1, swapchainOutOfDate);
+		if (resize == VulkanSwapchainResize_Failed) {
+			printf("Unable to recreate swapchain!\n");
+			return -1;
+		} else if (resize == VulkanSwapchainResize_Resized) {
+			swapchainOutOfDate = false;
+			projectionMatrix = Matrix4_Identity();
+
+			RenderGraph_SetImage(&renderGraph, depthTarget, swapchain.DepthImage.Image, swapchain.DepthImage.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+			if (clusterCulling) {
+				ASSERT(VulkanClusterCuller_SetDepth(&clusterCuller, &swapchain.DepthImage, &deletionQueue, frameNumber - 1));
+				RenderGraph_SetImage(&renderGraph, pyramidTarget, clusterCuller.Pyramid.Image, clusterCuller.Pyramid.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+			}
+
+			if (useDynamicResolution) {
+				VulkanDeletionQueue_PushPoolImage(&deletionQueue, frameNumber - 1, &renderTargetPool, &sceneColor);
+				if (sceneFramebuffer != VK_NULL_HANDLE) {
+					VulkanDeletionQueue_PushFramebuffer(&deletionQueue, frameNumber - 1, sceneFramebuffer);
+				}
+
+				ASSERT(VulkanImagePool_CreateImage(
+					&renderTargetPool,
+					&sceneColor,
+					swapchain.Extent.width,
+					swapchain.Extent.height,
+					1,
+					surfaceFormat.format,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+				));
+				if (!useDynamicRendering) {
+					ASSERT(CreateSceneFramebuffer(&sceneFramebuffer, device, renderPass, &sceneColor, &swapchain.DepthImage));
+				}
+				RenderGraph_SetImage(&renderGraph, sceneTarget, sceneColor.Image, sceneColor.View, VK_IMAGE_LAYOUT_UNDEFINED, 0);
+			}
+		}
+
+		// NOTE: A texture is Ready once the frame that acquired it was submitted, so after the fence wait
+		// no frame in flight can read the handle before the texture is usable. Evicted textures were last used
+		// by a finished frame, so their handles can go straight away
+		for (u64 i = 0; i < textureCount; i++) {
+			StreamRequest* request = textureRequests[i];
+			if (!request) {
+				continue;
+			}
+
+			StreamState state = StreamRequest_GetState(request);
+			if (state == StreamState_Ready && diffuseTextures[i] == BINDLESS_HANDLE_NONE) {
+				diffuseTextures[i] = VulkanBindless_AddSampledImage(&bindless, request->Texture.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+				ASSERT(diffuseTextures[i] != BINDLESS_HANDLE_NONE);
+				MaterialTable_SetDiffuseTexture(&materialTable, i, diffuseTextures[i]);
+			} else if (state == StreamState_Evicted && diffuseTextures[i] != BINDLESS_HANDLE_NONE) {
+				MaterialTable_SetDiffuseTexture(&materialTable, i, BINDLESS_HANDLE_NONE);
+				VulkanBindless_RemoveSampledImage(&bindless, diffuseTextures[i]);
+				diffuseTextures[i] = BINDLESS_HANDLE_NONE;
+			}
+
+			// NOTE: Every material is drawn with the mesh
+			VulkanStreamer_Touch(&streamer, request, frameNumber);
+		}
+
+		VulkanStreamer_Touch(&streamer, meshRequest, frameNumber);
+		StreamState meshState = StreamRequest_GetState(meshRequest);
+		if (meshState == StreamState_Failed) {
+			printf("Unable to upload %s\n", meshLoadJob.Filepath);
+			break;
+		}
+
+		if (clusterCulling) {
+			if (meshState == StreamState_Ready && clusterBufferHandle == BINDLESS_HANDLE_NONE && meshRequest->ClusterBuffer.Buffer != VK_NULL_HANDLE) {
+				clusterBufferHandle = VulkanBindless_AddStorageBuffer(&bindless, meshRequest->ClusterBuffer.Buffer, 0, meshRequest->ClusterBuffer.Size);
+				ASSERT(clusterBufferHandle != BINDLESS_HANDLE_NONE);
+			} else if (meshState == StreamState_Evicted && clusterBufferHandle != BINDLESS_HANDLE_NONE) {
+				VulkanBindless_RemoveStorageBuffer(&bindless, clusterBufferHandle);
+				clusterBufferHandle = BINDLESS_HANDLE_NONE;
+			}
+		}
+
+		Scene_Update(&scene);
+
+		VkExtent2D renderExtent = swapchain.Extent;
+		frame->RenderScale = 1.0f;
+		if (useDynamicResolution) {
+			DynamicResolution_GetSize(&dynamicResolution, swapchain.Extent.width, swapchain.Extent.height, &renderExtent.width, &renderExtent.height);
+			frame->RenderScale = dynamicResolution.Scale;
+		}
+
+		UniformBuffer* uniformData = frame->UniformBuffer.Data;
+		uniformData->ViewMatrix = Matrix4_Identity();
+		uniformData->ProjectionMatrix = projectionMatrix;
+		uniformData->LightBufferHandle = BINDLESS_HANDLE_NONE;
+		uniformData->LightGridHandle = BINDLESS_HANDLE_NONE;
+		uniformData->RenderWidth = cast(f32) renderExtent.width;
+		uniformData->RenderHeight = cast(f32) renderExtent.height;
+		uniformData->ShadowBufferHandle = BINDLESS_HANDLE_NONE;
+		uniformData->LightDirection = (Vector4){ lightDirection.x, lightDirection.y, lightDirection.z, 0.0f };
+
+		// NOTE: The lights do not move, but the frame's light buffer is only safe to write once its fence has signaled
+		if (lightCulling) {
+			ASSERT(VulkanLightCuller_BeginFrame(&lightCuller, frameIndex, lightCount, &projectionMatrix));
+
+			LightCullerFrame* lightFrame = &lightCuller.Frames[frameIndex];
+			memcpy(lightFrame->Lights.Data, lights, lightCount * sizeof(lights[0]));
+			uniformData->LightBufferHandle = lightFrame->LightsHandle;
+			uniformData->LightGridHandle = lightFrame->GridHandle;
+			uniformData->LightDepthNear = lightFrame->DepthNear;
+			uniformData->LightDepthFar = lightFrame->DepthFar;
+		}
+
+		DrawList_Clear(&drawList);
+		u64 drawnTriangleCount = 0;
+		for (u64 i = 0; meshState == StreamState_Ready && i < mesh.ObjectCount; i++) {
+			// NOTE: The view matrix is identity, so world z is the view depth
+			Matrix4 worldMatrix = Scene_GetWorldMatrix(&scene, objectNodes[i]);
+			f32 depth = worldMatrix.Data[3][2] * 0.5f + 0.5f;
+			objectMatrices[i] = worldMatrix;
+
+			// NOTE: The lod is picked by how many pixels its error covers at the object's bounding sphere center,
+			// using the largest axis scale so non uniform scaling never underestimates it
+			const MeshObject* object = &mesh.Objects[i];
+			f32 scale = 0.0f;
+			for (u32 j = 0; j < 3; j++) {
+				f32 x = worldMatrix.Data[j][0];
+				f32 y = worldMatrix.Data[j][1];
+				f32 z = worldMatrix.Data[j][2];
+				f32 axisScale = sqrtf(x * x + y * y + z * z);
+				scale = axisScale > scale ? axisScale : scale;
+			}
+
+			Matrix4 worldProjectionMatrix = Matrix4_Multiply(&projectionMatrix, &worldMatrix);
+			Vector4 clipCenter = Matrix4_MultiplyVector(&worldProjectionMatrix, (Vector4){ object->Center.x, object->Center.y, object->Center.z, 1.0f });
+
+			u32 lod = object->LodCount - 1;
+			if (clipCenter.w > 0.0f) {
+				f32 pixelsPerUnit = scale * projectionMatrix.Data[1][1] * cast(f32) swapchain.Extent.height * 0.5f / clipCenter.w;
+				lod = MeshObject_SelectLod(object, pixelsPerUnit, MESH_LOD_ERROR_PIXELS);
+			}
+			drawnTriangleCount += object->Lods[lod].IndexCount / 3;
+			objectLods[i] = lod;
+
+			// NOTE: The clusters are culled and drawn on the GPU instead
+			if (clusterCulling) {
+				continue;
+			}
+
+			Draw draw = {
+				.Pipeline = meshPipeline,
+				.PipelineLayout = meshPipelineLayout,
+				.DescriptorSet = bindless.Set,
+				.VertexBuffer = vertexPulling ? VK_NULL_HANDLE : meshRequest->VertexBuffer.Buffer,
+				.IndexBuffer = meshRequest->IndexBuffer.Buffer,
+				.IndexCount = cast(u32) object->Lods[lod].IndexCount,
+				.FirstIndex = cast(u32) object->Lods[lod].IndexOffset,
+				.VertexOffset = 0,
+				.ObjectIndex = cast(u32) i,
+				.ModelMatrix = worldMatrix,
+			};
+			ASSERT(DrawList_MakeSortKey(&drawList, &draw, depth, &draw.SortKey));
+			ASSERT(DrawList_Push(&drawList, &draw));
+		}
+
+		// NOTE: The draw count of this frame slot is from its last submission, which the fence wait above finished
+		u32 visibleClusterCount = clusterCulling ? VulkanClusterCuller_GetDrawCount(&clusterCuller, frameIndex) : 0;
+		u64 submittedClusterCount = 0;
+		if (clusterCulling) {
+			u64 objectCount = meshState == StreamState_Ready && clusterBufferHandle != BINDLESS_HANDLE_NONE ? mesh.ObjectCount : 0;
+			for (u64 i = 0; i < objectCount; i++) {
+				submittedClusterCount += mesh.Objects[i].Lods[objectLods[i]].ClusterCount;
+			}
+
+			ASSERT(VulkanClusterCuller_BeginFrame(&clusterCuller, frameIndex, submittedClusterCount, objectCount));
+
+			ClusterCullerFrame* cullerFrame = &clusterCuller.Frames[frameIndex];
+			Matrix4* objectMatrices = cullerFrame->Objects.Data;
+			ClusterInstance* instances = cullerFrame->Instances.Data;
+			u64 instanceCount = 0;
+			for (u64 i = 0; i < objectCount; i++) {
+				objectMatrices[i] = Scene_GetWorldMatrix(&scene, objectNodes[i]);
+
+				const MeshLod* lod = &mesh.Objects[i].Lods[objectLods[i]];
+				for (u64 j = 0; j < lod->ClusterCount; j++) {
+					instances[instanceCount++] = (ClusterInstance){
+						.ClusterIndex = cast(u32) (lod->ClusterOffset + j),
+						.ObjectIndex = cast(u32) i,
+					};
+				}
+			}
+		}
+
+		// NOTE: The cascades are culled against the same world matrices, with the mesh's lods instead of the ones picked for the view
+		if (shadows) {
+			ASSERT(VulkanShadowMap_BeginFrame(
+				&shadowMap,
+				frameIndex,
+				&uniformData->ViewMatrix,
+				&projectionMatrix,
+				lightDirection,
+				&mesh,
+				objectMatrices,
+				meshState == StreamState_Ready ? mesh.ObjectCount : 0
+			));
+			uniformData->ShadowBufferHandle = shadowMap.Frames[frameIndex].DataHandle;
+		}
+
+		DrawStats unsortedStats = {};
+		DrawList_CountStateChanges(&drawList, DRAW_RECORD_BATCH_SIZE, &unsortedStats);
+
+		ASSERT(DrawList_Sort(&drawList));
+
+		DrawStats sortedStats = {};
+		DrawList_CountStateChanges(&drawList, DRAW_RECORD_BATCH_SIZE, &sortedStats);
+
+		f64 currentTime = Timer_GetSeconds();
+		if (currentTime - lastStatsTime >= 1.0) {
+			lastStatsTime = currentTime;
+			printf(
+				"Draws: %llu, triangles: %llu, state changes unsorted: %llu pipeline %llu descriptor set %llu vertex buffer %llu index buffer, sorted: %llu pipeline %llu descriptor set %llu vertex buffer %llu index buffer\n",
+				drawList.Count,
+				drawnTriangleCount,
+				unsortedStats.PipelineBinds, unsortedStats.DescriptorSetBinds, unsortedStats.VertexBufferBinds, unsortedStats.IndexBufferBinds,
+				sortedStats.PipelineBinds, sortedStats.DescriptorSetBinds, sortedStats.VertexBufferBinds, sortedStats.IndexBufferBinds
+			);
+
+			if (clusterCulling) {
+				printf("Clusters: %u visible of %llu\n", visibleClusterCount, submittedClusterCount);
+			}
+
+			if (lightCulling) {
+				LightGridStats lightStats = VulkanLightCuller_GetStats(&lightCuller, frameIndex);
+				printf(
+					"Lights: %llu, %.2f per froxel, at most %u, %u froxels over capacity\n",
+					lightCount,
+					cast(f64) lightStats.TotalCount / VULKAN_LIGHT_CULLER_CLUSTER_COUNT,
+					lightStats.MaxCount,
+					lightStats.OverflowCount
+				);
+			}
+
+			if (shadows) {
+				printf("Shadows: %u of %u cascades drawn, %llu caster draws\n", shadowMap.RedrawCount, VULKAN_SHADOW_MAP_CASCADE_COUNT, shadowMap.RedrawDrawCount);
+			}
+
+			if (capture) {
+				printf("Captures: %llu read back, %llu dropped\n", capturePool.CapturedCount, capturePool.DroppedCount);
+			}
+
+			printf("Render graph: %u of %u passes, %u barriers\n", renderGraph.LivePassCount, renderGraph.PassCount, renderGraph.BarrierCount);
+
+			printf(
+				"Latency: %.2f ms input to present, %.2f ms input to done, %s with %u images\n",
+				presentLatencyCount > 0 ? presentLatencySum / cast(f64) presentLatencyCount * 1000.0 : 0.0,
+				completeLatencyCount > 0 ? completeLatencySum / cast(f64) completeLatencyCount * 1000.0 : 0.0,
+				VulkanSwapchain_GetPresentModeName(swapchain.PresentMode),
+				swapchain.ImageCount
+			);
+			presentLatencySum = 0.0;
+			completeLatencySum = 0.0;
+
+			if (hasFrameTimer) {
+				printf("GPU: %.2f ms, render scale %.2f\n", gpuSeconds * 1000.0, cast(f64) frame->RenderScale);
 			}
+			presentLatencyCount = 0;
+			completeLatencyCount = 0;
+
+			u32 heapIndex = memoryBudget.DeviceLocalHeapIndex;
+			printf(
+				"Device memory: %.2f MiB tracked, %.2f MiB used, %.2f MiB budget, texture memory: %.2f MiB\n",
+				cast(f64) VulkanMemoryBudget_GetTrackedUsage(heapIndex) / (1024.0 * 1024.0),
+				cast(f64) memoryBudget.HeapUsages[heapIndex] / (1024.0 * 1024.0),
+				cast(f64) memoryBudget.HeapBudgets[heapIndex] / (1024.0 * 1024.0),
+				cast(f64) streamer.ImagePool.AllocatedSize / (1024.0 * 1024.0)
+			);
+		}
+
+		// NOTE: An out of date swapchain can not be rendered to, the frame is skipped and the swapchain recreated at the start
+		// of the next one. The fence was not reset, so moving on to the next frame index keeps the frame numbers and fences in
+		// step. A suboptimal swapchain still signals the semaphore, so that frame is rendered before recreating
+		u32 swapchainImageIndex = 0;
+		VkResult acquireResult = vkAcquireNextImageKHR(device, swapchain.Swapchain, ~0ull, frame->ImageAvailableSemaphore, NULL, &swapchainImageIndex);
+		if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+			if (shadows) {
+				VulkanShadowMap_SkipFrame(&shadowMap);
+			}
+			swapchainOutOfDate = true;
+			frameIndex = (frameIndex + 1) % FRAMES_IN_FLIGHT;
+			continue;
+		}
+		ASSERT(acquireResult == VK_SUCCESS || acquireResult == VK_SUBOPTIMAL_KHR);
+		if (acquireResult == VK_SUBOPTIMAL_KHR) {
+			swapchainOutOfDate = true;
+		}
+
+		VkCall(vkResetFences(device, 1, &frame->InFlightFence));
+		VkCall(vkResetCommandPool(device, frame->CommandPool, 0));
+		ASSERT(VulkanCommandRecorder_BeginFrame(&commandRecorder, frameIndex));
+
+		VkCommandBuffer graphicsCommandBuffer = frame->CommandBuffer;
+		VkCall(vkBeginCommandBuffer(graphicsCommandBuffer, &(VkCommandBufferBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		}));
+
+		if (hasFrameTimer) {
+			VulkanFrameTimer_RecordBegin(&frameTimer, graphicsCommandBuffer, frameIndex);
+		}
+
+		u64 streamerWaitValue = VulkanStreamer_RecordAcquires(&streamer, graphicsCommandBuffer, frameNumber);
+
+		// NOTE: The swapchain image's previous contents are discarded, so it only has to wait for the acquire
+		RenderGraph_SetImage(
+			&renderGraph,
+			swapchainTarget,
+			swapchain.Images[swapchainImageIndex],
+			swapchain.ImageViews[swapchainImageIndex],
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
 		);
 
+		// NOTE: Dropped rather than waited for when every slot is still being read back or saved
+		if (capture && frameNumber % captureInterval == 0) {
+			VulkanCapturePool_BeginCapture(&capturePool, frameNumber, swapchain.Extent.width, swapchain.Extent.height, swapchain.Format.format);
+		}
+
+		frameRecord = (FrameRecordData){
+			.FrameIndex = frameIndex,
+			.Extent = swapchain.Extent,
+			.RenderExtent = renderExtent,
+			.SceneImage = sceneColor.Image,
+			.SwapchainImage = swapchain.Images[swapchainImageIndex],
+			.UpscaleFilter = upscaleFilter,
+			.RenderPass = renderPass,
+			.Framebuffer = useDynamicResolution ? sceneFramebuffer : swapchain.Framebuffers ? swapchain.Framebuffers[swapchainImageIndex] : VK_NULL_HANDLE,
+			.DynamicRendering = &dynamicRendering,
+			.ColorView = useDynamicResolution ? sceneColor.View : swapchain.ImageViews[swapchainImageIndex],
+			.DepthView = swapchain.DepthImage.View,
+			.ColorFormat = swapchain.Format.format,
+			.DepthFormat = swapchain.DepthFormat,
+			.CommandRecorder = &commandRecorder,
+			.DrawCount = drawList.Count,
+			.Draws = (DrawRecordData){
+				.Draws = drawList.Draws,
+				.Extent = renderExtent,
+				.PipelineLayout = meshPipelineLayout,
+				.PushConstants = (MeshPushConstants){
+					.UniformBufferHandle = frame->UniformBufferHandle,
+					.MaterialBufferHandle = materialBufferHandle,
+					.VertexAddress = meshRequest->VertexBuffer.DeviceAddress,
+					.VertexStride = sizeof(Vertex) / sizeof(u32),
+					.PositionOffset = offsetof(Vertex, Position) / sizeof(u32),
+					.NormalOffset = offsetof(Vertex, Normal) / sizeof(u32),
+					.TexCoordOffset = offsetof(Vertex, TexCoord) / sizeof(u32),
+					.MaterialIndexOffset = offsetof(Vertex, MaterialIndex) / sizeof(u32),
+				},
+			},
+			.DrawClusters = clusterCulling && clusterCuller.Frames[frameIndex].InstanceCount > 0,
+			.Clusters = (ClusterRecordData){
+				.ClusterCuller = &clusterCuller,
+				.FrameIndex = frameIndex,
+				.Extent = renderExtent,
+				.Pipeline = clusterPipeline,
+				.PipelineLayout = meshPipelineLayout,
+				.DescriptorSet = bindless.Set,
+				.VertexBuffer = meshRequest->VertexBuffer.Buffer,
+				.IndexBuffer = meshRequest->IndexBuffer.Buffer,
+				.PushConstants = (MeshPushConstants){
+					.UniformBufferHandle = frame->UniformBufferHandle,
+					.MaterialBufferHandle = materialBufferHandle,
+					.ObjectBufferHandle = clusterCuller.Frames[frameIndex].ObjectsHandle,
+				},
+			},
+			.ClusterCuller = &clusterCuller,
+			.LightCuller = &lightCuller,
+			.ShadowMap = &shadowMap,
+			.CapturePool = &capturePool,
+			.VertexBuffer = meshRequest->VertexBuffer.Buffer,
+			.IndexBuffer = meshRequest->IndexBuffer.Buffer,
+			.UniformBufferHandle = frame->UniformBufferHandle,
+			.ClusterBufferHandle = clusterBufferHandle,
+			.ViewMatrix = &uniformData->ViewMatrix,
+			.ProjectionMatrix = &uniformData->ProjectionMatrix,
+		};
+
+		RenderGraph_Execute(&renderGraph, graphicsCommandBuffer);
+
+		if (hasFrameTimer) {
+			VulkanFrameTimer_RecordEnd(&frameTimer, graphicsCommandBuffer, frameIndex);
+		}
+
 		VkCall(vkEndCommandBuffer(graphicsCommandBuffer));
 
+		// NOTE: The timeline wait is only added when this frame acquired new uploads, binary semaphores ignore their value
+		VulkanStreamer_LockQueue(&streamer);
 		VkCall(vkQueueSubmit(graphicsQueue, 1, &(VkSubmitInfo){
 			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &imageAvailableSemaphore,
-			.pWaitDstStageMask = (VkPipelineStageFlags[1]){ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT }, // HACK: Array of length 1 allows me to take the address of the flags inline
+			.pNext = &(VkTimelineSemaphoreSubmitInfo){
+				.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+				.waitSemaphoreValueCount = streamerWaitValue > 0 ? 2 : 1,
+				.pWaitSemaphoreValues = (u64[2]){ 0, streamerWaitValue },
+			},
+			.waitSemaphoreCount = streamerWaitValue > 0 ? 2 : 1,
+			.pWaitSemaphores = (VkSemaphore[2]){ frame->ImageAvailableSemaphore, streamer.Timeline },
+			.pWaitDstStageMask = (VkPipelineStageFlags[2]){ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VULKAN_STREAMER_CONSUMER_STAGES },
 			.commandBufferCount = 1,
 			.pCommandBuffers = &graphicsCommandBuffer,
 			.signalSemaphoreCount = 1,
-			.pSignalSemaphores = &renderFinishedSemaphore,
-		}, NULL));
+			.pSignalSemaphores = &frame->RenderFinishedSemaphore,
+		}, frame->InFlightFence));
 
-		VkCall(vkQueuePresentKHR(presentQueue, &(VkPresentInfoKHR){
+		VkResult presentResult = vkQueuePresentKHR(presentQueue, &(VkPresentInfoKHR){
 			.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
 			.waitSemaphoreCount = 1,
-			.pWaitSemaphores = &renderFinishedSemaphore,
+			.pWaitSemaphores = &frame->RenderFinishedSemaphore,
 			.swapchainCount = 1,
 			.pSwapchains = &swapchain.Swapchain,
 			.pImageIndices = &swapchainImageIndex,
-		}));
+		});
+		VulkanStreamer_UnlockQueue(&streamer);
 
-		VkCall(vkDeviceWaitIdle(device));
+		if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+			swapchainOutOfDate = true;
+		} else {
+			ASSERT(presentResult == VK_SUCCESS);
+		}
+
+		frame->InputTime = inputTime;
+		presentLatencySum += Timer_GetSeconds() - inputTime;
+		presentLatencyCount++;
+
+		// NOTE: The limiter sleeps right before the next input poll rather than after it, so waiting does not add latency.
+		// A frame that ran late moves the schedule instead of letting the next ones catch up
+		if (frameLimit > 0.0) {
+			nextFrameTime += 1.0 / frameLimit;
+			f64 presentTime = Timer_GetSeconds();
+			if (nextFrameTime < presentTime) {
+				nextFrameTime = presentTime;
+			}
+			Timer_SleepUntil(nextFrameTime);
+		}
+
+		frameIndex = (frameIndex + 1) % FRAMES_IN_FLIGHT;
 	}
 
 	VkCall(vkDeviceWaitIdle(device));
 	{
-		VulkanBuffer_Destroy(&uniformBuffer);
-		VulkanBuffer_Destroy(&vertexBuffer);
-		VulkanBuffer_Destroy(&indexBuffer);
+		VulkanDeletionQueue_Destroy(&deletionQueue);
+
+		free(objectNodes);
+		free(objectLods);
+		free(objectMatrices);
+		Scene_Destroy(&scene);
 
-		if (mesh.Vertices) {
-			free(mesh.Vertices);
+		RenderGraph_Destroy(&renderGraph);
+		if (sceneFramebuffer != VK_NULL_HANDLE) {
+			vkDestroyFramebuffer(device, sceneFramebuffer, NULL);
+		}
+		if (useDynamicResolution) {
+			VulkanImagePool_DestroyImage(&renderTargetPool, &sceneColor);
+		}
+		if (hasFrameTimer) {
+			VulkanFrameTimer_Destroy(&frameTimer);
+		}
+		DrawList_Destroy(&drawList);
+		if (clusterCulling) {
+			VulkanClusterCuller_Destroy(&clusterCuller);
+		}
+		if (lightCulling) {
+			VulkanLightCuller_Destroy(&lightCuller);
+		}
+		free(lights);
+		if (shadows) {
+			VulkanShadowMap_Destroy(&shadowMap);
+		}
+		if (capture) {
+			VulkanCapturePool_Destroy(&capturePool);
+		}
+		VulkanCommandRecorder_Destroy(&commandRecorder);
+
+		for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
+			VulkanBuffer_Destroy(&frames[i].UniformBuffer);
+			vkDestroyCommandPool(device, frames[i].CommandPool, NULL);
+			vkDestroyFence(device, frames[i].InFlightFence, NULL);
+			vkDestroySemaphore(device, frames[i].ImageAvailableSemaphore, NULL);
+			vkDestroySemaphore(device, frames[i].RenderFinishedSemaphore, NULL);
 		}
 
-		if (mesh.Indices) {
-			free(mesh.Indices);
+		MaterialTable_Destroy(&materialTable);
+
+		// NOTE: Has to go before the mesh, a pending mesh upload still reads from it
+		VulkanStreamer_Destroy(&streamer);
+		free(textureRequests);
+		free(diffuseTextures);
+
+		vkDestroySampler(device, textureSampler, NULL);
+
+		if (clusterBufferHandle != BINDLESS_HANDLE_NONE) {
+			VulkanBindless_RemoveStorageBuffer(&bindless, clusterBufferHandle);
 		}
 
+		Mesh_Destroy(&mesh);
+
 		vkDestroyPipelineLayout(device, meshPipelineLayout, NULL);
 		vkDestroyPipelineCache(device, meshPipelineCache, NULL);
 		vkDestroyPipeline(device, meshPipeline, NULL);
+		if (clusterPipeline != VK_NULL_HANDLE) {
+			vkDestroyPipeline(device, clusterPipeline, NULL);
+		}
 
-		vkDestroyDescriptorSetLayout(device, meshDescriptorSetLayout, NULL);
+		VulkanBindless_Destroy(&bindless);
 
 		vkDestroyShaderModule(device, fragmentShader, NULL);
 		vkDestroyShaderModule(device, vertexShader, NULL);
+		if (clusterCulling) {
+			vkDestroyShaderModule(device, clusterVertexShader, NULL);
+			vkDestroyShaderModule(device, clusterCullShader, NULL);
+			vkDestroyShaderModule(device, depthPyramidShader, NULL);
+		}
+		if (lightCulling) {
+			vkDestroyShaderModule(device, lightCullShader, NULL);
+		}
+		if (shadows) {
+			vkDestroyShaderModule(device, shadowVertexShader, NULL);
+		}
 
 		VulkanSwapchain_Destroy(&swapchain);
+		VulkanImagePool_Destroy(&renderTargetPool);
 
 		vkDestroyRenderPass(device, renderPass, NULL);
-
-		vkDestroyDescriptorPool(device, meshDescriptorPool, NULL);
-
-		vkDestroyCommandPool(device, graphicsCommandPool, NULL);
-
-		vkDestroySemaphore(device, imageAvailableSemaphore, NULL);
-		vkDestroySemaphore(device, renderFinishedSemaphore, NULL);
 	}
 	vkDestroyDevice(device, NULL);
 
@@ -815,5 +2146,7 @@ int main(int argc, char** argv) {
 #endif
 
 	vkDestroyInstance(instance, NULL);
+
+	JobSystem_Shutdown();
 	return 0;
 }
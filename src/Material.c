@@ -0,0 +1,60 @@
+#include "Material.h"
+
+GpuMaterial GpuMaterial_FromObj(const ObjMaterial* material, BindlessHandle diffuseTexture, BindlessHandle sampler) {
+	GpuMaterial result = (GpuMaterial){
+		.Ambient = (Vector4){ material->Ka.x, material->Ka.y, material->Ka.z, 0.0f },
+		.Diffuse = (Vector4){ material->Kd.x, material->Kd.y, material->Kd.z, material->d.x },
+		.Specular = (Vector4){ material->Ks.x, material->Ks.y, material->Ks.z, material->Ns },
+		.Emission = (Vector4){ material->Ke.x, material->Ke.y, material->Ke.z, material->Ni },
+		.DiffuseTexture = diffuseTexture,
+		.DiffuseSampler = sampler,
+	};
+	return result;
+}
+
+b8 MaterialTable_Create(
+	MaterialTable* table,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	const ObjMaterial* materials,
+	u64 materialCount,
+	const BindlessHandle* diffuseTextures,
+	BindlessHandle sampler
+) {
+	*table = (MaterialTable){};
+
+	// NOTE: Always keep one material around so the buffer is never empty
+	table->MaterialCount = materialCount > 0 ? materialCount : 1;
+
+	if (!VulkanBuffer_Create(&table->Buffer, device, physicalDevice, table->MaterialCount * sizeof(GpuMaterial), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+		return false;
+	}
+
+	GpuMaterial* gpuMaterials = table->Buffer.Data;
+	if (materialCount == 0) {
+		gpuMaterials[0] = (GpuMaterial){
+			.Diffuse = (Vector4){ 0.8f, 0.8f, 0.8f, 1.0f },
+			.Specular = (Vector4){ 0.0f, 0.0f, 0.0f, 1.0f },
+			.DiffuseTexture = BINDLESS_HANDLE_NONE,
+			.DiffuseSampler = sampler,
+		};
+		return true;
+	}
+
+	for (u64 i = 0; i < materialCount; i++) {
+		gpuMaterials[i] = GpuMaterial_FromObj(&materials[i], diffuseTextures ? diffuseTextures[i] : BINDLESS_HANDLE_NONE, sampler);
+	}
+
+	return true;
+}
+
+void MaterialTable_Destroy(MaterialTable* table) {
+	VulkanBuffer_Destroy(&table->Buffer);
+	*table = (MaterialTable){};
+}
+
+void MaterialTable_SetDiffuseTexture(MaterialTable* table, u64 materialIndex, BindlessHandle diffuseTexture) {
+	ASSERT(materialIndex < table->MaterialCount);
+	GpuMaterial* gpuMaterials = table->Buffer.Data;
+	gpuMaterials[materialIndex].DiffuseTexture = diffuseTexture;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+#include "ObjLoader.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindless.h"
+
+// NOTE: Matches the std430 Material struct in triangle.frag.glsl
+typedef struct GpuMaterial_t {
+	Vector4 Ambient;  // xyz Ka
+	Vector4 Diffuse;  // xyz Kd, w d
+	Vector4 Specular; // xyz Ks, w Ns
+	Vector4 Emission; // xyz Ke, w Ni
+	BindlessHandle DiffuseTexture; // BINDLESS_HANDLE_NONE when there is no map_Kd
+	BindlessHandle DiffuseSampler;
+	u32 Padding[2];
+} GpuMaterial;
+
+STATIC_ASSERT(sizeof(GpuMaterial) == 80, "GpuMaterial must match the std430 layout");
+
+typedef struct MaterialTable_t {
+	VulkanBuffer Buffer;
+	u64 MaterialCount;
+} MaterialTable;
+
+GpuMaterial GpuMaterial_FromObj(const ObjMaterial* material, BindlessHandle diffuseTexture, BindlessHandle sampler);
+
+// NOTE: Uploads every material once, vertices reference them through Vertex::MaterialIndex.
+// diffuseTextures has one handle per material and can be NULL when nothing is textured
+b8 MaterialTable_Create(
+	MaterialTable* table,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	const ObjMaterial* materials,
+	u64 materialCount,
+	const BindlessHandle* diffuseTextures,
+	BindlessHandle sampler
+);
+void MaterialTable_Destroy(MaterialTable* table);
+
+// NOTE: For textures that finish streaming after the table was created. Frames in flight see either the old
+// or the new handle, both of which are valid
+void MaterialTable_SetDiffuseTexture(MaterialTable* table, u64 materialIndex, BindlessHandle diffuseTexture);
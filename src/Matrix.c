@@ -23,3 +23,75 @@ Matrix4 Matrix4_Scale(Vector3 v) {
 	};
 	return result;
 }
+
+Matrix4 Matrix4_Translation(Vector3 v) {
+	Matrix4 result = (Matrix4){
+		.Data = {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ v.x,  v.y,  v.z,  1.0f },
+		},
+	};
+	return result;
+}
+
+// NOTE: Data is column major to match glsl, so Data[column][row]
+Matrix4 Matrix4_Multiply(const Matrix4* a, const Matrix4* b) {
+	Matrix4 result;
+	for (u32 column = 0; column < 4; column++) {
+		for (u32 row = 0; row < 4; row++) {
+			result.Data[column][row] =
+				a->Data[0][row] * b->Data[column][0] +
+				a->Data[1][row] * b->Data[column][1] +
+				a->Data[2][row] * b->Data[column][2] +
+				a->Data[3][row] * b->Data[column][3];
+		}
+	}
+	return result;
+}
+
+Vector4 Matrix4_MultiplyVector(const Matrix4* m, Vector4 v) {
+	Vector4 result = (Vector4){
+		.x = m->Data[0][0] * v.x + m->Data[1][0] * v.y + m->Data[2][0] * v.z + m->Data[3][0] * v.w,
+		.y = m->Data[0][1] * v.x + m->Data[1][1] * v.y + m->Data[2][1] * v.z + m->Data[3][1] * v.w,
+		.z = m->Data[0][2] * v.x + m->Data[1][2] * v.y + m->Data[2][2] * v.z + m->Data[3][2] * v.w,
+		.w = m->Data[0][3] * v.x + m->Data[1][3] * v.y + m->Data[2][3] * v.z + m->Data[3][3] * v.w,
+	};
+	return result;
+}
+
+// NOTE: Cofactor expansion, a singular matrix has a determinant of 0 and gives back the identity
+Matrix4 Matrix4_Inverse(const Matrix4* m) {
+	const f32* a = &m->Data[0][0];
+	f32 inverse[16];
+
+	inverse[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+	inverse[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+	inverse[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+	inverse[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+	inverse[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+	inverse[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+	inverse[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+	inverse[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+	inverse[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+	inverse[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+	inverse[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+	inverse[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+	inverse[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+	inverse[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+	inverse[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+	inverse[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+	f32 determinant = a[0] * inverse[0] + a[1] * inverse[4] + a[2] * inverse[8] + a[3] * inverse[12];
+	if (determinant == 0.0f) {
+		return Matrix4_Identity();
+	}
+
+	Matrix4 result;
+	f32* r = &result.Data[0][0];
+	for (u32 i = 0; i < 16; i++) {
+		r[i] = inverse[i] / determinant;
+	}
+	return result;
+}
@@ -9,3 +9,7 @@ typedef struct Matrix4_t {
 
 Matrix4 Matrix4_Identity();
 Matrix4 Matrix4_Scale(Vector3 v);
+Matrix4 Matrix4_Translation(Vector3 v);
+Matrix4 Matrix4_Multiply(const Matrix4* a, const Matrix4* b);
+Vector4 Matrix4_MultiplyVector(const Matrix4* m, Vector4 v);
+Matrix4 Matrix4_Inverse(const Matrix4* m);
@@ -0,0 +1,403 @@
+#include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "JobSystem.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// NOTE: Fractions of the full detail triangle count for the lods after the first
+static const f32 MeshLodRatios[MESH_MAX_LODS - 1] = { 0.5f, 0.25f, 0.1f };
+// NOTE: A lod that cannot get below this fraction of the previous one is not worth keeping, usually because too much is locked
+#define MESH_LOD_MIN_REDUCTION 0.9f
+
+typedef struct MeshCorner_t {
+	u64 Position;
+	u64 Normal;
+	u64 TexCoord;
+	u32 MaterialIndex;
+	u32 Corner;
+} MeshCorner;
+
+typedef struct MeshEdge_t {
+	u64 Position0;
+	u64 Position1;
+	u32 Vertex0;
+	u32 Vertex1;
+} MeshEdge;
+
+typedef struct MeshObjectBuild_t {
+	Vertex* Vertices;
+	u64 VertexCount;
+	u32* Indices; // Relative to the object's vertices, every lod one after another
+	u64 IndexCount;
+	MeshCluster* Clusters; // Index offsets are relative to Indices
+	u64 ClusterCount;
+	MeshObject Object; // Lod offsets are relative to Indices and Clusters
+	b8 Built;
+} MeshObjectBuild;
+
+typedef struct MeshBuildData_t {
+	const ObjMesh* ObjMesh;
+	MeshObjectBuild* Objects;
+} MeshBuildData;
+
+static int MeshCorner_Compare(const void* a, const void* b) {
+	const MeshCorner* cornerA = a;
+	const MeshCorner* cornerB = b;
+	if (cornerA->Position != cornerB->Position) return cornerA->Position < cornerB->Position ? -1 : 1;
+	if (cornerA->Normal != cornerB->Normal) return cornerA->Normal < cornerB->Normal ? -1 : 1;
+	if (cornerA->TexCoord != cornerB->TexCoord) return cornerA->TexCoord < cornerB->TexCoord ? -1 : 1;
+	if (cornerA->MaterialIndex != cornerB->MaterialIndex) return cornerA->MaterialIndex < cornerB->MaterialIndex ? -1 : 1;
+	return 0;
+}
+
+static int MeshEdge_Compare(const void* a, const void* b) {
+	const MeshEdge* edgeA = a;
+	const MeshEdge* edgeB = b;
+	if (edgeA->Position0 != edgeB->Position0) return edgeA->Position0 < edgeB->Position0 ? -1 : 1;
+	if (edgeA->Position1 != edgeB->Position1) return edgeA->Position1 < edgeB->Position1 ? -1 : 1;
+	return 0;
+}
+
+// NOTE: Welds the corners that share every attribute into one vertex. The sort keeps vertices with the same position next to
+// each other, a position that ends up with more than one vertex lies on a normal, uv or material seam and gets locked
+static b8 Mesh_WeldObject(MeshObjectBuild* build, const ObjMesh* objMesh, const ObjObject* object, u32* cornerVertices, u8** locked) {
+	u64 cornerCount = object->FaceCount * 3;
+
+	MeshCorner* corners = malloc(cornerCount * sizeof(corners[0]));
+	if (!corners) {
+		return false;
+	}
+
+	for (u64 i = 0; i < cornerCount; i++) {
+		const ObjFace* face = &objMesh->Faces[object->FaceOffset + i / 3];
+		corners[i] = (MeshCorner){
+			.Position = face->PositionIndices[i % 3],
+			.Normal = face->NormalIndices[i % 3],
+			.TexCoord = face->TexCoordIndices[i % 3],
+			.MaterialIndex = face->MaterialIndex,
+			.Corner = cast(u32) i,
+		};
+	}
+	qsort(corners, cornerCount, sizeof(corners[0]), MeshCorner_Compare);
+
+	build->Vertices = malloc(cornerCount * sizeof(build->Vertices[0]));
+	*locked = calloc(cornerCount, sizeof((*locked)[0]));
+	if (!build->Vertices || !*locked) {
+		free(corners);
+		return false;
+	}
+
+	u64 positionStart = 0;
+	for (u64 i = 0; i < cornerCount; i++) {
+		const MeshCorner* corner = &corners[i];
+		if (i == 0 || MeshCorner_Compare(&corners[i - 1], corner) != 0) {
+			if (i > 0 && corners[i - 1].Position != corner->Position) {
+				positionStart = build->VertexCount;
+			}
+
+			build->Vertices[build->VertexCount++] = (Vertex){
+				.Position = objMesh->Positions[corner->Position],
+				.Normal = objMesh->Normals[corner->Normal],
+				.TexCoord = objMesh->TexCoords[corner->TexCoord],
+				.MaterialIndex = corner->MaterialIndex,
+			};
+
+			if (build->VertexCount - positionStart > 1) {
+				for (u64 j = positionStart; j < build->VertexCount; j++) {
+					(*locked)[j] = true;
+				}
+			}
+		}
+		cornerVertices[corner->Corner] = cast(u32) (build->VertexCount - 1);
+	}
+
+	free(corners);
+	return true;
+}
+
+// NOTE: Edges that do not have exactly two triangles are borders or non manifold, collapsing their ends would eat into the outline
+static b8 Mesh_LockBorders(const ObjMesh* objMesh, const ObjObject* object, const u32* cornerVertices, u8* locked) {
+	u64 edgeCount = object->FaceCount * 3;
+
+	MeshEdge* edges = malloc(edgeCount * sizeof(edges[0]));
+	if (!edges) {
+		return false;
+	}
+
+	for (u64 i = 0; i < edgeCount; i++) {
+		const ObjFace* face = &objMesh->Faces[object->FaceOffset + i / 3];
+		u32 next = i % 3 == 2 ? cast(u32) (i - 2) : cast(u32) (i + 1);
+		u64 position0 = face->PositionIndices[i % 3];
+		u64 position1 = face->PositionIndices[(i + 1) % 3];
+		edges[i] = (MeshEdge){
+			.Position0 = position0 < position1 ? position0 : position1,
+			.Position1 = position0 < position1 ? position1 : position0,
+			.Vertex0 = cornerVertices[i],
+			.Vertex1 = cornerVertices[next],
+		};
+	}
+	qsort(edges, edgeCount, sizeof(edges[0]), MeshEdge_Compare);
+
+	for (u64 begin = 0; begin < edgeCount;) {
+		u64 end = begin + 1;
+		while (end < edgeCount && MeshEdge_Compare(&edges[begin], &edges[end]) == 0) {
+			end++;
+		}
+
+		if (end - begin != 2) {
+			for (u64 i = begin; i < end; i++) {
+				locked[edges[i].Vertex0] = true;
+				locked[edges[i].Vertex1] = true;
+			}
+		}
+		begin = end;
+	}
+
+	free(edges);
+	return true;
+}
+
+static void Mesh_ComputeBounds(MeshObjectBuild* build) {
+	if (build->VertexCount == 0) {
+		return;
+	}
+
+	Vector3 min = build->Vertices[0].Position;
+	Vector3 max = build->Vertices[0].Position;
+	for (u64 i = 1; i < build->VertexCount; i++) {
+		Vector3 position = build->Vertices[i].Position;
+		min = (Vector3){ fminf(min.x, position.x), fminf(min.y, position.y), fminf(min.z, position.z) };
+		max = (Vector3){ fmaxf(max.x, position.x), fmaxf(max.y, position.y), fmaxf(max.z, position.z) };
+	}
+
+	Vector3 center = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+	f32 radiusSquared = 0.0f;
+	for (u64 i = 0; i < build->VertexCount; i++) {
+		Vector3 position = build->Vertices[i].Position;
+		f32 x = position.x - center.x;
+		f32 y = position.y - center.y;
+		f32 z = position.z - center.z;
+		f32 distanceSquared = x * x + y * y + z * z;
+		radiusSquared = distanceSquared > radiusSquared ? distanceSquared : radiusSquared;
+	}
+
+	build->Object.Center = center;
+	build->Object.Radius = sqrtf(radiusSquared);
+}
+
+static b8 Mesh_BuildLods(MeshObjectBuild* build, const u8* locked) {
+	MeshLod* lods = build->Object.Lods;
+	u64 fullIndexCount = lods[0].IndexCount;
+	if (fullIndexCount == 0) {
+		return true;
+	}
+
+	MeshSimplifier simplifier;
+	if (!MeshSimplifier_Create(
+		&simplifier,
+		&build->Vertices[0].Position, sizeof(build->Vertices[0]), build->VertexCount,
+		locked,
+		build->Indices, fullIndexCount
+	)) {
+		return false;
+	}
+
+	for (u32 i = 0; i < MESH_MAX_LODS - 1; i++) {
+		u64 targetIndexCount = cast(u64) (cast(f32) (fullIndexCount / 3) * MeshLodRatios[i]) * 3;
+		u64 previousIndexCount = lods[build->Object.LodCount - 1].IndexCount;
+
+		u64 indexCount = MeshSimplifier_Reduce(&simplifier, targetIndexCount);
+		if (indexCount == 0 || cast(f32) indexCount > cast(f32) previousIndexCount * MESH_LOD_MIN_REDUCTION) {
+			break;
+		}
+
+		lods[build->Object.LodCount++] = (MeshLod){
+			.IndexOffset = build->IndexCount,
+			.IndexCount = indexCount,
+			.Error = simplifier.Error,
+		};
+		memcpy(&build->Indices[build->IndexCount], simplifier.Indices, indexCount * sizeof(build->Indices[0]));
+		build->IndexCount += indexCount;
+	}
+
+	MeshSimplifier_Destroy(&simplifier);
+	return true;
+}
+
+static b8 Mesh_BuildClusters(MeshObjectBuild* build) {
+	MeshLod* lods = build->Object.Lods;
+	for (u32 i = 0; i < build->Object.LodCount; i++) {
+		MeshCluster* clusters = NULL;
+		u64 clusterCount = 0;
+		if (!MeshCluster_Build(
+			&clusters, &clusterCount,
+			&build->Indices[lods[i].IndexOffset], lods[i].IndexCount,
+			&build->Vertices[0].Position, sizeof(build->Vertices[0]), build->VertexCount
+		)) {
+			return false;
+		}
+
+		MeshCluster* allClusters = realloc(build->Clusters, (build->ClusterCount + clusterCount) * sizeof(allClusters[0]));
+		if (clusterCount > 0 && !allClusters) {
+			free(clusters);
+			return false;
+		}
+		build->Clusters = allClusters;
+
+		lods[i].ClusterOffset = build->ClusterCount;
+		lods[i].ClusterCount = clusterCount;
+		for (u64 j = 0; j < clusterCount; j++) {
+			clusters[j].IndexOffset += cast(u32) lods[i].IndexOffset;
+			build->Clusters[build->ClusterCount++] = clusters[j];
+		}
+		free(clusters);
+	}
+
+	return true;
+}
+
+static void Mesh_BuildObjects(void* data, u64 begin, u64 end) {
+	MeshBuildData* buildData = data;
+	const ObjMesh* objMesh = buildData->ObjMesh;
+
+	for (u64 i = begin; i < end; i++) {
+		const ObjObject* object = &objMesh->Objects[i];
+		MeshObjectBuild* build = &buildData->Objects[i];
+		u64 cornerCount = object->FaceCount * 3;
+
+		build->Object.Lods[0] = (MeshLod){ .IndexCount = cornerCount };
+		build->Object.LodCount = 1;
+		if (cornerCount == 0) {
+			build->Built = true;
+			continue;
+		}
+
+		// NOTE: Every lod is at most MESH_LOD_MIN_REDUCTION of the previous one, so the chain always fits in 4 times the corners
+		u32* cornerVertices = malloc(cornerCount * sizeof(cornerVertices[0]));
+		build->Indices = malloc(cornerCount * MESH_MAX_LODS * sizeof(build->Indices[0]));
+		u8* locked = NULL;
+		if (cornerVertices && build->Indices &&
+			Mesh_WeldObject(build, objMesh, object, cornerVertices, &locked) &&
+			Mesh_LockBorders(objMesh, object, cornerVertices, locked)
+		) {
+			memcpy(build->Indices, cornerVertices, cornerCount * sizeof(build->Indices[0]));
+			build->IndexCount = cornerCount;
+
+			Mesh_ComputeBounds(build);
+			build->Built = Mesh_BuildLods(build, locked) && Mesh_BuildClusters(build);
+		}
+
+		free(locked);
+		free(cornerVertices);
+	}
+}
+
+b8 Mesh_CreateFromObj(Mesh* mesh, const ObjMesh* objMesh) {
+	*mesh = (Mesh){};
+
+	mesh->ObjectCount = objMesh->ObjectCount;
+
+	MeshObjectBuild* builds = calloc(mesh->ObjectCount, sizeof(builds[0]));
+	mesh->Objects = malloc(mesh->ObjectCount * sizeof(mesh->Objects[0]));
+	if (mesh->ObjectCount > 0 && (!builds || !mesh->Objects)) {
+		free(builds);
+		Mesh_Destroy(mesh);
+		return false;
+	}
+
+	MeshBuildData buildData = {
+		.ObjMesh = objMesh,
+		.Objects = builds,
+	};
+	JobSystem_ParallelFor(mesh->ObjectCount, 1, Mesh_BuildObjects, &buildData);
+
+	b8 built = true;
+	for (u64 i = 0; i < mesh->ObjectCount; i++) {
+		built = built && builds[i].Built;
+		mesh->VertexCount += builds[i].VertexCount;
+		mesh->IndexCount += builds[i].IndexCount;
+		mesh->ClusterCount += builds[i].ClusterCount;
+	}
+
+	if (built && mesh->VertexCount <= ~0u && mesh->IndexCount <= ~0u) {
+		mesh->Vertices = malloc(mesh->VertexCount * sizeof(mesh->Vertices[0]));
+		mesh->Indices = malloc(mesh->IndexCount * sizeof(mesh->Indices[0]));
+		mesh->Clusters = malloc(mesh->ClusterCount * sizeof(mesh->Clusters[0]));
+		built = (mesh->VertexCount == 0 || mesh->Vertices) && (mesh->IndexCount == 0 || mesh->Indices) && (mesh->ClusterCount == 0 || mesh->Clusters);
+	} else {
+		built = false;
+	}
+
+	u64 vertexOffset = 0;
+	u64 indexOffset = 0;
+	u64 clusterOffset = 0;
+	for (u64 i = 0; i < mesh->ObjectCount; i++) {
+		MeshObjectBuild* build = &builds[i];
+		if (built) {
+			memcpy(&mesh->Vertices[vertexOffset], build->Vertices, build->VertexCount * sizeof(mesh->Vertices[0]));
+			for (u64 j = 0; j < build->IndexCount; j++) {
+				mesh->Indices[indexOffset + j] = cast(u32) (build->Indices[j] + vertexOffset);
+			}
+
+			for (u64 j = 0; j < build->ClusterCount; j++) {
+				mesh->Clusters[clusterOffset + j] = build->Clusters[j];
+				mesh->Clusters[clusterOffset + j].IndexOffset += cast(u32) indexOffset;
+			}
+
+			mesh->Objects[i] = build->Object;
+			for (u32 j = 0; j < build->Object.LodCount; j++) {
+				mesh->Objects[i].Lods[j].IndexOffset += indexOffset;
+				mesh->Objects[i].Lods[j].ClusterOffset += clusterOffset;
+			}
+
+			vertexOffset += build->VertexCount;
+			indexOffset += build->IndexCount;
+			clusterOffset += build->ClusterCount;
+		}
+
+		free(build->Vertices);
+		free(build->Indices);
+		free(build->Clusters);
+	}
+	free(builds);
+
+	if (!built) {
+		Mesh_Destroy(mesh);
+		return false;
+	}
+
+	return true;
+}
+
+void Mesh_Destroy(Mesh* mesh) {
+	if (mesh->Vertices) {
+		free(mesh->Vertices);
+	}
+
+	if (mesh->Indices) {
+		free(mesh->Indices);
+	}
+
+	if (mesh->Objects) {
+		free(mesh->Objects);
+	}
+
+	if (mesh->Clusters) {
+		free(mesh->Clusters);
+	}
+
+	*mesh = (Mesh){};
+}
+
+u32 MeshObject_SelectLod(const MeshObject* object, f32 pixelsPerUnit, f32 maxErrorPixels) {
+	u32 lod = 0;
+	for (u32 i = 1; i < object->LodCount; i++) {
+		if (object->Lods[i].Error * pixelsPerUnit > maxErrorPixels) {
+			break;
+		}
+		lod = i;
+	}
+	return lod;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+#include "ObjLoader.h"
+#include "MeshCluster.h"
+
+typedef struct Vertex_t {
+	Vector3 Position;
+	Vector3 Normal;
+	Vector2 TexCoord;
+	u32 MaterialIndex;
+} Vertex;
+
+#define MESH_MAX_LODS 4
+
+typedef struct MeshLod_t {
+	u64 IndexOffset;
+	u64 IndexCount;
+	u64 ClusterOffset; // Into Mesh::Clusters, the clusters cover exactly the lod's index range
+	u64 ClusterCount;
+	f32 Error; // How far the surface moved from the full detail one, in object space. 0 for the first lod
+} MeshLod;
+
+// NOTE: Lods[0] is the full detail object, every following lod has fewer triangles over the same vertices
+typedef struct MeshObject_t {
+	Vector3 Center; // Object space bounding sphere
+	f32 Radius;
+	MeshLod Lods[MESH_MAX_LODS];
+	u32 LodCount;
+} MeshObject;
+
+typedef struct Mesh_t {
+	Vertex* Vertices;
+	u64 VertexCount;
+	u32* Indices;
+	u64 IndexCount;
+	MeshObject* Objects;
+	u64 ObjectCount;
+	MeshCluster* Clusters; // IndexOffset is into Indices
+	u64 ClusterCount;
+} Mesh;
+
+// NOTE: Vertices are welded per object and every object gets a lod chain at roughly 50%, 25% and 10% of its triangles.
+// Every lod is split into clusters
+b8 Mesh_CreateFromObj(Mesh* mesh, const ObjMesh* objMesh);
+void Mesh_Destroy(Mesh* mesh);
+
+// NOTE: Returns the coarsest lod whose error stays under maxErrorPixels, pixelsPerUnit is the projected size of one object space unit
+u32 MeshObject_SelectLod(const MeshObject* object, f32 pixelsPerUnit, f32 maxErrorPixels);
@@ -0,0 +1,237 @@
+#include "MeshCluster.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef struct MeshClusterBuilder_t {
+	const Vector3* Positions;
+	u64 PositionStride;
+
+	const u32* Indices;
+	u32* TriangleOffsets; // Vertex to triangle adjacency
+	u32* Triangles;
+	u8* Emitted;
+	u32* VertexClusters; // The last cluster that used each vertex
+
+	u32 Vertices[MESH_CLUSTER_MAX_VERTICES];
+	u32 VertexCount;
+	u32 TriangleCount;
+} MeshClusterBuilder;
+
+static Vector3 MeshClusterBuilder_GetPosition(const MeshClusterBuilder* builder, u32 vertex) {
+	return *cast(const Vector3*) (cast(const u8*) builder->Positions + vertex * builder->PositionStride);
+}
+
+static u32 MeshClusterBuilder_CountNewVertices(const MeshClusterBuilder* builder, u32 triangle, u32 cluster) {
+	const u32* vertices = &builder->Indices[triangle * 3];
+	u32 count = 0;
+	for (u32 i = 0; i < 3; i++) {
+		count += builder->VertexClusters[vertices[i]] != cluster;
+	}
+	return count;
+}
+
+static void MeshClusterBuilder_AddTriangle(MeshClusterBuilder* builder, u32 triangle, u32 cluster, u32* outIndices) {
+	const u32* vertices = &builder->Indices[triangle * 3];
+	for (u32 i = 0; i < 3; i++) {
+		if (builder->VertexClusters[vertices[i]] != cluster) {
+			builder->VertexClusters[vertices[i]] = cluster;
+			builder->Vertices[builder->VertexCount++] = vertices[i];
+		}
+		outIndices[i] = vertices[i];
+	}
+
+	builder->Emitted[triangle] = true;
+	builder->TriangleCount++;
+}
+
+// NOTE: Picks the unemitted neighbour that adds the fewest vertices, so the clusters stay compact
+static u32 MeshClusterBuilder_FindNeighbour(const MeshClusterBuilder* builder, u32 cluster) {
+	u32 bestTriangle = ~0u;
+	u32 bestNewVertices = 4;
+	for (u32 i = 0; i < builder->VertexCount && bestNewVertices > 0; i++) {
+		u32 vertex = builder->Vertices[i];
+		for (u32 j = builder->TriangleOffsets[vertex]; j < builder->TriangleOffsets[vertex + 1]; j++) {
+			u32 triangle = builder->Triangles[j];
+			if (builder->Emitted[triangle]) {
+				continue;
+			}
+
+			u32 newVertices = MeshClusterBuilder_CountNewVertices(builder, triangle, cluster);
+			if (builder->VertexCount + newVertices <= MESH_CLUSTER_MAX_VERTICES && newVertices < bestNewVertices) {
+				bestTriangle = triangle;
+				bestNewVertices = newVertices;
+				if (newVertices == 0) {
+					break;
+				}
+			}
+		}
+	}
+	return bestTriangle;
+}
+
+static void MeshClusterBuilder_ComputeBounds(const MeshClusterBuilder* builder, MeshCluster* cluster, const u32* indices) {
+	Vector3 min = MeshClusterBuilder_GetPosition(builder, builder->Vertices[0]);
+	Vector3 max = min;
+	for (u32 i = 1; i < builder->VertexCount; i++) {
+		Vector3 position = MeshClusterBuilder_GetPosition(builder, builder->Vertices[i]);
+		min = (Vector3){ fminf(min.x, position.x), fminf(min.y, position.y), fminf(min.z, position.z) };
+		max = (Vector3){ fmaxf(max.x, position.x), fmaxf(max.y, position.y), fmaxf(max.z, position.z) };
+	}
+
+	Vector3 center = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+	f32 radiusSquared = 0.0f;
+	for (u32 i = 0; i < builder->VertexCount; i++) {
+		Vector3 position = MeshClusterBuilder_GetPosition(builder, builder->Vertices[i]);
+		f32 x = position.x - center.x;
+		f32 y = position.y - center.y;
+		f32 z = position.z - center.z;
+		f32 distanceSquared = x * x + y * y + z * z;
+		radiusSquared = distanceSquared > radiusSquared ? distanceSquared : radiusSquared;
+	}
+
+	cluster->Center = center;
+	cluster->Radius = sqrtf(radiusSquared);
+
+	// NOTE: Degenerate triangles face nowhere, so they do not count towards the cone
+	Vector3 normals[MESH_CLUSTER_MAX_TRIANGLES];
+	u32 normalCount = 0;
+	Vector3 axis = {};
+	for (u32 i = 0; i < builder->TriangleCount; i++) {
+		Vector3 p0 = MeshClusterBuilder_GetPosition(builder, indices[i * 3 + 0]);
+		Vector3 p1 = MeshClusterBuilder_GetPosition(builder, indices[i * 3 + 1]);
+		Vector3 p2 = MeshClusterBuilder_GetPosition(builder, indices[i * 3 + 2]);
+		Vector3 e0 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		Vector3 e1 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		Vector3 normal = { e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+
+		f32 length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if (length == 0.0f) {
+			continue;
+		}
+
+		normal = (Vector3){ normal.x / length, normal.y / length, normal.z / length };
+		normals[normalCount++] = normal;
+		axis = (Vector3){ axis.x + normal.x, axis.y + normal.y, axis.z + normal.z };
+	}
+
+	f32 axisLength = sqrtf(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+	cluster->ConeAxis = (Vector3){ 0.0f, 0.0f, 1.0f };
+	cluster->ConeCutoff = 1.0f;
+	if (axisLength == 0.0f) {
+		return;
+	}
+
+	axis = (Vector3){ axis.x / axisLength, axis.y / axisLength, axis.z / axisLength };
+	f32 minDot = 1.0f;
+	for (u32 i = 0; i < normalCount; i++) {
+		f32 dot = axis.x * normals[i].x + axis.y * normals[i].y + axis.z * normals[i].z;
+		minDot = dot < minDot ? dot : minDot;
+	}
+
+	// NOTE: The normals spread up to acos(minDot) around the axis, so every triangle faces away once the view direction is within
+	// 90 - acos(minDot) degrees of the axis, which is where its cosine passes sin(acos(minDot)). A cone of 90 degrees or more never faces away
+	cluster->ConeAxis = axis;
+	if (minDot > 0.0f) {
+		cluster->ConeCutoff = sqrtf(1.0f - minDot * minDot);
+	}
+}
+
+b8 MeshCluster_Build(
+	MeshCluster** clusters, u64* clusterCount,
+	u32* indices, u64 indexCount,
+	const Vector3* positions, u64 positionStride, u64 vertexCount
+) {
+	*clusters = NULL;
+	*clusterCount = 0;
+
+	ASSERT(indexCount % 3 == 0);
+	u64 triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return true;
+	}
+
+	MeshClusterBuilder builder = {
+		.Positions = positions,
+		.PositionStride = positionStride,
+		.Indices = indices,
+		.TriangleOffsets = calloc(vertexCount + 1, sizeof(builder.TriangleOffsets[0])),
+		.Triangles = malloc(indexCount * sizeof(builder.Triangles[0])),
+		.Emitted = calloc(triangleCount, sizeof(builder.Emitted[0])),
+		.VertexClusters = malloc(vertexCount * sizeof(builder.VertexClusters[0])),
+	};
+	u32* sortedIndices = malloc(indexCount * sizeof(sortedIndices[0]));
+
+	// NOTE: Every triangle may end up alone, so this is the most clusters there can be
+	*clusters = malloc(triangleCount * sizeof((*clusters)[0]));
+
+	b8 result = builder.TriangleOffsets && builder.Triangles && builder.Emitted && builder.VertexClusters && sortedIndices && *clusters;
+	if (result) {
+		for (u64 i = 0; i < indexCount; i++) {
+			builder.TriangleOffsets[indices[i] + 1]++;
+		}
+		for (u64 i = 0; i < vertexCount; i++) {
+			builder.TriangleOffsets[i + 1] += builder.TriangleOffsets[i];
+		}
+		for (u64 i = 0; i < indexCount; i++) {
+			builder.Triangles[builder.TriangleOffsets[indices[i]]++] = cast(u32) (i / 3);
+		}
+		for (u64 i = vertexCount; i > 0; i--) {
+			builder.TriangleOffsets[i] = builder.TriangleOffsets[i - 1];
+		}
+		builder.TriangleOffsets[0] = 0;
+
+		memset(builder.VertexClusters, 0xFF, vertexCount * sizeof(builder.VertexClusters[0]));
+
+		u64 emittedIndexCount = 0;
+		u64 seed = 0;
+		while (emittedIndexCount < indexCount) {
+			while (builder.Emitted[seed]) {
+				seed++;
+			}
+
+			u32 cluster = cast(u32) *clusterCount;
+			builder.VertexCount = 0;
+			builder.TriangleCount = 0;
+
+			u32* clusterIndices = &sortedIndices[emittedIndexCount];
+			MeshClusterBuilder_AddTriangle(&builder, cast(u32) seed, cluster, &clusterIndices[0]);
+			while (builder.TriangleCount < MESH_CLUSTER_MAX_TRIANGLES) {
+				u32 triangle = MeshClusterBuilder_FindNeighbour(&builder, cluster);
+				if (triangle == ~0u) {
+					break;
+				}
+				MeshClusterBuilder_AddTriangle(&builder, triangle, cluster, &clusterIndices[builder.TriangleCount * 3]);
+			}
+
+			MeshCluster* meshCluster = &(*clusters)[(*clusterCount)++];
+			*meshCluster = (MeshCluster){
+				.IndexOffset = cast(u32) emittedIndexCount,
+				.IndexCount = builder.TriangleCount * 3,
+			};
+			MeshClusterBuilder_ComputeBounds(&builder, meshCluster, clusterIndices);
+
+			emittedIndexCount += builder.TriangleCount * 3;
+		}
+
+		memcpy(indices, sortedIndices, indexCount * sizeof(indices[0]));
+
+		MeshCluster* shrunk = realloc(*clusters, *clusterCount * sizeof((*clusters)[0]));
+		if (shrunk) {
+			*clusters = shrunk;
+		}
+	}
+
+	free(builder.TriangleOffsets);
+	free(builder.Triangles);
+	free(builder.Emitted);
+	free(builder.VertexClusters);
+	free(sortedIndices);
+
+	if (!result) {
+		free(*clusters);
+		*clusters = NULL;
+	}
+	return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+
+#define MESH_CLUSTER_MAX_VERTICES 64
+#define MESH_CLUSTER_MAX_TRIANGLES 124
+
+// NOTE: Matches the std430 Cluster struct in cluster_cull.comp.glsl. A cluster is a contiguous range of the mesh index buffer,
+// so it is drawn with a plain indexed draw
+typedef struct MeshCluster_t {
+	Vector3 Center; // Object space bounding sphere
+	f32 Radius;
+	Vector3 ConeAxis; // Average facing of the triangles
+	f32 ConeCutoff;   // The cluster faces away from any viewer where dot(center - viewer, ConeAxis) >= ConeCutoff * |center - viewer| + Radius, 1 when it never does
+	u32 IndexOffset;
+	u32 IndexCount;
+	u32 Padding[2];
+} MeshCluster;
+
+STATIC_ASSERT(sizeof(MeshCluster) == 48, "MeshCluster must match the std430 layout");
+
+// NOTE: Reorders the triangles of indices so that every cluster is one contiguous range, growing each cluster over neighbouring
+// triangles until it has MESH_CLUSTER_MAX_VERTICES unique vertices or MESH_CLUSTER_MAX_TRIANGLES triangles.
+// *clusters is allocated with malloc and IndexOffset is relative to indices
+b8 MeshCluster_Build(
+	MeshCluster** clusters, u64* clusterCount,
+	u32* indices, u64 indexCount,
+	const Vector3* positions, u64 positionStride, u64 vertexCount
+);
@@ -0,0 +1,344 @@
+#include "MeshCodec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MESH_CODEC_HASH_BITS 14
+#define MESH_CODEC_MIN_MATCH 4
+#define MESH_CODEC_MAX_OFFSET 65535
+// NOTE: The filters are undone this many vertices at a time, so the transposed deltas are still in the cache when they are summed
+#define MESH_CODEC_BLOCK_VERTICES 256
+
+u64 MeshCodec_GetEncodeBound(u64 size) {
+	return size + size / 255 + 16;
+}
+
+// NOTE: A sequence is a token, the literals and then the match. The token holds the literal count in its high and the match
+// length minus MESH_CODEC_MIN_MATCH in its low four bits, 15 means more length bytes follow the token or the offset. The last
+// sequence has no match and ends the input
+static u8* MeshCodec_WriteLength(u8* output, u8* outputEnd, u64 length) {
+	while (length >= 255) {
+		if (output >= outputEnd) {
+			return NULL;
+		}
+		*output++ = 255;
+		length -= 255;
+	}
+
+	if (output >= outputEnd) {
+		return NULL;
+	}
+	*output++ = cast(u8) length;
+	return output;
+}
+
+static u8* MeshCodec_WriteSequence(u8* output, u8* outputEnd, const u8* literals, u64 literalCount, u64 offset, u64 matchLength) {
+	if (output >= outputEnd) {
+		return NULL;
+	}
+
+	u64 matchCode = matchLength > 0 ? matchLength - MESH_CODEC_MIN_MATCH : 0;
+	*output++ = cast(u8) (((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+	if (literalCount >= 15 && !(output = MeshCodec_WriteLength(output, outputEnd, literalCount - 15))) {
+		return NULL;
+	}
+
+	if (cast(u64) (outputEnd - output) < literalCount) {
+		return NULL;
+	}
+	memcpy(output, literals, literalCount);
+	output += literalCount;
+
+	if (matchLength == 0) {
+		return output;
+	}
+
+	if (outputEnd - output < 2) {
+		return NULL;
+	}
+	*output++ = cast(u8) offset;
+	*output++ = cast(u8) (offset >> 8);
+	if (matchCode >= 15 && !(output = MeshCodec_WriteLength(output, outputEnd, matchCode - 15))) {
+		return NULL;
+	}
+	return output;
+}
+
+static u32 MeshCodec_Read32(const u8* data) {
+	u32 value = 0;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+u64 MeshCodec_Compress(u8* output, u64 outputCapacity, const void* input, u64 size) {
+	u32* table = calloc(1 << MESH_CODEC_HASH_BITS, sizeof(table[0]));
+	if (!table) {
+		return 0;
+	}
+
+	const u8* source = input;
+	u8* write = output;
+	u8* outputEnd = output + outputCapacity;
+	u64 anchor = 0;
+	u64 position = 0;
+
+	// NOTE: Greedy, every position is looked up in a hash table of the last position with the same four bytes. Positions are
+	// skipped faster the longer no match was found, which keeps incompressible data from being slow to encode
+	while (write && size >= MESH_CODEC_MIN_MATCH && position <= size - MESH_CODEC_MIN_MATCH) {
+		u32 sequence = MeshCodec_Read32(source + position);
+		u32 hash = (sequence * 2654435761u) >> (32 - MESH_CODEC_HASH_BITS);
+		u64 candidate = table[hash];
+		table[hash] = cast(u32) position;
+
+		if (candidate >= position || position - candidate > MESH_CODEC_MAX_OFFSET || MeshCodec_Read32(source + candidate) != sequence) {
+			position += 1 + ((position - anchor) >> 6);
+			continue;
+		}
+
+		u64 length = MESH_CODEC_MIN_MATCH;
+		while (position + length < size && source[candidate + length] == source[position + length]) {
+			length++;
+		}
+
+		write = MeshCodec_WriteSequence(write, outputEnd, source + anchor, position - anchor, position - candidate, length);
+		position += length;
+		anchor = position;
+	}
+
+	if (write) {
+		write = MeshCodec_WriteSequence(write, outputEnd, source + anchor, size - anchor, 0, 0);
+	}
+
+	free(table);
+	return write ? cast(u64) (write - output) : 0;
+}
+
+static b8 MeshCodec_ReadLength(const u8** input, const u8* inputEnd, u64* length) {
+	u8 byte = 255;
+	while (byte == 255) {
+		if (*input >= inputEnd) {
+			return false;
+		}
+		byte = *(*input)++;
+		*length += byte;
+	}
+	return true;
+}
+
+b8 MeshCodec_Decompress(void* output, u64 size, const u8* input, u64 inputSize) {
+	u8* write = output;
+	u8* outputEnd = write + size;
+	const u8* inputEnd = input + inputSize;
+
+	while (input < inputEnd) {
+		u8 token = *input++;
+
+		u64 literalCount = token >> 4;
+		if (literalCount == 15 && !MeshCodec_ReadLength(&input, inputEnd, &literalCount)) {
+			return false;
+		}
+		if (literalCount > cast(u64) (inputEnd - input) || literalCount > cast(u64) (outputEnd - write)) {
+			return false;
+		}
+		memcpy(write, input, literalCount);
+		write += literalCount;
+		input += literalCount;
+
+		if (input == inputEnd) {
+			break;
+		}
+
+		if (inputEnd - input < 2) {
+			return false;
+		}
+		u64 offset = input[0] | (cast(u64) input[1] << 8);
+		input += 2;
+
+		u64 length = (token & 15) + MESH_CODEC_MIN_MATCH;
+		if ((token & 15) == 15 && !MeshCodec_ReadLength(&input, inputEnd, &length)) {
+			return false;
+		}
+		if (offset == 0 || offset > cast(u64) (write - cast(u8*) output) || length > cast(u64) (outputEnd - write)) {
+			return false;
+		}
+
+		// NOTE: A match closer than its length repeats itself, every copy doubles the part that can be copied at once
+		const u8* match = write - offset;
+		while (length > 0) {
+			u64 count = cast(u64) (write - match) < length ? cast(u64) (write - match) : length;
+			memcpy(write, match, count);
+			write += count;
+			length -= count;
+		}
+	}
+
+	return write == outputEnd;
+}
+
+u64 MeshCodec_EncodeIndices(u8* output, u64 outputCapacity, const u32* indices, u64 indexCount) {
+	u8* planes = malloc(indexCount * sizeof(indices[0]));
+	if (indexCount > 0 && !planes) {
+		return 0;
+	}
+
+	u32 previous = 0;
+	for (u64 i = 0; i < indexCount; i++) {
+		s32 delta = cast(s32) (indices[i] - previous);
+		u32 zigzag = (cast(u32) delta << 1) ^ cast(u32) (delta >> 31);
+		previous = indices[i];
+
+		for (u32 j = 0; j < sizeof(indices[0]); j++) {
+			planes[j * indexCount + i] = cast(u8) (zigzag >> (j * 8));
+		}
+	}
+
+	u64 result = MeshCodec_Compress(output, outputCapacity, planes, indexCount * sizeof(indices[0]));
+	free(planes);
+	return result;
+}
+
+b8 MeshCodec_DecodeIndices(u32* indices, u64 indexCount, const u8* input, u64 inputSize) {
+	u8* planes = malloc(indexCount * sizeof(indices[0]));
+	if (indexCount > 0 && !planes) {
+		return false;
+	}
+
+	if (!MeshCodec_Decompress(planes, indexCount * sizeof(indices[0]), input, inputSize)) {
+		free(planes);
+		return false;
+	}
+
+	const u8* plane0 = planes;
+	const u8* plane1 = planes + indexCount;
+	const u8* plane2 = planes + indexCount * 2;
+	const u8* plane3 = planes + indexCount * 3;
+	for (u64 i = 0; i < indexCount; i++) {
+		u32 zigzag = plane0[i] | (cast(u32) plane1[i] << 8) | (cast(u32) plane2[i] << 16) | (cast(u32) plane3[i] << 24);
+		indices[i] = (zigzag >> 1) ^ (0u - (zigzag & 1));
+	}
+
+	// NOTE: The only serial part, one add per index
+	u32 previous = 0;
+	for (u64 i = 0; i < indexCount; i++) {
+		previous += indices[i];
+		indices[i] = previous;
+	}
+
+	free(planes);
+	return true;
+}
+
+u64 MeshCodec_EncodeVertices(u8* output, u64 outputCapacity, const void* vertices, u64 vertexCount, u64 vertexSize) {
+	u64 size = vertexCount * vertexSize;
+	u8* planes = malloc(size);
+	if (size > 0 && !planes) {
+		return 0;
+	}
+
+	const u8* source = vertices;
+	for (u64 j = 0; j < vertexSize; j++) {
+		u8* plane = planes + j * vertexCount;
+		u8 previous = 0;
+		for (u64 i = 0; i < vertexCount; i++) {
+			u8 byte = source[i * vertexSize + j];
+			plane[i] = cast(u8) (byte - previous);
+			previous = byte;
+		}
+	}
+
+	u64 result = MeshCodec_Compress(output, outputCapacity, planes, size);
+	free(planes);
+	return result;
+}
+
+// NOTE: Bytewise add of eight lanes, the carries are kept out of the neighbouring bytes
+static u64 MeshCodec_AddBytes(u64 a, u64 b) {
+	const u64 Low = 0x7f7f7f7f7f7f7f7full;
+	const u64 High = 0x8080808080808080ull;
+	return ((a & Low) + (b & Low)) ^ ((a ^ b) & High);
+}
+
+// NOTE: Transposes eight rows of eight bytes, byte k of rows[r] becomes byte r of rows[k]
+static void MeshCodec_Transpose8x8(u64 rows[8]) {
+	for (u32 r = 0; r < 8; r += 2) {
+		u64 t = ((rows[r] >> 8) ^ rows[r + 1]) & 0x00ff00ff00ff00ffull;
+		rows[r + 1] ^= t;
+		rows[r] ^= t << 8;
+	}
+	for (u32 r = 0; r < 8; r += (r & 1) ? 3 : 1) {
+		u64 t = ((rows[r] >> 16) ^ rows[r + 2]) & 0x0000ffff0000ffffull;
+		rows[r + 2] ^= t;
+		rows[r] ^= t << 16;
+	}
+	for (u32 r = 0; r < 4; r++) {
+		u64 t = ((rows[r] >> 32) ^ rows[r + 4]) & 0x00000000ffffffffull;
+		rows[r + 4] ^= t;
+		rows[r] ^= t << 32;
+	}
+}
+
+b8 MeshCodec_DecodeVertices(void* vertices, u64 vertexCount, u64 vertexSize, const u8* input, u64 inputSize) {
+	u64 size = vertexCount * vertexSize;
+	u8* planes = malloc(size);
+	if (size > 0 && !planes) {
+		return false;
+	}
+
+	if (!MeshCodec_Decompress(planes, size, input, inputSize)) {
+		free(planes);
+		return false;
+	}
+
+	// NOTE: Eight planes and eight vertices at a time are transposed in registers and added onto the previous vertex, which
+	// Running keeps per group of eight planes. The planes past the last whole group and the vertices past the last whole eight
+	// are summed one byte at a time
+	u8* output = vertices;
+	u64 groupCount = vertexSize / 8;
+	u64 wideCount = vertexCount / 8 * 8;
+	u64* running = calloc(groupCount > 0 ? groupCount : 1, sizeof(running[0]));
+	if (!running) {
+		free(planes);
+		return false;
+	}
+
+	for (u64 begin = 0; begin < wideCount; begin += MESH_CODEC_BLOCK_VERTICES) {
+		u64 end = begin + MESH_CODEC_BLOCK_VERTICES < wideCount ? begin + MESH_CODEC_BLOCK_VERTICES : wideCount;
+
+		for (u64 group = 0; group < groupCount; group++) {
+			u64 previous = running[group];
+			for (u64 i = begin; i < end; i += 8) {
+				u64 rows[8];
+				for (u32 r = 0; r < 8; r++) {
+					memcpy(&rows[r], planes + (group * 8 + r) * vertexCount + i, sizeof(rows[r]));
+				}
+				MeshCodec_Transpose8x8(rows);
+
+				for (u32 k = 0; k < 8; k++) {
+					previous = MeshCodec_AddBytes(previous, rows[k]);
+					memcpy(output + (i + k) * vertexSize + group * 8, &previous, sizeof(previous));
+				}
+			}
+			running[group] = previous;
+		}
+
+		for (u64 j = groupCount * 8; j < vertexSize; j++) {
+			const u8* plane = planes + j * vertexCount;
+			u8 previous = begin > 0 ? output[(begin - 1) * vertexSize + j] : 0;
+			for (u64 i = begin; i < end; i++) {
+				previous = cast(u8) (previous + plane[i]);
+				output[i * vertexSize + j] = previous;
+			}
+		}
+	}
+
+	for (u64 i = wideCount; i < vertexCount; i++) {
+		for (u64 j = 0; j < vertexSize; j++) {
+			u8 previous = i > 0 ? output[(i - 1) * vertexSize + j] : 0;
+			output[i * vertexSize + j] = cast(u8) (previous + planes[j * vertexCount + i]);
+		}
+	}
+
+	free(running);
+	free(planes);
+	return true;
+}
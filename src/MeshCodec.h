@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Typedefs.h"
+
+// NOTE: Lossless encoding for mesh data. Indices are stored as zigzagged deltas to the previous index and vertices as byte wise
+// deltas to the previous vertex, both split into byte planes so the bytes that barely change end up next to each other. The planes
+// are then compressed with a small LZ77 coder whose decoder is mostly memcpy. The filters are undone with branchless loops over
+// contiguous bytes that the compiler vectorizes
+//
+// Every encode function returns the encoded size, or 0 when the output did not fit into outputCapacity.
+// MeshCodec_GetEncodeBound is always enough
+
+u64 MeshCodec_GetEncodeBound(u64 size);
+
+u64 MeshCodec_Compress(u8* output, u64 outputCapacity, const void* input, u64 size);
+// NOTE: Fails unless the input decodes to exactly size bytes
+b8 MeshCodec_Decompress(void* output, u64 size, const u8* input, u64 inputSize);
+
+u64 MeshCodec_EncodeIndices(u8* output, u64 outputCapacity, const u32* indices, u64 indexCount);
+b8 MeshCodec_DecodeIndices(u32* indices, u64 indexCount, const u8* input, u64 inputSize);
+
+u64 MeshCodec_EncodeVertices(u8* output, u64 outputCapacity, const void* vertices, u64 vertexCount, u64 vertexSize);
+b8 MeshCodec_DecodeVertices(void* vertices, u64 vertexCount, u64 vertexSize, const u8* input, u64 inputSize);
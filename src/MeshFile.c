@@ -0,0 +1,490 @@
+#include "MeshFile.h"
+#include "MeshCodec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MESH_FILE_SECTION_ALIGNMENT 16
+#define MESH_FILE_STRING_NONE (~0u)
+
+static const u8 MeshFileIdentifier[12] = { 0xAB, 'R', 'M', 'S', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+typedef enum MeshFileSection_t {
+	MeshFileSection_Vertices,
+	MeshFileSection_Indices,
+	MeshFileSection_Objects,
+	MeshFileSection_Clusters,
+	MeshFileSection_Materials,
+	MeshFileSection_Strings, // The material names and texture paths, null terminated
+	MeshFileSection_Count,
+} MeshFileSection;
+
+typedef enum MeshFileEncoding_t {
+	MeshFileEncoding_Raw,
+	MeshFileEncoding_Compressed, // MeshCodec_Compress
+	MeshFileEncoding_Indices,    // MeshCodec_EncodeIndices
+	MeshFileEncoding_Vertices,   // MeshCodec_EncodeVertices with sizeof(Vertex)
+} MeshFileEncoding;
+
+// NOTE: Everything is little endian, the section index follows the header and the sections follow the index
+typedef struct MeshFileHeader_t {
+	u8 Identifier[12];
+	u32 SectionCount;
+	u64 SourceHash;
+	u64 VertexCount;
+	u64 IndexCount;
+	u64 ObjectCount;
+	u64 ClusterCount;
+	u64 MaterialCount;
+} MeshFileHeader;
+
+typedef struct MeshFileSectionIndex_t {
+	u64 Offset; // From the start of the file
+	u64 Size;   // In the file
+	u64 DecodedSize;
+	u32 Encoding;
+	u32 Reserved;
+} MeshFileSectionIndex;
+
+typedef struct MeshFileMaterial_t {
+	Vector3 Ka;
+	Vector3 Kd;
+	Vector3 Ks;
+	Vector3 Ke;
+	Vector3 Kt;
+	f32 Ns;
+	f32 Ni;
+	Vector3 Tf;
+	Vector3 d;
+	s32 illum;
+	u32 NameOffset;       // Into the string section
+	u32 DiffuseMapOffset; // MESH_FILE_STRING_NONE without a map_Kd
+} MeshFileMaterial;
+
+STATIC_ASSERT(sizeof(MeshFileHeader) == 64, "The mesh file header must not contain padding");
+STATIC_ASSERT(sizeof(MeshFileSectionIndex) == 32, "The mesh file section index must not contain padding");
+STATIC_ASSERT(sizeof(MeshFileMaterial) == 104, "The mesh file material must not contain padding");
+// NOTE: Vertices and objects are stored as they are in memory, a change to either has to change MeshFileIdentifier
+STATIC_ASSERT(sizeof(Vertex) == 36, "The mesh file vertex layout changed");
+STATIC_ASSERT(sizeof(MeshObject) == 184, "The mesh file object layout changed");
+STATIC_ASSERT(sizeof(MeshCluster) == 48, "The mesh file cluster layout changed");
+
+static u64 AlignUp(u64 value, u64 alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static u32 MeshFile_AddString(char* strings, u64* stringsSize, const char* string) {
+	if (!string) {
+		return MESH_FILE_STRING_NONE;
+	}
+
+	u64 length = strlen(string) + 1;
+	u32 offset = cast(u32) *stringsSize;
+	if (strings) {
+		memcpy(strings + offset, string, length);
+	}
+	*stringsSize += length;
+	return offset;
+}
+
+// NOTE: Returns the encoded size, or 0 when the section is stored raw because encoding did not make it smaller
+static u64 MeshFile_EncodeSection(u8** encoded, MeshFileEncoding* encoding, MeshFileSection section, const void* data, u64 size) {
+	*encoded = NULL;
+	*encoding = MeshFileEncoding_Raw;
+	if (size == 0) {
+		return 0;
+	}
+
+	u64 capacity = MeshCodec_GetEncodeBound(size);
+	u8* output = malloc(capacity);
+	if (!output) {
+		return 0;
+	}
+
+	u64 encodedSize = 0;
+	switch (section) {
+		case MeshFileSection_Vertices: {
+			*encoding = MeshFileEncoding_Vertices;
+			encodedSize = MeshCodec_EncodeVertices(output, capacity, data, size / sizeof(Vertex), sizeof(Vertex));
+		} break;
+
+		case MeshFileSection_Indices: {
+			*encoding = MeshFileEncoding_Indices;
+			encodedSize = MeshCodec_EncodeIndices(output, capacity, data, size / sizeof(u32));
+		} break;
+
+		default: {
+			*encoding = MeshFileEncoding_Compressed;
+			encodedSize = MeshCodec_Compress(output, capacity, data, size);
+		} break;
+	}
+
+	if (encodedSize == 0 || encodedSize >= size) {
+		free(output);
+		*encoding = MeshFileEncoding_Raw;
+		return 0;
+	}
+	*encoded = output;
+	return encodedSize;
+}
+
+b8 MeshFile_Save(const Mesh* mesh, const ObjMaterial* materials, u64 materialCount, u64 sourceHash, b8 compress, const char* filepath) {
+	// NOTE: The first pass only measures the strings
+	u64 stringsSize = 0;
+	for (u64 i = 0; i < materialCount; i++) {
+		MeshFile_AddString(NULL, &stringsSize, materials[i].Name ? materials[i].Name : "");
+		MeshFile_AddString(NULL, &stringsSize, materials[i].DiffuseMap);
+	}
+	if (stringsSize >= MESH_FILE_STRING_NONE) {
+		return false;
+	}
+
+	MeshFileMaterial* fileMaterials = malloc(materialCount * sizeof(fileMaterials[0]));
+	char* strings = malloc(stringsSize);
+	MeshObject* fileObjects = calloc(mesh->ObjectCount, sizeof(fileObjects[0]));
+	MeshCluster* fileClusters = malloc(mesh->ClusterCount * sizeof(fileClusters[0]));
+	if ((materialCount > 0 && !fileMaterials) || (stringsSize > 0 && !strings) ||
+		(mesh->ObjectCount > 0 && !fileObjects) || (mesh->ClusterCount > 0 && !fileClusters)
+	) {
+		free(fileMaterials);
+		free(strings);
+		free(fileObjects);
+		free(fileClusters);
+		return false;
+	}
+
+	// NOTE: The padding is zeroed so cooking the same source always writes the same bytes
+	for (u64 i = 0; i < mesh->ObjectCount; i++) {
+		const MeshObject* object = &mesh->Objects[i];
+		fileObjects[i].Center = object->Center;
+		fileObjects[i].Radius = object->Radius;
+		fileObjects[i].LodCount = object->LodCount;
+		for (u32 j = 0; j < MESH_MAX_LODS; j++) {
+			fileObjects[i].Lods[j].IndexOffset = object->Lods[j].IndexOffset;
+			fileObjects[i].Lods[j].IndexCount = object->Lods[j].IndexCount;
+			fileObjects[i].Lods[j].ClusterOffset = object->Lods[j].ClusterOffset;
+			fileObjects[i].Lods[j].ClusterCount = object->Lods[j].ClusterCount;
+			fileObjects[i].Lods[j].Error = object->Lods[j].Error;
+		}
+	}
+	for (u64 i = 0; i < mesh->ClusterCount; i++) {
+		fileClusters[i] = mesh->Clusters[i];
+		memset(fileClusters[i].Padding, 0, sizeof(fileClusters[i].Padding));
+	}
+
+	stringsSize = 0;
+	for (u64 i = 0; i < materialCount; i++) {
+		const ObjMaterial* material = &materials[i];
+		fileMaterials[i] = (MeshFileMaterial){
+			.Ka = material->Ka,
+			.Kd = material->Kd,
+			.Ks = material->Ks,
+			.Ke = material->Ke,
+			.Kt = material->Kt,
+			.Ns = material->Ns,
+			.Ni = material->Ni,
+			.Tf = material->Tf,
+			.d = material->d,
+			.illum = material->illum,
+			.NameOffset = MeshFile_AddString(strings, &stringsSize, material->Name ? material->Name : ""),
+			.DiffuseMapOffset = MeshFile_AddString(strings, &stringsSize, material->DiffuseMap),
+		};
+	}
+
+	const void* sections[MeshFileSection_Count] = {
+		[MeshFileSection_Vertices] = mesh->Vertices,
+		[MeshFileSection_Indices] = mesh->Indices,
+		[MeshFileSection_Objects] = fileObjects,
+		[MeshFileSection_Clusters] = fileClusters,
+		[MeshFileSection_Materials] = fileMaterials,
+		[MeshFileSection_Strings] = strings,
+	};
+	u64 sectionSizes[MeshFileSection_Count] = {
+		[MeshFileSection_Vertices] = mesh->VertexCount * sizeof(mesh->Vertices[0]),
+		[MeshFileSection_Indices] = mesh->IndexCount * sizeof(mesh->Indices[0]),
+		[MeshFileSection_Objects] = mesh->ObjectCount * sizeof(mesh->Objects[0]),
+		[MeshFileSection_Clusters] = mesh->ClusterCount * sizeof(mesh->Clusters[0]),
+		[MeshFileSection_Materials] = materialCount * sizeof(fileMaterials[0]),
+		[MeshFileSection_Strings] = stringsSize,
+	};
+
+	MeshFileHeader header = {
+		.SectionCount = MeshFileSection_Count,
+		.SourceHash = sourceHash,
+		.VertexCount = mesh->VertexCount,
+		.IndexCount = mesh->IndexCount,
+		.ObjectCount = mesh->ObjectCount,
+		.ClusterCount = mesh->ClusterCount,
+		.MaterialCount = materialCount,
+	};
+	memcpy(header.Identifier, MeshFileIdentifier, sizeof(MeshFileIdentifier));
+
+	MeshFileSectionIndex index[MeshFileSection_Count] = {};
+	u8* encodedSections[MeshFileSection_Count] = {};
+	u64 offset = sizeof(header) + sizeof(index);
+	for (u32 i = 0; i < MeshFileSection_Count; i++) {
+		MeshFileEncoding encoding = MeshFileEncoding_Raw;
+		u64 encodedSize = compress ? MeshFile_EncodeSection(&encodedSections[i], &encoding, i, sections[i], sectionSizes[i]) : 0;
+		if (encodedSections[i]) {
+			sections[i] = encodedSections[i];
+		}
+
+		offset = AlignUp(offset, MESH_FILE_SECTION_ALIGNMENT);
+		index[i] = (MeshFileSectionIndex){
+			.Offset = offset,
+			.Size = encodedSections[i] ? encodedSize : sectionSizes[i],
+			.DecodedSize = sectionSizes[i],
+			.Encoding = encoding,
+		};
+		offset += index[i].Size;
+	}
+
+	FILE* output = fopen(filepath, "wb");
+	b8 result = output != NULL &&
+		fwrite(&header, sizeof(header), 1, output) == 1 &&
+		fwrite(index, sizeof(index), 1, output) == 1;
+
+	static const u8 Padding[MESH_FILE_SECTION_ALIGNMENT] = {};
+	u64 position = sizeof(header) + sizeof(index);
+	for (u32 i = 0; result && i < MeshFileSection_Count; i++) {
+		u64 paddingSize = index[i].Offset - position;
+		result = fwrite(Padding, 1, paddingSize, output) == paddingSize &&
+			(index[i].Size == 0 || fwrite(sections[i], 1, index[i].Size, output) == index[i].Size);
+		position = index[i].Offset + index[i].Size;
+	}
+
+	for (u32 i = 0; i < MeshFileSection_Count; i++) {
+		free(encodedSections[i]);
+	}
+	free(fileMaterials);
+	free(strings);
+	free(fileObjects);
+	free(fileClusters);
+	if (output) {
+		result = fclose(output) == 0 && result;
+	}
+	return result;
+}
+
+static b8 MeshFile_DecodeSection(void** destination, const u8* data, const MeshFileSectionIndex* section, u64 expectedSize) {
+	if (section->DecodedSize != expectedSize) {
+		return false;
+	}
+	if (expectedSize == 0) {
+		return true;
+	}
+
+	*destination = malloc(expectedSize);
+	if (!*destination) {
+		return false;
+	}
+
+	const u8* input = data + section->Offset;
+	switch (section->Encoding) {
+		case MeshFileEncoding_Raw: {
+			if (section->Size != expectedSize) {
+				return false;
+			}
+			memcpy(*destination, input, expectedSize);
+			return true;
+		}
+
+		case MeshFileEncoding_Compressed: return MeshCodec_Decompress(*destination, expectedSize, input, section->Size);
+
+		case MeshFileEncoding_Indices: {
+			return expectedSize % sizeof(u32) == 0 &&
+				MeshCodec_DecodeIndices(*destination, expectedSize / sizeof(u32), input, section->Size);
+		}
+
+		case MeshFileEncoding_Vertices: {
+			return expectedSize % sizeof(Vertex) == 0 &&
+				MeshCodec_DecodeVertices(*destination, expectedSize / sizeof(Vertex), sizeof(Vertex), input, section->Size);
+		}
+
+		default: return false;
+	}
+}
+
+static char* MeshFile_CopyString(StringArena* arena, const char* strings, u64 stringsSize, u32 offset) {
+	if (offset >= stringsSize) {
+		return NULL;
+	}
+
+	const char* terminator = memchr(strings + offset, '\0', stringsSize - offset);
+	if (!terminator) {
+		return NULL;
+	}
+	return StringArena_Add(arena, strings + offset, terminator - (strings + offset));
+}
+
+b8 MeshFile_LoadFromMemory(MeshFile* file, const u8* data, u64 size) {
+	*file = (MeshFile){};
+
+	MeshFileHeader header = {};
+	MeshFileSectionIndex index[MeshFileSection_Count] = {};
+	if (size < sizeof(header) + sizeof(index)) {
+		return false;
+	}
+
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.Identifier, MeshFileIdentifier, sizeof(MeshFileIdentifier)) != 0 ||
+		header.SectionCount != MeshFileSection_Count ||
+		header.VertexCount > ~0u || header.IndexCount > ~0u
+	) {
+		return false;
+	}
+
+	memcpy(index, data + sizeof(header), sizeof(index));
+	for (u32 i = 0; i < MeshFileSection_Count; i++) {
+		if (index[i].Offset > size || index[i].Size > size - index[i].Offset) {
+			return false;
+		}
+	}
+
+	// NOTE: The counts are checked against the section sizes before anything is multiplied with them
+	if (header.MaterialCount > index[MeshFileSection_Materials].DecodedSize / sizeof(MeshFileMaterial) ||
+		header.VertexCount > index[MeshFileSection_Vertices].DecodedSize / sizeof(Vertex) ||
+		header.IndexCount > index[MeshFileSection_Indices].DecodedSize / sizeof(u32) ||
+		header.ObjectCount > index[MeshFileSection_Objects].DecodedSize / sizeof(MeshObject) ||
+		header.ClusterCount > index[MeshFileSection_Clusters].DecodedSize / sizeof(MeshCluster)
+	) {
+		return false;
+	}
+
+	Mesh* mesh = &file->Mesh;
+	mesh->VertexCount = header.VertexCount;
+	mesh->IndexCount = header.IndexCount;
+	mesh->ObjectCount = header.ObjectCount;
+	mesh->ClusterCount = header.ClusterCount;
+	file->SourceHash = header.SourceHash;
+
+	MeshFileMaterial* fileMaterials = NULL;
+	char* strings = NULL;
+	u64 stringsSize = index[MeshFileSection_Strings].DecodedSize;
+	b8 result = MeshFile_DecodeSection(cast(void**) &mesh->Vertices, data, &index[MeshFileSection_Vertices], mesh->VertexCount * sizeof(mesh->Vertices[0])) &&
+		MeshFile_DecodeSection(cast(void**) &mesh->Indices, data, &index[MeshFileSection_Indices], mesh->IndexCount * sizeof(mesh->Indices[0])) &&
+		MeshFile_DecodeSection(cast(void**) &mesh->Objects, data, &index[MeshFileSection_Objects], mesh->ObjectCount * sizeof(mesh->Objects[0])) &&
+		MeshFile_DecodeSection(cast(void**) &mesh->Clusters, data, &index[MeshFileSection_Clusters], mesh->ClusterCount * sizeof(mesh->Clusters[0])) &&
+		MeshFile_DecodeSection(cast(void**) &fileMaterials, data, &index[MeshFileSection_Materials], header.MaterialCount * sizeof(fileMaterials[0])) &&
+		MeshFile_DecodeSection(cast(void**) &strings, data, &index[MeshFileSection_Strings], stringsSize);
+
+	// NOTE: Everything the renderer indexes with has to stay inside the buffers. The material table keeps one material
+	// even when the mesh has none
+	for (u64 i = 0; result && i < mesh->IndexCount; i++) {
+		result = mesh->Indices[i] < mesh->VertexCount;
+	}
+	u64 gpuMaterialCount = header.MaterialCount > 0 ? header.MaterialCount : 1;
+	for (u64 i = 0; result && i < mesh->VertexCount; i++) {
+		result = mesh->Vertices[i].MaterialIndex < gpuMaterialCount;
+	}
+	for (u64 i = 0; result && i < mesh->ObjectCount; i++) {
+		const MeshObject* object = &mesh->Objects[i];
+		result = object->LodCount > 0 && object->LodCount <= MESH_MAX_LODS;
+		for (u32 j = 0; result && j < object->LodCount; j++) {
+			const MeshLod* lod = &object->Lods[j];
+			result = lod->IndexOffset <= mesh->IndexCount && lod->IndexCount <= mesh->IndexCount - lod->IndexOffset &&
+				lod->ClusterOffset <= mesh->ClusterCount && lod->ClusterCount <= mesh->ClusterCount - lod->ClusterOffset;
+		}
+	}
+	for (u64 i = 0; result && i < mesh->ClusterCount; i++) {
+		const MeshCluster* cluster = &mesh->Clusters[i];
+		result = cluster->IndexOffset <= mesh->IndexCount && cluster->IndexCount <= mesh->IndexCount - cluster->IndexOffset;
+	}
+
+	if (result && header.MaterialCount > 0) {
+		file->Materials = calloc(header.MaterialCount, sizeof(file->Materials[0]));
+		result = file->Materials != NULL;
+	}
+	if (result) {
+		file->MaterialCount = header.MaterialCount;
+	}
+
+	for (u64 i = 0; result && i < file->MaterialCount; i++) {
+		MeshFileMaterial material = fileMaterials[i];
+
+		file->Materials[i] = (ObjMaterial){
+			.Name = MeshFile_CopyString(&file->Strings, strings, stringsSize, material.NameOffset),
+			.Ka = material.Ka,
+			.Kd = material.Kd,
+			.Ks = material.Ks,
+			.Ke = material.Ke,
+			.Kt = material.Kt,
+			.Ns = material.Ns,
+			.Ni = material.Ni,
+			.Tf = material.Tf,
+			.d = material.d,
+			.illum = material.illum,
+		};
+		result = file->Materials[i].Name != NULL;
+
+		if (result && material.DiffuseMapOffset != MESH_FILE_STRING_NONE) {
+			file->Materials[i].DiffuseMap = MeshFile_CopyString(&file->Strings, strings, stringsSize, material.DiffuseMapOffset);
+			result = file->Materials[i].DiffuseMap != NULL;
+		}
+	}
+
+	free(fileMaterials);
+	free(strings);
+	if (!result) {
+		MeshFile_Destroy(file);
+	}
+
+	return result;
+}
+
+b8 MeshFile_Load(MeshFile* file, const char* filepath) {
+	*file = (MeshFile){};
+
+	FILE* input = fopen(filepath, "rb");
+	if (!input) {
+		return false;
+	}
+
+	fseek(input, 0, SEEK_END);
+	u64 size = ftell(input);
+	fseek(input, 0, SEEK_SET);
+
+	if (size == 0) {
+		fclose(input);
+		return false;
+	}
+
+	u8* data = malloc(size);
+	if (!data) {
+		fclose(input);
+		return false;
+	}
+
+	size = fread(data, 1, size, input);
+	fclose(input);
+
+	b8 result = MeshFile_LoadFromMemory(file, data, size);
+	free(data);
+	return result;
+}
+
+b8 MeshFile_ReadSourceHash(const char* filepath, u64* sourceHash) {
+	FILE* input = fopen(filepath, "rb");
+	if (!input) {
+		return false;
+	}
+
+	MeshFileHeader header = {};
+	b8 result = fread(&header, sizeof(header), 1, input) == 1 &&
+		memcmp(header.Identifier, MeshFileIdentifier, sizeof(MeshFileIdentifier)) == 0 &&
+		header.SectionCount == MeshFileSection_Count;
+	fclose(input);
+
+	if (result) {
+		*sourceHash = header.SourceHash;
+	}
+	return result;
+}
+
+void MeshFile_Destroy(MeshFile* file) {
+	Mesh_Destroy(&file->Mesh);
+	free(file->Materials);
+	StringArena_Destroy(&file->Strings);
+	*file = (MeshFile){};
+}
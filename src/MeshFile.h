@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Mesh.h"
+#include "ObjLoader.h"
+
+// NOTE: Cooked meshes are stored with their vertices, indices, objects and clusters in the layout the renderer uploads,
+// so loading one is a read and a few copies. The materials and their texture paths come along so the OBJ and MTL files
+// are not needed at all. With compress every section is stored encoded by MeshCodec when that makes it smaller, vertices
+// and indices with their filters and the rest with the plain compressor
+#define MESH_FILE_EXTENSION ".rmesh"
+
+typedef struct MeshFile_t {
+	Mesh Mesh;
+	ObjMaterial* Materials; // Name and DiffuseMap are interned in Strings, like the ones ObjMesh_Create loads
+	u64 MaterialCount;
+	StringArena Strings;
+	u64 SourceHash; // Of the OBJ and MTL files the mesh was cooked from
+} MeshFile;
+
+b8 MeshFile_Save(const Mesh* mesh, const ObjMaterial* materials, u64 materialCount, u64 sourceHash, b8 compress, const char* filepath);
+b8 MeshFile_Load(MeshFile* file, const char* filepath);
+b8 MeshFile_LoadFromMemory(MeshFile* file, const u8* data, u64 size);
+// NOTE: Only reads the header, returns false when filepath does not exist or is not a mesh file of this version
+b8 MeshFile_ReadSourceHash(const char* filepath, u64* sourceHash);
+void MeshFile_Destroy(MeshFile* file);
@@ -0,0 +1,297 @@
+#include "MeshSimplifier.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+static Vector3 Vector3_Subtract(Vector3 a, Vector3 b) {
+	return (Vector3){ a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+static Vector3 Vector3_Cross(Vector3 a, Vector3 b) {
+	return (Vector3){
+		a.y * b.z - a.z * b.y,
+		a.z * b.x - a.x * b.z,
+		a.x * b.y - a.y * b.x,
+	};
+}
+
+static f32 Vector3_Dot(Vector3 a, Vector3 b) {
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static void Quadric_AddPlane(Quadric* quadric, f64 a, f64 b, f64 c, f64 d, f64 weight) {
+	quadric->a2 += a * a * weight;
+	quadric->ab += a * b * weight;
+	quadric->ac += a * c * weight;
+	quadric->ad += a * d * weight;
+	quadric->b2 += b * b * weight;
+	quadric->bc += b * c * weight;
+	quadric->bd += b * d * weight;
+	quadric->c2 += c * c * weight;
+	quadric->cd += c * d * weight;
+	quadric->d2 += d * d * weight;
+	quadric->Weight += weight;
+}
+
+static void Quadric_Add(Quadric* quadric, const Quadric* other) {
+	quadric->a2 += other->a2;
+	quadric->ab += other->ab;
+	quadric->ac += other->ac;
+	quadric->ad += other->ad;
+	quadric->b2 += other->b2;
+	quadric->bc += other->bc;
+	quadric->bd += other->bd;
+	quadric->c2 += other->c2;
+	quadric->cd += other->cd;
+	quadric->d2 += other->d2;
+	quadric->Weight += other->Weight;
+}
+
+// NOTE: Weighted sum of the squared distances from p to the planes
+static f64 Quadric_Evaluate(const Quadric* q, Vector3 p) {
+	f64 x = p.x, y = p.y, z = p.z;
+	f64 error =
+		q->a2 * x * x + 2.0 * q->ab * x * y + 2.0 * q->ac * x * z + 2.0 * q->ad * x +
+		q->b2 * y * y + 2.0 * q->bc * y * z + 2.0 * q->bd * y +
+		q->c2 * z * z + 2.0 * q->cd * z +
+		q->d2;
+	return error > 0.0 ? error : 0.0;
+}
+
+b8 MeshSimplifier_Create(
+	MeshSimplifier* simplifier,
+	const Vector3* positions, u64 positionStride, u64 vertexCount,
+	const u8* locked,
+	const u32* indices, u64 indexCount
+) {
+	*simplifier = (MeshSimplifier){
+		.VertexCount = vertexCount,
+		.Locked = locked,
+		.IndexCount = indexCount,
+	};
+
+	ASSERT(indexCount % 3 == 0);
+	ASSERT(vertexCount < ~0u);
+
+	simplifier->Positions = malloc(vertexCount * sizeof(simplifier->Positions[0]));
+	simplifier->Indices = malloc(indexCount * sizeof(simplifier->Indices[0]));
+	simplifier->Quadrics = calloc(vertexCount, sizeof(simplifier->Quadrics[0]));
+	simplifier->TriangleOffsets = malloc((vertexCount + 1) * sizeof(simplifier->TriangleOffsets[0]));
+	simplifier->Triangles = malloc(indexCount * sizeof(simplifier->Triangles[0]));
+	simplifier->Collapses = malloc(vertexCount * sizeof(simplifier->Collapses[0]));
+	simplifier->Remap = malloc(vertexCount * sizeof(simplifier->Remap[0]));
+	simplifier->Touched = malloc(vertexCount * sizeof(simplifier->Touched[0]));
+	if ((vertexCount > 0 && (!simplifier->Positions || !simplifier->Quadrics || !simplifier->Collapses || !simplifier->Remap || !simplifier->Touched)) ||
+		(indexCount > 0 && (!simplifier->Indices || !simplifier->Triangles)) ||
+		!simplifier->TriangleOffsets
+	) {
+		MeshSimplifier_Destroy(simplifier);
+		return false;
+	}
+
+	for (u64 i = 0; i < vertexCount; i++) {
+		simplifier->Positions[i] = *cast(const Vector3*) (cast(const u8*) positions + i * positionStride);
+	}
+	memcpy(simplifier->Indices, indices, indexCount * sizeof(indices[0]));
+
+	for (u64 i = 0; i < indexCount; i += 3) {
+		Vector3 p0 = simplifier->Positions[indices[i + 0]];
+		Vector3 p1 = simplifier->Positions[indices[i + 1]];
+		Vector3 p2 = simplifier->Positions[indices[i + 2]];
+
+		Vector3 normal = Vector3_Cross(Vector3_Subtract(p1, p0), Vector3_Subtract(p2, p0));
+		f64 length = sqrt(cast(f64) Vector3_Dot(normal, normal));
+		if (length == 0.0) {
+			continue;
+		}
+
+		f64 a = normal.x / length;
+		f64 b = normal.y / length;
+		f64 c = normal.z / length;
+		f64 d = -(a * p0.x + b * p0.y + c * p0.z);
+		for (u32 j = 0; j < 3; j++) {
+			Quadric_AddPlane(&simplifier->Quadrics[indices[i + j]], a, b, c, d, length * 0.5);
+		}
+	}
+
+	return true;
+}
+
+void MeshSimplifier_Destroy(MeshSimplifier* simplifier) {
+	free(simplifier->Positions);
+	free(simplifier->Indices);
+	free(simplifier->Quadrics);
+	free(simplifier->TriangleOffsets);
+	free(simplifier->Triangles);
+	free(simplifier->Collapses);
+	free(simplifier->Remap);
+	free(simplifier->Touched);
+	*simplifier = (MeshSimplifier){};
+}
+
+// NOTE: Vertex to triangle adjacency in TriangleOffsets and Triangles
+static void MeshSimplifier_BuildAdjacency(MeshSimplifier* simplifier) {
+	u32* offsets = simplifier->TriangleOffsets;
+	memset(offsets, 0, (simplifier->VertexCount + 1) * sizeof(offsets[0]));
+
+	for (u64 i = 0; i < simplifier->IndexCount; i++) {
+		offsets[simplifier->Indices[i] + 1]++;
+	}
+
+	for (u64 i = 0; i < simplifier->VertexCount; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	// NOTE: Filling moves every offset to the start of the next vertex, shifting them back afterwards restores them
+	for (u64 i = 0; i < simplifier->IndexCount; i++) {
+		simplifier->Triangles[offsets[simplifier->Indices[i]]++] = cast(u32) (i / 3);
+	}
+
+	for (u64 i = simplifier->VertexCount; i > 0; i--) {
+		offsets[i] = offsets[i - 1];
+	}
+	offsets[0] = 0;
+}
+
+static void MeshSimplifier_ConsiderCollapse(MeshSimplifier* simplifier, u32 vertex, u32 target) {
+	if (simplifier->Locked && simplifier->Locked[vertex]) {
+		return;
+	}
+
+	Quadric quadric = simplifier->Quadrics[vertex];
+	Quadric_Add(&quadric, &simplifier->Quadrics[target]);
+
+	f64 cost = Quadric_Evaluate(&quadric, simplifier->Positions[target]);
+	if (quadric.Weight > 0.0) {
+		cost /= quadric.Weight;
+	}
+
+	if (cost < simplifier->Collapses[vertex].Cost) {
+		simplifier->Collapses[vertex].Cost = cast(f32) cost;
+		simplifier->Collapses[vertex].Target = target;
+	}
+}
+
+// NOTE: A collapse is rejected when it would flip any of the triangles that survive it
+static b8 MeshSimplifier_CanCollapse(MeshSimplifier* simplifier, u32 vertex, u32 target, u64* removedTriangles) {
+	*removedTriangles = 0;
+
+	for (u32 i = simplifier->TriangleOffsets[vertex]; i < simplifier->TriangleOffsets[vertex + 1]; i++) {
+		const u32* triangle = &simplifier->Indices[simplifier->Triangles[i] * 3];
+		if (triangle[0] == target || triangle[1] == target || triangle[2] == target) {
+			(*removedTriangles)++;
+			continue;
+		}
+
+		Vector3 before[3];
+		Vector3 after[3];
+		for (u32 j = 0; j < 3; j++) {
+			before[j] = simplifier->Positions[triangle[j]];
+			after[j] = triangle[j] == vertex ? simplifier->Positions[target] : before[j];
+		}
+
+		Vector3 normalBefore = Vector3_Cross(Vector3_Subtract(before[1], before[0]), Vector3_Subtract(before[2], before[0]));
+		Vector3 normalAfter = Vector3_Cross(Vector3_Subtract(after[1], after[0]), Vector3_Subtract(after[2], after[0]));
+		if (Vector3_Dot(normalBefore, normalAfter) <= 0.0f) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int MeshCollapse_Compare(const void* a, const void* b) {
+	f32 costA = (cast(const MeshCollapse*) a)->Cost;
+	f32 costB = (cast(const MeshCollapse*) b)->Cost;
+	return costA < costB ? -1 : costA > costB ? 1 : 0;
+}
+
+u64 MeshSimplifier_Reduce(MeshSimplifier* simplifier, u64 targetIndexCount) {
+	while (simplifier->IndexCount > targetIndexCount) {
+		MeshSimplifier_BuildAdjacency(simplifier);
+
+		// NOTE: Every vertex picks its cheapest edge, both directions of every edge are considered
+		for (u64 i = 0; i < simplifier->VertexCount; i++) {
+			simplifier->Collapses[i] = (MeshCollapse){ .Cost = FLT_MAX, .Vertex = cast(u32) i, .Target = ~0u };
+		}
+
+		for (u64 i = 0; i < simplifier->IndexCount; i += 3) {
+			for (u32 j = 0; j < 3; j++) {
+				u32 a = simplifier->Indices[i + j];
+				u32 b = simplifier->Indices[i + (j + 1) % 3];
+				MeshSimplifier_ConsiderCollapse(simplifier, a, b);
+				MeshSimplifier_ConsiderCollapse(simplifier, b, a);
+			}
+		}
+
+		u64 collapseCount = 0;
+		for (u64 i = 0; i < simplifier->VertexCount; i++) {
+			if (simplifier->Collapses[i].Target != ~0u) {
+				simplifier->Collapses[collapseCount++] = simplifier->Collapses[i];
+			}
+		}
+
+		qsort(simplifier->Collapses, collapseCount, sizeof(simplifier->Collapses[0]), MeshCollapse_Compare);
+
+		for (u64 i = 0; i < simplifier->VertexCount; i++) {
+			simplifier->Remap[i] = cast(u32) i;
+		}
+		memset(simplifier->Touched, 0, simplifier->VertexCount * sizeof(simplifier->Touched[0]));
+
+		// NOTE: Collapses in one pass must not share triangles, so everything around a collapsed vertex is skipped until the next pass
+		u64 trianglesToRemove = (simplifier->IndexCount - targetIndexCount + 2) / 3;
+		u64 removedTriangles = 0;
+		u64 appliedCount = 0;
+		for (u64 i = 0; i < collapseCount && removedTriangles < trianglesToRemove; i++) {
+			const MeshCollapse* collapse = &simplifier->Collapses[i];
+			u32 vertex = collapse->Vertex;
+			u32 target = collapse->Target;
+			if (simplifier->Touched[vertex] || simplifier->Touched[target]) {
+				continue;
+			}
+
+			u64 removed = 0;
+			if (!MeshSimplifier_CanCollapse(simplifier, vertex, target, &removed)) {
+				continue;
+			}
+
+			simplifier->Remap[vertex] = target;
+			Quadric_Add(&simplifier->Quadrics[target], &simplifier->Quadrics[vertex]);
+
+			f32 error = sqrtf(collapse->Cost);
+			simplifier->Error = error > simplifier->Error ? error : simplifier->Error;
+
+			simplifier->Touched[target] = true;
+			for (u32 j = simplifier->TriangleOffsets[vertex]; j < simplifier->TriangleOffsets[vertex + 1]; j++) {
+				const u32* triangle = &simplifier->Indices[simplifier->Triangles[j] * 3];
+				simplifier->Touched[triangle[0]] = true;
+				simplifier->Touched[triangle[1]] = true;
+				simplifier->Touched[triangle[2]] = true;
+			}
+
+			removedTriangles += removed;
+			appliedCount++;
+		}
+
+		if (appliedCount == 0) {
+			break;
+		}
+
+		u64 indexCount = 0;
+		for (u64 i = 0; i < simplifier->IndexCount; i += 3) {
+			u32 a = simplifier->Remap[simplifier->Indices[i + 0]];
+			u32 b = simplifier->Remap[simplifier->Indices[i + 1]];
+			u32 c = simplifier->Remap[simplifier->Indices[i + 2]];
+			if (a != b && b != c && a != c) {
+				simplifier->Indices[indexCount++] = a;
+				simplifier->Indices[indexCount++] = b;
+				simplifier->Indices[indexCount++] = c;
+			}
+		}
+		simplifier->IndexCount = indexCount;
+	}
+
+	return simplifier->IndexCount;
+}
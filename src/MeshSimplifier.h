@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+
+// NOTE: Symmetric 4x4 error quadric of the planes around a vertex, weighted by triangle area
+typedef struct Quadric_t {
+	f64 a2, ab, ac, ad;
+	f64 b2, bc, bd;
+	f64 c2, cd;
+	f64 d2;
+	f64 Weight;
+} Quadric;
+
+typedef struct MeshCollapse_t {
+	f32 Cost; // Squared distance
+	u32 Vertex;
+	u32 Target;
+} MeshCollapse;
+
+// NOTE: Half edge collapse simplification driven by quadric error metrics. Vertices never move, a collapse
+// snaps one vertex onto a neighbour, so every remaining vertex keeps its exact attributes. Locked vertices
+// (seams, borders) are never removed, so UV and normal seams and open edges keep their shape
+typedef struct MeshSimplifier_t {
+	Vector3* Positions; // Copied from the input
+	u64 VertexCount;
+	const u8* Locked;
+
+	u32* Indices; // The current simplified triangles
+	u64 IndexCount;
+	f32 Error; // Distance the surface moved so far, in the units of the positions
+
+	// NOTE: Scratch, sized once for the original mesh
+	Quadric* Quadrics;
+	u32* TriangleOffsets;
+	u32* Triangles;
+	MeshCollapse* Collapses;
+	u32* Remap;
+	u8* Touched;
+} MeshSimplifier;
+
+// NOTE: positions has a stride of positionStride bytes. locked has one byte per vertex, non zero for locked, it may be NULL
+// and has to outlive the simplifier
+b8 MeshSimplifier_Create(
+	MeshSimplifier* simplifier,
+	const Vector3* positions, u64 positionStride, u64 vertexCount,
+	const u8* locked,
+	const u32* indices, u64 indexCount
+);
+void MeshSimplifier_Destroy(MeshSimplifier* simplifier);
+
+// NOTE: Keeps collapsing until there are at most targetIndexCount indices left or nothing can be collapsed anymore,
+// can be called again with a smaller target to continue. Returns the new index count
+u64 MeshSimplifier_Reduce(MeshSimplifier* simplifier, u64 targetIndexCount);
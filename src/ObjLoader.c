@@ -21,18 +21,19 @@ static b8 ObjMesh_LoadMaterial(ObjMesh* mesh, char* source) {
 				chr++;
 			}
 
-			char* name = malloc((length + 1) * sizeof(name[0]));
+			char* name = StringArena_Add(&mesh->Strings, start, length);
 			if (!name) {
 				return false;
 			}
 
-			memcpy(name, start, length * sizeof(name[0]));
-			name[length] = '\0';
+			// NOTE: usemtl picks the first material of a name, like the linear search this replaced did
+			if (!StringMap_Insert(&mesh->MaterialIndices, name, length, mesh->MaterialCount)) {
+				return false;
+			}
 
 			mesh->MaterialCount++;
 			mesh->Materials = realloc(mesh->Materials, mesh->MaterialCount * sizeof(mesh->Materials[0]));
 			if (!mesh->Materials) {
-				free(name);
 				return false;
 			}
 
@@ -73,6 +74,25 @@ static b8 ObjMesh_LoadMaterial(ObjMesh* mesh, char* source) {
 			mesh->Materials[mesh->MaterialCount - 1].d.z = strtof(chr, &chr);
 		} else if (MATCH_FIRST_OF_MOVE(chr, "illum ")) {
 			mesh->Materials[mesh->MaterialCount - 1].illum = strtoul(chr, &chr, 10);
+		} else if (MATCH_FIRST_OF_MOVE(chr, "map_Kd ")) {
+			// NOTE: Texture options like -s or -o are not supported, the rest of the line is the path
+			char* start = chr;
+			u64 length = 0;
+			while (*chr != '\n' && *chr != '\0') {
+				length++;
+				chr++;
+			}
+
+			while (length > 0 && (start[length - 1] == '\r' || start[length - 1] == ' ')) {
+				length--;
+			}
+
+			char* path = StringArena_Add(&mesh->Strings, start, length);
+			if (!path) {
+				return false;
+			}
+
+			mesh->Materials[mesh->MaterialCount - 1].DiffuseMap = path;
 		} else if (*chr == '\n') {
 			chr++;
 			continue;
@@ -95,7 +115,6 @@ static b8 ObjMesh_LoadMaterial(ObjMesh* mesh, char* source) {
 static b8 ObjMesh_LoadMeshes(ObjMesh* mesh, char* source) {
 	u64 currentMaterialIndex = ~0ull;
 	u64 currentObjectIndex = ~0ull;
-	u64 currentFaceIndex = ~0ull;
 
 	char* chr = source;
 	while (*chr != '\0') {
@@ -161,25 +180,9 @@ static b8 ObjMesh_LoadMeshes(ObjMesh* mesh, char* source) {
 				chr++;
 			}
 
-			char* name = malloc((length + 1) * sizeof(name[0]));
-			if (!name) {
-				return false;
-			}
-
-			memcpy(name, start, length * sizeof(name[0]));
-			name[length] = '\0';
-
-			u64 index = ~0ull;
-			for (u64 i = 0; i < mesh->MaterialCount; i++) {
-				if (strcmp(mesh->Materials[i].Name, name) == 0) {
-					index = i;
-					break;
-				}
-			}
-			
-			free(name);
-
-			if (index == ~0ull) {
+			// NOTE: Looked up straight from the source, switching materials does not allocate
+			u64 index = OBJ_INDEX_NONE;
+			if (!StringMap_Find(&mesh->MaterialIndices, start, length, &index)) {
 				return false;
 			}
 
@@ -266,24 +269,20 @@ static b8 ObjMesh_LoadMeshes(ObjMesh* mesh, char* source) {
 				chr++;
 			}
 
-			char* name = malloc((length + 1) * sizeof(name[0]));
-			if (!name) {
+			char* name = StringArena_Add(&mesh->Strings, start, length);
+			if (!name || !StringMap_Insert(&mesh->ObjectIndices, name, length, mesh->ObjectCount)) {
 				return false;
 			}
 
-			memcpy(name, start, length * sizeof(name[0]));
-			name[length] = '\0';
-
 			currentObjectIndex++;
 			mesh->ObjectCount++;
 			mesh->Objects = realloc(mesh->Objects, mesh->ObjectCount * sizeof(mesh->Objects[0]));
 			if (!mesh->Objects) {
-				free(name);
 				return false;
 			}
 
 			mesh->Objects[currentObjectIndex].Name = name;
-			mesh->Objects[currentObjectIndex].FaceOffset = currentFaceIndex + 1;
+			mesh->Objects[currentObjectIndex].FaceOffset = mesh->FaceCount;
 			mesh->Objects[currentObjectIndex].FaceCount = 0;
 		} else if (*chr == '\n') {
 			chr++;
@@ -334,6 +333,7 @@ b8 ObjMesh_Create(ObjMesh* mesh, const char* filepath) {
 
 	if (!ObjMesh_LoadMeshes(mesh, source)) {
 		free(source);
+		ObjMesh_Destory(mesh);
 		return false;
 	}
 
@@ -359,16 +359,27 @@ void ObjMesh_Destory(ObjMesh* mesh) {
 	}
 
 	if (mesh->Materials) {
-		for (u64 i = 0; i < mesh->MaterialCount; i++) {
-			free(mesh->Materials[i].Name);
-		}
 		free(mesh->Materials);
 	}
 
 	if (mesh->Objects) {
-		for (u64 i = 0; i < mesh->ObjectCount; i++) {
-			free(mesh->Objects[i].Name);
-		}
 		free(mesh->Objects);
 	}
+
+	StringArena_Destroy(&mesh->Strings);
+	StringMap_Destroy(&mesh->MaterialIndices);
+	StringMap_Destroy(&mesh->ObjectIndices);
+	*mesh = (ObjMesh){};
+}
+
+u64 ObjMesh_FindMaterial(const ObjMesh* mesh, const char* name) {
+	u64 index = OBJ_INDEX_NONE;
+	StringMap_Find(&mesh->MaterialIndices, name, strlen(name), &index);
+	return index;
+}
+
+u64 ObjMesh_FindObject(const ObjMesh* mesh, const char* name) {
+	u64 index = OBJ_INDEX_NONE;
+	StringMap_Find(&mesh->ObjectIndices, name, strlen(name), &index);
+	return index;
 }
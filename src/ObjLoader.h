@@ -2,7 +2,9 @@
 
 #include "Typedefs.h"
 #include "Vector.h"
+#include "StringTable.h"
 
+// NOTE: Every name and path is interned in ObjMesh.Strings, nothing points to memory of its own
 typedef struct ObjMaterial_t {
 	char* Name;
 
@@ -16,6 +18,8 @@ typedef struct ObjMaterial_t {
 	Vector3 Tf; // Transmission Filter
 	Vector3 d;  // Alpha
 	s32 illum;  // Illumination Model
+
+	char* DiffuseMap; // map_Kd, NULL when the material has no texture
 } ObjMaterial;
 
 typedef struct ObjFace_t {
@@ -50,7 +54,17 @@ typedef struct ObjMesh_t {
 
 	ObjObject* Objects;
 	u64 ObjectCount;
+
+	StringArena Strings;
+	StringMap MaterialIndices; // Only filled by ObjMesh_Create
+	StringMap ObjectIndices;   // Only filled by ObjMesh_Create, the first object of a name when there are several
 } ObjMesh;
 
+#define OBJ_INDEX_NONE (~0ull)
+
 b8 ObjMesh_Create(ObjMesh* mesh, const char* filepath);
 void ObjMesh_Destory(ObjMesh* mesh);
+
+// NOTE: Return OBJ_INDEX_NONE when there is no material or object with that name
+u64 ObjMesh_FindMaterial(const ObjMesh* mesh, const char* name);
+u64 ObjMesh_FindObject(const ObjMesh* mesh, const char* name);
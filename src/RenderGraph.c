@@ -0,0 +1,554 @@
+#include "RenderGraph.h"
+#include "VulkanUtil.h"
+#include "VulkanMemoryBudget.h"
+
+#include <stdlib.h>
+
+#define RENDER_GRAPH_WRITE_ACCESS ( \
+	VK_ACCESS_SHADER_WRITE_BIT | \
+	VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | \
+	VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | \
+	VK_ACCESS_TRANSFER_WRITE_BIT | \
+	VK_ACCESS_HOST_WRITE_BIT | \
+	VK_ACCESS_MEMORY_WRITE_BIT \
+)
+
+// NOTE: Everything one vkCmdPipelineBarrier call needs, Images has room for one barrier per resource
+typedef struct RenderGraphBarrier_t {
+	VkPipelineStageFlags SrcStages;
+	VkPipelineStageFlags DstStages;
+	VkAccessFlags SrcAccess;
+	VkAccessFlags DstAccess;
+	VkImageMemoryBarrier* Images;
+	u32 ImageCount;
+	b8 Needed;
+} RenderGraphBarrier;
+
+b8 RenderGraph_Create(RenderGraph* graph, VkDevice device, VkPhysicalDevice physicalDevice) {
+	*graph = (RenderGraph){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+	};
+	return true;
+}
+
+static void RenderGraph_DestroyTransients(RenderGraph* graph) {
+	for (u32 i = 0; i < graph->ResourceCount; i++) {
+		RenderGraphResourceData* resource = &graph->Resources[i];
+		if (resource->Kind != RenderGraphResourceKind_TransientImage) {
+			continue;
+		}
+
+		if (resource->View != VK_NULL_HANDLE) {
+			vkDestroyImageView(graph->Device, resource->View, NULL);
+		}
+		if (resource->Image != VK_NULL_HANDLE) {
+			vkDestroyImage(graph->Device, resource->Image, NULL);
+		}
+		resource->View = VK_NULL_HANDLE;
+		resource->Image = VK_NULL_HANDLE;
+		resource->MemoryIndex = ~0u;
+	}
+
+	for (u32 i = 0; i < graph->MemoryCount; i++) {
+		RenderGraphMemory* memory = &graph->Memories[i];
+		if (memory->Memory != VK_NULL_HANDLE) {
+			VulkanMemoryBudget_TrackFree(memory->HeapIndex, memory->Size);
+			vkFreeMemory(graph->Device, memory->Memory, NULL);
+		}
+	}
+
+	free(graph->Memories);
+	graph->Memories = NULL;
+	graph->MemoryCount = 0;
+}
+
+void RenderGraph_Destroy(RenderGraph* graph) {
+	RenderGraph_DestroyTransients(graph);
+	free(graph->Resources);
+	free(graph->Passes);
+	*graph = (RenderGraph){};
+}
+
+static RenderGraphResource RenderGraph_AddResource(RenderGraph* graph, const char* name, RenderGraphResourceKind kind) {
+	if (graph->ResourceCount == graph->ResourceCapacity) {
+		u32 newCapacity = graph->ResourceCapacity ? graph->ResourceCapacity * 2 : 16;
+		RenderGraphResourceData* newResources = realloc(graph->Resources, newCapacity * sizeof(newResources[0]));
+		if (!newResources) {
+			return RENDER_GRAPH_RESOURCE_NONE;
+		}
+
+		graph->Resources = newResources;
+		graph->ResourceCapacity = newCapacity;
+	}
+
+	graph->Resources[graph->ResourceCount] = (RenderGraphResourceData){
+		.Name = name,
+		.Kind = kind,
+		.State = (RenderGraphState){
+			.Layout = VK_IMAGE_LAYOUT_UNDEFINED,
+		},
+		.MemoryIndex = ~0u,
+		.FirstPass = ~0u,
+		.LastPass = ~0u,
+	};
+	graph->Compiled = false;
+	return graph->ResourceCount++;
+}
+
+RenderGraphResource RenderGraph_ImportBuffer(RenderGraph* graph, const char* name) {
+	return RenderGraph_AddResource(graph, name, RenderGraphResourceKind_Buffer);
+}
+
+RenderGraphResource RenderGraph_ImportImage(RenderGraph* graph, const char* name, VkImageAspectFlags aspect) {
+	RenderGraphResource resource = RenderGraph_AddResource(graph, name, RenderGraphResourceKind_ImportedImage);
+	if (resource != RENDER_GRAPH_RESOURCE_NONE) {
+		graph->Resources[resource].Aspect = aspect;
+	}
+	return resource;
+}
+
+RenderGraphResource RenderGraph_CreateImage(RenderGraph* graph, const char* name, VkFormat format, u32 width, u32 height, VkImageUsageFlags usage) {
+	RenderGraphResource resource = RenderGraph_AddResource(graph, name, RenderGraphResourceKind_TransientImage);
+	if (resource != RENDER_GRAPH_RESOURCE_NONE) {
+		RenderGraphResourceData* data = &graph->Resources[resource];
+		data->Aspect = GetVulkanFormatAspect(format);
+		data->Format = format;
+		data->Width = width;
+		data->Height = height;
+		data->Usage = usage;
+	}
+	return resource;
+}
+
+void RenderGraph_SetImage(RenderGraph* graph, RenderGraphResource resource, VkImage image, VkImageView view, VkImageLayout layout, VkPipelineStageFlags stages) {
+	ASSERT(resource < graph->ResourceCount);
+	RenderGraphResourceData* data = &graph->Resources[resource];
+	ASSERT(data->Kind == RenderGraphResourceKind_ImportedImage);
+
+	data->Image = image;
+	data->View = view;
+	data->State = (RenderGraphState){
+		.WriteStages = stages,
+		.Layout = layout,
+	};
+}
+
+void RenderGraph_SetImageSize(RenderGraph* graph, RenderGraphResource resource, u32 width, u32 height) {
+	ASSERT(resource < graph->ResourceCount);
+	RenderGraphResourceData* data = &graph->Resources[resource];
+	ASSERT(data->Kind == RenderGraphResourceKind_TransientImage);
+
+	if (data->Width != width || data->Height != height) {
+		data->Width = width;
+		data->Height = height;
+		graph->Compiled = false;
+	}
+}
+
+VkImage RenderGraph_GetImage(const RenderGraph* graph, RenderGraphResource resource) {
+	ASSERT(resource < graph->ResourceCount);
+	return graph->Resources[resource].Image;
+}
+
+VkImageView RenderGraph_GetImageView(const RenderGraph* graph, RenderGraphResource resource) {
+	ASSERT(resource < graph->ResourceCount);
+	return graph->Resources[resource].View;
+}
+
+void RenderGraph_ExportResource(RenderGraph* graph, RenderGraphResource resource) {
+	ASSERT(resource < graph->ResourceCount);
+	graph->Resources[resource].Exported = true;
+	graph->Compiled = false;
+}
+
+void RenderGraph_SetFinalState(RenderGraph* graph, RenderGraphResource resource, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout) {
+	ASSERT(resource < graph->ResourceCount);
+	RenderGraphResourceData* data = &graph->Resources[resource];
+	data->Exported = true;
+	data->HasFinalState = true;
+	data->FinalStages = stages;
+	data->FinalAccess = access;
+	data->FinalLayout = layout;
+	graph->Compiled = false;
+}
+
+b8 RenderGraph_AddPass(
+	RenderGraph* graph,
+	const char* name,
+	const RenderGraphAccess* accesses,
+	u32 accessCount,
+	RenderGraphRecordFunction record,
+	void* data
+) {
+	ASSERT(accessCount <= RENDER_GRAPH_MAX_PASS_ACCESSES);
+
+	if (graph->PassCount == graph->PassCapacity) {
+		u32 newCapacity = graph->PassCapacity ? graph->PassCapacity * 2 : 16;
+		RenderGraphPassData* newPasses = realloc(graph->Passes, newCapacity * sizeof(newPasses[0]));
+		if (!newPasses) {
+			return false;
+		}
+
+		graph->Passes = newPasses;
+		graph->PassCapacity = newCapacity;
+	}
+
+	RenderGraphPassData* pass = &graph->Passes[graph->PassCount++];
+	*pass = (RenderGraphPassData){
+		.Name = name,
+		.Record = record,
+		.Data = data,
+		.AccessCount = accessCount,
+	};
+
+	for (u32 i = 0; i < accessCount; i++) {
+		ASSERT(accesses[i].Resource < graph->ResourceCount);
+		pass->Accesses[i] = accesses[i];
+	}
+
+	graph->Compiled = false;
+	return true;
+}
+
+// NOTE: Walks the passes backwards from the exported resources. A pass is live when it writes something a later live pass
+// or the outside needs, a write that discards the contents ends the need for any earlier writer
+static void RenderGraph_CullPasses(RenderGraph* graph) {
+	b8 needed[graph->ResourceCount + 1];
+	for (u32 i = 0; i < graph->ResourceCount; i++) {
+		needed[i] = graph->Resources[i].Exported;
+	}
+
+	graph->LivePassCount = 0;
+	for (u32 i = graph->PassCount; i-- > 0;) {
+		RenderGraphPassData* pass = &graph->Passes[i];
+
+		pass->Live = false;
+		for (u32 j = 0; j < pass->AccessCount; j++) {
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			if ((access->Access & RENDER_GRAPH_WRITE_ACCESS) != 0 && needed[access->Resource]) {
+				pass->Live = true;
+			}
+		}
+
+		if (!pass->Live) {
+			continue;
+		}
+		graph->LivePassCount++;
+
+		for (u32 j = 0; j < pass->AccessCount; j++) {
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			if ((access->Access & RENDER_GRAPH_WRITE_ACCESS) != 0 && access->Discard) {
+				needed[access->Resource] = false;
+			}
+		}
+
+		for (u32 j = 0; j < pass->AccessCount; j++) {
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			if ((access->Access & RENDER_GRAPH_WRITE_ACCESS) == 0 || !access->Discard) {
+				needed[access->Resource] = true;
+			}
+		}
+	}
+}
+
+static u32 RenderGraph_SelectMemoryType(const VkPhysicalDeviceMemoryProperties* memoryProperties, u32 memoryTypeBits) {
+	for (u32 i = 0; i < memoryProperties->memoryTypeCount; i++) {
+		if ((memoryTypeBits & (1 << i)) != 0 && (memoryProperties->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0) {
+			return i;
+		}
+	}
+
+	return ~0u;
+}
+
+// NOTE: Greedy, in the order the images are first used each one takes the first memory whose images are all dead by then.
+// Every image is bound at offset 0, so the memory is as large as its largest image
+static b8 RenderGraph_AllocateTransients(RenderGraph* graph) {
+	graph->Memories = malloc((graph->ResourceCount + 1) * sizeof(graph->Memories[0]));
+	if (!graph->Memories) {
+		return false;
+	}
+
+	for (u32 pass = 0; pass < graph->PassCount; pass++) {
+		for (u32 i = 0; i < graph->ResourceCount; i++) {
+			RenderGraphResourceData* resource = &graph->Resources[i];
+			if (resource->Kind != RenderGraphResourceKind_TransientImage || resource->FirstPass != pass) {
+				continue;
+			}
+
+			VkCheck(vkCreateImage(graph->Device, &(VkImageCreateInfo){
+				.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+				.imageType = VK_IMAGE_TYPE_2D,
+				.format = resource->Format,
+				.extent = (VkExtent3D){ resource->Width, resource->Height, 1 },
+				.mipLevels = 1,
+				.arrayLayers = 1,
+				.samples = VK_SAMPLE_COUNT_1_BIT,
+				.tiling = VK_IMAGE_TILING_OPTIMAL,
+				.usage = resource->Usage,
+				.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+				.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			}, NULL, &resource->Image));
+
+			VkMemoryRequirements memoryRequirements = {};
+			vkGetImageMemoryRequirements(graph->Device, resource->Image, &memoryRequirements);
+
+			u32 memoryIndex = 0;
+			while (memoryIndex < graph->MemoryCount) {
+				RenderGraphMemory* memory = &graph->Memories[memoryIndex];
+				if (memory->LastPass < resource->FirstPass && (memory->MemoryTypeBits & memoryRequirements.memoryTypeBits) != 0) {
+					break;
+				}
+				memoryIndex++;
+			}
+
+			if (memoryIndex == graph->MemoryCount) {
+				graph->Memories[graph->MemoryCount++] = (RenderGraphMemory){
+					.MemoryTypeBits = memoryRequirements.memoryTypeBits,
+					.Occupant = RENDER_GRAPH_RESOURCE_NONE,
+				};
+			}
+
+			RenderGraphMemory* memory = &graph->Memories[memoryIndex];
+			memory->Size = memoryRequirements.size > memory->Size ? memoryRequirements.size : memory->Size;
+			memory->MemoryTypeBits &= memoryRequirements.memoryTypeBits;
+			memory->LastPass = resource->LastPass;
+			resource->MemoryIndex = memoryIndex;
+		}
+	}
+
+	VkPhysicalDeviceMemoryProperties memoryProperties = {};
+	vkGetPhysicalDeviceMemoryProperties(graph->PhysicalDevice, &memoryProperties);
+
+	for (u32 i = 0; i < graph->MemoryCount; i++) {
+		RenderGraphMemory* memory = &graph->Memories[i];
+
+		u32 memoryTypeIndex = RenderGraph_SelectMemoryType(&memoryProperties, memory->MemoryTypeBits);
+		if (memoryTypeIndex == ~0u) {
+			return false;
+		}
+
+		VkCheck(vkAllocateMemory(graph->Device, &(VkMemoryAllocateInfo){
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+			.allocationSize = memory->Size,
+			.memoryTypeIndex = memoryTypeIndex,
+		}, NULL, &memory->Memory));
+
+		memory->HeapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+		VulkanMemoryBudget_TrackAllocation(memory->HeapIndex, memory->Size);
+	}
+
+	for (u32 i = 0; i < graph->ResourceCount; i++) {
+		RenderGraphResourceData* resource = &graph->Resources[i];
+		if (resource->Kind != RenderGraphResourceKind_TransientImage || resource->Image == VK_NULL_HANDLE) {
+			continue;
+		}
+
+		VkCheck(vkBindImageMemory(graph->Device, resource->Image, graph->Memories[resource->MemoryIndex].Memory, 0));
+		VkCheck(vkCreateImageView(graph->Device, &(VkImageViewCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.image = resource->Image,
+			.viewType = VK_IMAGE_VIEW_TYPE_2D,
+			.format = resource->Format,
+			.subresourceRange = (VkImageSubresourceRange){
+				.aspectMask = resource->Aspect,
+				.levelCount = 1,
+				.layerCount = 1,
+			},
+		}, NULL, &resource->View));
+
+		resource->State = (RenderGraphState){
+			.Layout = VK_IMAGE_LAYOUT_UNDEFINED,
+		};
+	}
+
+	return true;
+}
+
+b8 RenderGraph_Compile(RenderGraph* graph) {
+	RenderGraph_DestroyTransients(graph);
+	graph->Compiled = false;
+
+	RenderGraph_CullPasses(graph);
+
+	for (u32 i = 0; i < graph->ResourceCount; i++) {
+		graph->Resources[i].FirstPass = ~0u;
+		graph->Resources[i].LastPass = ~0u;
+	}
+
+	for (u32 i = 0; i < graph->PassCount; i++) {
+		const RenderGraphPassData* pass = &graph->Passes[i];
+		if (!pass->Live) {
+			continue;
+		}
+
+		for (u32 j = 0; j < pass->AccessCount; j++) {
+			RenderGraphResourceData* resource = &graph->Resources[pass->Accesses[j].Resource];
+			if (resource->FirstPass == ~0u) {
+				resource->FirstPass = i;
+			}
+			resource->LastPass = i;
+		}
+	}
+
+	if (!RenderGraph_AllocateTransients(graph)) {
+		RenderGraph_DestroyTransients(graph);
+		return false;
+	}
+
+	graph->Compiled = true;
+	return true;
+}
+
+static void RenderGraph_Synchronize(RenderGraph* graph, RenderGraphBarrier* barrier, const RenderGraphAccess* access) {
+	RenderGraphResourceData* resource = &graph->Resources[access->Resource];
+	RenderGraphState* state = &resource->State;
+	b8 isImage = resource->Kind != RenderGraphResourceKind_Buffer;
+
+	VkPipelineStageFlags srcStages = 0;
+	VkAccessFlags srcAccess = 0;
+
+	// NOTE: A transient image taking over memory from another one has to wait until every use of the other one is done,
+	// its own contents are undefined from then on
+	if (resource->Kind == RenderGraphResourceKind_TransientImage) {
+		RenderGraphMemory* memory = &graph->Memories[resource->MemoryIndex];
+		if (memory->Occupant != access->Resource) {
+			if (memory->Occupant != RENDER_GRAPH_RESOURCE_NONE) {
+				const RenderGraphState* previous = &graph->Resources[memory->Occupant].State;
+				srcStages |= previous->WriteStages | previous->ReadStages;
+			}
+
+			memory->Occupant = access->Resource;
+			*state = (RenderGraphState){
+				.Layout = VK_IMAGE_LAYOUT_UNDEFINED,
+			};
+		}
+	}
+
+	b8 write = (access->Access & RENDER_GRAPH_WRITE_ACCESS) != 0;
+	b8 transition = isImage && access->Layout != state->Layout;
+	VkImageLayout oldLayout = access->Discard ? VK_IMAGE_LAYOUT_UNDEFINED : state->Layout;
+
+	if (write || transition) {
+		// NOTE: Writes and layout transitions wait for every earlier read and write. Only a transition on its own is
+		// visible to the pass right away, what the pass writes still needs a barrier before anything reads it
+		srcStages |= state->WriteStages | state->ReadStages;
+		srcAccess |= access->Discard ? 0 : state->WriteAccess;
+
+		*state = (RenderGraphState){
+			.WriteStages = access->Stages,
+			.WriteAccess = access->Access & RENDER_GRAPH_WRITE_ACCESS,
+			.ReadStages = write ? 0 : access->Stages,
+			.ReadAccess = write ? 0 : access->Access,
+			.Layout = isImage ? access->Layout : VK_IMAGE_LAYOUT_UNDEFINED,
+		};
+	} else {
+		// NOTE: Reads only wait for the last write, and not at all when an earlier barrier already made it visible to them
+		b8 visible = (access->Stages & ~state->ReadStages) == 0 && (access->Access & ~state->ReadAccess) == 0;
+		if (state->WriteStages != 0 && !visible) {
+			srcStages |= state->WriteStages;
+			srcAccess |= state->WriteAccess;
+		}
+
+		state->ReadStages |= access->Stages;
+		state->ReadAccess |= access->Access;
+	}
+
+	if (srcStages == 0 && !transition) {
+		return;
+	}
+
+	if (transition) {
+		barrier->Images[barrier->ImageCount++] = (VkImageMemoryBarrier){
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.srcAccessMask = srcAccess,
+			.dstAccessMask = access->Access,
+			.oldLayout = oldLayout,
+			.newLayout = access->Layout,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = resource->Image,
+			.subresourceRange = (VkImageSubresourceRange){
+				.aspectMask = resource->Aspect,
+				.levelCount = VK_REMAINING_MIP_LEVELS,
+				.layerCount = VK_REMAINING_ARRAY_LAYERS,
+			},
+		};
+	} else if (srcAccess != 0) {
+		barrier->SrcAccess |= srcAccess;
+		barrier->DstAccess |= access->Access;
+	}
+
+	barrier->SrcStages |= srcStages;
+	barrier->DstStages |= access->Stages;
+	barrier->Needed = true;
+}
+
+static void RenderGraph_Flush(RenderGraph* graph, RenderGraphBarrier* barrier, VkCommandBuffer commandBuffer) {
+	if (!barrier->Needed) {
+		return;
+	}
+
+	b8 hasMemoryBarrier = barrier->SrcAccess != 0 || barrier->DstAccess != 0;
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		barrier->SrcStages != 0 ? barrier->SrcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		barrier->DstStages,
+		0,
+		hasMemoryBarrier ? 1 : 0,
+		&(VkMemoryBarrier){
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.srcAccessMask = barrier->SrcAccess,
+			.dstAccessMask = barrier->DstAccess,
+		},
+		0,
+		NULL,
+		barrier->ImageCount,
+		barrier->Images
+	);
+	graph->BarrierCount++;
+
+	*barrier = (RenderGraphBarrier){
+		.Images = barrier->Images,
+	};
+}
+
+void RenderGraph_Execute(RenderGraph* graph, VkCommandBuffer commandBuffer) {
+	ASSERT(graph->Compiled);
+
+	VkImageMemoryBarrier images[graph->ResourceCount + 1];
+	RenderGraphBarrier barrier = {
+		.Images = images,
+	};
+
+	graph->BarrierCount = 0;
+	for (u32 i = 0; i < graph->PassCount; i++) {
+		RenderGraphPassData* pass = &graph->Passes[i];
+		if (!pass->Live) {
+			continue;
+		}
+
+		for (u32 j = 0; j < pass->AccessCount; j++) {
+			RenderGraph_Synchronize(graph, &barrier, &pass->Accesses[j]);
+		}
+		RenderGraph_Flush(graph, &barrier, commandBuffer);
+
+		pass->Record(commandBuffer, pass->Data);
+	}
+
+	for (u32 i = 0; i < graph->ResourceCount; i++) {
+		const RenderGraphResourceData* resource = &graph->Resources[i];
+		if (!resource->HasFinalState || resource->FirstPass == ~0u) {
+			continue;
+		}
+
+		RenderGraph_Synchronize(graph, &barrier, &(RenderGraphAccess){
+			.Resource = i,
+			.Stages = resource->FinalStages,
+			.Access = resource->FinalAccess,
+			.Layout = resource->FinalLayout,
+		});
+	}
+	RenderGraph_Flush(graph, &barrier, commandBuffer);
+}
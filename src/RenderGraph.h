@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+#define RENDER_GRAPH_MAX_PASS_ACCESSES 8
+
+typedef u32 RenderGraphResource;
+#define RENDER_GRAPH_RESOURCE_NONE (~0u)
+
+typedef enum RenderGraphResourceKind_t {
+	RenderGraphResourceKind_Buffer,         // Synchronized with global memory barriers, so no handle is needed
+	RenderGraphResourceKind_ImportedImage,  // Owned outside the graph, set with RenderGraph_SetImage
+	RenderGraphResourceKind_TransientImage, // Created by RenderGraph_Compile, may share memory with other transient images
+} RenderGraphResourceKind;
+
+// NOTE: How a pass uses a resource, Layout is ignored for buffers. Discard means the pass does not need the previous
+// contents, so a layout transition may start from VK_IMAGE_LAYOUT_UNDEFINED
+typedef struct RenderGraphAccess_t {
+	RenderGraphResource Resource;
+	VkPipelineStageFlags Stages;
+	VkAccessFlags Access;
+	VkImageLayout Layout;
+	b8 Discard;
+} RenderGraphAccess;
+
+// NOTE: The last write, and the stages and accesses that have already waited for it
+typedef struct RenderGraphState_t {
+	VkPipelineStageFlags WriteStages;
+	VkAccessFlags WriteAccess;
+	VkPipelineStageFlags ReadStages;
+	VkAccessFlags ReadAccess;
+	VkImageLayout Layout;
+} RenderGraphState;
+
+typedef struct RenderGraphResourceData_t {
+	const char* Name;
+	RenderGraphResourceKind Kind;
+	RenderGraphState State;
+
+	VkImage Image;
+	VkImageView View;
+	VkImageAspectFlags Aspect;
+
+	// NOTE: Transient images only
+	VkFormat Format;
+	u32 Width;
+	u32 Height;
+	VkImageUsageFlags Usage;
+	u32 MemoryIndex;
+
+	// NOTE: Exported resources keep the passes that write them alive, a final state is transitioned to after the last pass
+	b8 Exported;
+	b8 HasFinalState;
+	VkPipelineStageFlags FinalStages;
+	VkAccessFlags FinalAccess;
+	VkImageLayout FinalLayout;
+
+	// NOTE: Indices of the first and last live pass that use the resource, set by RenderGraph_Compile
+	u32 FirstPass;
+	u32 LastPass;
+} RenderGraphResourceData;
+
+typedef void (*RenderGraphRecordFunction)(VkCommandBuffer commandBuffer, void* data);
+
+typedef struct RenderGraphPassData_t {
+	const char* Name;
+	RenderGraphRecordFunction Record;
+	void* Data;
+	RenderGraphAccess Accesses[RENDER_GRAPH_MAX_PASS_ACCESSES];
+	u32 AccessCount;
+	b8 Live;
+} RenderGraphPassData;
+
+// NOTE: Transient images whose lifetimes do not overlap are bound to the same memory
+typedef struct RenderGraphMemory_t {
+	VkDeviceMemory Memory;
+	u64 Size;
+	u32 MemoryTypeBits;
+	u32 HeapIndex;
+	u32 LastPass;
+	RenderGraphResource Occupant; // The image that used the memory last while executing
+} RenderGraphMemory;
+
+// NOTE: Passes and resources are declared once, RenderGraph_Compile culls the passes that nothing exported depends on
+// and allocates the transient images. RenderGraph_Execute then records the live passes in declaration order with the
+// barriers and layout transitions between them batched into one vkCmdPipelineBarrier per pass. Resource states carry
+// over from one execution to the next, so the graph also synchronizes against the previous frame on the same queue
+typedef struct RenderGraph_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+
+	RenderGraphResourceData* Resources;
+	u32 ResourceCount;
+	u32 ResourceCapacity;
+
+	RenderGraphPassData* Passes;
+	u32 PassCount;
+	u32 PassCapacity;
+
+	RenderGraphMemory* Memories;
+	u32 MemoryCount;
+
+	b8 Compiled;
+	u32 LivePassCount;
+	u32 BarrierCount; // vkCmdPipelineBarrier calls made by the last RenderGraph_Execute
+} RenderGraph;
+
+b8 RenderGraph_Create(RenderGraph* graph, VkDevice device, VkPhysicalDevice physicalDevice);
+// NOTE: Nothing recorded with the graph may still be in flight
+void RenderGraph_Destroy(RenderGraph* graph);
+
+RenderGraphResource RenderGraph_ImportBuffer(RenderGraph* graph, const char* name);
+RenderGraphResource RenderGraph_ImportImage(RenderGraph* graph, const char* name, VkImageAspectFlags aspect);
+RenderGraphResource RenderGraph_CreateImage(RenderGraph* graph, const char* name, VkFormat format, u32 width, u32 height, VkImageUsageFlags usage);
+
+// NOTE: The image is in layout once its previous uses in stages have finished, for swapchain images that is the stage that waits for the acquire
+void RenderGraph_SetImage(RenderGraph* graph, RenderGraphResource resource, VkImage image, VkImageView view, VkImageLayout layout, VkPipelineStageFlags stages);
+// NOTE: Transient images are recreated by the next RenderGraph_Compile
+void RenderGraph_SetImageSize(RenderGraph* graph, RenderGraphResource resource, u32 width, u32 height);
+VkImage RenderGraph_GetImage(const RenderGraph* graph, RenderGraphResource resource);
+VkImageView RenderGraph_GetImageView(const RenderGraph* graph, RenderGraphResource resource);
+
+void RenderGraph_ExportResource(RenderGraph* graph, RenderGraphResource resource);
+void RenderGraph_SetFinalState(RenderGraph* graph, RenderGraphResource resource, VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout);
+
+b8 RenderGraph_AddPass(
+	RenderGraph* graph,
+	const char* name,
+	const RenderGraphAccess* accesses,
+	u32 accessCount,
+	RenderGraphRecordFunction record,
+	void* data
+);
+
+// NOTE: Only has to be called again after passes were added or transient images resized, and then only while the device is idle
+b8 RenderGraph_Compile(RenderGraph* graph);
+void RenderGraph_Execute(RenderGraph* graph, VkCommandBuffer commandBuffer);
@@ -0,0 +1,292 @@
+#include "Scene.h"
+#include "JobSystem.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENE_UPDATE_BATCH_SIZE 2048
+
+static b8 Scene_Reserve(Scene* scene, u64 nodeCapacity) {
+	if (nodeCapacity <= scene->NodeCapacity) {
+		return true;
+	}
+
+	#define GROW(array) \
+		do { \
+			void* newArray = realloc(scene->array, nodeCapacity * sizeof(scene->array[0])); \
+			if (!newArray) { \
+				return false; \
+			} \
+			scene->array = newArray; \
+		} while (0)
+
+	GROW(LocalMatrices);
+	GROW(WorldMatrices);
+	GROW(Parents);
+	GROW(Depths);
+	GROW(Dirty);
+	GROW(IndexToNode);
+	GROW(NodeToIndex);
+
+	#undef GROW
+
+	scene->NodeCapacity = nodeCapacity;
+	return true;
+}
+
+static b8 Scene_ReserveLevels(Scene* scene, u32 levelCount) {
+	if (levelCount + 1 <= scene->LevelCapacity) {
+		return true;
+	}
+
+	u32 levelCapacity = scene->LevelCapacity ? scene->LevelCapacity : 8;
+	while (levelCapacity < levelCount + 1) {
+		levelCapacity *= 2;
+	}
+
+	u32* levelOffsets = realloc(scene->LevelOffsets, levelCapacity * sizeof(levelOffsets[0]));
+	if (!levelOffsets) {
+		return false;
+	}
+
+	scene->LevelOffsets = levelOffsets;
+	scene->LevelCapacity = levelCapacity;
+	return true;
+}
+
+b8 Scene_Create(Scene* scene, u64 nodeCapacity) {
+	*scene = (Scene){};
+	scene->FirstDirtyLevel = ~0u;
+
+	if (nodeCapacity == 0) {
+		nodeCapacity = 64;
+	}
+
+	if (!Scene_Reserve(scene, nodeCapacity) || !Scene_ReserveLevels(scene, 1)) {
+		Scene_Destroy(scene);
+		return false;
+	}
+
+	scene->LevelOffsets[0] = 0;
+	return true;
+}
+
+void Scene_Destroy(Scene* scene) {
+	free(scene->LocalMatrices);
+	free(scene->WorldMatrices);
+	free(scene->Parents);
+	free(scene->Depths);
+	free(scene->Dirty);
+	free(scene->IndexToNode);
+	free(scene->NodeToIndex);
+	free(scene->LevelOffsets);
+	*scene = (Scene){};
+}
+
+SceneNode Scene_AddNode(Scene* scene, SceneNode parent, Matrix4 localMatrix) {
+	if (scene->NodeCount >= ~0u - 1) {
+		return SCENE_NODE_NONE;
+	}
+
+	if (scene->NodeCount == scene->NodeCapacity && !Scene_Reserve(scene, scene->NodeCapacity * 2)) {
+		return SCENE_NODE_NONE;
+	}
+
+	u32 parentIndex = SCENE_NODE_NONE;
+	u32 depth = 0;
+	if (parent != SCENE_NODE_NONE) {
+		ASSERT(parent < scene->NodeCount);
+		parentIndex = scene->NodeToIndex[parent];
+		depth = scene->Depths[parentIndex] + 1;
+	}
+
+	if (!Scene_ReserveLevels(scene, depth + 1)) {
+		return SCENE_NODE_NONE;
+	}
+
+	u32 index = cast(u32) scene->NodeCount;
+	SceneNode node = cast(SceneNode) scene->NodeCount;
+	scene->NodeCount++;
+
+	scene->LocalMatrices[index] = localMatrix;
+	scene->WorldMatrices[index] = localMatrix;
+	scene->Parents[index] = parentIndex;
+	scene->Depths[index] = depth;
+	scene->Dirty[index] = true;
+	scene->IndexToNode[index] = node;
+	scene->NodeToIndex[node] = index;
+
+	// NOTE: Appending only keeps the depth order when the new node is at least as deep as the last one,
+	// the level ranges are rebuilt on the next update either way
+	scene->NeedsSort = true;
+
+	if (depth < scene->FirstDirtyLevel) {
+		scene->FirstDirtyLevel = depth;
+	}
+
+	return node;
+}
+
+void Scene_SetLocalMatrix(Scene* scene, SceneNode node, Matrix4 localMatrix) {
+	ASSERT(node < scene->NodeCount);
+	u32 index = scene->NodeToIndex[node];
+
+	scene->LocalMatrices[index] = localMatrix;
+	scene->Dirty[index] = true;
+
+	if (scene->Depths[index] < scene->FirstDirtyLevel) {
+		scene->FirstDirtyLevel = scene->Depths[index];
+	}
+}
+
+Matrix4 Scene_GetWorldMatrix(Scene* scene, SceneNode node) {
+	ASSERT(node < scene->NodeCount);
+	return scene->WorldMatrices[scene->NodeToIndex[node]];
+}
+
+static b8 Scene_Sort(Scene* scene) {
+	u32 levelCount = 0;
+	b8 isSorted = true;
+	for (u64 i = 0; i < scene->NodeCount; i++) {
+		if (scene->Depths[i] + 1 > levelCount) {
+			levelCount = scene->Depths[i] + 1;
+		}
+
+		if (i > 0 && scene->Depths[i] < scene->Depths[i - 1]) {
+			isSorted = false;
+		}
+	}
+
+	if (!Scene_ReserveLevels(scene, levelCount)) {
+		return false;
+	}
+
+	u32* levelOffsets = scene->LevelOffsets;
+	memset(levelOffsets, 0, (levelCount + 1) * sizeof(levelOffsets[0]));
+	for (u64 i = 0; i < scene->NodeCount; i++) {
+		levelOffsets[scene->Depths[i] + 1]++;
+	}
+
+	for (u32 i = 0; i < levelCount; i++) {
+		levelOffsets[i + 1] += levelOffsets[i];
+	}
+
+	scene->LevelCount = levelCount;
+	scene->NeedsSort = false;
+
+	if (isSorted) {
+		return true;
+	}
+
+	// NOTE: Stable counting sort by depth, parents keep coming before their children
+	u32* newIndices = malloc(scene->NodeCount * sizeof(newIndices[0]));
+	u32* cursors = malloc(levelCount * sizeof(cursors[0]));
+	Matrix4* localMatrices = malloc(scene->NodeCapacity * sizeof(localMatrices[0]));
+	Matrix4* worldMatrices = malloc(scene->NodeCapacity * sizeof(worldMatrices[0]));
+	u32* parents = malloc(scene->NodeCapacity * sizeof(parents[0]));
+	u32* depths = malloc(scene->NodeCapacity * sizeof(depths[0]));
+	u8* dirty = malloc(scene->NodeCapacity * sizeof(dirty[0]));
+	SceneNode* indexToNode = malloc(scene->NodeCapacity * sizeof(indexToNode[0]));
+
+	if (!newIndices || !cursors || !localMatrices || !worldMatrices || !parents || !depths || !dirty || !indexToNode) {
+		free(newIndices);
+		free(cursors);
+		free(localMatrices);
+		free(worldMatrices);
+		free(parents);
+		free(depths);
+		free(dirty);
+		free(indexToNode);
+		scene->NeedsSort = true;
+		return false;
+	}
+
+	memcpy(cursors, levelOffsets, levelCount * sizeof(cursors[0]));
+	for (u64 i = 0; i < scene->NodeCount; i++) {
+		newIndices[i] = cursors[scene->Depths[i]]++;
+	}
+
+	for (u64 i = 0; i < scene->NodeCount; i++) {
+		u32 newIndex = newIndices[i];
+		localMatrices[newIndex] = scene->LocalMatrices[i];
+		worldMatrices[newIndex] = scene->WorldMatrices[i];
+		parents[newIndex] = scene->Parents[i] == SCENE_NODE_NONE ? SCENE_NODE_NONE : newIndices[scene->Parents[i]];
+		depths[newIndex] = scene->Depths[i];
+		dirty[newIndex] = scene->Dirty[i];
+		indexToNode[newIndex] = scene->IndexToNode[i];
+		scene->NodeToIndex[scene->IndexToNode[i]] = newIndex;
+	}
+
+	free(scene->LocalMatrices);
+	free(scene->WorldMatrices);
+	free(scene->Parents);
+	free(scene->Depths);
+	free(scene->Dirty);
+	free(scene->IndexToNode);
+
+	scene->LocalMatrices = localMatrices;
+	scene->WorldMatrices = worldMatrices;
+	scene->Parents = parents;
+	scene->Depths = depths;
+	scene->Dirty = dirty;
+	scene->IndexToNode = indexToNode;
+
+	free(cursors);
+	free(newIndices);
+	return true;
+}
+
+void Scene_UpdateRange(Scene* scene, u32 begin, u32 end) {
+	const Matrix4* localMatrices = scene->LocalMatrices;
+	Matrix4* worldMatrices = scene->WorldMatrices;
+	const u32* parents = scene->Parents;
+	u8* dirty = scene->Dirty;
+
+	for (u32 i = begin; i < end; i++) {
+		u32 parent = parents[i];
+		if (parent == SCENE_NODE_NONE) {
+			if (dirty[i]) {
+				worldMatrices[i] = localMatrices[i];
+			}
+		} else if (dirty[i] || dirty[parent]) {
+			worldMatrices[i] = Matrix4_Multiply(&worldMatrices[parent], &localMatrices[i]);
+			dirty[i] = true; // NOTE: Propagates to the children in the next level
+		}
+	}
+}
+
+typedef struct SceneUpdateData_t {
+	Scene* Scene;
+	u32 Offset;
+} SceneUpdateData;
+
+static void Scene_UpdateBatch(void* data, u64 begin, u64 end) {
+	SceneUpdateData* update = data;
+	Scene_UpdateRange(update->Scene, update->Offset + cast(u32) begin, update->Offset + cast(u32) end);
+}
+
+void Scene_Update(Scene* scene) {
+	if (scene->NeedsSort) {
+		if (!Scene_Sort(scene)) {
+			return;
+		}
+	}
+
+	if (scene->FirstDirtyLevel >= scene->LevelCount) {
+		scene->FirstDirtyLevel = ~0u;
+		return;
+	}
+
+	// NOTE: Nodes in the same level never depend on each other, so each level is split across the job system
+	for (u32 level = scene->FirstDirtyLevel; level < scene->LevelCount; level++) {
+		SceneUpdateData update = {
+			.Scene = scene,
+			.Offset = scene->LevelOffsets[level],
+		};
+		JobSystem_ParallelFor(scene->LevelOffsets[level + 1] - scene->LevelOffsets[level], SCENE_UPDATE_BATCH_SIZE, Scene_UpdateBatch, &update);
+	}
+
+	u32 firstDirty = scene->LevelOffsets[scene->FirstDirtyLevel];
+	memset(&scene->Dirty[firstDirty], 0, (scene->NodeCount - firstDirty) * sizeof(scene->Dirty[0]));
+	scene->FirstDirtyLevel = ~0u;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Matrix.h"
+
+typedef u32 SceneNode;
+
+#define SCENE_NODE_NONE (~0u)
+
+// NOTE: All per node data is stored structure of arrays and kept sorted by hierarchy depth,
+// so a parent is always stored before its children and every depth level is a contiguous range
+typedef struct Scene_t {
+	u64 NodeCount;
+	u64 NodeCapacity;
+
+	Matrix4* LocalMatrices;
+	Matrix4* WorldMatrices;
+	u32* Parents; // Index of the parent, not the SceneNode
+	u32* Depths;
+	u8* Dirty;
+
+	SceneNode* IndexToNode;
+	u32* NodeToIndex;
+
+	u32* LevelOffsets; // LevelCount + 1 entries
+	u32 LevelCount;
+	u32 LevelCapacity;
+
+	u32 FirstDirtyLevel;
+	b8 NeedsSort;
+} Scene;
+
+b8 Scene_Create(Scene* scene, u64 nodeCapacity);
+void Scene_Destroy(Scene* scene);
+
+SceneNode Scene_AddNode(Scene* scene, SceneNode parent, Matrix4 localMatrix);
+void Scene_SetLocalMatrix(Scene* scene, SceneNode node, Matrix4 localMatrix);
+Matrix4 Scene_GetWorldMatrix(Scene* scene, SceneNode node);
+
+// NOTE: Recomputes the world matrices of all dirty nodes and their subtrees
+void Scene_Update(Scene* scene);
+void Scene_UpdateRange(Scene* scene, u32 begin, u32 end);
@@ -0,0 +1,115 @@
+#include "StringTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define STRING_ARENA_BLOCK_SIZE (64 * 1024)
+#define STRING_MAP_MIN_CAPACITY 16
+
+char* StringArena_Add(StringArena* arena, const char* string, u64 length) {
+	StringArenaBlock* block = arena->Blocks;
+	if (!block || block->Capacity - block->Size < length + 1) {
+		// NOTE: A string longer than a block gets a block of its own
+		u64 capacity = length + 1 > STRING_ARENA_BLOCK_SIZE ? length + 1 : STRING_ARENA_BLOCK_SIZE;
+		block = malloc(sizeof(*block) + capacity);
+		if (!block) {
+			return NULL;
+		}
+
+		block->Next = arena->Blocks;
+		block->Size = 0;
+		block->Capacity = capacity;
+		arena->Blocks = block;
+	}
+
+	char* result = block->Data + block->Size;
+	memcpy(result, string, length);
+	result[length] = '\0';
+	block->Size += length + 1;
+	return result;
+}
+
+void StringArena_Destroy(StringArena* arena) {
+	StringArenaBlock* block = arena->Blocks;
+	while (block) {
+		StringArenaBlock* next = block->Next;
+		free(block);
+		block = next;
+	}
+	*arena = (StringArena){};
+}
+
+// NOTE: FNV-1a
+static u64 StringMap_Hash(const char* key, u64 keyLength) {
+	u64 hash = 0xcbf29ce484222325ull;
+	for (u64 i = 0; i < keyLength; i++) {
+		hash ^= cast(u8) key[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static StringMapEntry* StringMap_Probe(StringMapEntry* entries, u64 capacity, const char* key, u64 keyLength, u64 hash) {
+	u64 mask = capacity - 1;
+	for (u64 i = hash & mask; ; i = (i + 1) & mask) {
+		StringMapEntry* entry = &entries[i];
+		if (!entry->Key ||
+			(entry->Hash == hash && entry->KeyLength == keyLength && memcmp(entry->Key, key, keyLength) == 0)
+		) {
+			return entry;
+		}
+	}
+}
+
+b8 StringMap_Find(const StringMap* map, const char* key, u64 keyLength, u64* value) {
+	if (map->Count == 0) {
+		return false;
+	}
+
+	const StringMapEntry* entry = StringMap_Probe(map->Entries, map->Capacity, key, keyLength, StringMap_Hash(key, keyLength));
+	if (!entry->Key) {
+		return false;
+	}
+	*value = entry->Value;
+	return true;
+}
+
+b8 StringMap_Insert(StringMap* map, const char* key, u64 keyLength, u64 value) {
+	// NOTE: Grows at a load factor of one half, which keeps the probe sequences short
+	if ((map->Count + 1) * 2 > map->Capacity) {
+		u64 capacity = map->Capacity ? map->Capacity * 2 : STRING_MAP_MIN_CAPACITY;
+		StringMapEntry* entries = calloc(capacity, sizeof(entries[0]));
+		if (!entries) {
+			return false;
+		}
+
+		for (u64 i = 0; i < map->Capacity; i++) {
+			const StringMapEntry* entry = &map->Entries[i];
+			if (entry->Key) {
+				*StringMap_Probe(entries, capacity, entry->Key, entry->KeyLength, entry->Hash) = *entry;
+			}
+		}
+
+		free(map->Entries);
+		map->Entries = entries;
+		map->Capacity = capacity;
+	}
+
+	u64 hash = StringMap_Hash(key, keyLength);
+	StringMapEntry* entry = StringMap_Probe(map->Entries, map->Capacity, key, keyLength, hash);
+	if (!entry->Key) {
+		*entry = (StringMapEntry){
+			.Key = key,
+			.KeyLength = keyLength,
+			.Hash = hash,
+			.Value = value,
+		};
+		map->Count++;
+	}
+	return true;
+}
+
+void StringMap_Destroy(StringMap* map) {
+	free(map->Entries);
+	*map = (StringMap){};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Typedefs.h"
+
+// NOTE: Strings are copied into blocks that are never moved or freed one by one, so the returned pointers stay valid
+// until StringArena_Destroy and everything owned by the arena is freed at once
+typedef struct StringArenaBlock_t {
+	struct StringArenaBlock_t* Next;
+	u64 Size;
+	u64 Capacity;
+	char Data[];
+} StringArenaBlock;
+
+typedef struct StringArena_t {
+	StringArenaBlock* Blocks; // The newest block first
+} StringArena;
+
+// NOTE: Copies length characters and null terminates them, returns NULL when out of memory
+char* StringArena_Add(StringArena* arena, const char* string, u64 length);
+void StringArena_Destroy(StringArena* arena);
+
+typedef struct StringMapEntry_t {
+	const char* Key; // NULL for an empty entry
+	u64 KeyLength;
+	u64 Hash;
+	u64 Value;
+} StringMapEntry;
+
+// NOTE: Open addressing with linear probing. The keys are not copied, they have to outlive the map, which they do
+// when they come from a StringArena
+typedef struct StringMap_t {
+	StringMapEntry* Entries;
+	u64 Capacity; // Always a power of two
+	u64 Count;
+} StringMap;
+
+// NOTE: The key does not have to be null terminated, so a name can be looked up straight from the source it is parsed from
+b8 StringMap_Find(const StringMap* map, const char* key, u64 keyLength, u64* value);
+// NOTE: Keeps the existing value when the key is already in the map
+b8 StringMap_Insert(StringMap* map, const char* key, u64 keyLength, u64 value);
+void StringMap_Destroy(StringMap* map);
@@ -0,0 +1,309 @@
+#include "TextureFile.h"
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXTURE_FILE_FLAG_SRGB 1
+#define TEXTURE_FILE_LEVEL_ALIGNMENT 16
+
+static const u8 TextureFileIdentifier[12] = { 0xAB, 'R', 'T', 'X', ' ', '1', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// NOTE: Everything is little endian, the level index follows the header and the level data follows the index
+typedef struct TextureFileHeader_t {
+	u8 Identifier[12];
+	u32 Format;
+	u32 Flags;
+	u32 Width;
+	u32 Height;
+	u32 LevelCount;
+	u32 Reserved;
+} TextureFileHeader;
+
+typedef struct TextureFileLevelIndex_t {
+	u64 Offset; // From the start of the file
+	u64 Size;
+} TextureFileLevelIndex;
+
+STATIC_ASSERT(sizeof(TextureFileHeader) == 36, "The texture file header must not contain padding");
+STATIC_ASSERT(sizeof(TextureFileLevelIndex) == 16, "The texture file level index must not contain padding");
+
+static const char* TextureFormatNames[TextureFormat_Count] = {
+	[TextureFormat_RGBA8] = "rgba8",
+	[TextureFormat_BC1] = "bc1",
+	[TextureFormat_BC5] = "bc5",
+	[TextureFormat_BC7] = "bc7",
+};
+
+const char* TextureFormat_GetName(TextureFormat format) {
+	return format < TextureFormat_Count ? TextureFormatNames[format] : "unknown";
+}
+
+b8 TextureFormat_FromName(TextureFormat* format, const char* name) {
+	for (u32 i = 0; i < TextureFormat_Count; i++) {
+		if (strcmp(name, TextureFormatNames[i]) == 0) {
+			*format = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static u32 TextureFormat_GetBlockSize(TextureFormat format) {
+	switch (format) {
+		case TextureFormat_BC1: return 8;
+		case TextureFormat_BC5: return 16;
+		case TextureFormat_BC7: return 16;
+		default: return 0;
+	}
+}
+
+u64 TextureFormat_GetLevelSize(TextureFormat format, u32 width, u32 height) {
+	if (format == TextureFormat_RGBA8) {
+		return cast(u64) width * height * 4;
+	}
+
+	u64 blocksX = (width + 3) / 4;
+	u64 blocksY = (height + 3) / 4;
+	return blocksX * blocksY * TextureFormat_GetBlockSize(format);
+}
+
+static void TextureFile_SetLevels(TextureFile* file) {
+	u32 width = file->Width;
+	u32 height = file->Height;
+	u64 offset = 0;
+	for (u32 i = 0; i < file->LevelCount; i++) {
+		file->Levels[i] = (TextureLevel){
+			.Width = width,
+			.Height = height,
+			.Offset = offset,
+			.Size = TextureFormat_GetLevelSize(file->Format, width, height),
+		};
+
+		offset += file->Levels[i].Size;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	file->DataSize = offset;
+}
+
+typedef struct TextureCookData_t {
+	const Image* Source;
+	TextureFormat Format;
+	u8* Output;
+} TextureCookData;
+
+static void TextureFile_EncodeBlockRows(void* data, u64 begin, u64 end) {
+	TextureCookData* cook = data;
+	const Image* source = cook->Source;
+	u32 blockSize = TextureFormat_GetBlockSize(cook->Format);
+	u32 blocksX = (source->Width + 3) / 4;
+
+	for (u64 blockY = begin; blockY < end; blockY++) {
+		for (u32 blockX = 0; blockX < blocksX; blockX++) {
+			// NOTE: Blocks hanging over the edge of small mips repeat the last row and column
+			u8 texels[BLOCK_COMPRESSION_BLOCK_TEXELS * 4];
+			for (u32 y = 0; y < 4; y++) {
+				u32 sourceY = cast(u32) blockY * 4 + y;
+				sourceY = sourceY < source->Height ? sourceY : source->Height - 1;
+				for (u32 x = 0; x < 4; x++) {
+					u32 sourceX = blockX * 4 + x;
+					sourceX = sourceX < source->Width ? sourceX : source->Width - 1;
+					memcpy(&texels[(y * 4 + x) * 4], &source->Pixels[(cast(u64) sourceY * source->Width + sourceX) * 4], 4);
+				}
+			}
+
+			u8* output = cook->Output + (blockY * blocksX + blockX) * blockSize;
+			switch (cook->Format) {
+				case TextureFormat_BC1: BlockCompression_EncodeBC1(texels, output); break;
+				case TextureFormat_BC5: BlockCompression_EncodeBC5(texels, output); break;
+				case TextureFormat_BC7: BlockCompression_EncodeBC7(texels, output); break;
+				default: ASSERT(false); break;
+			}
+		}
+	}
+}
+
+b8 TextureFile_Cook(TextureFile* file, const Image* image, TextureFormat format, b8 srgb) {
+	*file = (TextureFile){
+		.Format = format,
+		.Srgb = srgb && format != TextureFormat_BC5,
+		.Width = image->Width,
+		.Height = image->Height,
+		.LevelCount = Image_GetMipCount(image->Width, image->Height),
+	};
+
+	if (format >= TextureFormat_Count || file->LevelCount > TEXTURE_FILE_MAX_LEVELS) {
+		return false;
+	}
+
+	TextureFile_SetLevels(file);
+
+	Image mips[TEXTURE_FILE_MAX_LEVELS - 1] = {};
+	if (file->LevelCount > 1 && !Image_GenerateMips(image, mips, file->LevelCount - 1, file->Srgb)) {
+		return false;
+	}
+
+	file->Data = malloc(file->DataSize);
+	b8 result = file->Data != NULL;
+
+	for (u32 i = 0; result && i < file->LevelCount; i++) {
+		const Image* level = i == 0 ? image : &mips[i - 1];
+		u8* output = file->Data + file->Levels[i].Offset;
+
+		if (format == TextureFormat_RGBA8) {
+			memcpy(output, level->Pixels, file->Levels[i].Size);
+			continue;
+		}
+
+		TextureCookData cook = {
+			.Source = level,
+			.Format = format,
+			.Output = output,
+		};
+		JobSystem_ParallelFor((level->Height + 3) / 4, 4, TextureFile_EncodeBlockRows, &cook);
+	}
+
+	for (u32 i = 0; i + 1 < file->LevelCount; i++) {
+		Image_Destroy(&mips[i]);
+	}
+
+	if (!result) {
+		TextureFile_Destroy(file);
+	}
+
+	return result;
+}
+
+static u64 AlignUp(u64 value, u64 alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+b8 TextureFile_Save(const TextureFile* file, const char* filepath) {
+	FILE* output = fopen(filepath, "wb");
+	if (!output) {
+		return false;
+	}
+
+	TextureFileHeader header = {
+		.Format = file->Format,
+		.Flags = file->Srgb ? TEXTURE_FILE_FLAG_SRGB : 0,
+		.Width = file->Width,
+		.Height = file->Height,
+		.LevelCount = file->LevelCount,
+	};
+	memcpy(header.Identifier, TextureFileIdentifier, sizeof(TextureFileIdentifier));
+
+	TextureFileLevelIndex index[TEXTURE_FILE_MAX_LEVELS] = {};
+	u64 offset = sizeof(header) + file->LevelCount * sizeof(index[0]);
+	for (u32 i = 0; i < file->LevelCount; i++) {
+		offset = AlignUp(offset, TEXTURE_FILE_LEVEL_ALIGNMENT);
+		index[i] = (TextureFileLevelIndex){
+			.Offset = offset,
+			.Size = file->Levels[i].Size,
+		};
+		offset += file->Levels[i].Size;
+	}
+
+	b8 result = fwrite(&header, sizeof(header), 1, output) == 1 &&
+		fwrite(index, sizeof(index[0]), file->LevelCount, output) == file->LevelCount;
+
+	static const u8 Padding[TEXTURE_FILE_LEVEL_ALIGNMENT] = {};
+	u64 position = sizeof(header) + file->LevelCount * sizeof(index[0]);
+	for (u32 i = 0; result && i < file->LevelCount; i++) {
+		u64 paddingSize = index[i].Offset - position;
+		result = fwrite(Padding, 1, paddingSize, output) == paddingSize &&
+			fwrite(file->Data + file->Levels[i].Offset, 1, index[i].Size, output) == index[i].Size;
+		position = index[i].Offset + index[i].Size;
+	}
+
+	return fclose(output) == 0 && result;
+}
+
+b8 TextureFile_LoadFromMemory(TextureFile* file, const u8* data, u64 size) {
+	*file = (TextureFile){};
+
+	TextureFileHeader header = {};
+	if (size < sizeof(header)) {
+		return false;
+	}
+
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.Identifier, TextureFileIdentifier, sizeof(TextureFileIdentifier)) != 0 ||
+		header.Format >= TextureFormat_Count ||
+		header.Width == 0 || header.Height == 0 ||
+		header.LevelCount == 0 || header.LevelCount > Image_GetMipCount(header.Width, header.Height)
+	) {
+		return false;
+	}
+
+	TextureFileLevelIndex index[TEXTURE_FILE_MAX_LEVELS] = {};
+	if (size < sizeof(header) + header.LevelCount * sizeof(index[0])) {
+		return false;
+	}
+	memcpy(index, data + sizeof(header), header.LevelCount * sizeof(index[0]));
+
+	file->Format = header.Format;
+	file->Srgb = (header.Flags & TEXTURE_FILE_FLAG_SRGB) != 0;
+	file->Width = header.Width;
+	file->Height = header.Height;
+	file->LevelCount = header.LevelCount;
+	TextureFile_SetLevels(file);
+
+	for (u32 i = 0; i < file->LevelCount; i++) {
+		if (index[i].Size != file->Levels[i].Size || index[i].Offset > size || index[i].Size > size - index[i].Offset) {
+			return false;
+		}
+	}
+
+	file->Data = malloc(file->DataSize);
+	if (!file->Data) {
+		return false;
+	}
+
+	for (u32 i = 0; i < file->LevelCount; i++) {
+		memcpy(file->Data + file->Levels[i].Offset, data + index[i].Offset, index[i].Size);
+	}
+
+	return true;
+}
+
+b8 TextureFile_Load(TextureFile* file, const char* filepath) {
+	*file = (TextureFile){};
+
+	FILE* input = fopen(filepath, "rb");
+	if (!input) {
+		return false;
+	}
+
+	fseek(input, 0, SEEK_END);
+	u64 size = ftell(input);
+	fseek(input, 0, SEEK_SET);
+
+	if (size == 0) {
+		fclose(input);
+		return false;
+	}
+
+	u8* data = malloc(size);
+	if (!data) {
+		fclose(input);
+		return false;
+	}
+
+	size = fread(data, 1, size, input);
+	fclose(input);
+
+	b8 result = TextureFile_LoadFromMemory(file, data, size);
+	free(data);
+	return result;
+}
+
+void TextureFile_Destroy(TextureFile* file) {
+	free(file->Data);
+	*file = (TextureFile){};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "ImageLoader.h"
+
+// NOTE: Cooked textures are stored in a small KTX2 like container, every mip level is already in the GPU format
+// so the runtime only has to copy the levels into a staging buffer
+#define TEXTURE_FILE_MAX_LEVELS 32
+#define TEXTURE_FILE_EXTENSION ".rtx"
+
+typedef enum TextureFormat_t {
+	TextureFormat_RGBA8,
+	TextureFormat_BC1, // RGB, 8 bytes per block
+	TextureFormat_BC5, // RG, 16 bytes per block
+	TextureFormat_BC7, // RGBA, 16 bytes per block
+	TextureFormat_Count,
+} TextureFormat;
+
+typedef struct TextureLevel_t {
+	u32 Width;
+	u32 Height;
+	u64 Offset; // Into TextureFile.Data
+	u64 Size;
+} TextureLevel;
+
+typedef struct TextureFile_t {
+	TextureFormat Format;
+	b8 Srgb;
+	u32 Width;
+	u32 Height;
+	u32 LevelCount;
+	TextureLevel Levels[TEXTURE_FILE_MAX_LEVELS];
+
+	u8* Data;
+	u64 DataSize;
+} TextureFile;
+
+const char* TextureFormat_GetName(TextureFormat format);
+b8 TextureFormat_FromName(TextureFormat* format, const char* name);
+u64 TextureFormat_GetLevelSize(TextureFormat format, u32 width, u32 height);
+
+// NOTE: Builds the full mip chain of image and encodes every level, the blocks are split across the job system
+b8 TextureFile_Cook(TextureFile* file, const Image* image, TextureFormat format, b8 srgb);
+b8 TextureFile_Save(const TextureFile* file, const char* filepath);
+b8 TextureFile_Load(TextureFile* file, const char* filepath);
+b8 TextureFile_LoadFromMemory(TextureFile* file, const u8* data, u64 size);
+void TextureFile_Destroy(TextureFile* file);
@@ -0,0 +1,54 @@
+#include "Timer.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+#include <Windows.h>
+
+f64 Timer_GetSeconds() {
+	static f64 InverseFrequency = 0.0;
+	if (InverseFrequency == 0.0) {
+		LARGE_INTEGER frequency = {};
+		QueryPerformanceFrequency(&frequency);
+		InverseFrequency = 1.0 / cast(f64) frequency.QuadPart;
+	}
+
+	LARGE_INTEGER counter = {};
+	QueryPerformanceCounter(&counter);
+	return cast(f64) counter.QuadPart * InverseFrequency;
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+	#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void Timer_SleepUntil(f64 seconds) {
+	// NOTE: A high resolution waitable timer wakes up within a fraction of a millisecond. Without one (before Windows 10 1803)
+	// Sleep only has the default scheduler tick of about 15.6 ms, so the whole last tick is spun instead of overshooting it
+	static HANDLE WaitableTimer = NULL;
+	static f64 SpinSeconds = 0.0;
+	if (SpinSeconds == 0.0) {
+		WaitableTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		SpinSeconds = WaitableTimer ? 0.0005 : 0.016;
+	}
+
+	f64 remaining = seconds - Timer_GetSeconds();
+	if (remaining > SpinSeconds) {
+		if (WaitableTimer) {
+			// NOTE: Negative due times are relative, in 100 nanosecond units
+			LARGE_INTEGER dueTime = { .QuadPart = -cast(LONGLONG) ((remaining - SpinSeconds) * 10000000.0) };
+			if (SetWaitableTimer(WaitableTimer, &dueTime, 0, NULL, NULL, FALSE)) {
+				WaitForSingleObject(WaitableTimer, INFINITE);
+			}
+		} else {
+			Sleep(cast(DWORD) ((remaining - SpinSeconds) * 1000.0));
+		}
+	}
+
+	while (Timer_GetSeconds() < seconds) {
+		YieldProcessor();
+	}
+}
+
+#else
+	#error This platform is not supported
+#endif
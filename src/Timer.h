@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Typedefs.h"
+
+f64 Timer_GetSeconds();
+// NOTE: Seconds on the same clock as Timer_GetSeconds
+void Timer_SleepUntil(f64 seconds);
@@ -12,3 +12,10 @@ typedef struct Vector3_t {
 	f32 y;
 	f32 z;
 } Vector3;
+
+typedef struct Vector4_t {
+	f32 x;
+	f32 y;
+	f32 z;
+	f32 w;
+} Vector4;
@@ -0,0 +1,302 @@
+#include "VulkanBindless.h"
+
+#include <stdlib.h>
+
+static b8 BindlessSlots_Create(BindlessSlots* slots, u32 capacity) {
+	*slots = (BindlessSlots){
+		.Capacity = capacity,
+		.FreeSlots = malloc(capacity * sizeof(slots->FreeSlots[0])),
+	};
+	return slots->FreeSlots != NULL;
+}
+
+static void BindlessSlots_Destroy(BindlessSlots* slots) {
+	free(slots->FreeSlots);
+	*slots = (BindlessSlots){};
+}
+
+static BindlessHandle BindlessSlots_Allocate(BindlessSlots* slots) {
+	if (slots->FreeCount > 0) {
+		return slots->FreeSlots[--slots->FreeCount];
+	}
+
+	if (slots->Count == slots->Capacity) {
+		return BINDLESS_HANDLE_NONE;
+	}
+
+	return slots->Count++;
+}
+
+static void BindlessSlots_Free(BindlessSlots* slots, BindlessHandle handle) {
+	ASSERT(handle < slots->Count);
+	ASSERT(slots->FreeCount < slots->Capacity);
+	slots->FreeSlots[slots->FreeCount++] = handle;
+}
+
+static u32 Min(u32 a, u32 b) {
+	return a < b ? a : b;
+}
+
+void VulkanBindless_RequireFeatures(VkPhysicalDeviceVulkan12Features* features) {
+	features->descriptorIndexing = VK_TRUE;
+	features->runtimeDescriptorArray = VK_TRUE;
+	features->descriptorBindingPartiallyBound = VK_TRUE;
+	features->descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	features->descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	features->descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+	features->shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+	features->shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+}
+
+b8 VulkanBindless_Create(VulkanBindless* bindless, VkDevice device, VkPhysicalDevice physicalDevice) {
+	*bindless = (VulkanBindless){
+		.Device = device,
+	};
+
+	VkPhysicalDeviceVulkan12Properties properties12 = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES,
+	};
+	vkGetPhysicalDeviceProperties2(physicalDevice, &(VkPhysicalDeviceProperties2){
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+		.pNext = &properties12,
+	});
+
+	// NOTE: The arrays are sized to the device limits, PARTIALLY_BOUND lets most of the slots stay empty
+	u32 storageBufferCount = Min(BINDLESS_MAX_STORAGE_BUFFERS, Min(
+		properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+		properties12.maxDescriptorSetUpdateAfterBindStorageBuffers
+	));
+	u32 sampledImageCount = Min(BINDLESS_MAX_SAMPLED_IMAGES, Min(
+		properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		properties12.maxDescriptorSetUpdateAfterBindSampledImages
+	));
+	u32 samplerCount = Min(BINDLESS_MAX_SAMPLERS, Min(
+		properties12.maxPerStageDescriptorUpdateAfterBindSamplers,
+		properties12.maxDescriptorSetUpdateAfterBindSamplers
+	));
+	u32 storageImageCount = Min(BINDLESS_MAX_STORAGE_IMAGES, Min(
+		properties12.maxPerStageDescriptorUpdateAfterBindStorageImages,
+		properties12.maxDescriptorSetUpdateAfterBindStorageImages
+	));
+
+	if (storageBufferCount == 0 || sampledImageCount == 0 || samplerCount == 0 || storageImageCount == 0) {
+		return false;
+	}
+
+	if (!BindlessSlots_Create(&bindless->StorageBuffers, storageBufferCount) ||
+		!BindlessSlots_Create(&bindless->SampledImages, sampledImageCount) ||
+		!BindlessSlots_Create(&bindless->Samplers, samplerCount) ||
+		!BindlessSlots_Create(&bindless->StorageImages, storageImageCount)
+	) {
+		VulkanBindless_Destroy(bindless);
+		return false;
+	}
+
+	const VkDescriptorBindingFlags BindingFlags =
+		VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+		VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+	if (vkCreateDescriptorSetLayout(device, &(VkDescriptorSetLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+		.pNext = &(VkDescriptorSetLayoutBindingFlagsCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.bindingCount = 4,
+			.pBindingFlags = (VkDescriptorBindingFlags[4]){ BindingFlags, BindingFlags, BindingFlags, BindingFlags },
+		},
+		.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+		.bindingCount = 4,
+		.pBindings = (VkDescriptorSetLayoutBinding[4]){
+			{
+				.binding = BINDLESS_STORAGE_BUFFER_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = storageBufferCount,
+				.stageFlags = VK_SHADER_STAGE_ALL,
+			},
+			{
+				.binding = BINDLESS_SAMPLED_IMAGE_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+				.descriptorCount = sampledImageCount,
+				.stageFlags = VK_SHADER_STAGE_ALL,
+			},
+			{
+				.binding = BINDLESS_SAMPLER_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+				.descriptorCount = samplerCount,
+				.stageFlags = VK_SHADER_STAGE_ALL,
+			},
+			{
+				.binding = BINDLESS_STORAGE_IMAGE_BINDING,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				.descriptorCount = storageImageCount,
+				.stageFlags = VK_SHADER_STAGE_ALL,
+			},
+		},
+	}, NULL, &bindless->SetLayout) != VK_SUCCESS) {
+		VulkanBindless_Destroy(bindless);
+		return false;
+	}
+
+	if (vkCreateDescriptorPool(device, &(VkDescriptorPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+		.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+		.maxSets = 1,
+		.poolSizeCount = 4,
+		.pPoolSizes = (VkDescriptorPoolSize[4]){
+			{
+				.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = storageBufferCount,
+			},
+			{
+				.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+				.descriptorCount = sampledImageCount,
+			},
+			{
+				.type = VK_DESCRIPTOR_TYPE_SAMPLER,
+				.descriptorCount = samplerCount,
+			},
+			{
+				.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				.descriptorCount = storageImageCount,
+			},
+		},
+	}, NULL, &bindless->Pool) != VK_SUCCESS) {
+		VulkanBindless_Destroy(bindless);
+		return false;
+	}
+
+	if (vkAllocateDescriptorSets(device, &(VkDescriptorSetAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+		.descriptorPool = bindless->Pool,
+		.descriptorSetCount = 1,
+		.pSetLayouts = &bindless->SetLayout,
+	}, &bindless->Set) != VK_SUCCESS) {
+		VulkanBindless_Destroy(bindless);
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanBindless_Destroy(VulkanBindless* bindless) {
+	if (bindless->Pool != VK_NULL_HANDLE) {
+		vkDestroyDescriptorPool(bindless->Device, bindless->Pool, NULL);
+	}
+
+	if (bindless->SetLayout != VK_NULL_HANDLE) {
+		vkDestroyDescriptorSetLayout(bindless->Device, bindless->SetLayout, NULL);
+	}
+
+	BindlessSlots_Destroy(&bindless->StorageBuffers);
+	BindlessSlots_Destroy(&bindless->SampledImages);
+	BindlessSlots_Destroy(&bindless->Samplers);
+	BindlessSlots_Destroy(&bindless->StorageImages);
+
+	*bindless = (VulkanBindless){};
+}
+
+BindlessHandle VulkanBindless_AddStorageBuffer(VulkanBindless* bindless, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+	BindlessHandle handle = BindlessSlots_Allocate(&bindless->StorageBuffers);
+	if (handle == BINDLESS_HANDLE_NONE) {
+		return BINDLESS_HANDLE_NONE;
+	}
+
+	vkUpdateDescriptorSets(bindless->Device, 1, &(VkWriteDescriptorSet){
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = bindless->Set,
+		.dstBinding = BINDLESS_STORAGE_BUFFER_BINDING,
+		.dstArrayElement = handle,
+		.descriptorCount = 1,
+		.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		.pBufferInfo = &(VkDescriptorBufferInfo){
+			.buffer = buffer,
+			.offset = offset,
+			.range = range,
+		},
+	}, 0, NULL);
+
+	return handle;
+}
+
+BindlessHandle VulkanBindless_AddSampledImage(VulkanBindless* bindless, VkImageView imageView, VkImageLayout layout) {
+	BindlessHandle handle = BindlessSlots_Allocate(&bindless->SampledImages);
+	if (handle == BINDLESS_HANDLE_NONE) {
+		return BINDLESS_HANDLE_NONE;
+	}
+
+	vkUpdateDescriptorSets(bindless->Device, 1, &(VkWriteDescriptorSet){
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = bindless->Set,
+		.dstBinding = BINDLESS_SAMPLED_IMAGE_BINDING,
+		.dstArrayElement = handle,
+		.descriptorCount = 1,
+		.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+		.pImageInfo = &(VkDescriptorImageInfo){
+			.imageView = imageView,
+			.imageLayout = layout,
+		},
+	}, 0, NULL);
+
+	return handle;
+}
+
+BindlessHandle VulkanBindless_AddSampler(VulkanBindless* bindless, VkSampler sampler) {
+	BindlessHandle handle = BindlessSlots_Allocate(&bindless->Samplers);
+	if (handle == BINDLESS_HANDLE_NONE) {
+		return BINDLESS_HANDLE_NONE;
+	}
+
+	vkUpdateDescriptorSets(bindless->Device, 1, &(VkWriteDescriptorSet){
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = bindless->Set,
+		.dstBinding = BINDLESS_SAMPLER_BINDING,
+		.dstArrayElement = handle,
+		.descriptorCount = 1,
+		.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+		.pImageInfo = &(VkDescriptorImageInfo){
+			.sampler = sampler,
+		},
+	}, 0, NULL);
+
+	return handle;
+}
+
+BindlessHandle VulkanBindless_AddStorageImage(VulkanBindless* bindless, VkImageView imageView) {
+	BindlessHandle handle = BindlessSlots_Allocate(&bindless->StorageImages);
+	if (handle == BINDLESS_HANDLE_NONE) {
+		return BINDLESS_HANDLE_NONE;
+	}
+
+	vkUpdateDescriptorSets(bindless->Device, 1, &(VkWriteDescriptorSet){
+		.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+		.dstSet = bindless->Set,
+		.dstBinding = BINDLESS_STORAGE_IMAGE_BINDING,
+		.dstArrayElement = handle,
+		.descriptorCount = 1,
+		.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+		.pImageInfo = &(VkDescriptorImageInfo){
+			.imageView = imageView,
+			.imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+		},
+	}, 0, NULL);
+
+	return handle;
+}
+
+// NOTE: Removed slots keep their stale descriptor, PARTIALLY_BOUND means that is fine as long as no shader reads it
+void VulkanBindless_RemoveStorageBuffer(VulkanBindless* bindless, BindlessHandle handle) {
+	BindlessSlots_Free(&bindless->StorageBuffers, handle);
+}
+
+void VulkanBindless_RemoveSampledImage(VulkanBindless* bindless, BindlessHandle handle) {
+	BindlessSlots_Free(&bindless->SampledImages, handle);
+}
+
+void VulkanBindless_RemoveSampler(VulkanBindless* bindless, BindlessHandle handle) {
+	BindlessSlots_Free(&bindless->Samplers, handle);
+}
+
+void VulkanBindless_RemoveStorageImage(VulkanBindless* bindless, BindlessHandle handle) {
+	BindlessSlots_Free(&bindless->StorageImages, handle);
+}
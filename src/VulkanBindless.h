@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+#define BINDLESS_STORAGE_BUFFER_BINDING 0
+#define BINDLESS_SAMPLED_IMAGE_BINDING 1
+#define BINDLESS_SAMPLER_BINDING 2
+#define BINDLESS_STORAGE_IMAGE_BINDING 3
+
+#define BINDLESS_MAX_STORAGE_BUFFERS 16384
+#define BINDLESS_MAX_SAMPLED_IMAGES 16384
+#define BINDLESS_MAX_SAMPLERS 64
+#define BINDLESS_MAX_STORAGE_IMAGES 1024
+
+typedef u32 BindlessHandle;
+
+#define BINDLESS_HANDLE_NONE (~0u)
+
+typedef struct BindlessSlots_t {
+	u32 Capacity;
+	u32 Count; // Slots that have ever been handed out
+	u32* FreeSlots;
+	u32 FreeCount;
+} BindlessSlots;
+
+// NOTE: One global update-after-bind descriptor set, shaders index the arrays with BindlessHandles.
+// Not thread safe, handles must not be removed while a submitted frame can still use them
+typedef struct VulkanBindless_t {
+	VkDevice Device;
+	VkDescriptorSetLayout SetLayout;
+	VkDescriptorPool Pool;
+	VkDescriptorSet Set;
+
+	BindlessSlots StorageBuffers;
+	BindlessSlots SampledImages;
+	BindlessSlots Samplers;
+	BindlessSlots StorageImages;
+} VulkanBindless;
+
+// NOTE: Fills in the VkPhysicalDeviceVulkan12Features members the bindless set needs
+void VulkanBindless_RequireFeatures(VkPhysicalDeviceVulkan12Features* features);
+
+b8 VulkanBindless_Create(VulkanBindless* bindless, VkDevice device, VkPhysicalDevice physicalDevice);
+void VulkanBindless_Destroy(VulkanBindless* bindless);
+
+BindlessHandle VulkanBindless_AddStorageBuffer(VulkanBindless* bindless, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+BindlessHandle VulkanBindless_AddSampledImage(VulkanBindless* bindless, VkImageView imageView, VkImageLayout layout);
+BindlessHandle VulkanBindless_AddSampler(VulkanBindless* bindless, VkSampler sampler);
+// NOTE: Storage images are always accessed in VK_IMAGE_LAYOUT_GENERAL
+BindlessHandle VulkanBindless_AddStorageImage(VulkanBindless* bindless, VkImageView imageView);
+
+void VulkanBindless_RemoveStorageBuffer(VulkanBindless* bindless, BindlessHandle handle);
+void VulkanBindless_RemoveSampledImage(VulkanBindless* bindless, BindlessHandle handle);
+void VulkanBindless_RemoveSampler(VulkanBindless* bindless, BindlessHandle handle);
+void VulkanBindless_RemoveStorageImage(VulkanBindless* bindless, BindlessHandle handle);
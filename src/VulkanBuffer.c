@@ -0,0 +1,133 @@
+#include "VulkanBuffer.h"
+#include "VulkanUtil.h"
+#include "VulkanMemoryBudget.h"
+
+static u32 VulkanBuffer_SelectMemoryType(const VkPhysicalDeviceMemoryProperties* memoryProperties, u32 memoryTypeBits, VkMemoryPropertyFlags propertyFlags) {
+	for (u32 i = 0; i < memoryProperties->memoryTypeCount; i++) {
+		if ((memoryTypeBits & (1 << i)) != 0 && (memoryProperties->memoryTypes[i].propertyFlags & propertyFlags) == propertyFlags) {
+			return i;
+		}
+	}
+
+	return ~0u;
+}
+
+static b8 VulkanBuffer_CreateWithMemory(
+	VulkanBuffer* buffer,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	u64 size,
+	VkBufferUsageFlags usageFlags,
+	VkMemoryPropertyFlags memoryFlags,
+	VkMemoryPropertyFlags preferredFlags
+) {
+	buffer->Buffer = VK_NULL_HANDLE;
+	buffer->Device = device;
+	buffer->PhysicalDevice = physicalDevice;
+	buffer->Memory = VK_NULL_HANDLE;
+	buffer->HeapIndex = 0;
+	buffer->AllocationSize = 0;
+	buffer->Data = NULL;
+	buffer->Size = size;
+	buffer->DeviceAddress = 0;
+	buffer->UsageFlags = usageFlags;
+
+	VkCheck(vkCreateBuffer(device, &(VkBufferCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		.size = size,
+		.usage = buffer->UsageFlags,
+		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+	}, NULL, &buffer->Buffer));
+
+	if (buffer->Buffer == VK_NULL_HANDLE) {
+		return false;
+	}
+
+	VkPhysicalDeviceMemoryProperties memoryProperties = {};
+	vkGetPhysicalDeviceMemoryProperties(buffer->PhysicalDevice, &memoryProperties);
+
+	VkMemoryRequirements memoryRequirements = {};
+	vkGetBufferMemoryRequirements(buffer->Device, buffer->Buffer, &memoryRequirements);
+	
+	u32 memoryTypeIndex = VulkanBuffer_SelectMemoryType(&memoryProperties, memoryRequirements.memoryTypeBits, memoryFlags | preferredFlags);
+	if (memoryTypeIndex == ~0u) {
+		memoryTypeIndex = VulkanBuffer_SelectMemoryType(&memoryProperties, memoryRequirements.memoryTypeBits, memoryFlags);
+	}
+	ASSERT(memoryTypeIndex != ~0u);
+
+	b8 needsDeviceAddress = (buffer->UsageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0;
+
+	VkCheck(vkAllocateMemory(buffer->Device, &(VkMemoryAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		.pNext = needsDeviceAddress ? &(VkMemoryAllocateFlagsInfo){
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+			.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+		} : NULL,
+		.allocationSize = memoryRequirements.size,
+		.memoryTypeIndex = memoryTypeIndex,
+	}, NULL, &buffer->Memory));
+
+	if (buffer->Memory == VK_NULL_HANDLE) {
+		return false;
+	}
+
+	buffer->HeapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+	buffer->AllocationSize = memoryRequirements.size;
+	VulkanMemoryBudget_TrackAllocation(buffer->HeapIndex, buffer->AllocationSize);
+
+	VkCheck(vkBindBufferMemory(buffer->Device, buffer->Buffer, buffer->Memory, 0));
+
+	if (needsDeviceAddress) {
+		buffer->DeviceAddress = vkGetBufferDeviceAddress(buffer->Device, &(VkBufferDeviceAddressInfo){
+			.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+			.buffer = buffer->Buffer,
+		});
+
+		if (buffer->DeviceAddress == 0) {
+			return false;
+		}
+	}
+
+	if ((memoryFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+		return true;
+	}
+
+	VkCheck(vkMapMemory(buffer->Device, buffer->Memory, 0, buffer->Size, 0, &buffer->Data));
+	
+	if (buffer->Data == NULL) {
+		return false;
+	}
+
+	return true;
+}
+
+b8 VulkanBuffer_Create(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags) {
+	return VulkanBuffer_CreateWithMemory(buffer, device, physicalDevice, size, usageFlags, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0);
+}
+
+b8 VulkanBuffer_CreateReadback(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags) {
+	return VulkanBuffer_CreateWithMemory(
+		buffer,
+		device,
+		physicalDevice,
+		size,
+		usageFlags,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		VK_MEMORY_PROPERTY_HOST_CACHED_BIT
+	);
+}
+
+b8 VulkanBuffer_CreateDeviceLocal(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags) {
+	return VulkanBuffer_CreateWithMemory(buffer, device, physicalDevice, size, usageFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0);
+}
+
+void VulkanBuffer_Destroy(VulkanBuffer* buffer) {
+	if (buffer->Data != NULL) {
+		vkUnmapMemory(buffer->Device, buffer->Memory);
+	}
+	if (buffer->Memory != VK_NULL_HANDLE) {
+		VulkanMemoryBudget_TrackFree(buffer->HeapIndex, buffer->AllocationSize);
+	}
+	vkFreeMemory(buffer->Device, buffer->Memory, NULL);
+	vkDestroyBuffer(buffer->Device, buffer->Buffer, NULL);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+typedef struct VulkanBuffer_t {
+	VkBuffer Buffer;
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VkDeviceMemory Memory;
+	u32 HeapIndex;
+	u64 AllocationSize; // NOTE: What was counted against the heap, can be larger than Size
+	void* Data;
+	u64 Size;
+	VkDeviceAddress DeviceAddress; // NOTE: Only set when created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+
+	VkBufferUsageFlags UsageFlags;
+} VulkanBuffer;
+
+b8 VulkanBuffer_Create(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags);
+// NOTE: Mapped like VulkanBuffer_Create but prefers cached memory, which the CPU reads back much faster than write combined memory
+b8 VulkanBuffer_CreateReadback(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags);
+// NOTE: Not mapped, Data stays NULL, so it has to be filled with a transfer
+b8 VulkanBuffer_CreateDeviceLocal(VulkanBuffer* buffer, VkDevice device, VkPhysicalDevice physicalDevice, u64 size, VkBufferUsageFlags usageFlags);
+void VulkanBuffer_Destroy(VulkanBuffer* buffer);
@@ -0,0 +1,146 @@
+#include "VulkanCapturePool.h"
+#include "VulkanUtil.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE: Converts the readback to RGBA, hands it to the callback and frees the slot
+static void VulkanCapturePool_ConsumeJob(void* data, u64 index) {
+	(void)index;
+	CaptureSlot* slot = data;
+
+	slot->Image.Width = slot->Width;
+	slot->Image.Height = slot->Height;
+	u64 pixelCount = cast(u64) slot->Width * slot->Height;
+	const u8* source = slot->Readback.Data;
+	u8* pixels = slot->Image.Pixels;
+	if (slot->Bgra) {
+		for (u64 i = 0; i < pixelCount; i++) {
+			pixels[i * 4 + 0] = source[i * 4 + 2];
+			pixels[i * 4 + 1] = source[i * 4 + 1];
+			pixels[i * 4 + 2] = source[i * 4 + 0];
+			pixels[i * 4 + 3] = source[i * 4 + 3];
+		}
+	} else {
+		memcpy(pixels, source, pixelCount * 4);
+	}
+
+	slot->Pool->Callback(&slot->Image, slot->Frame, slot->Pool->UserData);
+	atomic_store(&slot->State, CaptureSlotState_Free);
+}
+
+b8 VulkanCapturePool_Create(VulkanCapturePool* pool, VkDevice device, VkPhysicalDevice physicalDevice, u32 slotCount, CaptureCallback callback, void* userData) {
+	ASSERT(slotCount > 0 && slotCount <= VULKAN_CAPTURE_POOL_MAX_SLOTS);
+	ASSERT(callback);
+	*pool = (VulkanCapturePool){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.Callback = callback,
+		.UserData = userData,
+		.SlotCount = slotCount,
+		.CurrentSlot = ~0u,
+	};
+
+	// NOTE: The readback buffers are created by the first capture that uses them, so their size follows the swapchain
+	for (u32 i = 0; i < slotCount; i++) {
+		CaptureSlot* slot = &pool->Slots[i];
+		atomic_init(&slot->State, CaptureSlotState_Free);
+		slot->Pool = pool;
+	}
+	return true;
+}
+
+void VulkanCapturePool_Destroy(VulkanCapturePool* pool) {
+	for (u32 i = 0; i < pool->SlotCount; i++) {
+		CaptureSlot* slot = &pool->Slots[i];
+		JobSystem_Wait(&slot->Counter);
+		if (slot->Readback.Buffer != VK_NULL_HANDLE) {
+			VulkanBuffer_Destroy(&slot->Readback);
+		}
+		Image_Destroy(&slot->Image);
+	}
+	*pool = (VulkanCapturePool){};
+}
+
+void VulkanCapturePool_Update(VulkanCapturePool* pool, u64 safeFrame) {
+	for (u32 i = 0; i < pool->SlotCount; i++) {
+		CaptureSlot* slot = &pool->Slots[i];
+		if (atomic_load(&slot->State) != CaptureSlotState_Copying || slot->Frame >= safeFrame) {
+			continue;
+		}
+
+		// NOTE: The buffer is host coherent and the graph made the copy visible to the host before the frame's fence
+		// signaled, so the job can read it as it is
+		atomic_store(&slot->State, CaptureSlotState_Consuming);
+		pool->CapturedCount++;
+		JobSystem_Run(&(Job){ .Function = VulkanCapturePool_ConsumeJob, .Data = slot }, 1, &slot->Counter);
+	}
+}
+
+b8 VulkanCapturePool_BeginCapture(VulkanCapturePool* pool, u64 frame, u32 width, u32 height, VkFormat format) {
+	ASSERT(pool->CurrentSlot == ~0u);
+
+	b8 bgra = false;
+	switch (format) {
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB: bgra = false; break;
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB: bgra = true; break;
+		default: {
+			pool->DroppedCount++;
+			return false;
+		}
+	}
+
+	CaptureSlot* slot = NULL;
+	for (u32 i = 0; i < pool->SlotCount; i++) {
+		if (atomic_load(&pool->Slots[i].State) == CaptureSlotState_Free) {
+			slot = &pool->Slots[i];
+			pool->CurrentSlot = i;
+			break;
+		}
+	}
+	if (slot == NULL) {
+		pool->DroppedCount++;
+		return false;
+	}
+
+	u64 size = cast(u64) width * height * 4;
+	if (slot->Readback.Size < size) {
+		if (slot->Readback.Buffer != VK_NULL_HANDLE) {
+			VulkanBuffer_Destroy(&slot->Readback);
+		}
+		u8* pixels = realloc(slot->Image.Pixels, size);
+		if (pixels == NULL || !VulkanBuffer_CreateReadback(&slot->Readback, pool->Device, pool->PhysicalDevice, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+			slot->Image.Pixels = pixels ? pixels : slot->Image.Pixels;
+			slot->Readback = (VulkanBuffer){};
+			pool->CurrentSlot = ~0u;
+			pool->DroppedCount++;
+			return false;
+		}
+		slot->Image.Pixels = pixels;
+	}
+
+	slot->Frame = frame;
+	slot->Width = width;
+	slot->Height = height;
+	slot->Bgra = bgra;
+	atomic_store(&slot->State, CaptureSlotState_Copying);
+	return true;
+}
+
+void VulkanCapturePool_RecordCopy(VulkanCapturePool* pool, VkCommandBuffer commandBuffer, VkImage image) {
+	if (pool->CurrentSlot == ~0u) {
+		return;
+	}
+	CaptureSlot* slot = &pool->Slots[pool->CurrentSlot];
+	pool->CurrentSlot = ~0u;
+
+	vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->Readback.Buffer, 1, &(VkBufferImageCopy){
+		.imageSubresource = (VkImageSubresourceLayers){
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.layerCount = 1,
+		},
+		.imageExtent = (VkExtent3D){ slot->Width, slot->Height, 1 },
+	});
+}
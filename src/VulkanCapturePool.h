@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "ImageLoader.h"
+#include "JobSystem.h"
+#include "VulkanBuffer.h"
+
+#include <vulkan/vulkan.h>
+#include <stdatomic.h>
+
+#define VULKAN_CAPTURE_POOL_MAX_SLOTS 8
+
+typedef enum CaptureSlotState_t {
+	CaptureSlotState_Free,
+	CaptureSlotState_Copying,   // The copy was recorded into Frame, which may still be on the GPU
+	CaptureSlotState_Consuming, // Converted and handed to the callback on the job system
+} CaptureSlotState;
+
+// NOTE: Runs on a job system thread, image is only valid during the call. Several captures may be consumed at the same time
+typedef void (*CaptureCallback)(const Image* image, u64 frame, void* userData);
+
+typedef struct CaptureSlot_t {
+	_Atomic u32 State;
+	u64 Frame;
+	u32 Width;
+	u32 Height;
+	b8 Bgra;
+
+	VulkanBuffer Readback; // Grown when a capture does not fit, only while the slot is Free
+	Image Image;           // RGBA copy of Readback, reused between captures
+	struct VulkanCapturePool_t* Pool;
+	JobCounter Counter;
+} CaptureSlot;
+
+// NOTE: Reads frames back without stalling the frame loop. VulkanCapturePool_BeginCapture claims a free slot for the frame
+// being recorded, VulkanCapturePool_RecordCopy copies the image into the slot's host visible buffer, and once the frame's fence
+// has been waited for VulkanCapturePool_Update hands the pixels to the callback on the job system. When every slot is still
+// busy the capture is dropped rather than waited for. Only used from the render thread, apart from the callback
+typedef struct VulkanCapturePool_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	CaptureCallback Callback;
+	void* UserData;
+
+	CaptureSlot Slots[VULKAN_CAPTURE_POOL_MAX_SLOTS];
+	u32 SlotCount;
+	u32 CurrentSlot; // Claimed for the frame being recorded, ~0u when it is not captured
+
+	u64 CapturedCount; // Handed to the callback
+	u64 DroppedCount;  // Requested while every slot was busy, or with an unsupported format
+} VulkanCapturePool;
+
+b8 VulkanCapturePool_Create(VulkanCapturePool* pool, VkDevice device, VkPhysicalDevice physicalDevice, u32 slotCount, CaptureCallback callback, void* userData);
+// NOTE: Waits for the callbacks that are still running, nothing recorded with the pool may still be in flight
+void VulkanCapturePool_Destroy(VulkanCapturePool* pool);
+
+// NOTE: Call once per frame from the render thread. safeFrame is the oldest frame that may still be on the GPU, the captures of
+// every earlier frame are handed to the callback
+void VulkanCapturePool_Update(VulkanCapturePool* pool, u64 safeFrame);
+
+// NOTE: Claims a slot for frame, which is the one being recorded. Returns false without waiting when no slot is free or format is
+// not 8 bit RGBA or BGRA
+b8 VulkanCapturePool_BeginCapture(VulkanCapturePool* pool, u64 frame, u32 width, u32 height, VkFormat format);
+// NOTE: Copies image, which is in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, into the claimed slot. Does nothing when the frame is not
+// captured. The copy has to be made visible to VK_PIPELINE_STAGE_HOST_BIT before the frame's fence signals
+void VulkanCapturePool_RecordCopy(VulkanCapturePool* pool, VkCommandBuffer commandBuffer, VkImage image);
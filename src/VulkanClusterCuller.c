@@ -0,0 +1,524 @@
+#include "VulkanClusterCuller.h"
+#include "VulkanUtil.h"
+
+// NOTE: Matches the PushConstants block in cluster_cull.comp.glsl
+typedef struct ClusterCullPushConstants_t {
+	Vector4 Viewer;
+	BindlessHandle UniformBufferHandle;
+	BindlessHandle ClusterBufferHandle;
+	BindlessHandle InstanceBufferHandle;
+	BindlessHandle ObjectBufferHandle;
+	BindlessHandle DrawBufferHandle;
+	u32 InstanceCount;
+	BindlessHandle PyramidHandle;
+	BindlessHandle SamplerHandle;
+	u32 DepthWidth;
+	u32 DepthHeight;
+	u32 PyramidLevelCount;
+} ClusterCullPushConstants;
+
+// NOTE: Matches the PushConstants block in depth_pyramid.comp.glsl
+typedef struct DepthPyramidPushConstants_t {
+	BindlessHandle SourceHandle;
+	u32 SourceLevel;
+	BindlessHandle DestinationHandle;
+	BindlessHandle SamplerHandle;
+	u32 SourceWidth;
+	u32 SourceHeight;
+	u32 DestinationWidth;
+	u32 DestinationHeight;
+} DepthPyramidPushConstants;
+
+STATIC_ASSERT(sizeof(ClusterCullPushConstants) >= sizeof(DepthPyramidPushConstants), "The pipeline layout is sized for the cull push constants");
+
+// NOTE: The draw count is padded to 16 bytes in front of the commands
+#define CLUSTER_DRAWS_OFFSET 16
+#define CLUSTER_MIN_CAPACITY 1024
+
+static u32 Max(u32 a, u32 b) {
+	return a > b ? a : b;
+}
+
+b8 VulkanClusterCuller_RequireFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures* features, VkPhysicalDeviceVulkan12Features* features12) {
+	VkPhysicalDeviceVulkan12Features supportedFeatures12 = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+	};
+	VkPhysicalDeviceFeatures2 supportedFeatures = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+		.pNext = &supportedFeatures12,
+	};
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+
+	if (!supportedFeatures.features.multiDrawIndirect || !supportedFeatures.features.drawIndirectFirstInstance || !supportedFeatures12.drawIndirectCount) {
+		return false;
+	}
+
+	features->multiDrawIndirect = VK_TRUE;
+	features->drawIndirectFirstInstance = VK_TRUE;
+	features12->drawIndirectCount = VK_TRUE;
+	return true;
+}
+
+static b8 VulkanClusterCuller_CreatePipeline(VulkanClusterCuller* culler, VkShaderModule shader, VkPipeline* pipeline) {
+	VkCheck(vkCreateComputePipelines(culler->Device, VK_NULL_HANDLE, 1, &(VkComputePipelineCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+		.stage = (VkPipelineShaderStageCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+			.module = shader,
+			.pName = "main",
+		},
+		.layout = culler->PipelineLayout,
+	}, NULL, pipeline));
+	return true;
+}
+
+b8 VulkanClusterCuller_Create(
+	VulkanClusterCuller* culler,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	VulkanImagePool* imagePool,
+	u32 frameCount,
+	VkShaderModule cullShader,
+	VkShaderModule pyramidShader
+) {
+	ASSERT(frameCount <= VULKAN_CLUSTER_CULLER_MAX_FRAMES);
+
+	*culler = (VulkanClusterCuller){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.Bindless = bindless,
+		.ImagePool = imagePool,
+		.FrameCount = frameCount,
+		.SamplerHandle = BINDLESS_HANDLE_NONE,
+		.DepthHandle = BINDLESS_HANDLE_NONE,
+		.PyramidHandle = BINDLESS_HANDLE_NONE,
+	};
+
+	for (u32 i = 0; i < frameCount; i++) {
+		ClusterCullerFrame* frame = &culler->Frames[i];
+		frame->InstancesHandle = BINDLESS_HANDLE_NONE;
+		frame->ObjectsHandle = BINDLESS_HANDLE_NONE;
+		frame->DrawsHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	for (u32 i = 0; i < frameCount; i++) {
+		ClusterCullerFrame* frame = &culler->Frames[i];
+		if (!VulkanBuffer_Create(&frame->Stats, device, physicalDevice, sizeof(u32), VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+			VulkanClusterCuller_Destroy(culler);
+			return false;
+		}
+		*cast(u32*) frame->Stats.Data = 0;
+	}
+
+	if (vkCreatePipelineLayout(device, &(VkPipelineLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		.setLayoutCount = 1,
+		.pSetLayouts = &bindless->SetLayout,
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = &(VkPushConstantRange){
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof(ClusterCullPushConstants),
+		},
+	}, NULL, &culler->PipelineLayout) != VK_SUCCESS ||
+		!VulkanClusterCuller_CreatePipeline(culler, cullShader, &culler->CullPipeline) ||
+		!VulkanClusterCuller_CreatePipeline(culler, pyramidShader, &culler->PyramidPipeline)
+	) {
+		VulkanClusterCuller_Destroy(culler);
+		return false;
+	}
+
+	if (vkCreateSampler(device, &(VkSamplerCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+		.magFilter = VK_FILTER_NEAREST,
+		.minFilter = VK_FILTER_NEAREST,
+		.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+		.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.minLod = 0.0f,
+		.maxLod = VK_LOD_CLAMP_NONE,
+	}, NULL, &culler->Sampler) != VK_SUCCESS) {
+		VulkanClusterCuller_Destroy(culler);
+		return false;
+	}
+
+	culler->SamplerHandle = VulkanBindless_AddSampler(bindless, culler->Sampler);
+	if (culler->SamplerHandle == BINDLESS_HANDLE_NONE) {
+		VulkanClusterCuller_Destroy(culler);
+		return false;
+	}
+
+	return true;
+}
+
+static void VulkanClusterCuller_RemoveHandle(VulkanBindless* bindless, BindlessHandle* handle) {
+	if (*handle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveStorageBuffer(bindless, *handle);
+		*handle = BINDLESS_HANDLE_NONE;
+	}
+}
+
+static void VulkanClusterCuller_DestroyBuffer(VulkanBuffer* buffer) {
+	if (buffer->Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(buffer);
+		*buffer = (VulkanBuffer){};
+	}
+}
+
+static void VulkanClusterCuller_DestroyPyramid(VulkanClusterCuller* culler) {
+	for (u32 i = 0; i < culler->PyramidLevelCount; i++) {
+		if (culler->PyramidLevelHandles[i] != BINDLESS_HANDLE_NONE) {
+			VulkanBindless_RemoveStorageImage(culler->Bindless, culler->PyramidLevelHandles[i]);
+		}
+		if (culler->PyramidLevelViews[i] != VK_NULL_HANDLE) {
+			vkDestroyImageView(culler->Device, culler->PyramidLevelViews[i], NULL);
+		}
+		culler->PyramidLevelHandles[i] = BINDLESS_HANDLE_NONE;
+		culler->PyramidLevelViews[i] = VK_NULL_HANDLE;
+	}
+	culler->PyramidLevelCount = 0;
+
+	if (culler->PyramidHandle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveSampledImage(culler->Bindless, culler->PyramidHandle);
+		culler->PyramidHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	if (culler->DepthHandle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveSampledImage(culler->Bindless, culler->DepthHandle);
+		culler->DepthHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	VulkanImagePool_DestroyImage(culler->ImagePool, &culler->Pyramid);
+	culler->PyramidValid = false;
+}
+
+void VulkanClusterCuller_Destroy(VulkanClusterCuller* culler) {
+	VulkanClusterCuller_DestroyPyramid(culler);
+
+	for (u32 i = 0; i < culler->FrameCount; i++) {
+		ClusterCullerFrame* frame = &culler->Frames[i];
+		VulkanClusterCuller_RemoveHandle(culler->Bindless, &frame->InstancesHandle);
+		VulkanClusterCuller_RemoveHandle(culler->Bindless, &frame->ObjectsHandle);
+		VulkanClusterCuller_RemoveHandle(culler->Bindless, &frame->DrawsHandle);
+		VulkanClusterCuller_DestroyBuffer(&frame->Instances);
+		VulkanClusterCuller_DestroyBuffer(&frame->Objects);
+		VulkanClusterCuller_DestroyBuffer(&frame->Draws);
+		VulkanClusterCuller_DestroyBuffer(&frame->Stats);
+	}
+
+	if (culler->SamplerHandle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveSampler(culler->Bindless, culler->SamplerHandle);
+	}
+
+	if (culler->Sampler != VK_NULL_HANDLE) {
+		vkDestroySampler(culler->Device, culler->Sampler, NULL);
+	}
+
+	if (culler->CullPipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(culler->Device, culler->CullPipeline, NULL);
+	}
+
+	if (culler->PyramidPipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(culler->Device, culler->PyramidPipeline, NULL);
+	}
+
+	if (culler->PipelineLayout != VK_NULL_HANDLE) {
+		vkDestroyPipelineLayout(culler->Device, culler->PipelineLayout, NULL);
+	}
+
+	*culler = (VulkanClusterCuller){};
+}
+
+// NOTE: Like VulkanClusterCuller_DestroyPyramid, but for a pyramid that frames up to frame may still use
+static void VulkanClusterCuller_RetirePyramid(VulkanClusterCuller* culler, VulkanDeletionQueue* deletionQueue, u64 frame) {
+	for (u32 i = 0; i < culler->PyramidLevelCount; i++) {
+		if (culler->PyramidLevelHandles[i] != BINDLESS_HANDLE_NONE) {
+			VulkanDeletionQueue_PushStorageImageHandle(deletionQueue, frame, culler->Bindless, culler->PyramidLevelHandles[i]);
+		}
+		if (culler->PyramidLevelViews[i] != VK_NULL_HANDLE) {
+			VulkanDeletionQueue_PushImageView(deletionQueue, frame, culler->PyramidLevelViews[i]);
+		}
+		culler->PyramidLevelHandles[i] = BINDLESS_HANDLE_NONE;
+		culler->PyramidLevelViews[i] = VK_NULL_HANDLE;
+	}
+	culler->PyramidLevelCount = 0;
+
+	if (culler->PyramidHandle != BINDLESS_HANDLE_NONE) {
+		VulkanDeletionQueue_PushSampledImageHandle(deletionQueue, frame, culler->Bindless, culler->PyramidHandle);
+		culler->PyramidHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	if (culler->DepthHandle != BINDLESS_HANDLE_NONE) {
+		VulkanDeletionQueue_PushSampledImageHandle(deletionQueue, frame, culler->Bindless, culler->DepthHandle);
+		culler->DepthHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	VulkanDeletionQueue_PushPoolImage(deletionQueue, frame, culler->ImagePool, &culler->Pyramid);
+	culler->PyramidValid = false;
+}
+
+b8 VulkanClusterCuller_SetDepth(VulkanClusterCuller* culler, const VulkanImage* depthImage, VulkanDeletionQueue* deletionQueue, u64 frame) {
+	VulkanClusterCuller_RetirePyramid(culler, deletionQueue, frame);
+
+	culler->DepthExtent = (VkExtent2D){ depthImage->Width, depthImage->Height };
+	culler->DepthHandle = VulkanBindless_AddSampledImage(culler->Bindless, depthImage->View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	if (culler->DepthHandle == BINDLESS_HANDLE_NONE) {
+		return false;
+	}
+
+	// NOTE: Level 0 is half the depth buffer rounded down, every level after that halves again until both sides are 1
+	u32 width = Max(depthImage->Width / 2, 1);
+	u32 height = Max(depthImage->Height / 2, 1);
+	u32 levelCount = 1;
+	for (u32 size = Max(width, height); size > 1 && levelCount < VULKAN_CLUSTER_CULLER_MAX_PYRAMID_LEVELS; size /= 2) {
+		levelCount++;
+	}
+
+	if (!VulkanImagePool_CreateImage(culler->ImagePool, &culler->Pyramid, width, height, levelCount, VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)) {
+		return false;
+	}
+
+	culler->PyramidHandle = VulkanBindless_AddSampledImage(culler->Bindless, culler->Pyramid.View, VK_IMAGE_LAYOUT_GENERAL);
+	if (culler->PyramidHandle == BINDLESS_HANDLE_NONE) {
+		return false;
+	}
+
+	for (u32 i = 0; i < levelCount; i++) {
+		culler->PyramidLevelHandles[i] = BINDLESS_HANDLE_NONE;
+		culler->PyramidLevelViews[i] = VK_NULL_HANDLE;
+		culler->PyramidLevelCount++;
+
+		VkCheck(vkCreateImageView(culler->Device, &(VkImageViewCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.image = culler->Pyramid.Image,
+			.viewType = VK_IMAGE_VIEW_TYPE_2D,
+			.format = VK_FORMAT_R32_SFLOAT,
+			.subresourceRange = (VkImageSubresourceRange){
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.baseMipLevel = i,
+				.levelCount = 1,
+				.layerCount = 1,
+			},
+		}, NULL, &culler->PyramidLevelViews[i]));
+
+		culler->PyramidLevelHandles[i] = VulkanBindless_AddStorageImage(culler->Bindless, culler->PyramidLevelViews[i]);
+		if (culler->PyramidLevelHandles[i] == BINDLESS_HANDLE_NONE) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static b8 VulkanClusterCuller_CreateStorageBuffer(
+	VulkanClusterCuller* culler,
+	VulkanBuffer* buffer,
+	BindlessHandle* handle,
+	u64 size,
+	VkBufferUsageFlags usage,
+	b8 deviceLocal
+) {
+	VulkanClusterCuller_RemoveHandle(culler->Bindless, handle);
+	VulkanClusterCuller_DestroyBuffer(buffer);
+
+	b8 created = deviceLocal
+		? VulkanBuffer_CreateDeviceLocal(buffer, culler->Device, culler->PhysicalDevice, size, usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+		: VulkanBuffer_Create(buffer, culler->Device, culler->PhysicalDevice, size, usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	if (!created) {
+		return false;
+	}
+
+	*handle = VulkanBindless_AddStorageBuffer(culler->Bindless, buffer->Buffer, 0, buffer->Size);
+	return *handle != BINDLESS_HANDLE_NONE;
+}
+
+b8 VulkanClusterCuller_BeginFrame(VulkanClusterCuller* culler, u32 frameIndex, u64 instanceCount, u64 objectCount) {
+	ASSERT(frameIndex < culler->FrameCount);
+	ClusterCullerFrame* frame = &culler->Frames[frameIndex];
+	frame->InstanceCount = 0;
+
+	// NOTE: The frame's previous submission has finished, so its buffers can be replaced straight away
+	if (instanceCount > frame->InstanceCapacity || frame->Instances.Buffer == VK_NULL_HANDLE) {
+		u64 capacity = frame->InstanceCapacity > CLUSTER_MIN_CAPACITY ? frame->InstanceCapacity : CLUSTER_MIN_CAPACITY;
+		while (capacity < instanceCount) {
+			capacity *= 2;
+		}
+
+		frame->InstanceCapacity = 0;
+		if (!VulkanClusterCuller_CreateStorageBuffer(culler, &frame->Instances, &frame->InstancesHandle, capacity * sizeof(ClusterInstance), 0, false) ||
+			!VulkanClusterCuller_CreateStorageBuffer(
+				culler, &frame->Draws, &frame->DrawsHandle,
+				CLUSTER_DRAWS_OFFSET + capacity * sizeof(VkDrawIndexedIndirectCommand),
+				VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				true
+			)
+		) {
+			return false;
+		}
+		frame->InstanceCapacity = capacity;
+	}
+
+	if (objectCount > frame->ObjectCapacity || frame->Objects.Buffer == VK_NULL_HANDLE) {
+		u64 capacity = frame->ObjectCapacity > CLUSTER_MIN_CAPACITY ? frame->ObjectCapacity : CLUSTER_MIN_CAPACITY;
+		while (capacity < objectCount) {
+			capacity *= 2;
+		}
+
+		frame->ObjectCapacity = 0;
+		if (!VulkanClusterCuller_CreateStorageBuffer(culler, &frame->Objects, &frame->ObjectsHandle, capacity * sizeof(Matrix4), 0, false)) {
+			return false;
+		}
+		frame->ObjectCapacity = capacity;
+	}
+
+	frame->InstanceCount = instanceCount;
+	return true;
+}
+
+u32 VulkanClusterCuller_GetDrawCount(const VulkanClusterCuller* culler, u32 frameIndex) {
+	ASSERT(frameIndex < culler->FrameCount);
+	return *cast(const u32*) culler->Frames[frameIndex].Stats.Data;
+}
+
+// NOTE: The view matrix is expected to be a rotation and translation, so the viewer is found without a full inverse. Projections
+// without perspective have no viewer position, there the cone test uses the direction depth grows in
+static Vector4 VulkanClusterCuller_GetViewer(const Matrix4* view, const Matrix4* projection) {
+	f32 tx = view->Data[3][0];
+	f32 ty = view->Data[3][1];
+	f32 tz = view->Data[3][2];
+
+	if (projection->Data[2][3] != 0.0f) {
+		return (Vector4){
+			.x = -(view->Data[0][0] * tx + view->Data[0][1] * ty + view->Data[0][2] * tz),
+			.y = -(view->Data[1][0] * tx + view->Data[1][1] * ty + view->Data[1][2] * tz),
+			.z = -(view->Data[2][0] * tx + view->Data[2][1] * ty + view->Data[2][2] * tz),
+			.w = 1.0f,
+		};
+	}
+
+	f32 forward = projection->Data[2][2] >= 0.0f ? 1.0f : -1.0f;
+	return (Vector4){
+		.x = view->Data[0][2] * forward,
+		.y = view->Data[1][2] * forward,
+		.z = view->Data[2][2] * forward,
+		.w = 0.0f,
+	};
+}
+
+void VulkanClusterCuller_RecordCull(
+	VulkanClusterCuller* culler,
+	VkCommandBuffer commandBuffer,
+	u32 frameIndex,
+	BindlessHandle uniformBufferHandle,
+	BindlessHandle clusterBufferHandle,
+	const Matrix4* viewMatrix,
+	const Matrix4* projectionMatrix
+) {
+	ASSERT(frameIndex < culler->FrameCount);
+	ClusterCullerFrame* frame = &culler->Frames[frameIndex];
+
+	vkCmdFillBuffer(commandBuffer, frame->Draws.Buffer, 0, sizeof(u32), 0);
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &(VkMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+		.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	}, 0, NULL, 0, NULL);
+
+	if (frame->InstanceCount > 0) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->CullPipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->PipelineLayout, 0, 1, &culler->Bindless->Set, 0, NULL);
+
+		ClusterCullPushConstants pushConstants = {
+			.Viewer = VulkanClusterCuller_GetViewer(viewMatrix, projectionMatrix),
+			.UniformBufferHandle = uniformBufferHandle,
+			.ClusterBufferHandle = clusterBufferHandle,
+			.InstanceBufferHandle = frame->InstancesHandle,
+			.ObjectBufferHandle = frame->ObjectsHandle,
+			.DrawBufferHandle = frame->DrawsHandle,
+			.InstanceCount = cast(u32) frame->InstanceCount,
+			.PyramidHandle = culler->PyramidValid ? culler->PyramidHandle : BINDLESS_HANDLE_NONE,
+			.SamplerHandle = culler->SamplerHandle,
+			.DepthWidth = culler->PyramidRenderExtent.width,
+			.DepthHeight = culler->PyramidRenderExtent.height,
+			.PyramidLevelCount = culler->PyramidLevelCount,
+		};
+		vkCmdPushConstants(commandBuffer, culler->PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+		u64 groupCount = (frame->InstanceCount + VULKAN_CLUSTER_CULLER_GROUP_SIZE - 1) / VULKAN_CLUSTER_CULLER_GROUP_SIZE;
+		vkCmdDispatch(commandBuffer, cast(u32) groupCount, 1, 1);
+	}
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &(VkMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+		.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+	}, 0, NULL, 0, NULL);
+
+	vkCmdCopyBuffer(commandBuffer, frame->Draws.Buffer, frame->Stats.Buffer, 1, &(VkBufferCopy){ .srcOffset = 0, .dstOffset = 0, .size = sizeof(u32) });
+}
+
+void VulkanClusterCuller_RecordDraws(VulkanClusterCuller* culler, VkCommandBuffer commandBuffer, u32 frameIndex) {
+	ASSERT(frameIndex < culler->FrameCount);
+	ClusterCullerFrame* frame = &culler->Frames[frameIndex];
+	if (frame->InstanceCount == 0) {
+		return;
+	}
+
+	vkCmdDrawIndexedIndirectCount(
+		commandBuffer,
+		frame->Draws.Buffer,
+		CLUSTER_DRAWS_OFFSET,
+		frame->Draws.Buffer,
+		0,
+		cast(u32) frame->InstanceCount,
+		sizeof(VkDrawIndexedIndirectCommand)
+	);
+}
+
+void VulkanClusterCuller_RecordPyramid(VulkanClusterCuller* culler, VkCommandBuffer commandBuffer, VkExtent2D renderExtent) {
+	ASSERT(renderExtent.width <= culler->DepthExtent.width && renderExtent.height <= culler->DepthExtent.height);
+	culler->PyramidRenderExtent = renderExtent;
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->PyramidPipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->PipelineLayout, 0, 1, &culler->Bindless->Set, 0, NULL);
+
+	// NOTE: Only the drawn part is reduced, so the work scales with the render resolution and nothing outside it ends up in
+	// the pyramid. Levels past the size of the drawn part are 1x1, the texels after that are never read
+	u32 sourceWidth = renderExtent.width;
+	u32 sourceHeight = renderExtent.height;
+	for (u32 i = 0; i < culler->PyramidLevelCount; i++) {
+		u32 width = Max(sourceWidth / 2, 1);
+		u32 height = Max(sourceHeight / 2, 1);
+
+		DepthPyramidPushConstants pushConstants = {
+			.SourceHandle = i == 0 ? culler->DepthHandle : culler->PyramidHandle,
+			.SourceLevel = i == 0 ? 0 : i - 1,
+			.DestinationHandle = culler->PyramidLevelHandles[i],
+			.SamplerHandle = culler->SamplerHandle,
+			.SourceWidth = sourceWidth,
+			.SourceHeight = sourceHeight,
+			.DestinationWidth = width,
+			.DestinationHeight = height,
+		};
+		vkCmdPushConstants(commandBuffer, culler->PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+		vkCmdDispatch(commandBuffer, (width + 7) / 8, (height + 7) / 8, 1);
+
+		// NOTE: The next level reads this one, the last level is left to the render graph
+		if (i + 1 < culler->PyramidLevelCount) {
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &(VkMemoryBarrier){
+				.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+			}, 0, NULL, 0, NULL);
+		}
+
+		sourceWidth = width;
+		sourceHeight = height;
+	}
+
+	culler->PyramidValid = true;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+#include "Matrix.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindless.h"
+#include "VulkanImagePool.h"
+#include "VulkanDeletionQueue.h"
+
+#include <vulkan/vulkan.h>
+
+#define VULKAN_CLUSTER_CULLER_MAX_FRAMES 4
+#define VULKAN_CLUSTER_CULLER_MAX_PYRAMID_LEVELS 16
+// NOTE: Matches local_size_x in cluster_cull.comp.glsl
+#define VULKAN_CLUSTER_CULLER_GROUP_SIZE 64
+
+// NOTE: One per cluster that may be drawn this frame, ObjectIndex selects the model matrix and becomes the draw's first instance
+typedef struct ClusterInstance_t {
+	u32 ClusterIndex;
+	u32 ObjectIndex;
+} ClusterInstance;
+
+typedef struct ClusterCullerFrame_t {
+	VulkanBuffer Instances; // ClusterInstance, written by the CPU
+	VulkanBuffer Objects;   // Model matrices, written by the CPU
+	VulkanBuffer Draws;     // Draw count followed by VkDrawIndexedIndirectCommands, written by the cull shader
+	VulkanBuffer Stats;     // The draw count copied back for the CPU
+	BindlessHandle InstancesHandle;
+	BindlessHandle ObjectsHandle;
+	BindlessHandle DrawsHandle;
+	u64 InstanceCapacity;
+	u64 ObjectCapacity;
+	u64 InstanceCount;
+} ClusterCullerFrame;
+
+// NOTE: Culls clusters on the GPU against the frustum, their normal cone and a depth pyramid of the previous frame, then draws
+// the survivors with one indirect count draw. The pyramid is one frame old, so clusters that were hidden last frame and are
+// disoccluded by movement show up one frame late
+typedef struct VulkanClusterCuller_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VulkanBindless* Bindless;
+	VulkanImagePool* ImagePool; // Only used from the render thread
+
+	VkPipelineLayout PipelineLayout;
+	VkPipeline CullPipeline;
+	VkPipeline PyramidPipeline;
+	VkSampler Sampler;
+	BindlessHandle SamplerHandle;
+
+	ClusterCullerFrame Frames[VULKAN_CLUSTER_CULLER_MAX_FRAMES];
+	u32 FrameCount;
+
+	VkExtent2D DepthExtent;
+	VkExtent2D PyramidRenderExtent; // The top left part of the depth buffer that was drawn to when the pyramid was built
+	BindlessHandle DepthHandle;
+	VulkanImage Pyramid;
+	BindlessHandle PyramidHandle;
+	VkImageView PyramidLevelViews[VULKAN_CLUSTER_CULLER_MAX_PYRAMID_LEVELS];
+	BindlessHandle PyramidLevelHandles[VULKAN_CLUSTER_CULLER_MAX_PYRAMID_LEVELS];
+	u32 PyramidLevelCount;
+	b8 PyramidValid; // The pyramid holds the depth of a previous frame
+} VulkanClusterCuller;
+
+// NOTE: Fills in the device features the indirect cluster draws need, returns false when the device does not support them
+b8 VulkanClusterCuller_RequireFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures* features, VkPhysicalDeviceVulkan12Features* features12);
+
+b8 VulkanClusterCuller_Create(
+	VulkanClusterCuller* culler,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	VulkanImagePool* imagePool,
+	u32 frameCount,
+	VkShaderModule cullShader,
+	VkShaderModule pyramidShader
+);
+void VulkanClusterCuller_Destroy(VulkanClusterCuller* culler);
+
+// NOTE: Rebuilds the pyramid for a new depth buffer, which has to be sampled in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+// The old pyramid goes to deletionQueue with frame, the last frame that may have used it
+b8 VulkanClusterCuller_SetDepth(VulkanClusterCuller* culler, const VulkanImage* depthImage, VulkanDeletionQueue* deletionQueue, u64 frame);
+
+// NOTE: Call once the frame's previous submission has finished. Makes room for instanceCount instances and objectCount model matrices,
+// which are written to the mapped Instances and Objects buffers of the frame before recording
+b8 VulkanClusterCuller_BeginFrame(VulkanClusterCuller* culler, u32 frameIndex, u64 instanceCount, u64 objectCount);
+// NOTE: How many clusters survived culling the last time frameIndex was submitted
+u32 VulkanClusterCuller_GetDrawCount(const VulkanClusterCuller* culler, u32 frameIndex);
+
+// NOTE: The cull and pyramid passes only synchronize their own steps, the render graph orders them against everything else.
+// The cull pass writes the Draws and Stats buffers and reads the pyramid in VK_IMAGE_LAYOUT_GENERAL, the pyramid pass reads the
+// depth buffer in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and rewrites the whole pyramid in VK_IMAGE_LAYOUT_GENERAL
+
+// NOTE: Outside of a render pass, before the draws
+void VulkanClusterCuller_RecordCull(
+	VulkanClusterCuller* culler,
+	VkCommandBuffer commandBuffer,
+	u32 frameIndex,
+	BindlessHandle uniformBufferHandle,
+	BindlessHandle clusterBufferHandle,
+	const Matrix4* viewMatrix,
+	const Matrix4* projectionMatrix
+);
+// NOTE: Inside the render pass, with the mesh pipeline, descriptor set, push constants and vertex and index buffers bound
+void VulkanClusterCuller_RecordDraws(VulkanClusterCuller* culler, VkCommandBuffer commandBuffer, u32 frameIndex);
+// NOTE: After the render pass that wrote the depth buffer. Only the top left renderExtent of it was drawn to, the pyramid is
+// built from that part alone and every level keeps the top left size that covers it
+void VulkanClusterCuller_RecordPyramid(VulkanClusterCuller* culler, VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
@@ -0,0 +1,199 @@
+#include "VulkanCommandRecorder.h"
+#include "VulkanUtil.h"
+#include "JobSystem.h"
+
+#include <stdlib.h>
+
+b8 VulkanCommandRecorder_Create(VulkanCommandRecorder* recorder, VkDevice device, u32 queueFamilyIndex, u32 threadCount, u32 frameCount) {
+	*recorder = (VulkanCommandRecorder){};
+	recorder->Device = device;
+	recorder->ThreadCount = threadCount;
+	recorder->FrameCount = frameCount;
+
+	recorder->Pools = calloc(threadCount * frameCount, sizeof(recorder->Pools[0]));
+	if (!recorder->Pools) {
+		return false;
+	}
+
+	for (u32 i = 0; i < threadCount * frameCount; i++) {
+		VkCheck(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			.queueFamilyIndex = queueFamilyIndex,
+		}, NULL, &recorder->Pools[i].Pool));
+
+		if (recorder->Pools[i].Pool == VK_NULL_HANDLE) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VulkanCommandRecorder_Destroy(VulkanCommandRecorder* recorder) {
+	if (recorder->Pools) {
+		for (u32 i = 0; i < recorder->ThreadCount * recorder->FrameCount; i++) {
+			if (recorder->Pools[i].Pool != VK_NULL_HANDLE) {
+				vkDestroyCommandPool(recorder->Device, recorder->Pools[i].Pool, NULL);
+			}
+			free(recorder->Pools[i].CommandBuffers);
+		}
+		free(recorder->Pools);
+	}
+
+	free(recorder->BatchCommandBuffers);
+	*recorder = (VulkanCommandRecorder){};
+}
+
+b8 VulkanCommandRecorder_BeginFrame(VulkanCommandRecorder* recorder, u32 frameIndex) {
+	ASSERT(frameIndex < recorder->FrameCount);
+
+	for (u32 i = 0; i < recorder->ThreadCount; i++) {
+		VulkanThreadCommandPool* pool = &recorder->Pools[frameIndex * recorder->ThreadCount + i];
+		if (pool->UsedCount > 0) {
+			VkCheck(vkResetCommandPool(recorder->Device, pool->Pool, 0));
+			pool->UsedCount = 0;
+		}
+	}
+
+	return true;
+}
+
+static VkCommandBuffer VulkanThreadCommandPool_Acquire(VulkanThreadCommandPool* pool, VkDevice device) {
+	if (pool->UsedCount == pool->CommandBufferCount) {
+		u32 count = pool->CommandBufferCount ? pool->CommandBufferCount * 2 : 4;
+		VkCommandBuffer* commandBuffers = realloc(pool->CommandBuffers, count * sizeof(commandBuffers[0]));
+		if (!commandBuffers) {
+			return VK_NULL_HANDLE;
+		}
+		pool->CommandBuffers = commandBuffers;
+
+		if (vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.commandPool = pool->Pool,
+			.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+			.commandBufferCount = count - pool->CommandBufferCount,
+		}, &pool->CommandBuffers[pool->CommandBufferCount]) != VK_SUCCESS) {
+			return VK_NULL_HANDLE;
+		}
+
+		pool->CommandBufferCount = count;
+	}
+
+	return pool->CommandBuffers[pool->UsedCount++];
+}
+
+typedef struct VulkanRecordData_t {
+	VulkanCommandRecorder* Recorder;
+	u32 FrameIndex;
+	const VkCommandBufferInheritanceInfo* InheritanceInfo;
+	u64 BatchSize;
+	VulkanRecordFunction Function;
+	void* Data;
+	_Atomic b32 Failed;
+} VulkanRecordData;
+
+static void VulkanCommandRecorder_RecordBatches(void* data, u64 begin, u64 end) {
+	VulkanRecordData* record = data;
+	VulkanCommandRecorder* recorder = record->Recorder;
+
+	u32 threadIndex = JobSystem_GetThreadIndex();
+	ASSERT(threadIndex < recorder->ThreadCount);
+	VulkanThreadCommandPool* pool = &recorder->Pools[record->FrameIndex * recorder->ThreadCount + threadIndex];
+
+	for (u64 batch = begin; batch < end; batch++) {
+		VkCommandBuffer commandBuffer = VulkanThreadCommandPool_Acquire(pool, recorder->Device);
+		recorder->BatchCommandBuffers[batch] = commandBuffer;
+		if (commandBuffer == VK_NULL_HANDLE) {
+			atomic_store(&record->Failed, true);
+			continue;
+		}
+
+		if (vkBeginCommandBuffer(commandBuffer, &(VkCommandBufferBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+			.pInheritanceInfo = record->InheritanceInfo,
+		}) != VK_SUCCESS) {
+			atomic_store(&record->Failed, true);
+			continue;
+		}
+
+		u64 itemBegin = batch * record->BatchSize;
+		record->Function(commandBuffer, record->Data, itemBegin, itemBegin + record->BatchSize);
+
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+			atomic_store(&record->Failed, true);
+		}
+	}
+}
+
+b8 VulkanCommandRecorder_Record(
+	VulkanCommandRecorder* recorder,
+	u32 frameIndex,
+	VkCommandBuffer primaryCommandBuffer,
+	const VkCommandBufferInheritanceInfo* inheritanceInfo,
+	u64 itemCount,
+	u64 batchSize,
+	VulkanRecordFunction function,
+	void* data
+) {
+	ASSERT(frameIndex < recorder->FrameCount);
+	ASSERT(JobSystem_GetThreadCount() <= recorder->ThreadCount);
+
+	if (itemCount == 0) {
+		return true;
+	}
+
+	if (batchSize == 0) {
+		batchSize = 1;
+	}
+
+	u64 batchCount = (itemCount + batchSize - 1) / batchSize;
+	if (batchCount > recorder->BatchCapacity) {
+		VkCommandBuffer* batchCommandBuffers = realloc(recorder->BatchCommandBuffers, batchCount * sizeof(batchCommandBuffers[0]));
+		if (!batchCommandBuffers) {
+			return false;
+		}
+
+		recorder->BatchCommandBuffers = batchCommandBuffers;
+		recorder->BatchCapacity = batchCount;
+	}
+
+	VulkanRecordData record = {
+		.Recorder = recorder,
+		.FrameIndex = frameIndex,
+		.InheritanceInfo = inheritanceInfo,
+		.BatchSize = batchSize,
+		.Function = function,
+		.Data = data,
+	};
+
+	// NOTE: The last batch may be short, so record it here instead of clamping in every batch
+	u64 fullBatchCount = itemCount / batchSize;
+	JobSystem_ParallelFor(fullBatchCount, 1, VulkanCommandRecorder_RecordBatches, &record);
+
+	if (fullBatchCount != batchCount) {
+		VulkanThreadCommandPool* pool = &recorder->Pools[frameIndex * recorder->ThreadCount + JobSystem_GetThreadIndex()];
+		VkCommandBuffer commandBuffer = VulkanThreadCommandPool_Acquire(pool, recorder->Device);
+		if (commandBuffer == VK_NULL_HANDLE) {
+			return false;
+		}
+
+		VkCheck(vkBeginCommandBuffer(commandBuffer, &(VkCommandBufferBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+			.pInheritanceInfo = inheritanceInfo,
+		}));
+		function(commandBuffer, data, fullBatchCount * batchSize, itemCount);
+		VkCheck(vkEndCommandBuffer(commandBuffer));
+
+		recorder->BatchCommandBuffers[fullBatchCount] = commandBuffer;
+	}
+
+	if (atomic_load(&record.Failed)) {
+		return false;
+	}
+
+	vkCmdExecuteCommands(primaryCommandBuffer, cast(u32) batchCount, recorder->BatchCommandBuffers);
+	return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+typedef struct VulkanThreadCommandPool_t {
+	VkCommandPool Pool;
+	VkCommandBuffer* CommandBuffers;
+	u32 CommandBufferCount;
+	u32 UsedCount;
+} VulkanThreadCommandPool;
+
+// NOTE: Records secondary command buffers on the job system, every job system thread gets its own
+// command pool per frame in flight so no pool is ever touched by two threads at once
+typedef struct VulkanCommandRecorder_t {
+	VkDevice Device;
+	u32 ThreadCount;
+	u32 FrameCount;
+	VulkanThreadCommandPool* Pools; // [frameIndex * ThreadCount + threadIndex]
+
+	VkCommandBuffer* BatchCommandBuffers;
+	u64 BatchCapacity;
+} VulkanCommandRecorder;
+
+typedef void (*VulkanRecordFunction)(VkCommandBuffer commandBuffer, void* data, u64 begin, u64 end);
+
+b8 VulkanCommandRecorder_Create(VulkanCommandRecorder* recorder, VkDevice device, u32 queueFamilyIndex, u32 threadCount, u32 frameCount);
+void VulkanCommandRecorder_Destroy(VulkanCommandRecorder* recorder);
+
+// NOTE: Must only be called once the frame's previous submission has finished
+b8 VulkanCommandRecorder_BeginFrame(VulkanCommandRecorder* recorder, u32 frameIndex);
+
+// NOTE: Splits [0, itemCount) into batches recorded in parallel, then executes them in order inside primaryCommandBuffer,
+// which must be inside a render pass begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+b8 VulkanCommandRecorder_Record(
+	VulkanCommandRecorder* recorder,
+	u32 frameIndex,
+	VkCommandBuffer primaryCommandBuffer,
+	const VkCommandBufferInheritanceInfo* inheritanceInfo,
+	u64 itemCount,
+	u64 batchSize,
+	VulkanRecordFunction function,
+	void* data
+);
@@ -0,0 +1,146 @@
+#include "VulkanDeletionQueue.h"
+#include "VulkanUtil.h"
+
+#include <stdlib.h>
+
+b8 VulkanDeletionQueue_Create(VulkanDeletionQueue* queue, VkDevice device) {
+	*queue = (VulkanDeletionQueue){
+		.Device = device,
+	};
+
+	queue->Capacity = 64;
+	queue->Deletions = malloc(queue->Capacity * sizeof(queue->Deletions[0]));
+	if (!queue->Deletions) {
+		return false;
+	}
+
+	return true;
+}
+
+static void VulkanDeletion_Execute(VkDevice device, VulkanDeletion* deletion) {
+	switch (deletion->Kind) {
+		case VulkanDeletionKind_Swapchain: {
+			vkDestroySwapchainKHR(device, deletion->Swapchain, NULL);
+		} break;
+
+		case VulkanDeletionKind_ImageView: {
+			vkDestroyImageView(device, deletion->ImageView, NULL);
+		} break;
+
+		case VulkanDeletionKind_Framebuffer: {
+			vkDestroyFramebuffer(device, deletion->Framebuffer, NULL);
+		} break;
+
+		case VulkanDeletionKind_PoolImage: {
+			VulkanImagePool_DestroyImage(deletion->PoolImage.Pool, &deletion->PoolImage.Image);
+		} break;
+
+		case VulkanDeletionKind_SampledImageHandle: {
+			VulkanBindless_RemoveSampledImage(deletion->Bindless.Bindless, deletion->Bindless.Handle);
+		} break;
+
+		case VulkanDeletionKind_StorageImageHandle: {
+			VulkanBindless_RemoveStorageImage(deletion->Bindless.Bindless, deletion->Bindless.Handle);
+		} break;
+	}
+}
+
+void VulkanDeletionQueue_Destroy(VulkanDeletionQueue* queue) {
+	for (u64 i = 0; i < queue->Count; i++) {
+		VulkanDeletion_Execute(queue->Device, &queue->Deletions[i]);
+	}
+
+	free(queue->Deletions);
+	*queue = (VulkanDeletionQueue){};
+}
+
+static void VulkanDeletionQueue_Push(VulkanDeletionQueue* queue, VulkanDeletion* deletion) {
+	if (queue->Count == queue->Capacity) {
+		u64 newCapacity = queue->Capacity * 2;
+		VulkanDeletion* newDeletions = realloc(queue->Deletions, newCapacity * sizeof(newDeletions[0]));
+
+		// NOTE: Out of memory is not worth failing the caller over, waiting for the device makes it safe to destroy the object now
+		if (!newDeletions) {
+			VkCall(vkDeviceWaitIdle(queue->Device));
+			VulkanDeletion_Execute(queue->Device, deletion);
+			return;
+		}
+
+		queue->Deletions = newDeletions;
+		queue->Capacity = newCapacity;
+	}
+
+	queue->Deletions[queue->Count++] = *deletion;
+}
+
+void VulkanDeletionQueue_PushSwapchain(VulkanDeletionQueue* queue, u64 frame, VkSwapchainKHR swapchain) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_Swapchain,
+		.Frame = frame,
+		.Swapchain = swapchain,
+	});
+}
+
+void VulkanDeletionQueue_PushImageView(VulkanDeletionQueue* queue, u64 frame, VkImageView imageView) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_ImageView,
+		.Frame = frame,
+		.ImageView = imageView,
+	});
+}
+
+void VulkanDeletionQueue_PushFramebuffer(VulkanDeletionQueue* queue, u64 frame, VkFramebuffer framebuffer) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_Framebuffer,
+		.Frame = frame,
+		.Framebuffer = framebuffer,
+	});
+}
+
+void VulkanDeletionQueue_PushPoolImage(VulkanDeletionQueue* queue, u64 frame, VulkanImagePool* pool, VulkanImage* image) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_PoolImage,
+		.Frame = frame,
+		.PoolImage = {
+			.Pool = pool,
+			.Image = *image,
+		},
+	});
+	*image = (VulkanImage){};
+}
+
+void VulkanDeletionQueue_PushSampledImageHandle(VulkanDeletionQueue* queue, u64 frame, VulkanBindless* bindless, BindlessHandle handle) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_SampledImageHandle,
+		.Frame = frame,
+		.Bindless = {
+			.Bindless = bindless,
+			.Handle = handle,
+		},
+	});
+}
+
+void VulkanDeletionQueue_PushStorageImageHandle(VulkanDeletionQueue* queue, u64 frame, VulkanBindless* bindless, BindlessHandle handle) {
+	VulkanDeletionQueue_Push(queue, &(VulkanDeletion){
+		.Kind = VulkanDeletionKind_StorageImageHandle,
+		.Frame = frame,
+		.Bindless = {
+			.Bindless = bindless,
+			.Handle = handle,
+		},
+	});
+}
+
+void VulkanDeletionQueue_Flush(VulkanDeletionQueue* queue, u64 safeFrame) {
+	// NOTE: Keeps the order of what is left, so objects pushed together are destroyed in the order they were pushed
+	u64 keptCount = 0;
+	for (u64 i = 0; i < queue->Count; i++) {
+		VulkanDeletion* deletion = &queue->Deletions[i];
+		if (deletion->Frame < safeFrame) {
+			VulkanDeletion_Execute(queue->Device, deletion);
+		} else {
+			queue->Deletions[keptCount++] = *deletion;
+		}
+	}
+	queue->Count = keptCount;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "VulkanBindless.h"
+#include "VulkanImagePool.h"
+
+#include <vulkan/vulkan.h>
+
+typedef enum VulkanDeletionKind_t {
+	VulkanDeletionKind_Swapchain,
+	VulkanDeletionKind_ImageView,
+	VulkanDeletionKind_Framebuffer,
+	VulkanDeletionKind_PoolImage,
+	VulkanDeletionKind_SampledImageHandle,
+	VulkanDeletionKind_StorageImageHandle,
+} VulkanDeletionKind;
+
+typedef struct VulkanDeletion_t {
+	VulkanDeletionKind Kind;
+	u64 Frame; // The last frame that may use the object
+	union {
+		VkSwapchainKHR Swapchain;
+		VkImageView ImageView;
+		VkFramebuffer Framebuffer;
+		struct {
+			VulkanImagePool* Pool;
+			VulkanImage Image;
+		} PoolImage;
+		struct {
+			VulkanBindless* Bindless;
+			BindlessHandle Handle;
+		} Bindless;
+	};
+} VulkanDeletion;
+
+// NOTE: Objects that a submitted frame may still use are pushed with that frame's number and destroyed by
+// VulkanDeletionQueue_Flush once the frame has finished, so replacing them never waits for the device.
+// Only used from the render thread
+typedef struct VulkanDeletionQueue_t {
+	VkDevice Device;
+	VulkanDeletion* Deletions;
+	u64 Count;
+	u64 Capacity;
+} VulkanDeletionQueue;
+
+b8 VulkanDeletionQueue_Create(VulkanDeletionQueue* queue, VkDevice device);
+// NOTE: Destroys everything that is still queued, so nothing may be in flight
+void VulkanDeletionQueue_Destroy(VulkanDeletionQueue* queue);
+
+void VulkanDeletionQueue_PushSwapchain(VulkanDeletionQueue* queue, u64 frame, VkSwapchainKHR swapchain);
+void VulkanDeletionQueue_PushImageView(VulkanDeletionQueue* queue, u64 frame, VkImageView imageView);
+void VulkanDeletionQueue_PushFramebuffer(VulkanDeletionQueue* queue, u64 frame, VkFramebuffer framebuffer);
+// NOTE: Takes over the image, which is zeroed
+void VulkanDeletionQueue_PushPoolImage(VulkanDeletionQueue* queue, u64 frame, VulkanImagePool* pool, VulkanImage* image);
+void VulkanDeletionQueue_PushSampledImageHandle(VulkanDeletionQueue* queue, u64 frame, VulkanBindless* bindless, BindlessHandle handle);
+void VulkanDeletionQueue_PushStorageImageHandle(VulkanDeletionQueue* queue, u64 frame, VulkanBindless* bindless, BindlessHandle handle);
+
+// NOTE: safeFrame is the oldest frame that may still be on the GPU, everything pushed with an earlier frame is destroyed
+void VulkanDeletionQueue_Flush(VulkanDeletionQueue* queue, u64 safeFrame);
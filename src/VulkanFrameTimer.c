@@ -0,0 +1,78 @@
+#include "VulkanFrameTimer.h"
+#include "VulkanUtil.h"
+
+b8 VulkanFrameTimer_Create(VulkanFrameTimer* timer, VkDevice device, VkPhysicalDevice physicalDevice, u32 queueFamilyIndex, u32 frameCount) {
+	ASSERT(frameCount <= VULKAN_FRAME_TIMER_MAX_FRAMES);
+	*timer = (VulkanFrameTimer){
+		.Device = device,
+		.FrameCount = frameCount,
+	};
+
+	u32 queueFamilyPropertiesCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, NULL);
+	VkQueueFamilyProperties queueFamilyProperties[queueFamilyPropertiesCount];
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties);
+
+	ASSERT(queueFamilyIndex < queueFamilyPropertiesCount);
+	u32 validBits = queueFamilyProperties[queueFamilyIndex].timestampValidBits;
+	if (validBits == 0) {
+		return false;
+	}
+	timer->TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	timer->TimestampPeriod = properties.limits.timestampPeriod;
+
+	VkCheck(vkCreateQueryPool(device, &(VkQueryPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+		.queryType = VK_QUERY_TYPE_TIMESTAMP,
+		.queryCount = frameCount * 2,
+	}, NULL, &timer->QueryPool));
+
+	return true;
+}
+
+void VulkanFrameTimer_Destroy(VulkanFrameTimer* timer) {
+	vkDestroyQueryPool(timer->Device, timer->QueryPool, NULL);
+	*timer = (VulkanFrameTimer){};
+}
+
+void VulkanFrameTimer_RecordBegin(VulkanFrameTimer* timer, VkCommandBuffer commandBuffer, u32 frameIndex) {
+	ASSERT(frameIndex < timer->FrameCount);
+	vkCmdResetQueryPool(commandBuffer, timer->QueryPool, frameIndex * 2, 2);
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timer->QueryPool, frameIndex * 2);
+}
+
+void VulkanFrameTimer_RecordEnd(VulkanFrameTimer* timer, VkCommandBuffer commandBuffer, u32 frameIndex) {
+	ASSERT(frameIndex < timer->FrameCount);
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timer->QueryPool, frameIndex * 2 + 1);
+	timer->Pending[frameIndex] = true;
+}
+
+b8 VulkanFrameTimer_Read(VulkanFrameTimer* timer, u32 frameIndex, f64* seconds) {
+	ASSERT(frameIndex < timer->FrameCount);
+	if (!timer->Pending[frameIndex]) {
+		return false;
+	}
+	timer->Pending[frameIndex] = false;
+
+	u64 timestamps[2] = {};
+	VkResult result = vkGetQueryPoolResults(
+		timer->Device,
+		timer->QueryPool,
+		frameIndex * 2,
+		2,
+		sizeof(timestamps),
+		timestamps,
+		sizeof(timestamps[0]),
+		VK_QUERY_RESULT_64_BIT
+	);
+	if (result != VK_SUCCESS) {
+		return false;
+	}
+
+	u64 ticks = (timestamps[1] - timestamps[0]) & timer->TimestampMask;
+	*seconds = cast(f64) ticks * timer->TimestampPeriod * 1e-9;
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+#define VULKAN_FRAME_TIMER_MAX_FRAMES 4
+
+// NOTE: Two timestamps per frame in flight, at the start and end of the frame's command buffer. The time between
+// them is how long the GPU spent on the frame, including any gaps where it waited inside the command buffer
+typedef struct VulkanFrameTimer_t {
+	VkDevice Device;
+	VkQueryPool QueryPool;
+	u32 FrameCount;
+	f64 TimestampPeriod; // Nanoseconds per tick
+	u64 TimestampMask;   // Only the queue's valid bits of a timestamp count
+	b8 Pending[VULKAN_FRAME_TIMER_MAX_FRAMES]; // Written by a submitted frame and not read back yet
+} VulkanFrameTimer;
+
+// NOTE: Returns false when queueFamilyIndex can not write timestamps
+b8 VulkanFrameTimer_Create(VulkanFrameTimer* timer, VkDevice device, VkPhysicalDevice physicalDevice, u32 queueFamilyIndex, u32 frameCount);
+void VulkanFrameTimer_Destroy(VulkanFrameTimer* timer);
+
+// NOTE: Outside of render passes, first and last thing in the frame's command buffer
+void VulkanFrameTimer_RecordBegin(VulkanFrameTimer* timer, VkCommandBuffer commandBuffer, u32 frameIndex);
+void VulkanFrameTimer_RecordEnd(VulkanFrameTimer* timer, VkCommandBuffer commandBuffer, u32 frameIndex);
+
+// NOTE: Call once the frame's fence has signaled. Returns false when there is no new time for the frame
+b8 VulkanFrameTimer_Read(VulkanFrameTimer* timer, u32 frameIndex, f64* seconds);
@@ -0,0 +1,271 @@
+#include "VulkanImagePool.h"
+#include "VulkanUtil.h"
+#include "VulkanMemoryBudget.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static u64 AlignUp(u64 value, u64 alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static b8 VulkanImagePoolBlock_InsertRange(VulkanImagePoolBlock* block, u64 index, VulkanMemoryRange range) {
+	if (block->FreeRangeCount == block->FreeRangeCapacity) {
+		u64 newCapacity = block->FreeRangeCapacity ? block->FreeRangeCapacity * 2 : 16;
+		VulkanMemoryRange* newRanges = realloc(block->FreeRanges, newCapacity * sizeof(newRanges[0]));
+		if (!newRanges) {
+			return false;
+		}
+
+		block->FreeRanges = newRanges;
+		block->FreeRangeCapacity = newCapacity;
+	}
+
+	memmove(&block->FreeRanges[index + 1], &block->FreeRanges[index], (block->FreeRangeCount - index) * sizeof(block->FreeRanges[0]));
+	block->FreeRanges[index] = range;
+	block->FreeRangeCount++;
+	return true;
+}
+
+static void VulkanImagePoolBlock_RemoveRange(VulkanImagePoolBlock* block, u64 index) {
+	memmove(&block->FreeRanges[index], &block->FreeRanges[index + 1], (block->FreeRangeCount - index - 1) * sizeof(block->FreeRanges[0]));
+	block->FreeRangeCount--;
+}
+
+// NOTE: First fit, the alignment padding in front of an allocation stays in the free list
+static b8 VulkanImagePoolBlock_Allocate(VulkanImagePoolBlock* block, u64 size, u64 alignment, u64* offset) {
+	for (u64 i = 0; i < block->FreeRangeCount; i++) {
+		VulkanMemoryRange* range = &block->FreeRanges[i];
+		u64 alignedOffset = AlignUp(range->Offset, alignment);
+		u64 end = range->Offset + range->Size;
+		if (alignedOffset + size > end) {
+			continue;
+		}
+
+		u64 remainder = end - (alignedOffset + size);
+		if (alignedOffset > range->Offset) {
+			range->Size = alignedOffset - range->Offset;
+			if (remainder > 0 && !VulkanImagePoolBlock_InsertRange(block, i + 1, (VulkanMemoryRange){ alignedOffset + size, remainder })) {
+				range->Size = end - range->Offset;
+				return false;
+			}
+		} else if (remainder > 0) {
+			range->Offset = alignedOffset + size;
+			range->Size = remainder;
+		} else {
+			VulkanImagePoolBlock_RemoveRange(block, i);
+		}
+
+		block->AllocationCount++;
+		*offset = alignedOffset;
+		return true;
+	}
+
+	return false;
+}
+
+static b8 VulkanImagePoolBlock_Free(VulkanImagePoolBlock* block, u64 offset, u64 size) {
+	u64 index = 0;
+	while (index < block->FreeRangeCount && block->FreeRanges[index].Offset < offset) {
+		index++;
+	}
+
+	b8 mergePrevious = index > 0 && block->FreeRanges[index - 1].Offset + block->FreeRanges[index - 1].Size == offset;
+	b8 mergeNext = index < block->FreeRangeCount && offset + size == block->FreeRanges[index].Offset;
+
+	if (mergePrevious && mergeNext) {
+		block->FreeRanges[index - 1].Size += size + block->FreeRanges[index].Size;
+		VulkanImagePoolBlock_RemoveRange(block, index);
+	} else if (mergePrevious) {
+		block->FreeRanges[index - 1].Size += size;
+	} else if (mergeNext) {
+		block->FreeRanges[index].Offset = offset;
+		block->FreeRanges[index].Size += size;
+	} else if (!VulkanImagePoolBlock_InsertRange(block, index, (VulkanMemoryRange){ offset, size })) {
+		return false;
+	}
+
+	block->AllocationCount--;
+	return true;
+}
+
+static u32 VulkanImagePool_SelectMemoryType(VulkanImagePool* pool, u32 memoryTypeBits, VkMemoryPropertyFlags propertyFlags) {
+	for (u32 i = 0; i < pool->MemoryProperties.memoryTypeCount; i++) {
+		if ((memoryTypeBits & (1 << i)) != 0 && (pool->MemoryProperties.memoryTypes[i].propertyFlags & propertyFlags) == propertyFlags) {
+			return i;
+		}
+	}
+
+	return ~0u;
+}
+
+static void VulkanImagePool_FreeBlockMemory(VulkanImagePool* pool, VulkanImagePoolBlock* block) {
+	VulkanMemoryBudget_TrackFree(pool->MemoryProperties.memoryTypes[block->MemoryTypeIndex].heapIndex, block->Size);
+	vkFreeMemory(pool->Device, block->Memory, NULL);
+	block->Memory = VK_NULL_HANDLE;
+}
+
+static u64 VulkanImagePool_AddBlock(VulkanImagePool* pool, u32 memoryTypeIndex, u64 size) {
+	u64 blockIndex = 0;
+	while (blockIndex < pool->BlockCount && pool->Blocks[blockIndex].Memory != VK_NULL_HANDLE) {
+		blockIndex++;
+	}
+
+	if (blockIndex == pool->BlockCount) {
+		VulkanImagePoolBlock* newBlocks = realloc(pool->Blocks, (pool->BlockCount + 1) * sizeof(newBlocks[0]));
+		if (!newBlocks) {
+			return ~0ull;
+		}
+
+		pool->Blocks = newBlocks;
+		pool->Blocks[pool->BlockCount++] = (VulkanImagePoolBlock){};
+	}
+
+	VulkanImagePoolBlock* block = &pool->Blocks[blockIndex];
+	block->MemoryTypeIndex = memoryTypeIndex;
+	block->Size = size;
+	block->AllocationCount = 0;
+	block->FreeRangeCount = 0;
+
+	if (!VulkanImagePoolBlock_InsertRange(block, 0, (VulkanMemoryRange){ 0, size })) {
+		return ~0ull;
+	}
+
+	if (vkAllocateMemory(pool->Device, &(VkMemoryAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		.allocationSize = size,
+		.memoryTypeIndex = memoryTypeIndex,
+	}, NULL, &block->Memory) != VK_SUCCESS) {
+		block->Memory = VK_NULL_HANDLE;
+		return ~0ull;
+	}
+
+	VulkanMemoryBudget_TrackAllocation(pool->MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex, size);
+
+	return blockIndex;
+}
+
+b8 VulkanImagePool_Create(VulkanImagePool* pool, VkDevice device, VkPhysicalDevice physicalDevice, u64 blockSize) {
+	*pool = (VulkanImagePool){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.BlockSize = blockSize ? blockSize : VULKAN_IMAGE_POOL_DEFAULT_BLOCK_SIZE,
+	};
+
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &pool->MemoryProperties);
+	return true;
+}
+
+void VulkanImagePool_Destroy(VulkanImagePool* pool) {
+	for (u64 i = 0; i < pool->BlockCount; i++) {
+		if (pool->Blocks[i].Memory != VK_NULL_HANDLE) {
+			VulkanImagePool_FreeBlockMemory(pool, &pool->Blocks[i]);
+		}
+		free(pool->Blocks[i].FreeRanges);
+	}
+
+	free(pool->Blocks);
+	*pool = (VulkanImagePool){};
+}
+
+b8 VulkanImagePool_CreateImage(VulkanImagePool* pool, VulkanImage* image, u32 width, u32 height, u32 mipLevels, VkFormat format, VkImageUsageFlags usage) {
+	*image = (VulkanImage){
+		.Format = format,
+		.Width = width,
+		.Height = height,
+		.MipLevels = mipLevels,
+	};
+
+	VkCheck(vkCreateImage(pool->Device, &(VkImageCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		.imageType = VK_IMAGE_TYPE_2D,
+		.format = format,
+		.extent = (VkExtent3D){ width, height, 1 },
+		.mipLevels = mipLevels,
+		.arrayLayers = 1,
+		.samples = VK_SAMPLE_COUNT_1_BIT,
+		.tiling = VK_IMAGE_TILING_OPTIMAL,
+		.usage = usage,
+		.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+		.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+	}, NULL, &image->Image));
+
+	VkMemoryRequirements memoryRequirements = {};
+	vkGetImageMemoryRequirements(pool->Device, image->Image, &memoryRequirements);
+
+	u32 memoryTypeIndex = VulkanImagePool_SelectMemoryType(pool, memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	if (memoryTypeIndex == ~0u) {
+		VulkanImagePool_DestroyImage(pool, image);
+		return false;
+	}
+
+	// NOTE: Only optimal tiling images live in the pool, so bufferImageGranularity never comes into play
+	u64 blockIndex = ~0ull;
+	u64 offset = 0;
+	for (u64 i = 0; i < pool->BlockCount; i++) {
+		VulkanImagePoolBlock* block = &pool->Blocks[i];
+		if (block->Memory != VK_NULL_HANDLE && block->MemoryTypeIndex == memoryTypeIndex &&
+			VulkanImagePoolBlock_Allocate(block, memoryRequirements.size, memoryRequirements.alignment, &offset)
+		) {
+			blockIndex = i;
+			break;
+		}
+	}
+
+	if (blockIndex == ~0ull) {
+		u64 blockSize = memoryRequirements.size > pool->BlockSize ? memoryRequirements.size : pool->BlockSize;
+		blockIndex = VulkanImagePool_AddBlock(pool, memoryTypeIndex, blockSize);
+		if (blockIndex == ~0ull || !VulkanImagePoolBlock_Allocate(&pool->Blocks[blockIndex], memoryRequirements.size, memoryRequirements.alignment, &offset)) {
+			VulkanImagePool_DestroyImage(pool, image);
+			return false;
+		}
+	}
+
+	image->BlockIndex = blockIndex;
+	image->Offset = offset;
+	image->Size = memoryRequirements.size;
+	pool->AllocatedSize += image->Size;
+
+	if (vkBindImageMemory(pool->Device, image->Image, pool->Blocks[blockIndex].Memory, offset) != VK_SUCCESS ||
+		vkCreateImageView(pool->Device, &(VkImageViewCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.image = image->Image,
+			.viewType = VK_IMAGE_VIEW_TYPE_2D,
+			.format = format,
+			.subresourceRange = (VkImageSubresourceRange){
+				.aspectMask = GetVulkanFormatAspect(format),
+				.levelCount = mipLevels,
+				.layerCount = 1,
+			},
+		}, NULL, &image->View) != VK_SUCCESS
+	) {
+		VulkanImagePool_DestroyImage(pool, image);
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanImagePool_DestroyImage(VulkanImagePool* pool, VulkanImage* image) {
+	if (image->View != VK_NULL_HANDLE) {
+		vkDestroyImageView(pool->Device, image->View, NULL);
+	}
+
+	if (image->Image != VK_NULL_HANDLE) {
+		vkDestroyImage(pool->Device, image->Image, NULL);
+	}
+
+	// NOTE: Size is only set once the memory is allocated, so zero initialized images are safe to destroy
+	if (image->Size > 0) {
+		VulkanImagePoolBlock* block = &pool->Blocks[image->BlockIndex];
+		ASSERT(VulkanImagePoolBlock_Free(block, image->Offset, image->Size));
+		pool->AllocatedSize -= image->Size;
+
+		// NOTE: Empty blocks are returned to the driver, the slot is reused by the next block
+		if (block->AllocationCount == 0) {
+			VulkanImagePool_FreeBlockMemory(pool, block);
+		}
+	}
+
+	*image = (VulkanImage){};
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+#define VULKAN_IMAGE_POOL_DEFAULT_BLOCK_SIZE (64ull * 1024 * 1024)
+
+typedef struct VulkanMemoryRange_t {
+	u64 Offset;
+	u64 Size;
+} VulkanMemoryRange;
+
+typedef struct VulkanImagePoolBlock_t {
+	VkDeviceMemory Memory; // VK_NULL_HANDLE when the block is unused
+	u32 MemoryTypeIndex;
+	u64 Size;
+	u64 AllocationCount;
+
+	VulkanMemoryRange* FreeRanges; // Sorted by offset and never adjacent
+	u64 FreeRangeCount;
+	u64 FreeRangeCapacity;
+} VulkanImagePoolBlock;
+
+// NOTE: Device local images are sub allocated from large blocks instead of one vkAllocateMemory each,
+// images bigger than a block get a block of their own
+typedef struct VulkanImagePool_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VkPhysicalDeviceMemoryProperties MemoryProperties;
+	u64 BlockSize;
+
+	VulkanImagePoolBlock* Blocks;
+	u64 BlockCount;
+
+	u64 AllocatedSize; // Sum of the live image allocations, not the blocks
+} VulkanImagePool;
+
+typedef struct VulkanImage_t {
+	VkImage Image;
+	VkImageView View;
+	VkFormat Format;
+	u32 Width;
+	u32 Height;
+	u32 MipLevels;
+
+	u64 BlockIndex;
+	u64 Offset;
+	u64 Size;
+} VulkanImage;
+
+b8 VulkanImagePool_Create(VulkanImagePool* pool, VkDevice device, VkPhysicalDevice physicalDevice, u64 blockSize);
+void VulkanImagePool_Destroy(VulkanImagePool* pool);
+
+// NOTE: Creates a 2D optimal tiling image with a view over every mip level, the view only has the depth aspect for depth formats
+b8 VulkanImagePool_CreateImage(VulkanImagePool* pool, VulkanImage* image, u32 width, u32 height, u32 mipLevels, VkFormat format, VkImageUsageFlags usage);
+void VulkanImagePool_DestroyImage(VulkanImagePool* pool, VulkanImage* image);
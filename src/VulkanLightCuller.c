@@ -0,0 +1,277 @@
+#include "VulkanLightCuller.h"
+#include "VulkanUtil.h"
+
+#include <string.h>
+
+// NOTE: Matches the PushConstants block in light_cull.comp.glsl
+typedef struct LightCullPushConstants_t {
+	Matrix4 ViewMatrix;
+	BindlessHandle LightBufferHandle;
+	BindlessHandle BoundsBufferHandle;
+	BindlessHandle GridBufferHandle;
+	u32 LightCount;
+} LightCullPushConstants;
+
+#define LIGHT_MIN_CAPACITY 256
+#define LIGHT_GRID_SIZE (sizeof(LightGridStats) + VULKAN_LIGHT_CULLER_CLUSTER_COUNT * (VULKAN_LIGHT_CULLER_MAX_CLUSTER_LIGHTS + 1) * sizeof(u32))
+
+static void VulkanLightCuller_RemoveHandle(VulkanBindless* bindless, BindlessHandle* handle) {
+	if (*handle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveStorageBuffer(bindless, *handle);
+		*handle = BINDLESS_HANDLE_NONE;
+	}
+}
+
+static void VulkanLightCuller_DestroyBuffer(VulkanBuffer* buffer) {
+	if (buffer->Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(buffer);
+		*buffer = (VulkanBuffer){};
+	}
+}
+
+static b8 VulkanLightCuller_CreateStorageBuffer(
+	VulkanLightCuller* culler,
+	VulkanBuffer* buffer,
+	BindlessHandle* handle,
+	u64 size,
+	VkBufferUsageFlags usage,
+	b8 deviceLocal
+) {
+	VulkanLightCuller_RemoveHandle(culler->Bindless, handle);
+	VulkanLightCuller_DestroyBuffer(buffer);
+
+	b8 created = deviceLocal
+		? VulkanBuffer_CreateDeviceLocal(buffer, culler->Device, culler->PhysicalDevice, size, usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+		: VulkanBuffer_Create(buffer, culler->Device, culler->PhysicalDevice, size, usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	if (!created) {
+		return false;
+	}
+
+	*handle = VulkanBindless_AddStorageBuffer(culler->Bindless, buffer->Buffer, 0, buffer->Size);
+	return *handle != BINDLESS_HANDLE_NONE;
+}
+
+b8 VulkanLightCuller_Create(
+	VulkanLightCuller* culler,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	u32 frameCount,
+	VkShaderModule cullShader
+) {
+	ASSERT(frameCount <= VULKAN_LIGHT_CULLER_MAX_FRAMES);
+
+	*culler = (VulkanLightCuller){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.Bindless = bindless,
+		.FrameCount = frameCount,
+	};
+
+	for (u32 i = 0; i < frameCount; i++) {
+		LightCullerFrame* frame = &culler->Frames[i];
+		frame->LightsHandle = BINDLESS_HANDLE_NONE;
+		frame->BoundsHandle = BINDLESS_HANDLE_NONE;
+		frame->GridHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	for (u32 i = 0; i < frameCount; i++) {
+		LightCullerFrame* frame = &culler->Frames[i];
+		if (!VulkanLightCuller_CreateStorageBuffer(culler, &frame->Bounds, &frame->BoundsHandle, VULKAN_LIGHT_CULLER_CLUSTER_COUNT * sizeof(LightClusterBounds), 0, false) ||
+			!VulkanLightCuller_CreateStorageBuffer(culler, &frame->Grid, &frame->GridHandle, LIGHT_GRID_SIZE, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, true) ||
+			!VulkanBuffer_Create(&frame->Stats, device, physicalDevice, sizeof(LightGridStats), VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+		) {
+			VulkanLightCuller_Destroy(culler);
+			return false;
+		}
+		*cast(LightGridStats*) frame->Stats.Data = (LightGridStats){};
+	}
+
+	if (vkCreatePipelineLayout(device, &(VkPipelineLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		.setLayoutCount = 1,
+		.pSetLayouts = &bindless->SetLayout,
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = &(VkPushConstantRange){
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof(LightCullPushConstants),
+		},
+	}, NULL, &culler->PipelineLayout) != VK_SUCCESS) {
+		VulkanLightCuller_Destroy(culler);
+		return false;
+	}
+
+	if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &(VkComputePipelineCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+		.stage = (VkPipelineShaderStageCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+			.module = cullShader,
+			.pName = "main",
+		},
+		.layout = culler->PipelineLayout,
+	}, NULL, &culler->Pipeline) != VK_SUCCESS) {
+		VulkanLightCuller_Destroy(culler);
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanLightCuller_Destroy(VulkanLightCuller* culler) {
+	for (u32 i = 0; i < culler->FrameCount; i++) {
+		LightCullerFrame* frame = &culler->Frames[i];
+		VulkanLightCuller_RemoveHandle(culler->Bindless, &frame->LightsHandle);
+		VulkanLightCuller_RemoveHandle(culler->Bindless, &frame->BoundsHandle);
+		VulkanLightCuller_RemoveHandle(culler->Bindless, &frame->GridHandle);
+		VulkanLightCuller_DestroyBuffer(&frame->Lights);
+		VulkanLightCuller_DestroyBuffer(&frame->Bounds);
+		VulkanLightCuller_DestroyBuffer(&frame->Grid);
+		VulkanLightCuller_DestroyBuffer(&frame->Stats);
+	}
+
+	if (culler->Pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(culler->Device, culler->Pipeline, NULL);
+	}
+
+	if (culler->PipelineLayout != VK_NULL_HANDLE) {
+		vkDestroyPipelineLayout(culler->Device, culler->PipelineLayout, NULL);
+	}
+
+	*culler = (VulkanLightCuller){};
+}
+
+static Vector3 VulkanLightCuller_Unproject(const Matrix4* inverseProjection, f32 x, f32 y, f32 z) {
+	Vector4 v = Matrix4_MultiplyVector(inverseProjection, (Vector4){ x, y, z, 1.0f });
+	return (Vector3){ v.x / v.w, v.y / v.w, v.z / v.w };
+}
+
+// NOTE: Moves along the line from a to b until it reaches view z
+static Vector3 VulkanLightCuller_AtDepth(Vector3 a, Vector3 b, f32 z) {
+	f32 t = b.z != a.z ? (z - a.z) / (b.z - a.z) : 0.0f;
+	return (Vector3){ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, z };
+}
+
+// NOTE: The slices are linear in view z between the near and far plane, which works for projections with and without perspective.
+// Every froxel is bounded by the rays through its tile corners, cut at the view z of its slice. The tiles are in framebuffer
+// order, with the viewport flipped the top row of tiles is at ndc y 1
+static void VulkanLightCuller_BuildBounds(LightCullerFrame* frame, const Matrix4* projectionMatrix) {
+	Matrix4 inverseProjection = Matrix4_Inverse(projectionMatrix);
+	frame->DepthNear = VulkanLightCuller_Unproject(&inverseProjection, 0.0f, 0.0f, 0.0f).z;
+	frame->DepthFar = VulkanLightCuller_Unproject(&inverseProjection, 0.0f, 0.0f, 1.0f).z;
+
+	LightClusterBounds* bounds = frame->Bounds.Data;
+	for (u32 y = 0; y < VULKAN_LIGHT_CULLER_GRID_Y; y++) {
+		for (u32 x = 0; x < VULKAN_LIGHT_CULLER_GRID_X; x++) {
+			f32 ndcX[2] = {
+				-1.0f + 2.0f * cast(f32) x / VULKAN_LIGHT_CULLER_GRID_X,
+				-1.0f + 2.0f * cast(f32) (x + 1) / VULKAN_LIGHT_CULLER_GRID_X,
+			};
+			f32 ndcY[2] = {
+				1.0f - 2.0f * cast(f32) y / VULKAN_LIGHT_CULLER_GRID_Y,
+				1.0f - 2.0f * cast(f32) (y + 1) / VULKAN_LIGHT_CULLER_GRID_Y,
+			};
+
+			Vector3 nearCorners[4];
+			Vector3 farCorners[4];
+			for (u32 i = 0; i < 4; i++) {
+				nearCorners[i] = VulkanLightCuller_Unproject(&inverseProjection, ndcX[i % 2], ndcY[i / 2], 0.0f);
+				farCorners[i] = VulkanLightCuller_Unproject(&inverseProjection, ndcX[i % 2], ndcY[i / 2], 1.0f);
+			}
+
+			for (u32 z = 0; z < VULKAN_LIGHT_CULLER_GRID_Z; z++) {
+				f32 sliceDepths[2] = {
+					frame->DepthNear + (frame->DepthFar - frame->DepthNear) * cast(f32) z / VULKAN_LIGHT_CULLER_GRID_Z,
+					frame->DepthNear + (frame->DepthFar - frame->DepthNear) * cast(f32) (z + 1) / VULKAN_LIGHT_CULLER_GRID_Z,
+				};
+
+				Vector3 min = VulkanLightCuller_AtDepth(nearCorners[0], farCorners[0], sliceDepths[0]);
+				Vector3 max = min;
+				for (u32 i = 0; i < 8; i++) {
+					Vector3 p = VulkanLightCuller_AtDepth(nearCorners[i % 4], farCorners[i % 4], sliceDepths[i / 4]);
+					min = (Vector3){ p.x < min.x ? p.x : min.x, p.y < min.y ? p.y : min.y, p.z < min.z ? p.z : min.z };
+					max = (Vector3){ p.x > max.x ? p.x : max.x, p.y > max.y ? p.y : max.y, p.z > max.z ? p.z : max.z };
+				}
+
+				u32 clusterIndex = (z * VULKAN_LIGHT_CULLER_GRID_Y + y) * VULKAN_LIGHT_CULLER_GRID_X + x;
+				bounds[clusterIndex] = (LightClusterBounds){
+					.Min = (Vector4){ min.x, min.y, min.z, 0.0f },
+					.Max = (Vector4){ max.x, max.y, max.z, 0.0f },
+				};
+			}
+		}
+	}
+
+	frame->BoundsProjection = *projectionMatrix;
+	frame->BoundsValid = true;
+}
+
+b8 VulkanLightCuller_BeginFrame(VulkanLightCuller* culler, u32 frameIndex, u64 lightCount, const Matrix4* projectionMatrix) {
+	ASSERT(frameIndex < culler->FrameCount);
+	LightCullerFrame* frame = &culler->Frames[frameIndex];
+	frame->LightCount = 0;
+
+	// NOTE: The frame's previous submission has finished, so its buffers can be replaced straight away
+	if (lightCount > frame->LightCapacity || frame->Lights.Buffer == VK_NULL_HANDLE) {
+		u64 capacity = frame->LightCapacity > LIGHT_MIN_CAPACITY ? frame->LightCapacity : LIGHT_MIN_CAPACITY;
+		while (capacity < lightCount) {
+			capacity *= 2;
+		}
+
+		frame->LightCapacity = 0;
+		if (!VulkanLightCuller_CreateStorageBuffer(culler, &frame->Lights, &frame->LightsHandle, capacity * sizeof(GpuLight), 0, false)) {
+			return false;
+		}
+		frame->LightCapacity = capacity;
+	}
+
+	if (!frame->BoundsValid || memcmp(&frame->BoundsProjection, projectionMatrix, sizeof(*projectionMatrix)) != 0) {
+		VulkanLightCuller_BuildBounds(frame, projectionMatrix);
+	}
+
+	frame->LightCount = lightCount;
+	return true;
+}
+
+LightGridStats VulkanLightCuller_GetStats(const VulkanLightCuller* culler, u32 frameIndex) {
+	ASSERT(frameIndex < culler->FrameCount);
+	return *cast(const LightGridStats*) culler->Frames[frameIndex].Stats.Data;
+}
+
+void VulkanLightCuller_RecordCull(VulkanLightCuller* culler, VkCommandBuffer commandBuffer, u32 frameIndex, const Matrix4* viewMatrix) {
+	ASSERT(frameIndex < culler->FrameCount);
+	LightCullerFrame* frame = &culler->Frames[frameIndex];
+
+	vkCmdFillBuffer(commandBuffer, frame->Grid.Buffer, 0, sizeof(LightGridStats), 0);
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &(VkMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+		.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	}, 0, NULL, 0, NULL);
+
+	// NOTE: Every froxel is rewritten even without lights, so the fragment shader never reads an old count
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, culler->PipelineLayout, 0, 1, &culler->Bindless->Set, 0, NULL);
+
+	LightCullPushConstants pushConstants = {
+		.ViewMatrix = *viewMatrix,
+		.LightBufferHandle = frame->LightsHandle,
+		.BoundsBufferHandle = frame->BoundsHandle,
+		.GridBufferHandle = frame->GridHandle,
+		.LightCount = cast(u32) frame->LightCount,
+	};
+	vkCmdPushConstants(commandBuffer, culler->PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+	// NOTE: One workgroup per froxel, its invocations split the lights between them
+	vkCmdDispatch(commandBuffer, VULKAN_LIGHT_CULLER_CLUSTER_COUNT, 1, 1);
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &(VkMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+		.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+	}, 0, NULL, 0, NULL);
+
+	vkCmdCopyBuffer(commandBuffer, frame->Grid.Buffer, frame->Stats.Buffer, 1, &(VkBufferCopy){ .srcOffset = 0, .dstOffset = 0, .size = sizeof(LightGridStats) });
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+#include "Matrix.h"
+#include "Light.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindless.h"
+
+#include <vulkan/vulkan.h>
+
+#define VULKAN_LIGHT_CULLER_MAX_FRAMES 4
+
+// NOTE: Matches the constants in light_cull.comp.glsl and triangle.frag.glsl. The grid splits the screen into tiles and the view
+// depth into linear slices, every froxel stores the lights that touch it
+#define VULKAN_LIGHT_CULLER_GRID_X 16
+#define VULKAN_LIGHT_CULLER_GRID_Y 9
+#define VULKAN_LIGHT_CULLER_GRID_Z 24
+#define VULKAN_LIGHT_CULLER_CLUSTER_COUNT (VULKAN_LIGHT_CULLER_GRID_X * VULKAN_LIGHT_CULLER_GRID_Y * VULKAN_LIGHT_CULLER_GRID_Z)
+// NOTE: Lights past this in one froxel are dropped, a froxel is its count followed by this many indices
+#define VULKAN_LIGHT_CULLER_MAX_CLUSTER_LIGHTS 255
+
+// NOTE: View space bounds of one froxel, matches ClusterBounds in light_cull.comp.glsl
+typedef struct LightClusterBounds_t {
+	Vector4 Min;
+	Vector4 Max;
+} LightClusterBounds;
+
+// NOTE: Matches the header of the grid buffer, the counts are from before the froxels were clamped
+typedef struct LightGridStats_t {
+	u32 TotalCount;    // Light references summed over every froxel
+	u32 MaxCount;      // Most lights touching one froxel
+	u32 OverflowCount; // Froxels that dropped lights
+	u32 Padding;
+} LightGridStats;
+
+typedef struct LightCullerFrame_t {
+	VulkanBuffer Lights; // GpuLight, written by the CPU
+	VulkanBuffer Bounds; // LightClusterBounds, rebuilt by the CPU when the projection changes
+	VulkanBuffer Grid;   // LightGridStats followed by every froxel's lights, written by the cull shader
+	VulkanBuffer Stats;  // The grid stats copied back for the CPU
+	BindlessHandle LightsHandle;
+	BindlessHandle BoundsHandle;
+	BindlessHandle GridHandle;
+	u64 LightCapacity;
+	u64 LightCount;
+
+	Matrix4 BoundsProjection; // The projection Bounds was built for
+	b8 BoundsValid;
+	f32 DepthNear; // The view z the first slice starts at
+	f32 DepthFar;  // The view z the last slice ends at
+} LightCullerFrame;
+
+// NOTE: Clustered forward lighting. A compute pass bins the frame's lights into view space froxels and the fragment shader
+// only shades with the lights of the froxel it lands in. The lights are culled against the froxel bounds with a sphere test,
+// spot lights also with a cone test against the froxel's bounding sphere
+typedef struct VulkanLightCuller_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VulkanBindless* Bindless;
+
+	VkPipelineLayout PipelineLayout;
+	VkPipeline Pipeline;
+
+	LightCullerFrame Frames[VULKAN_LIGHT_CULLER_MAX_FRAMES];
+	u32 FrameCount;
+} VulkanLightCuller;
+
+b8 VulkanLightCuller_Create(
+	VulkanLightCuller* culler,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	u32 frameCount,
+	VkShaderModule cullShader
+);
+void VulkanLightCuller_Destroy(VulkanLightCuller* culler);
+
+// NOTE: Call once the frame's previous submission has finished. Makes room for lightCount lights, which are written to the mapped
+// Lights buffer of the frame before recording, and rebuilds the froxel bounds if projectionMatrix changed
+b8 VulkanLightCuller_BeginFrame(VulkanLightCuller* culler, u32 frameIndex, u64 lightCount, const Matrix4* projectionMatrix);
+// NOTE: The grid stats from the last time frameIndex was submitted
+LightGridStats VulkanLightCuller_GetStats(const VulkanLightCuller* culler, u32 frameIndex);
+
+// NOTE: Outside of a render pass, before the draws that shade with the grid. Only synchronizes its own steps, the render graph
+// orders the Grid and Stats buffers it writes against everything else
+void VulkanLightCuller_RecordCull(VulkanLightCuller* culler, VkCommandBuffer commandBuffer, u32 frameIndex, const Matrix4* viewMatrix);
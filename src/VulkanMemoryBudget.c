@@ -0,0 +1,73 @@
+#include "VulkanMemoryBudget.h"
+
+#include <stdatomic.h>
+
+static _Atomic u64 TrackedHeapUsages[VK_MAX_MEMORY_HEAPS];
+
+void VulkanMemoryBudget_Create(VulkanMemoryBudget* budget, VkPhysicalDevice physicalDevice, b8 hasBudgetExtension) {
+	*budget = (VulkanMemoryBudget){
+		.PhysicalDevice = physicalDevice,
+		.HasBudgetExtension = hasBudgetExtension,
+	};
+
+	VulkanMemoryBudget_Update(budget);
+}
+
+void VulkanMemoryBudget_Update(VulkanMemoryBudget* budget) {
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+	};
+
+	VkPhysicalDeviceMemoryProperties2 memoryProperties = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+		.pNext = budget->HasBudgetExtension ? &budgetProperties : NULL,
+	};
+	vkGetPhysicalDeviceMemoryProperties2(budget->PhysicalDevice, &memoryProperties);
+
+	budget->HeapCount = memoryProperties.memoryProperties.memoryHeapCount;
+	budget->DeviceLocalHeapIndex = VulkanMemoryBudget_FindDeviceLocalHeap(&memoryProperties.memoryProperties);
+
+	for (u32 i = 0; i < budget->HeapCount; i++) {
+		u64 heapSize = memoryProperties.memoryProperties.memoryHeaps[i].size;
+		u64 trackedUsage = VulkanMemoryBudget_GetTrackedUsage(i);
+		budget->HeapSizes[i] = heapSize;
+
+		if (budget->HasBudgetExtension) {
+			u64 untrackedUsage = budgetProperties.heapUsage[i] > trackedUsage ? budgetProperties.heapUsage[i] - trackedUsage : 0;
+			budget->HeapBudgets[i] = budgetProperties.heapBudget[i] > untrackedUsage ? budgetProperties.heapBudget[i] - untrackedUsage : 0;
+			budget->HeapUsages[i] = budgetProperties.heapUsage[i];
+		} else {
+			budget->HeapBudgets[i] = heapSize / 100 * VULKAN_MEMORY_BUDGET_FALLBACK_PERCENT;
+			budget->HeapUsages[i] = trackedUsage;
+		}
+	}
+}
+
+u32 VulkanMemoryBudget_FindDeviceLocalHeap(const VkPhysicalDeviceMemoryProperties* memoryProperties) {
+	u32 heapIndex = 0;
+	u64 heapSize = 0;
+	for (u32 i = 0; i < memoryProperties->memoryHeapCount; i++) {
+		const VkMemoryHeap* heap = &memoryProperties->memoryHeaps[i];
+		if ((heap->flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap->size > heapSize) {
+			heapIndex = i;
+			heapSize = heap->size;
+		}
+	}
+
+	return heapIndex;
+}
+
+void VulkanMemoryBudget_TrackAllocation(u32 heapIndex, u64 size) {
+	ASSERT(heapIndex < VK_MAX_MEMORY_HEAPS);
+	atomic_fetch_add(&TrackedHeapUsages[heapIndex], size);
+}
+
+void VulkanMemoryBudget_TrackFree(u32 heapIndex, u64 size) {
+	ASSERT(heapIndex < VK_MAX_MEMORY_HEAPS);
+	atomic_fetch_sub(&TrackedHeapUsages[heapIndex], size);
+}
+
+u64 VulkanMemoryBudget_GetTrackedUsage(u32 heapIndex) {
+	ASSERT(heapIndex < VK_MAX_MEMORY_HEAPS);
+	return atomic_load(&TrackedHeapUsages[heapIndex]);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Typedefs.h"
+
+#include <vulkan/vulkan.h>
+
+// NOTE: Without VK_EXT_memory_budget the tracked allocations may only fill this much of a heap
+#define VULKAN_MEMORY_BUDGET_FALLBACK_PERCENT 80
+
+typedef struct VulkanMemoryBudget_t {
+	VkPhysicalDevice PhysicalDevice;
+	b8 HasBudgetExtension;
+	u32 HeapCount;
+	u32 DeviceLocalHeapIndex; // The largest device local heap
+
+	// NOTE: Refreshed by VulkanMemoryBudget_Update. A budget is how large the tracked allocations in that heap may grow,
+	// memory used by other processes and untracked allocations (the swapchain) is already taken out
+	u64 HeapSizes[VK_MAX_MEMORY_HEAPS];
+	u64 HeapBudgets[VK_MAX_MEMORY_HEAPS];
+	u64 HeapUsages[VK_MAX_MEMORY_HEAPS]; // Reported by the driver, the tracked usage without the extension
+} VulkanMemoryBudget;
+
+// NOTE: hasBudgetExtension must only be set when VK_EXT_memory_budget was enabled on the device
+void VulkanMemoryBudget_Create(VulkanMemoryBudget* budget, VkPhysicalDevice physicalDevice, b8 hasBudgetExtension);
+void VulkanMemoryBudget_Update(VulkanMemoryBudget* budget);
+
+u32 VulkanMemoryBudget_FindDeviceLocalHeap(const VkPhysicalDeviceMemoryProperties* memoryProperties);
+
+// NOTE: Every VulkanBuffer and image pool block reports its vkAllocateMemory here, safe to call from any thread
+void VulkanMemoryBudget_TrackAllocation(u32 heapIndex, u64 size);
+void VulkanMemoryBudget_TrackFree(u32 heapIndex, u64 size);
+u64 VulkanMemoryBudget_GetTrackedUsage(u32 heapIndex);
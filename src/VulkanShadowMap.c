@@ -0,0 +1,659 @@
+#include "VulkanShadowMap.h"
+#include "VulkanUtil.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+
+// NOTE: Matches the PushConstants block in shadow.vert.glsl
+typedef struct ShadowPushConstants_t {
+	Matrix4 ModelMatrix; // NOTE: Pushed per draw, the rest once per cascade
+	BindlessHandle ShadowBufferHandle;
+	u32 CascadeIndex;
+} ShadowPushConstants;
+
+#define SHADOW_MIN_DRAW_CAPACITY 64
+
+// NOTE: How much larger than their slice of the view the cached cascades are, so the view can move a bit before they are refitted
+#define SHADOW_CACHED_CASCADE_MARGIN 1.25f
+// NOTE: How far the splits lean towards a logarithmic split, which gives the near cascades more of the resolution
+#define SHADOW_SPLIT_LAMBDA 0.75f
+
+b8 VulkanShadowMap_Create(
+	VulkanShadowMap* map,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	VulkanImagePool* imagePool,
+	u32 frameCount,
+	VkFormat depthFormat,
+	u32 resolution,
+	VkShaderModule vertexShader
+) {
+	ASSERT(frameCount <= VULKAN_SHADOW_MAP_MAX_FRAMES);
+	ASSERT(resolution > 2);
+
+	*map = (VulkanShadowMap){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.Bindless = bindless,
+		.ImagePool = imagePool,
+		.SamplerHandle = BINDLESS_HANDLE_NONE,
+		.Resolution = resolution,
+		.AtlasHandle = BINDLESS_HANDLE_NONE,
+		.FrameCount = frameCount,
+	};
+
+	for (u32 i = 0; i < frameCount; i++) {
+		map->Frames[i].DataHandle = BINDLESS_HANDLE_NONE;
+	}
+
+	for (u32 i = 0; i < frameCount; i++) {
+		ShadowMapFrame* frame = &map->Frames[i];
+		if (!VulkanBuffer_Create(&frame->Data, device, physicalDevice, sizeof(ShadowData), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+			VulkanShadowMap_Destroy(map);
+			return false;
+		}
+
+		frame->DataHandle = VulkanBindless_AddStorageBuffer(bindless, frame->Data.Buffer, 0, frame->Data.Size);
+		if (frame->DataHandle == BINDLESS_HANDLE_NONE) {
+			VulkanShadowMap_Destroy(map);
+			return false;
+		}
+	}
+
+	if (!VulkanImagePool_CreateImage(
+		imagePool,
+		&map->Atlas,
+		resolution * 2,
+		resolution * 2,
+		1,
+		depthFormat,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+	) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	map->AtlasHandle = VulkanBindless_AddSampledImage(bindless, map->Atlas.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	if (map->AtlasHandle == BINDLESS_HANDLE_NONE) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	// NOTE: Linear filtering of a comparison sampler blends the results of the four nearest texels, which softens the edges for free
+	if (vkCreateSampler(device, &(VkSamplerCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+		.magFilter = VK_FILTER_LINEAR,
+		.minFilter = VK_FILTER_LINEAR,
+		.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+		.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		.compareEnable = VK_TRUE,
+		.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL,
+		.minLod = 0.0f,
+		.maxLod = 0.0f,
+	}, NULL, &map->Sampler) != VK_SUCCESS) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	map->SamplerHandle = VulkanBindless_AddSampler(bindless, map->Sampler);
+	if (map->SamplerHandle == BINDLESS_HANDLE_NONE) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	// NOTE: The atlas is loaded so the cached cascades survive, the tiles that are drawn again are cleared by RecordDraws. Like the
+	// main pass it stays in its attachment layout and the render graph transitions it around the pass
+	if (vkCreateRenderPass(device, &(VkRenderPassCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+		.attachmentCount = 1,
+		.pAttachments = &(VkAttachmentDescription){
+			.format = depthFormat,
+			.samples = VK_SAMPLE_COUNT_1_BIT,
+			.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+			.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+			.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+			.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+			.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+		},
+		.subpassCount = 1,
+		.pSubpasses = &(VkSubpassDescription){
+			.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+			.pDepthStencilAttachment = &(VkAttachmentReference){
+				.attachment = 0,
+				.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			},
+		},
+	}, NULL, &map->RenderPass) != VK_SUCCESS) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	if (vkCreateFramebuffer(device, &(VkFramebufferCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+		.renderPass = map->RenderPass,
+		.attachmentCount = 1,
+		.pAttachments = &map->Atlas.View,
+		.width = map->Atlas.Width,
+		.height = map->Atlas.Height,
+		.layers = 1,
+	}, NULL, &map->Framebuffer) != VK_SUCCESS) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	if (vkCreatePipelineLayout(device, &(VkPipelineLayoutCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		.setLayoutCount = 1,
+		.pSetLayouts = &bindless->SetLayout,
+		.pushConstantRangeCount = 1,
+		.pPushConstantRanges = &(VkPushConstantRange){
+			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+			.offset = 0,
+			.size = sizeof(ShadowPushConstants),
+		},
+	}, NULL, &map->PipelineLayout) != VK_SUCCESS) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	// NOTE: Depth only, the vertex input only reads the positions out of the mesh's vertices. The slope scaled bias keeps surfaces
+	// at grazing angles to the light from shadowing themselves
+	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &(VkGraphicsPipelineCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+		.stageCount = 1,
+		.pStages = &(VkPipelineShaderStageCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage = VK_SHADER_STAGE_VERTEX_BIT,
+			.module = vertexShader,
+			.pName = "main",
+		},
+		.pVertexInputState = &(VkPipelineVertexInputStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.vertexBindingDescriptionCount = 1,
+			.pVertexBindingDescriptions = &(VkVertexInputBindingDescription){
+				.binding = 0,
+				.stride = sizeof(Vertex),
+				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+			},
+			.vertexAttributeDescriptionCount = 1,
+			.pVertexAttributeDescriptions = &(VkVertexInputAttributeDescription){
+				.location = 0,
+				.binding = 0,
+				.format = VK_FORMAT_R32G32B32_SFLOAT,
+				.offset = offsetof(Vertex, Position),
+			},
+		},
+		.pInputAssemblyState = &(VkPipelineInputAssemblyStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+			.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+		},
+		.pViewportState = &(VkPipelineViewportStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+			.viewportCount = 1,
+			.scissorCount = 1,
+		},
+		.pRasterizationState = &(VkPipelineRasterizationStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+			.polygonMode = VK_POLYGON_MODE_FILL,
+			.frontFace = VK_FRONT_FACE_CLOCKWISE,
+			.depthBiasEnable = VK_TRUE,
+			.depthBiasConstantFactor = 1.25f,
+			.depthBiasSlopeFactor = 1.75f,
+			.lineWidth = 1.0f,
+		},
+		.pMultisampleState = &(VkPipelineMultisampleStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+			.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+		},
+		.pDepthStencilState = &(VkPipelineDepthStencilStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+			.depthTestEnable = VK_TRUE,
+			.depthWriteEnable = VK_TRUE,
+			.depthCompareOp = VK_COMPARE_OP_LESS,
+		},
+		.pColorBlendState = &(VkPipelineColorBlendStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+		},
+		.pDynamicState = &(VkPipelineDynamicStateCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+			.dynamicStateCount = 2,
+			.pDynamicStates = (VkDynamicState[2]){
+				VK_DYNAMIC_STATE_VIEWPORT,
+				VK_DYNAMIC_STATE_SCISSOR,
+			},
+		},
+		.layout = map->PipelineLayout,
+		.renderPass = map->RenderPass,
+		.subpass = 0,
+	}, NULL, &map->Pipeline) != VK_SUCCESS) {
+		VulkanShadowMap_Destroy(map);
+		return false;
+	}
+
+	// NOTE: The cascades sit in the atlas two by two
+	for (u32 i = 0; i < VULKAN_SHADOW_MAP_CASCADE_COUNT; i++) {
+		map->Data.Cascades[i].AtlasRect = (Vector4){ cast(f32) (i % 2) * 0.5f, cast(f32) (i / 2) * 0.5f, 0.5f, 0.5f };
+	}
+	map->Data.AtlasHandle = map->AtlasHandle;
+	map->Data.SamplerHandle = map->SamplerHandle;
+
+	return true;
+}
+
+void VulkanShadowMap_Destroy(VulkanShadowMap* map) {
+	for (u32 i = 0; i < map->FrameCount; i++) {
+		ShadowMapFrame* frame = &map->Frames[i];
+		if (frame->DataHandle != BINDLESS_HANDLE_NONE) {
+			VulkanBindless_RemoveStorageBuffer(map->Bindless, frame->DataHandle);
+		}
+		if (frame->Data.Buffer != VK_NULL_HANDLE) {
+			VulkanBuffer_Destroy(&frame->Data);
+		}
+	}
+
+	if (map->Pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(map->Device, map->Pipeline, NULL);
+	}
+
+	if (map->PipelineLayout != VK_NULL_HANDLE) {
+		vkDestroyPipelineLayout(map->Device, map->PipelineLayout, NULL);
+	}
+
+	if (map->Framebuffer != VK_NULL_HANDLE) {
+		vkDestroyFramebuffer(map->Device, map->Framebuffer, NULL);
+	}
+
+	if (map->RenderPass != VK_NULL_HANDLE) {
+		vkDestroyRenderPass(map->Device, map->RenderPass, NULL);
+	}
+
+	if (map->SamplerHandle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveSampler(map->Bindless, map->SamplerHandle);
+	}
+
+	if (map->Sampler != VK_NULL_HANDLE) {
+		vkDestroySampler(map->Device, map->Sampler, NULL);
+	}
+
+	if (map->AtlasHandle != BINDLESS_HANDLE_NONE) {
+		VulkanBindless_RemoveSampledImage(map->Bindless, map->AtlasHandle);
+	}
+
+	if (map->ImagePool) {
+		VulkanImagePool_DestroyImage(map->ImagePool, &map->Atlas);
+	}
+
+	free(map->Draws);
+
+	*map = (VulkanShadowMap){};
+}
+
+static Vector3 VulkanShadowMap_Transform(const Matrix4* m, Vector3 v) {
+	Vector4 result = Matrix4_MultiplyVector(m, (Vector4){ v.x, v.y, v.z, 1.0f });
+	return (Vector3){ result.x / result.w, result.y / result.w, result.z / result.w };
+}
+
+static Vector3 VulkanShadowMap_Normalize(Vector3 v) {
+	f32 length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+	return (Vector3){ v.x / length, v.y / length, v.z / length };
+}
+
+static Vector3 VulkanShadowMap_Cross(Vector3 a, Vector3 b) {
+	return (Vector3){ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+// NOTE: Only rotates, the light looks down +z of its view space. The cascades are placed inside it by their projections
+static Matrix4 VulkanShadowMap_LightView(Vector3 lightDirection) {
+	Vector3 forward = (Vector3){ -lightDirection.x, -lightDirection.y, -lightDirection.z };
+	Vector3 worldUp = fabsf(forward.y) < 0.99f ? (Vector3){ 0.0f, 1.0f, 0.0f } : (Vector3){ 1.0f, 0.0f, 0.0f };
+	Vector3 right = VulkanShadowMap_Normalize(VulkanShadowMap_Cross(worldUp, forward));
+	Vector3 up = VulkanShadowMap_Cross(forward, right);
+
+	return (Matrix4){
+		.Data = {
+			{ right.x, up.x, forward.x, 0.0f },
+			{ right.y, up.y, forward.y, 0.0f },
+			{ right.z, up.z, forward.z, 0.0f },
+			{ 0.0f,    0.0f, 0.0f,      1.0f },
+		},
+	};
+}
+
+// NOTE: FNV-1a
+static u64 VulkanShadowMap_Hash(u64 hash, const void* data, u64 size) {
+	const u8* bytes = data;
+	for (u64 i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// NOTE: Where split i of the view ends, as a fraction of the way from the near to the far plane. Blends an even split with a
+// logarithmic one, projections without a near plane in front of the eye get a quadratic one in its place
+static f32 VulkanShadowMap_GetSplit(f32 depthNear, f32 depthFar, u32 i) {
+	f32 even = cast(f32) (i + 1) / VULKAN_SHADOW_MAP_CASCADE_COUNT;
+	f32 logarithmic = even * even;
+
+	f32 nearDistance = fabsf(depthNear);
+	f32 farDistance = fabsf(depthFar);
+	if (nearDistance > 0.0f && farDistance > nearDistance) {
+		logarithmic = (nearDistance * powf(farDistance / nearDistance, even) - nearDistance) / (farDistance - nearDistance);
+	}
+
+	return SHADOW_SPLIT_LAMBDA * logarithmic + (1.0f - SHADOW_SPLIT_LAMBDA) * even;
+}
+
+// NOTE: The bounding sphere of the part of the view between two splits, in the light's view space
+static void VulkanShadowMap_BoundSlice(
+	const Matrix4* lightView,
+	const Vector3 nearCorners[4],
+	const Vector3 farCorners[4],
+	f32 begin,
+	f32 end,
+	Vector3* center,
+	f32* radius
+) {
+	Vector3 corners[8];
+	Vector3 sum = {};
+	for (u32 i = 0; i < 8; i++) {
+		Vector3 a = nearCorners[i % 4];
+		Vector3 b = farCorners[i % 4];
+		f32 t = i < 4 ? begin : end;
+		corners[i] = (Vector3){ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+		sum = (Vector3){ sum.x + corners[i].x, sum.y + corners[i].y, sum.z + corners[i].z };
+	}
+
+	Vector3 worldCenter = (Vector3){ sum.x / 8.0f, sum.y / 8.0f, sum.z / 8.0f };
+	f32 radiusSquared = 0.0f;
+	for (u32 i = 0; i < 8; i++) {
+		Vector3 offset = (Vector3){ corners[i].x - worldCenter.x, corners[i].y - worldCenter.y, corners[i].z - worldCenter.z };
+		f32 distanceSquared = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+		radiusSquared = distanceSquared > radiusSquared ? distanceSquared : radiusSquared;
+	}
+
+	*center = VulkanShadowMap_Transform(lightView, worldCenter);
+	*radius = sqrtf(radiusSquared);
+}
+
+// NOTE: Grows the square by the texel the snapping can move it, then snaps its center to whole texels
+static void VulkanShadowMap_Fit(ShadowCascade* cascade, u32 resolution, Vector3 center, f32 radius) {
+	radius *= cast(f32) resolution / cast(f32) (resolution - 2);
+	f32 texelSize = 2.0f * radius / cast(f32) resolution;
+
+	cascade->Center = (Vector3){
+		floorf(center.x / texelSize) * texelSize,
+		floorf(center.y / texelSize) * texelSize,
+		center.z,
+	};
+	cascade->Radius = radius;
+}
+
+// NOTE: The sphere of the slice still fits inside the square and depth range the cascade was drawn with
+static b8 VulkanShadowMap_Contains(const ShadowCascade* cascade, Vector3 center, f32 radius) {
+	return
+		fabsf(center.x - cascade->Center.x) + radius <= cascade->Radius &&
+		fabsf(center.y - cascade->Center.y) + radius <= cascade->Radius &&
+		center.z - radius >= cascade->Center.z - cascade->Radius &&
+		center.z + radius <= cascade->DepthMax;
+}
+
+// NOTE: Every object whose bounding sphere overlaps the cascade's square and is not entirely behind it casts into it. The depth
+// range is pulled towards the light to cover every caster, so nothing in front of the view's slice is clipped away. Distant
+// cascades draw coarser lods, which is also what keeps the lod they draw from changing with the view
+static u64 VulkanShadowMap_CullCasters(
+	VulkanShadowMap* map,
+	ShadowCascade* cascade,
+	u32 cascadeIndex,
+	const Matrix4* lightView,
+	const Mesh* mesh,
+	const Matrix4* worldMatrices,
+	u64 objectCount
+) {
+	u64 hash = 0xcbf29ce484222325ull;
+	cascade->DepthMax = cascade->Center.z + cascade->Radius;
+	cascade->DepthMin = cascade->Center.z - cascade->Radius;
+	cascade->DrawCount = 0;
+
+	for (u64 i = 0; i < objectCount; i++) {
+		const MeshObject* object = &mesh->Objects[i];
+		const Matrix4* worldMatrix = &worldMatrices[i];
+
+		f32 scale = 0.0f;
+		for (u32 j = 0; j < 3; j++) {
+			f32 x = worldMatrix->Data[j][0];
+			f32 y = worldMatrix->Data[j][1];
+			f32 z = worldMatrix->Data[j][2];
+			f32 axisScale = sqrtf(x * x + y * y + z * z);
+			scale = axisScale > scale ? axisScale : scale;
+		}
+
+		Vector3 worldCenter = VulkanShadowMap_Transform(worldMatrix, object->Center);
+		Vector3 center = VulkanShadowMap_Transform(lightView, worldCenter);
+		f32 radius = object->Radius * scale;
+		if (fabsf(center.x - cascade->Center.x) > cascade->Radius + radius ||
+			fabsf(center.y - cascade->Center.y) > cascade->Radius + radius ||
+			center.z - radius > cascade->DepthMax
+		) {
+			continue;
+		}
+
+		cascade->DepthMin = center.z - radius < cascade->DepthMin ? center.z - radius : cascade->DepthMin;
+
+		u32 lod = cascadeIndex < object->LodCount ? cascadeIndex : object->LodCount - 1;
+		map->Draws[cascade->DrawOffset + cascade->DrawCount++] = (ShadowDraw){
+			.ModelMatrix = *worldMatrix,
+			.IndexCount = cast(u32) object->Lods[lod].IndexCount,
+			.FirstIndex = cast(u32) object->Lods[lod].IndexOffset,
+		};
+
+		u32 key[2] = { cast(u32) i, lod };
+		hash = VulkanShadowMap_Hash(hash, key, sizeof(key));
+		hash = VulkanShadowMap_Hash(hash, worldMatrix, sizeof(*worldMatrix));
+	}
+
+	return hash;
+}
+
+// NOTE: Orthographic over the cascade's square, light view z DepthMin to DepthMax becomes depth 0 to 1
+static void VulkanShadowMap_UpdateMatrix(ShadowCascade* cascade, const Matrix4* lightView) {
+	f32 depthRange = cascade->DepthMax - cascade->DepthMin;
+	Matrix4 projection = (Matrix4){
+		.Data = {
+			{ 1.0f / cascade->Radius, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f / cascade->Radius, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f / depthRange, 0.0f },
+			{ -cascade->Center.x / cascade->Radius, -cascade->Center.y / cascade->Radius, -cascade->DepthMin / depthRange, 1.0f },
+		},
+	};
+	cascade->ViewProjection = Matrix4_Multiply(&projection, lightView);
+}
+
+b8 VulkanShadowMap_BeginFrame(
+	VulkanShadowMap* map,
+	u32 frameIndex,
+	const Matrix4* viewMatrix,
+	const Matrix4* projectionMatrix,
+	Vector3 lightDirection,
+	const Mesh* mesh,
+	const Matrix4* worldMatrices,
+	u64 objectCount
+) {
+	ASSERT(frameIndex < map->FrameCount);
+	map->RedrawCount = 0;
+	map->RedrawDrawCount = 0;
+
+	// NOTE: Every cascade may hold every object
+	u64 drawCount = objectCount * VULKAN_SHADOW_MAP_CASCADE_COUNT;
+	if (drawCount > map->DrawCapacity) {
+		u64 capacity = map->DrawCapacity > SHADOW_MIN_DRAW_CAPACITY ? map->DrawCapacity : SHADOW_MIN_DRAW_CAPACITY;
+		while (capacity < drawCount) {
+			capacity *= 2;
+		}
+
+		ShadowDraw* draws = realloc(map->Draws, capacity * sizeof(draws[0]));
+		if (!draws) {
+			return false;
+		}
+		map->Draws = draws;
+		map->DrawCapacity = capacity;
+	}
+
+	// NOTE: A new light direction invalidates every cascade
+	b8 lightChanged = memcmp(&map->LightDirection, &lightDirection, sizeof(lightDirection)) != 0;
+	map->LightDirection = lightDirection;
+	Matrix4 lightView = VulkanShadowMap_LightView(lightDirection);
+
+	Matrix4 inverseProjection = Matrix4_Inverse(projectionMatrix);
+	map->Data.DepthNear = VulkanShadowMap_Transform(&inverseProjection, (Vector3){ 0.0f, 0.0f, 0.0f }).z;
+	map->Data.DepthFar = VulkanShadowMap_Transform(&inverseProjection, (Vector3){ 0.0f, 0.0f, 1.0f }).z;
+
+	Matrix4 viewProjection = Matrix4_Multiply(projectionMatrix, viewMatrix);
+	Matrix4 inverseViewProjection = Matrix4_Inverse(&viewProjection);
+	Vector3 nearCorners[4];
+	Vector3 farCorners[4];
+	for (u32 i = 0; i < 4; i++) {
+		f32 x = i % 2 == 0 ? -1.0f : 1.0f;
+		f32 y = i / 2 == 0 ? -1.0f : 1.0f;
+		nearCorners[i] = VulkanShadowMap_Transform(&inverseViewProjection, (Vector3){ x, y, 0.0f });
+		farCorners[i] = VulkanShadowMap_Transform(&inverseViewProjection, (Vector3){ x, y, 1.0f });
+	}
+
+	f32 splits[VULKAN_SHADOW_MAP_CASCADE_COUNT];
+	f32 splitBegin = 0.0f;
+	for (u32 i = 0; i < VULKAN_SHADOW_MAP_CASCADE_COUNT; i++) {
+		ShadowCascade* cascade = &map->Cascades[i];
+		cascade->DrawOffset = i * objectCount;
+
+		f32 splitEnd = VulkanShadowMap_GetSplit(map->Data.DepthNear, map->Data.DepthFar, i);
+		splits[i] = splitEnd;
+
+		Vector3 center;
+		f32 radius;
+		VulkanShadowMap_BoundSlice(&lightView, nearCorners, farCorners, splitBegin, splitEnd, &center, &radius);
+		splitBegin = splitEnd;
+
+		// NOTE: A cached cascade keeps its square while the view stays inside it, and is only drawn again when that or its casters change
+		b8 cached = i >= VULKAN_SHADOW_MAP_FIRST_CACHED_CASCADE;
+		b8 refit = !cached || !cascade->Valid || lightChanged || !VulkanShadowMap_Contains(cascade, center, radius);
+		if (refit) {
+			VulkanShadowMap_Fit(cascade, map->Resolution, center, cached ? radius * SHADOW_CACHED_CASCADE_MARGIN : radius);
+		}
+
+		u64 casterHash = VulkanShadowMap_CullCasters(map, cascade, i, &lightView, mesh, worldMatrices, objectCount);
+		cascade->Redraw = refit || casterHash != cascade->CasterHash;
+		cascade->CasterHash = casterHash;
+		cascade->Valid = true;
+
+		if (cascade->Redraw) {
+			VulkanShadowMap_UpdateMatrix(cascade, &lightView);
+			map->RedrawCount++;
+			map->RedrawDrawCount += cascade->DrawCount;
+		}
+
+		map->Data.Cascades[i].ViewProjection = cascade->ViewProjection;
+		map->Data.Cascades[i].TexelSize = 2.0f * cascade->Radius / cast(f32) map->Resolution;
+	}
+	map->Data.SplitDepths = (Vector4){ splits[0], splits[1], splits[2], splits[3] };
+
+	*cast(ShadowData*) map->Frames[frameIndex].Data.Data = map->Data;
+	return true;
+}
+
+void VulkanShadowMap_RecordDraws(VulkanShadowMap* map, VkCommandBuffer commandBuffer, u32 frameIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer) {
+	ASSERT(frameIndex < map->FrameCount);
+	if (map->RedrawCount == 0) {
+		return;
+	}
+
+	vkCmdBeginRenderPass(commandBuffer, &(VkRenderPassBeginInfo){
+		.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+		.renderPass = map->RenderPass,
+		.framebuffer = map->Framebuffer,
+		.renderArea = (VkRect2D){
+			.offset = (VkOffset2D){ .x = 0, .y = 0 },
+			.extent = (VkExtent2D){ .width = map->Atlas.Width, .height = map->Atlas.Height },
+		},
+	}, VK_SUBPASS_CONTENTS_INLINE);
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, map->Pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, map->PipelineLayout, 0, 1, &map->Bindless->Set, 0, NULL);
+	if (map->RedrawDrawCount > 0) {
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &(VkDeviceSize){ 0 });
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	for (u32 i = 0; i < VULKAN_SHADOW_MAP_CASCADE_COUNT; i++) {
+		const ShadowCascade* cascade = &map->Cascades[i];
+		if (!cascade->Redraw) {
+			continue;
+		}
+
+		// NOTE: The viewport is not flipped, so atlas v grows with light clip y like u does with x
+		VkRect2D tile = (VkRect2D){
+			.offset = (VkOffset2D){ .x = cast(s32) ((i % 2) * map->Resolution), .y = cast(s32) ((i / 2) * map->Resolution) },
+			.extent = (VkExtent2D){ .width = map->Resolution, .height = map->Resolution },
+		};
+		vkCmdSetViewport(commandBuffer, 0, 1, &(VkViewport){
+			.x = cast(f32) tile.offset.x,
+			.y = cast(f32) tile.offset.y,
+			.width = cast(f32) tile.extent.width,
+			.height = cast(f32) tile.extent.height,
+			.minDepth = 0.0f,
+			.maxDepth = 1.0f,
+		});
+		vkCmdSetScissor(commandBuffer, 0, 1, &tile);
+
+		vkCmdClearAttachments(commandBuffer, 1, &(VkClearAttachment){
+			.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+			.clearValue = (VkClearValue){
+				.depthStencil = (VkClearDepthStencilValue){ .depth = 1.0f, .stencil = 0 },
+			},
+		}, 1, &(VkClearRect){
+			.rect = tile,
+			.baseArrayLayer = 0,
+			.layerCount = 1,
+		});
+
+		const u64 CascadeOffset = offsetof(ShadowPushConstants, ShadowBufferHandle);
+		ShadowPushConstants pushConstants = {
+			.ShadowBufferHandle = map->Frames[frameIndex].DataHandle,
+			.CascadeIndex = i,
+		};
+		vkCmdPushConstants(
+			commandBuffer,
+			map->PipelineLayout,
+			VK_SHADER_STAGE_VERTEX_BIT,
+			CascadeOffset,
+			sizeof(pushConstants) - CascadeOffset,
+			&pushConstants.ShadowBufferHandle
+		);
+
+		for (u64 j = 0; j < cascade->DrawCount; j++) {
+			const ShadowDraw* draw = &map->Draws[cascade->DrawOffset + j];
+			vkCmdPushConstants(commandBuffer, map->PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(draw->ModelMatrix), &draw->ModelMatrix);
+			vkCmdDrawIndexed(commandBuffer, draw->IndexCount, 1, draw->FirstIndex, 0, 0);
+		}
+	}
+
+	vkCmdEndRenderPass(commandBuffer);
+}
+
+void VulkanShadowMap_SkipFrame(VulkanShadowMap* map) {
+	// NOTE: BeginFrame already moved their squares and caster hashes on, so the next one has to fit and draw them again
+	for (u32 i = 0; i < VULKAN_SHADOW_MAP_CASCADE_COUNT; i++) {
+		ShadowCascade* cascade = &map->Cascades[i];
+		if (cascade->Redraw) {
+			cascade->Valid = false;
+			cascade->Redraw = false;
+		}
+	}
+	map->RedrawCount = 0;
+	map->RedrawDrawCount = 0;
+}
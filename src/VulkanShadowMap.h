@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Vector.h"
+#include "Matrix.h"
+#include "Mesh.h"
+#include "VulkanBuffer.h"
+#include "VulkanBindless.h"
+#include "VulkanImagePool.h"
+
+#include <vulkan/vulkan.h>
+
+#define VULKAN_SHADOW_MAP_MAX_FRAMES 4
+
+// NOTE: Matches the constants in triangle.frag.glsl. The cascades are tiles of one atlas, two by two
+#define VULKAN_SHADOW_MAP_CASCADE_COUNT 4
+// NOTE: The cascades from this one on are cached, they are only drawn again when the light, the casters in them or a view that
+// leaves their margin changes them. The ones before it follow the view and are drawn every frame
+#define VULKAN_SHADOW_MAP_FIRST_CACHED_CASCADE 2
+
+// NOTE: Matches ShadowCascade in shadow.vert.glsl and triangle.frag.glsl
+typedef struct ShadowCascadeData_t {
+	Matrix4 ViewProjection; // World space to the cascade's light clip space
+	Vector4 AtlasRect;      // xy offset and zw size of the cascade's tile in atlas uv
+	f32 TexelSize;          // World space size of one texel
+	f32 Padding[3];
+} ShadowCascadeData;
+
+STATIC_ASSERT(sizeof(ShadowCascadeData) == 96, "ShadowCascadeData must match the std430 layout");
+
+// NOTE: Matches ShadowBuffer in shadow.vert.glsl and triangle.frag.glsl
+typedef struct ShadowData_t {
+	ShadowCascadeData Cascades[VULKAN_SHADOW_MAP_CASCADE_COUNT];
+	Vector4 SplitDepths; // Where each cascade ends, as a fraction of the way from the near to the far plane
+	f32 DepthNear;       // The view z of the near plane
+	f32 DepthFar;        // The view z of the far plane
+	BindlessHandle AtlasHandle;
+	BindlessHandle SamplerHandle;
+} ShadowData;
+
+STATIC_ASSERT(sizeof(ShadowData) == 416, "ShadowData must match the std430 layout");
+
+// NOTE: One object drawn into one cascade
+typedef struct ShadowDraw_t {
+	Matrix4 ModelMatrix;
+	u32 IndexCount;
+	u32 FirstIndex;
+} ShadowDraw;
+
+typedef struct ShadowCascade_t {
+	// NOTE: The square the cascade covers, in the light's view space. The light looks down +z
+	Vector3 Center;
+	f32 Radius;
+	f32 DepthMin;
+	f32 DepthMax;
+	Matrix4 ViewProjection;
+
+	u64 CasterHash; // Of the objects, lods and model matrices drawn into the cascade
+	u64 DrawOffset; // Into VulkanShadowMap::Draws
+	u64 DrawCount;
+	b8 Valid;       // The atlas tile holds this cascade for the current light
+	b8 Redraw;      // Drawn by this frame's RecordDraws
+} ShadowCascade;
+
+typedef struct ShadowMapFrame_t {
+	VulkanBuffer Data; // ShadowData, written by the CPU
+	BindlessHandle DataHandle;
+} ShadowMapFrame;
+
+// NOTE: Cascaded shadow maps for one directional light. The view frustum is split by depth and every split gets an orthographic
+// cascade fitted around its bounding sphere, so the cascade keeps its size while the view turns, and snapped to whole texels so it
+// does not shimmer while the view moves. The objects are culled per cascade on the CPU and drawn with a depth only pipeline that
+// reads the mesh's vertex and index buffers like the main pass. The atlas persists between frames, which is what lets the cached
+// cascades skip drawing
+typedef struct VulkanShadowMap_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VulkanBindless* Bindless;
+	VulkanImagePool* ImagePool;
+
+	VkRenderPass RenderPass;
+	VkPipelineLayout PipelineLayout;
+	VkPipeline Pipeline;
+	VkSampler Sampler; // Compares against the stored depth
+	BindlessHandle SamplerHandle;
+
+	u32 Resolution; // Of one cascade, the atlas is twice as large on both axes
+	VulkanImage Atlas;
+	VkFramebuffer Framebuffer;
+	BindlessHandle AtlasHandle;
+
+	ShadowMapFrame Frames[VULKAN_SHADOW_MAP_MAX_FRAMES];
+	u32 FrameCount;
+
+	Vector3 LightDirection; // The one the cascades were fitted for
+	ShadowCascade Cascades[VULKAN_SHADOW_MAP_CASCADE_COUNT];
+	ShadowData Data;
+
+	ShadowDraw* Draws;
+	u64 DrawCapacity;
+	u32 RedrawCount; // Cascades drawn by this frame's RecordDraws
+	u64 RedrawDrawCount;
+} VulkanShadowMap;
+
+// NOTE: depthFormat has to support being sampled with linear filtering
+b8 VulkanShadowMap_Create(
+	VulkanShadowMap* map,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VulkanBindless* bindless,
+	VulkanImagePool* imagePool,
+	u32 frameCount,
+	VkFormat depthFormat,
+	u32 resolution,
+	VkShaderModule vertexShader
+);
+// NOTE: Nothing recorded with the map may still be in flight
+void VulkanShadowMap_Destroy(VulkanShadowMap* map);
+
+// NOTE: Call once the frame's previous submission has finished. Fits the cascades to the view, culls the objects into them and decides
+// which cascades are drawn, then writes the frame's ShadowData. lightDirection points towards the light and is normalized.
+// worldMatrices has one model matrix per mesh object, objectCount is 0 while the mesh can not be drawn
+b8 VulkanShadowMap_BeginFrame(
+	VulkanShadowMap* map,
+	u32 frameIndex,
+	const Matrix4* viewMatrix,
+	const Matrix4* projectionMatrix,
+	Vector3 lightDirection,
+	const Mesh* mesh,
+	const Matrix4* worldMatrices,
+	u64 objectCount
+);
+
+// NOTE: Outside of a render pass, with the atlas in VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL. Only the tiles of the cascades
+// that are drawn again are cleared, the others keep what they had. The main pass samples the atlas in
+// VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, the render graph orders the two
+void VulkanShadowMap_RecordDraws(VulkanShadowMap* map, VkCommandBuffer commandBuffer, u32 frameIndex, VkBuffer vertexBuffer, VkBuffer indexBuffer);
+// NOTE: For a frame that called BeginFrame but is never recorded, the cascades it was going to redraw still hold their old tiles
+void VulkanShadowMap_SkipFrame(VulkanShadowMap* map);
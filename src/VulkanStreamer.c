@@ -0,0 +1,753 @@
+#include "VulkanStreamer.h"
+#include "VulkanUtil.h"
+#include "VulkanTexture.h"
+#include "TextureFile.h"
+#include "ImageLoader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct StreamLoadData_t {
+	VulkanStreamer* Streamer;
+	StreamRequest* Request;
+} StreamLoadData;
+
+static b8 StreamRequestList_Push(StreamRequestList* list, StreamRequest* request) {
+	if (list->Count == list->Capacity) {
+		u64 newCapacity = list->Capacity ? list->Capacity * 2 : 16;
+		StreamRequest** newRequests = realloc(list->Requests, newCapacity * sizeof(newRequests[0]));
+		if (!newRequests) {
+			return false;
+		}
+
+		list->Requests = newRequests;
+		list->Capacity = newCapacity;
+	}
+
+	list->Requests[list->Count++] = request;
+	return true;
+}
+
+static void StreamRequestList_Destroy(StreamRequestList* list) {
+	free(list->Requests);
+	*list = (StreamRequestList){};
+}
+
+static void VulkanStreamer_SetFailed(StreamRequest* request) {
+	atomic_store(&request->State, StreamState_Failed);
+}
+
+// NOTE: Hands a decoded request to the streaming thread
+static void VulkanStreamer_PushLoaded(VulkanStreamer* streamer, StreamRequest* request) {
+	AcquireSRWLockExclusive(&streamer->Lock);
+	b8 pushed = StreamRequestList_Push(&streamer->Loaded, request);
+	ReleaseSRWLockExclusive(&streamer->Lock);
+
+	if (!pushed) {
+		VulkanStreamer_SetFailed(request);
+		return;
+	}
+
+	ReleaseSemaphore(streamer->WakeSemaphore, 1, NULL);
+}
+
+static void VulkanStreamer_LoadTextureJob(void* data, u64 index) {
+	StreamLoadData* load = data;
+	VulkanStreamer* streamer = load->Streamer;
+	StreamRequest* request = load->Request;
+	free(load);
+
+	TextureFile* file = calloc(1, sizeof(TextureFile));
+	if (!file) {
+		VulkanStreamer_SetFailed(request);
+		return;
+	}
+
+	char cookedPath[VULKAN_STREAMER_MAX_PATH + 8];
+	snprintf(cookedPath, sizeof(cookedPath), "%s%s", request->Filepath, TEXTURE_FILE_EXTENSION);
+
+	b8 loaded = TextureFile_Load(file, cookedPath) &&
+		VulkanTexture_IsFormatSupported(streamer->PhysicalDevice, VulkanTexture_GetFileFormat(file->Format, file->Srgb));
+
+	// NOTE: Without a usable cooked file the source is decoded and turned into an uncompressed file with a CPU mip chain
+	if (!loaded) {
+		TextureFile_Destroy(file);
+
+		Image image = {};
+		if (Image_Load(&image, request->Filepath)) {
+			loaded = TextureFile_Cook(file, &image, TextureFormat_RGBA8, request->Srgb);
+			Image_Destroy(&image);
+		}
+	}
+
+	if (!loaded) {
+		printf("Unable to load texture %s\n", request->Filepath);
+		free(file);
+		VulkanStreamer_SetFailed(request);
+		return;
+	}
+
+	request->Source = file;
+	VulkanStreamer_PushLoaded(streamer, request);
+}
+
+static b8 VulkanStreamer_RecordMesh(VulkanStreamer* streamer, StreamRequest* request, VkCommandBuffer commandBuffer) {
+	const Mesh* mesh = request->Mesh;
+	u64 vertexSize = mesh->VertexCount * sizeof(mesh->Vertices[0]);
+	u64 indexSize = mesh->IndexCount * sizeof(mesh->Indices[0]);
+	u64 clusterSize = mesh->ClusterCount * sizeof(mesh->Clusters[0]);
+
+	if (!VulkanBuffer_CreateDeviceLocal(&request->VertexBuffer, streamer->Device, streamer->PhysicalDevice, vertexSize, request->VertexUsage | VK_BUFFER_USAGE_TRANSFER_DST_BIT) ||
+		!VulkanBuffer_CreateDeviceLocal(&request->IndexBuffer, streamer->Device, streamer->PhysicalDevice, indexSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT) ||
+		(clusterSize > 0 && !VulkanBuffer_CreateDeviceLocal(&request->ClusterBuffer, streamer->Device, streamer->PhysicalDevice, clusterSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) ||
+		!VulkanBuffer_Create(&request->Staging, streamer->Device, streamer->PhysicalDevice, vertexSize + indexSize + clusterSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+	) {
+		return false;
+	}
+
+	memcpy(request->Staging.Data, mesh->Vertices, vertexSize);
+	memcpy(cast(u8*) request->Staging.Data + vertexSize, mesh->Indices, indexSize);
+	memcpy(cast(u8*) request->Staging.Data + vertexSize + indexSize, mesh->Clusters, clusterSize);
+
+	vkCmdCopyBuffer(commandBuffer, request->Staging.Buffer, request->VertexBuffer.Buffer, 1, &(VkBufferCopy){ .srcOffset = 0, .size = vertexSize });
+	vkCmdCopyBuffer(commandBuffer, request->Staging.Buffer, request->IndexBuffer.Buffer, 1, &(VkBufferCopy){ .srcOffset = vertexSize, .size = indexSize });
+	if (clusterSize > 0) {
+		vkCmdCopyBuffer(commandBuffer, request->Staging.Buffer, request->ClusterBuffer.Buffer, 1, &(VkBufferCopy){ .srcOffset = vertexSize + indexSize, .size = clusterSize });
+	}
+
+	if (streamer->TransferQueueFamilyIndex != streamer->GraphicsQueueFamilyIndex) {
+		VkBufferMemoryBarrier releases[3];
+		VkBuffer buffers[3] = { request->VertexBuffer.Buffer, request->IndexBuffer.Buffer, request->ClusterBuffer.Buffer };
+		u32 bufferCount = clusterSize > 0 ? 3 : 2;
+		for (u32 i = 0; i < bufferCount; i++) {
+			releases[i] = (VkBufferMemoryBarrier){
+				.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.dstAccessMask = 0,
+				.srcQueueFamilyIndex = streamer->TransferQueueFamilyIndex,
+				.dstQueueFamilyIndex = streamer->GraphicsQueueFamilyIndex,
+				.buffer = buffers[i],
+				.offset = 0,
+				.size = VK_WHOLE_SIZE,
+			};
+		}
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, bufferCount, releases, 0, NULL);
+	}
+
+	return true;
+}
+
+static b8 VulkanStreamer_RecordTexture(VulkanStreamer* streamer, StreamRequest* request, VkCommandBuffer commandBuffer) {
+	const TextureFile* file = request->Source;
+	VkFormat format = VulkanTexture_GetFileFormat(file->Format, file->Srgb);
+
+	AcquireSRWLockExclusive(&streamer->PoolLock);
+	b8 created = VulkanImagePool_CreateImage(&streamer->ImagePool, &request->Texture, file->Width, file->Height, file->LevelCount, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+	ReleaseSRWLockExclusive(&streamer->PoolLock);
+
+	if (!created ||
+		!VulkanBuffer_Create(&request->Staging, streamer->Device, streamer->PhysicalDevice, file->DataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+	) {
+		return false;
+	}
+
+	memcpy(request->Staging.Data, file->Data, file->DataSize);
+
+	VkBufferImageCopy regions[TEXTURE_FILE_MAX_LEVELS] = {};
+	for (u32 i = 0; i < file->LevelCount; i++) {
+		regions[i] = (VkBufferImageCopy){
+			.bufferOffset = file->Levels[i].Offset,
+			.imageSubresource = (VkImageSubresourceLayers){
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.mipLevel = i,
+				.layerCount = 1,
+			},
+			.imageExtent = (VkExtent3D){ file->Levels[i].Width, file->Levels[i].Height, 1 },
+		};
+	}
+
+	const VkImageSubresourceRange AllLevels = {
+		.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+		.levelCount = VK_REMAINING_MIP_LEVELS,
+		.layerCount = 1,
+	};
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &(VkImageMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+		.srcAccessMask = 0,
+		.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+		.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+		.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.image = request->Texture.Image,
+		.subresourceRange = AllLevels,
+	});
+
+	vkCmdCopyBufferToImage(commandBuffer, request->Staging.Buffer, request->Texture.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, file->LevelCount, regions);
+
+	// NOTE: The layout transition is part of the release, the acquire on the graphics queue has to repeat it exactly
+	b8 transferOwnership = streamer->TransferQueueFamilyIndex != streamer->GraphicsQueueFamilyIndex;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &(VkImageMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+		.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+		.dstAccessMask = 0,
+		.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		.srcQueueFamilyIndex = transferOwnership ? streamer->TransferQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = transferOwnership ? streamer->GraphicsQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+		.image = request->Texture.Image,
+		.subresourceRange = AllLevels,
+	});
+
+	return true;
+}
+
+static void VulkanStreamer_FreeUpload(VulkanStreamer* streamer, StreamRequest* request) {
+	if (request->Staging.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&request->Staging);
+		request->Staging = (VulkanBuffer){};
+	}
+
+	if (request->CommandBuffer != VK_NULL_HANDLE) {
+		vkFreeCommandBuffers(streamer->Device, streamer->CommandPool, 1, &request->CommandBuffer);
+		request->CommandBuffer = VK_NULL_HANDLE;
+	}
+}
+
+static void VulkanStreamer_FreeSource(StreamRequest* request) {
+	if (request->Source) {
+		TextureFile_Destroy(request->Source);
+		free(request->Source);
+		request->Source = NULL;
+	}
+}
+
+static void VulkanStreamer_FreeResults(VulkanStreamer* streamer, StreamRequest* request) {
+	if (request->VertexBuffer.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&request->VertexBuffer);
+		request->VertexBuffer = (VulkanBuffer){};
+	}
+
+	if (request->IndexBuffer.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&request->IndexBuffer);
+		request->IndexBuffer = (VulkanBuffer){};
+	}
+
+	if (request->ClusterBuffer.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&request->ClusterBuffer);
+		request->ClusterBuffer = (VulkanBuffer){};
+	}
+
+	AcquireSRWLockExclusive(&streamer->PoolLock);
+	VulkanImagePool_DestroyImage(&streamer->ImagePool, &request->Texture);
+	ReleaseSRWLockExclusive(&streamer->PoolLock);
+
+	request->ResidentSize = 0;
+}
+
+static u64 VulkanStreamer_GetUploadSize(const StreamRequest* request) {
+	if (request->Type == StreamRequestType_Mesh) {
+		const Mesh* mesh = request->Mesh;
+		return mesh->VertexCount * sizeof(mesh->Vertices[0]) + mesh->IndexCount * sizeof(mesh->Indices[0]) + mesh->ClusterCount * sizeof(mesh->Clusters[0]);
+	}
+
+	const TextureFile* file = request->Source;
+	return file->DataSize;
+}
+
+static b8 VulkanStreamer_FitsBudget(VulkanStreamer* streamer, u64 size) {
+	u64 limit = atomic_load(&streamer->BudgetLimit);
+	return limit == 0 || atomic_load(&streamer->AllowOverBudget) || VulkanMemoryBudget_GetTrackedUsage(streamer->HeapIndex) + size <= limit;
+}
+
+// NOTE: Returns false without touching the request when it does not fit in the budget yet
+static b8 VulkanStreamer_Upload(VulkanStreamer* streamer, StreamRequest* request) {
+	if (!VulkanStreamer_FitsBudget(streamer, VulkanStreamer_GetUploadSize(request))) {
+		return false;
+	}
+
+	// NOTE: An evicted request can still have the staging memory of its last upload, that upload has finished by now
+	VulkanStreamer_FreeUpload(streamer, request);
+
+	b8 result = vkAllocateCommandBuffers(streamer->Device, &(VkCommandBufferAllocateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		.commandPool = streamer->CommandPool,
+		.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		.commandBufferCount = 1,
+	}, &request->CommandBuffer) == VK_SUCCESS &&
+		vkBeginCommandBuffer(request->CommandBuffer, &(VkCommandBufferBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		}) == VK_SUCCESS;
+
+	if (result) {
+		if (request->Type == StreamRequestType_Mesh) {
+			result = VulkanStreamer_RecordMesh(streamer, request, request->CommandBuffer);
+		} else {
+			result = VulkanStreamer_RecordTexture(streamer, request, request->CommandBuffer);
+		}
+
+		result = vkEndCommandBuffer(request->CommandBuffer) == VK_SUCCESS && result;
+	}
+
+	// NOTE: The texture data is in the staging buffer now
+	VulkanStreamer_FreeSource(request);
+
+	u64 timelineValue = streamer->LastSubmittedValue + 1;
+	if (result) {
+		VulkanStreamer_LockQueue(streamer);
+		result = vkQueueSubmit(streamer->TransferQueue, 1, &(VkSubmitInfo){
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.pNext = &(VkTimelineSemaphoreSubmitInfo){
+				.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+				.signalSemaphoreValueCount = 1,
+				.pSignalSemaphoreValues = &timelineValue,
+			},
+			.commandBufferCount = 1,
+			.pCommandBuffers = &request->CommandBuffer,
+			.signalSemaphoreCount = 1,
+			.pSignalSemaphores = &streamer->Timeline,
+		}, VK_NULL_HANDLE) == VK_SUCCESS;
+		VulkanStreamer_UnlockQueue(streamer);
+	}
+
+	if (!result) {
+		VulkanStreamer_FreeUpload(streamer, request);
+		VulkanStreamer_FreeResults(streamer, request);
+		VulkanStreamer_SetFailed(request);
+		return true;
+	}
+
+	streamer->LastSubmittedValue = timelineValue;
+	request->TimelineValue = timelineValue;
+	request->ResidentSize = request->Type == StreamRequestType_Mesh
+		? request->VertexBuffer.AllocationSize + request->IndexBuffer.AllocationSize + request->ClusterBuffer.AllocationSize
+		: request->Texture.Size;
+
+	// NOTE: If either push fails the request can never be acquired, so wait for it here instead
+	AcquireSRWLockExclusive(&streamer->Lock);
+	b8 pushed = StreamRequestList_Push(&streamer->Submitted, request);
+	ReleaseSRWLockExclusive(&streamer->Lock);
+
+	if (!pushed || !StreamRequestList_Push(&streamer->InFlight, request)) {
+		vkWaitSemaphores(streamer->Device, &(VkSemaphoreWaitInfo){
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.semaphoreCount = 1,
+			.pSemaphores = &streamer->Timeline,
+			.pValues = &timelineValue,
+		}, ~0ull);
+		VulkanStreamer_FreeUpload(streamer, request);
+
+		if (!pushed) {
+			VulkanStreamer_SetFailed(request);
+		}
+	}
+
+	return true;
+}
+
+// NOTE: Frees the staging memory of every upload the transfer queue has finished
+static void VulkanStreamer_Reclaim(VulkanStreamer* streamer) {
+	u64 completedValue = 0;
+	if (vkGetSemaphoreCounterValue(streamer->Device, streamer->Timeline, &completedValue) != VK_SUCCESS) {
+		return;
+	}
+
+	u64 keepCount = 0;
+	for (u64 i = 0; i < streamer->InFlight.Count; i++) {
+		StreamRequest* request = streamer->InFlight.Requests[i];
+		if (request->TimelineValue <= completedValue) {
+			VulkanStreamer_FreeUpload(streamer, request);
+		} else {
+			streamer->InFlight.Requests[keepCount++] = request;
+		}
+	}
+	streamer->InFlight.Count = keepCount;
+}
+
+static DWORD WINAPI VulkanStreamer_ThreadMain(LPVOID parameter) {
+	VulkanStreamer* streamer = parameter;
+
+	while (true) {
+		VulkanStreamer_Reclaim(streamer);
+
+		// NOTE: Deferred uploads are retried every time the thread wakes up, before anything new
+		u64 deferredCount = 0;
+		u64 deferredSize = 0;
+		for (u64 i = 0; i < streamer->Deferred.Count; i++) {
+			StreamRequest* request = streamer->Deferred.Requests[i];
+			if (!VulkanStreamer_Upload(streamer, request)) {
+				streamer->Deferred.Requests[deferredCount++] = request;
+				deferredSize += VulkanStreamer_GetUploadSize(request);
+			}
+		}
+		streamer->Deferred.Count = deferredCount;
+
+		StreamRequest* request = NULL;
+		AcquireSRWLockExclusive(&streamer->Lock);
+		if (streamer->Loaded.Count > 0) {
+			request = streamer->Loaded.Requests[0];
+			memmove(&streamer->Loaded.Requests[0], &streamer->Loaded.Requests[1], (streamer->Loaded.Count - 1) * sizeof(streamer->Loaded.Requests[0]));
+			streamer->Loaded.Count--;
+		}
+		ReleaseSRWLockExclusive(&streamer->Lock);
+
+		if (request && !VulkanStreamer_Upload(streamer, request)) {
+			if (StreamRequestList_Push(&streamer->Deferred, request)) {
+				deferredSize += VulkanStreamer_GetUploadSize(request);
+			} else {
+				VulkanStreamer_FreeSource(request);
+				VulkanStreamer_SetFailed(request);
+			}
+		}
+
+		atomic_store(&streamer->DeferredSize, deferredSize);
+
+		if (request) {
+			continue;
+		}
+
+		if (atomic_load(&streamer->ShuttingDown)) {
+			break;
+		}
+
+		// NOTE: Nothing left to submit, so the staging memory is released as soon as the last upload lands
+		if (streamer->InFlight.Count > 0) {
+			vkWaitSemaphores(streamer->Device, &(VkSemaphoreWaitInfo){
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+				.semaphoreCount = 1,
+				.pSemaphores = &streamer->Timeline,
+				.pValues = &streamer->LastSubmittedValue,
+			}, ~0ull);
+			continue;
+		}
+
+		WaitForSingleObject(streamer->WakeSemaphore, INFINITE);
+	}
+
+	return 0;
+}
+
+void VulkanStreamer_RequireFeatures(VkPhysicalDeviceVulkan12Features* features) {
+	features->timelineSemaphore = VK_TRUE;
+}
+
+b8 VulkanStreamer_Create(
+	VulkanStreamer* streamer,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VkQueue transferQueue,
+	u32 transferQueueFamilyIndex,
+	VkQueue graphicsQueue,
+	u32 graphicsQueueFamilyIndex
+) {
+	*streamer = (VulkanStreamer){
+		.Device = device,
+		.PhysicalDevice = physicalDevice,
+		.TransferQueue = transferQueue,
+		.TransferQueueFamilyIndex = transferQueueFamilyIndex,
+		.GraphicsQueueFamilyIndex = graphicsQueueFamilyIndex,
+		.SharesGraphicsQueue = transferQueue == graphicsQueue,
+	};
+
+	atomic_init(&streamer->ShuttingDown, false);
+	InitializeSRWLock(&streamer->Lock);
+	InitializeSRWLock(&streamer->QueueLock);
+	InitializeSRWLock(&streamer->PoolLock);
+
+	VkCheck(vkCreateSemaphore(device, &(VkSemaphoreCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+		.pNext = &(VkSemaphoreTypeCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+			.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+			.initialValue = 0,
+		},
+	}, NULL, &streamer->Timeline));
+
+	VkCheck(vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = transferQueueFamilyIndex,
+	}, NULL, &streamer->CommandPool));
+
+	if (!VulkanImagePool_Create(&streamer->ImagePool, device, physicalDevice, VULKAN_IMAGE_POOL_DEFAULT_BLOCK_SIZE)) {
+		return false;
+	}
+
+	streamer->HeapIndex = VulkanMemoryBudget_FindDeviceLocalHeap(&streamer->ImagePool.MemoryProperties);
+
+	streamer->WakeSemaphore = CreateSemaphoreA(NULL, 0, 0x7FFFFFFF, NULL);
+	if (!streamer->WakeSemaphore) {
+		return false;
+	}
+
+	streamer->Thread = CreateThread(NULL, 0, VulkanStreamer_ThreadMain, streamer, 0, NULL);
+	return streamer->Thread != NULL;
+}
+
+void VulkanStreamer_Destroy(VulkanStreamer* streamer) {
+	// NOTE: Loads can still push to Loaded, so they have to finish before the thread is told to stop
+	JobSystem_Wait(&streamer->LoadCounter);
+
+	if (streamer->Thread) {
+		atomic_store(&streamer->ShuttingDown, true);
+		ReleaseSemaphore(streamer->WakeSemaphore, 1, NULL);
+		WaitForSingleObject(streamer->Thread, INFINITE);
+		CloseHandle(streamer->Thread);
+	}
+
+	if (streamer->WakeSemaphore) {
+		CloseHandle(streamer->WakeSemaphore);
+	}
+
+	if (streamer->Timeline != VK_NULL_HANDLE) {
+		vkWaitSemaphores(streamer->Device, &(VkSemaphoreWaitInfo){
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.semaphoreCount = 1,
+			.pSemaphores = &streamer->Timeline,
+			.pValues = &streamer->LastSubmittedValue,
+		}, ~0ull);
+	}
+
+	for (u64 i = 0; i < streamer->All.Count; i++) {
+		StreamRequest* request = streamer->All.Requests[i];
+		VulkanStreamer_FreeUpload(streamer, request);
+		VulkanStreamer_FreeSource(request);
+		VulkanStreamer_FreeResults(streamer, request);
+		free(request);
+	}
+
+	StreamRequestList_Destroy(&streamer->All);
+	StreamRequestList_Destroy(&streamer->Loaded);
+	StreamRequestList_Destroy(&streamer->Submitted);
+	StreamRequestList_Destroy(&streamer->InFlight);
+	StreamRequestList_Destroy(&streamer->Deferred);
+
+	VulkanImagePool_Destroy(&streamer->ImagePool);
+
+	if (streamer->CommandPool != VK_NULL_HANDLE) {
+		vkDestroyCommandPool(streamer->Device, streamer->CommandPool, NULL);
+	}
+
+	if (streamer->Timeline != VK_NULL_HANDLE) {
+		vkDestroySemaphore(streamer->Device, streamer->Timeline, NULL);
+	}
+
+	*streamer = (VulkanStreamer){};
+}
+
+static void VulkanStreamer_StartTextureLoad(VulkanStreamer* streamer, StreamRequest* request) {
+	StreamLoadData* load = malloc(sizeof(StreamLoadData));
+	if (!load) {
+		VulkanStreamer_SetFailed(request);
+		return;
+	}
+
+	*load = (StreamLoadData){
+		.Streamer = streamer,
+		.Request = request,
+	};
+	JobSystem_Run(&(Job){ .Function = VulkanStreamer_LoadTextureJob, .Data = load }, 1, &streamer->LoadCounter);
+}
+
+static StreamRequest* VulkanStreamer_AddRequest(VulkanStreamer* streamer, StreamRequestType type) {
+	StreamRequest* request = calloc(1, sizeof(StreamRequest));
+	if (!request) {
+		return NULL;
+	}
+
+	request->Type = type;
+	atomic_init(&request->State, StreamState_Loading);
+	atomic_init(&request->LastUsedFrame, 0);
+
+	AcquireSRWLockExclusive(&streamer->Lock);
+	b8 pushed = StreamRequestList_Push(&streamer->All, request);
+	ReleaseSRWLockExclusive(&streamer->Lock);
+
+	if (!pushed) {
+		free(request);
+		return NULL;
+	}
+
+	return request;
+}
+
+StreamRequest* VulkanStreamer_RequestMesh(VulkanStreamer* streamer, const Mesh* mesh, VkBufferUsageFlags vertexUsage) {
+	StreamRequest* request = VulkanStreamer_AddRequest(streamer, StreamRequestType_Mesh);
+	if (!request) {
+		return NULL;
+	}
+
+	// NOTE: The mesh is already in memory, so it skips the job system and goes straight to the streaming thread
+	request->Mesh = mesh;
+	request->VertexUsage = vertexUsage;
+	atomic_store(&request->State, StreamState_Uploading);
+	VulkanStreamer_PushLoaded(streamer, request);
+	return request;
+}
+
+StreamRequest* VulkanStreamer_RequestTexture(VulkanStreamer* streamer, const char* filepath, b8 srgb) {
+	if (strlen(filepath) >= VULKAN_STREAMER_MAX_PATH) {
+		return NULL;
+	}
+
+	StreamRequest* request = VulkanStreamer_AddRequest(streamer, StreamRequestType_Texture);
+	if (!request) {
+		return NULL;
+	}
+
+	strcpy(request->Filepath, filepath);
+	request->Srgb = srgb;
+	VulkanStreamer_StartTextureLoad(streamer, request);
+	return request;
+}
+
+StreamState StreamRequest_GetState(const StreamRequest* request) {
+	return atomic_load(&(cast(StreamRequest*) request)->State);
+}
+
+u64 VulkanStreamer_RecordAcquires(VulkanStreamer* streamer, VkCommandBuffer commandBuffer, u64 frame) {
+	b8 transferOwnership = streamer->TransferQueueFamilyIndex != streamer->GraphicsQueueFamilyIndex;
+	u64 waitValue = 0;
+
+	AcquireSRWLockExclusive(&streamer->Lock);
+	for (u64 i = 0; i < streamer->Submitted.Count; i++) {
+		StreamRequest* request = streamer->Submitted.Requests[i];
+		waitValue = request->TimelineValue > waitValue ? request->TimelineValue : waitValue;
+
+		if (transferOwnership && request->Type == StreamRequestType_Mesh) {
+			VkBufferMemoryBarrier acquires[3];
+			VkBuffer buffers[3] = { request->VertexBuffer.Buffer, request->IndexBuffer.Buffer, request->ClusterBuffer.Buffer };
+			u32 bufferCount = request->ClusterBuffer.Buffer != VK_NULL_HANDLE ? 3 : 2;
+			for (u32 j = 0; j < bufferCount; j++) {
+				acquires[j] = (VkBufferMemoryBarrier){
+					.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+					.srcAccessMask = 0,
+					.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+					.srcQueueFamilyIndex = streamer->TransferQueueFamilyIndex,
+					.dstQueueFamilyIndex = streamer->GraphicsQueueFamilyIndex,
+					.buffer = buffers[j],
+					.offset = 0,
+					.size = VK_WHOLE_SIZE,
+				};
+			}
+
+			vkCmdPipelineBarrier(commandBuffer, VULKAN_STREAMER_CONSUMER_STAGES, VULKAN_STREAMER_CONSUMER_STAGES, 0, 0, NULL, bufferCount, acquires, 0, NULL);
+		} else if (transferOwnership) {
+			vkCmdPipelineBarrier(commandBuffer, VULKAN_STREAMER_CONSUMER_STAGES, VULKAN_STREAMER_CONSUMER_STAGES, 0, 0, NULL, 0, NULL, 1, &(VkImageMemoryBarrier){
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.srcAccessMask = 0,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+				.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				.srcQueueFamilyIndex = streamer->TransferQueueFamilyIndex,
+				.dstQueueFamilyIndex = streamer->GraphicsQueueFamilyIndex,
+				.image = request->Texture.Image,
+				.subresourceRange = (VkImageSubresourceRange){
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.levelCount = VK_REMAINING_MIP_LEVELS,
+					.layerCount = 1,
+				},
+			});
+		}
+
+		// NOTE: The acquiring frame counts as a use, so nothing is evicted before its upload has been waited for
+		if (atomic_load(&request->LastUsedFrame) < frame) {
+			atomic_store(&request->LastUsedFrame, frame);
+		}
+		atomic_store(&request->State, StreamState_Ready);
+	}
+	streamer->Submitted.Count = 0;
+	ReleaseSRWLockExclusive(&streamer->Lock);
+
+	return waitValue;
+}
+
+void VulkanStreamer_Touch(VulkanStreamer* streamer, StreamRequest* request, u64 frame) {
+	atomic_store(&request->LastUsedFrame, frame);
+	if (StreamRequest_GetState(request) != StreamState_Evicted) {
+		return;
+	}
+
+	if (request->Type == StreamRequestType_Mesh) {
+		atomic_store(&request->State, StreamState_Uploading);
+		VulkanStreamer_PushLoaded(streamer, request);
+	} else {
+		atomic_store(&request->State, StreamState_Loading);
+		VulkanStreamer_StartTextureLoad(streamer, request);
+	}
+}
+
+static int StreamRequest_CompareLastUsedFrame(const void* a, const void* b) {
+	u64 frameA = atomic_load(&(*cast(StreamRequest**) a)->LastUsedFrame);
+	u64 frameB = atomic_load(&(*cast(StreamRequest**) b)->LastUsedFrame);
+	return frameA < frameB ? -1 : frameA > frameB ? 1 : 0;
+}
+
+// NOTE: Frees least recently used requests until at least size bytes are gone, returns how many were freed
+static u64 VulkanStreamer_Evict(VulkanStreamer* streamer, u64 size, u64 safeFrame) {
+	AcquireSRWLockExclusive(&streamer->Lock);
+
+	u64 candidateCount = 0;
+	StreamRequest** candidates = malloc(streamer->All.Count * sizeof(candidates[0]));
+	for (u64 i = 0; candidates && i < streamer->All.Count; i++) {
+		StreamRequest* request = streamer->All.Requests[i];
+		if (StreamRequest_GetState(request) == StreamState_Ready && atomic_load(&request->LastUsedFrame) < safeFrame) {
+			candidates[candidateCount++] = request;
+		}
+	}
+
+	ReleaseSRWLockExclusive(&streamer->Lock);
+
+	if (!candidates) {
+		return 0;
+	}
+
+	qsort(candidates, candidateCount, sizeof(candidates[0]), StreamRequest_CompareLastUsedFrame);
+
+	u64 evictedSize = 0;
+	for (u64 i = 0; i < candidateCount && evictedSize < size; i++) {
+		StreamRequest* request = candidates[i];
+		evictedSize += request->ResidentSize;
+		VulkanStreamer_FreeResults(streamer, request);
+		atomic_store(&request->State, StreamState_Evicted);
+	}
+
+	free(candidates);
+	return evictedSize;
+}
+
+void VulkanStreamer_UpdateResidency(VulkanStreamer* streamer, const VulkanMemoryBudget* budget, u64 safeFrame) {
+	u64 limit = budget->HeapBudgets[streamer->HeapIndex];
+	atomic_store(&streamer->BudgetLimit, limit);
+
+	u64 deferredSize = atomic_load(&streamer->DeferredSize);
+	u64 requiredSize = VulkanMemoryBudget_GetTrackedUsage(streamer->HeapIndex) + deferredSize;
+	if (requiredSize > limit) {
+		u64 evictedSize = VulkanStreamer_Evict(streamer, requiredSize - limit, safeFrame);
+		requiredSize -= evictedSize < requiredSize ? evictedSize : requiredSize;
+	}
+
+	// NOTE: When everything resident is still in use, going over the budget lets the driver page memory out
+	// instead of the uploads waiting forever
+	atomic_store(&streamer->AllowOverBudget, requiredSize > limit);
+
+	if (deferredSize > 0) {
+		ReleaseSemaphore(streamer->WakeSemaphore, 1, NULL);
+	}
+}
+
+void VulkanStreamer_LockQueue(VulkanStreamer* streamer) {
+	if (streamer->SharesGraphicsQueue) {
+		AcquireSRWLockExclusive(&streamer->QueueLock);
+	}
+}
+
+void VulkanStreamer_UnlockQueue(VulkanStreamer* streamer) {
+	if (streamer->SharesGraphicsQueue) {
+		ReleaseSRWLockExclusive(&streamer->QueueLock);
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "Mesh.h"
+#include "JobSystem.h"
+#include "VulkanBuffer.h"
+#include "VulkanImagePool.h"
+#include "VulkanMemoryBudget.h"
+
+#include <Windows.h>
+#include <vulkan/vulkan.h>
+#include <stdatomic.h>
+
+#define VULKAN_STREAMER_MAX_PATH 260
+
+// NOTE: The stages that read streamed resources, the graphics queue waits for the uploads at these stages
+#define VULKAN_STREAMER_CONSUMER_STAGES (VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)
+
+typedef enum StreamRequestType_t {
+	StreamRequestType_Mesh,
+	StreamRequestType_Texture,
+} StreamRequestType;
+
+typedef enum StreamState_t {
+	StreamState_Loading,   // Reading and decoding on the job system
+	StreamState_Uploading, // Waiting for or submitted to the transfer queue
+	StreamState_Ready,     // Acquired by the graphics queue, safe to use from the next recorded frame
+	StreamState_Failed,
+	StreamState_Evicted,   // Freed to stay within the memory budget, VulkanStreamer_Touch streams it back in
+} StreamState;
+
+typedef struct StreamRequest_t {
+	StreamRequestType Type;
+	_Atomic u32 State;
+
+	// NOTE: Mesh requests read the caller's mesh whenever they are uploaded, so it has to outlive the streamer
+	const Mesh* Mesh;
+	VkBufferUsageFlags VertexUsage;
+	char Filepath[VULKAN_STREAMER_MAX_PATH];
+	b8 Srgb;
+
+	// NOTE: Results, only valid once Ready. They are owned by the streamer and live until it is destroyed
+	VulkanBuffer VertexBuffer;
+	VulkanBuffer IndexBuffer;
+	VulkanBuffer ClusterBuffer; // Storage buffer of Mesh::Clusters, not created for meshes without clusters
+	VulkanImage Texture;
+
+	// NOTE: Residency, LastUsedFrame is written by VulkanStreamer_Touch and VulkanStreamer_RecordAcquires
+	_Atomic u64 LastUsedFrame;
+	u64 ResidentSize; // Bytes in the device local heap while Ready
+
+	// NOTE: Internal
+	void* Source; // Decoded TextureFile between loading and uploading
+	u64 TimelineValue;
+	VulkanBuffer Staging;
+	VkCommandBuffer CommandBuffer;
+} StreamRequest;
+
+typedef struct StreamRequestList_t {
+	StreamRequest** Requests;
+	u64 Count;
+	u64 Capacity;
+} StreamRequestList;
+
+// NOTE: Loads on the job system and uploads from a background thread on a dedicated transfer queue. The uploads signal
+// a timeline semaphore and, when the transfer family is not the graphics family, release the resources to the graphics family.
+// The render loop calls VulkanStreamer_RecordAcquires each frame and waits on Timeline for the returned value
+typedef struct VulkanStreamer_t {
+	VkDevice Device;
+	VkPhysicalDevice PhysicalDevice;
+	VkQueue TransferQueue;
+	u32 HeapIndex; // The device local heap everything is streamed into
+	u32 TransferQueueFamilyIndex;
+	u32 GraphicsQueueFamilyIndex;
+	b8 SharesGraphicsQueue; // NOTE: Only on devices with a single queue, submits to it are serialized by QueueLock
+
+	VkSemaphore Timeline;
+	u64 LastSubmittedValue; // Only written by the streaming thread
+	VkCommandPool CommandPool; // Only used by the streaming thread
+	VulkanImagePool ImagePool; // Guarded by PoolLock, evictions free images from the render thread
+	SRWLOCK PoolLock;
+
+	HANDLE Thread;
+	HANDLE WakeSemaphore;
+	_Atomic b8 ShuttingDown;
+	JobCounter LoadCounter;
+
+	// NOTE: Uploads that would go over BudgetLimit wait in Deferred until VulkanStreamer_UpdateResidency makes room,
+	// or allows going over the budget because everything resident is still in use
+	_Atomic u64 BudgetLimit; // 0 until the first VulkanStreamer_UpdateResidency
+	_Atomic u64 DeferredSize;
+	_Atomic b8 AllowOverBudget;
+
+	SRWLOCK Lock; // Guards every list below
+	SRWLOCK QueueLock;
+	StreamRequestList All;
+	StreamRequestList Loaded;    // Decoded, waiting for the streaming thread
+	StreamRequestList Submitted; // On the transfer queue, waiting for VulkanStreamer_RecordAcquires
+	StreamRequestList InFlight;  // Staging memory the streaming thread frees once the timeline passes it, only used by the thread
+	StreamRequestList Deferred;  // Only used by the thread
+} VulkanStreamer;
+
+// NOTE: Fills in the VkPhysicalDeviceVulkan12Features members the streamer needs
+void VulkanStreamer_RequireFeatures(VkPhysicalDeviceVulkan12Features* features);
+
+b8 VulkanStreamer_Create(
+	VulkanStreamer* streamer,
+	VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VkQueue transferQueue,
+	u32 transferQueueFamilyIndex,
+	VkQueue graphicsQueue,
+	u32 graphicsQueueFamilyIndex
+);
+// NOTE: Waits for every outstanding load and upload, then frees all streamed resources
+void VulkanStreamer_Destroy(VulkanStreamer* streamer);
+
+// NOTE: The vertex buffer also gets TRANSFER_DST, everything lands in device local memory
+StreamRequest* VulkanStreamer_RequestMesh(VulkanStreamer* streamer, const Mesh* mesh, VkBufferUsageFlags vertexUsage);
+// NOTE: Uses filepath + TEXTURE_FILE_EXTENSION when it exists and the device supports its format, otherwise decodes filepath.
+// The transfer queue cannot blit, so uncooked textures get their mips on the CPU
+StreamRequest* VulkanStreamer_RequestTexture(VulkanStreamer* streamer, const char* filepath, b8 srgb);
+
+StreamState StreamRequest_GetState(const StreamRequest* request);
+
+// NOTE: Marks the request as used by frame, which has to be called for everything a frame draws.
+// Evicted requests are loaded and uploaded again
+void VulkanStreamer_Touch(VulkanStreamer* streamer, StreamRequest* request, u64 frame);
+// NOTE: Call once per frame from the render thread. Evicts the least recently used Ready requests while the device local heap
+// is over its budget, only requests last used before safeFrame (the oldest frame that may still be on the GPU) are considered.
+// Evicted textures have to be unbound before the next frame is recorded
+void VulkanStreamer_UpdateResidency(VulkanStreamer* streamer, const VulkanMemoryBudget* budget, u64 safeFrame);
+
+// NOTE: Records the queue family acquire barriers for every upload that was submitted since the last call and marks them Ready,
+// frame counts as a use of each of them
+// Returns the timeline value the graphics submit has to wait for at VULKAN_STREAMER_CONSUMER_STAGES, 0 when there is nothing to wait for
+u64 VulkanStreamer_RecordAcquires(VulkanStreamer* streamer, VkCommandBuffer commandBuffer, u64 frame);
+
+// NOTE: Wrap graphics queue submits and presents, these do nothing unless the streamer shares the graphics queue
+void VulkanStreamer_LockQueue(VulkanStreamer* streamer);
+void VulkanStreamer_UnlockQueue(VulkanStreamer* streamer);
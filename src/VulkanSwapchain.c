@@ -2,8 +2,9 @@
 #include "VulkanUtil.h"
 
 #include <stdlib.h>
+#include <string.h>
 
-static b8 ChoosePresentMode(VkPresentModeKHR* presentMode, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface) {
+static b8 ChoosePresentMode(VkPresentModeKHR* presentMode, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkPresentModeKHR requestedPresentMode) {
 	u32 presentModeCount = 0;
 	VkCheck(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, NULL));
 	if (presentModeCount == 0) {
@@ -13,8 +14,9 @@ static b8 ChoosePresentMode(VkPresentModeKHR* presentMode, VkPhysicalDevice phys
 	VkPresentModeKHR presentModes[presentModeCount];
 	VkCheck(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes));
 
+	VkPresentModeKHR preferredPresentMode = requestedPresentMode == VULKAN_SWAPCHAIN_PRESENT_MODE_DEFAULT ? VK_PRESENT_MODE_MAILBOX_KHR : requestedPresentMode;
 	for (u64 i = 0; i < presentModeCount; i++) {
-		if (presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
+		if (presentModes[i] == preferredPresentMode) {
 			*presentMode = presentModes[i];
 			return true;
 		}
@@ -31,6 +33,10 @@ b8 VulkanSwapchain_Create(
 	VkSurfaceKHR surface,
 	VkRenderPass renderPass,
 	VkSurfaceFormatKHR format,
+	VulkanImagePool* imagePool,
+	VkFormat depthFormat,
+	VkPresentModeKHR requestedPresentMode,
+	u32 requestedImageCount,
 	Window window,
 	u32 graphicsQueueFamilyIndex,
 	u32 presentQueueFamilyIndex,
@@ -45,11 +51,16 @@ b8 VulkanSwapchain_Create(
 	swapchain->Surface = surface;
 	swapchain->RenderPass = renderPass;
 	swapchain->Format = format;
+	swapchain->ImagePool = imagePool;
+	swapchain->DepthFormat = depthFormat;
+	swapchain->DepthImage = (VulkanImage){};
+	swapchain->RequestedPresentMode = requestedPresentMode;
+	swapchain->RequestedImageCount = requestedImageCount;
 	swapchain->Window = window;
 	swapchain->GraphicsQueueFamilyIndex = graphicsQueueFamilyIndex;
 	swapchain->PresentQueueFamilyIndex = presentQueueFamilyIndex;
 
-	if (!ChoosePresentMode(&swapchain->PresentMode, swapchain->PhysicalDevice, swapchain->Surface)) {
+	if (!ChoosePresentMode(&swapchain->PresentMode, swapchain->PhysicalDevice, swapchain->Surface, swapchain->RequestedPresentMode)) {
 		return false;
 	}
 
@@ -65,8 +76,13 @@ b8 VulkanSwapchain_Create(
 		? VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR
 		: VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
 
-	swapchain->ImageCount = surfaceCapabilities.minImageCount + 1;
-	if (swapchain->ImageCount > surfaceCapabilities.maxImageCount) {
+	// NOTE: More images let the CPU and GPU run further ahead of the display, fewer cut latency but may stall on acquire.
+	// A maxImageCount of 0 means there is no limit
+	swapchain->ImageCount = requestedImageCount > 0 ? requestedImageCount : surfaceCapabilities.minImageCount + 1;
+	if (swapchain->ImageCount < surfaceCapabilities.minImageCount) {
+		swapchain->ImageCount = surfaceCapabilities.minImageCount;
+	}
+	if (surfaceCapabilities.maxImageCount > 0 && swapchain->ImageCount > surfaceCapabilities.maxImageCount) {
 		swapchain->ImageCount = surfaceCapabilities.maxImageCount;
 	}
 
@@ -96,6 +112,10 @@ b8 VulkanSwapchain_Create(
 
 	swapchain->Transform = surfaceCapabilities.currentTransform;
 
+	// NOTE: Transfer destination lets an offscreen image be blitted in instead of rendering to the swapchain directly,
+	// transfer source lets the presented image be copied out for captures
+	swapchain->ImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (surfaceCapabilities.supportedUsageFlags & (VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+
 	VkResult result = vkCreateSwapchainKHR(device, &(VkSwapchainCreateInfoKHR){
 		.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
 		.surface = surface,
@@ -104,7 +124,7 @@ b8 VulkanSwapchain_Create(
 		.imageColorSpace = swapchain->Format.colorSpace,
 		.imageExtent = swapchain->Extent,
 		.imageArrayLayers = 1,
-		.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+		.imageUsage = swapchain->ImageUsage,
 		.imageSharingMode = swapchain->GraphicsQueueFamilyIndex != swapchain->PresentQueueFamilyIndex ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
 		.queueFamilyIndexCount = swapchain->GraphicsQueueFamilyIndex != swapchain->PresentQueueFamilyIndex ? 2 : 1,
 		.pQueueFamilyIndices = (u32[2]){ swapchain->GraphicsQueueFamilyIndex, swapchain->PresentQueueFamilyIndex },
@@ -157,6 +177,24 @@ b8 VulkanSwapchain_Create(
 		}
 	}
 
+	if (!VulkanImagePool_CreateImage(
+		swapchain->ImagePool,
+		&swapchain->DepthImage,
+		swapchain->Extent.width,
+		swapchain->Extent.height,
+		1,
+		swapchain->DepthFormat,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+	) {
+		return false;
+	}
+
+	// NOTE: Without a render pass the image views are rendered to directly with dynamic rendering
+	swapchain->Framebuffers = NULL;
+	if (swapchain->RenderPass == VK_NULL_HANDLE) {
+		return true;
+	}
+
 	swapchain->Framebuffers = malloc(swapchain->ImageCount * sizeof(swapchain->Framebuffers[0]));
 	for (u32 i = 0; i < swapchain->ImageCount; i++) {
 		swapchain->Framebuffers[i] = VK_NULL_HANDLE;
@@ -164,8 +202,8 @@ b8 VulkanSwapchain_Create(
 		VkResult result = (vkCreateFramebuffer(device, &(VkFramebufferCreateInfo){
 			.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
 			.renderPass = swapchain->RenderPass,
-			.attachmentCount = 1,
-			.pAttachments = &swapchain->ImageViews[i],
+			.attachmentCount = 2,
+			.pAttachments = (VkImageView[2]){ swapchain->ImageViews[i], swapchain->DepthImage.View },
 			.width = swapchain->Extent.width,
 			.height = swapchain->Extent.height,
 			.layers = 1,
@@ -180,7 +218,7 @@ b8 VulkanSwapchain_Create(
 }
 
 void VulkanSwapchain_Destroy(VulkanSwapchain* swapchain) {
-	for (u32 i = 0; i < swapchain->ImageCount; i++) {
+	for (u32 i = 0; swapchain->Framebuffers && i < swapchain->ImageCount; i++) {
 		vkDestroyFramebuffer(swapchain->Device, swapchain->Framebuffers[i], NULL);
 	}
 	free(swapchain->Framebuffers);
@@ -189,39 +227,100 @@ void VulkanSwapchain_Destroy(VulkanSwapchain* swapchain) {
 		vkDestroyImageView(swapchain->Device, swapchain->ImageViews[i], NULL);
 	}
 	free(swapchain->ImageViews);
+	free(swapchain->Images);
+
+	VulkanImagePool_DestroyImage(swapchain->ImagePool, &swapchain->DepthImage);
 
 	vkDestroySwapchainKHR(swapchain->Device, swapchain->Swapchain, NULL);
 }
 
-b8 VulkanSwapchain_TryResize(VulkanSwapchain* swapchain) {
+// NOTE: The old images are no longer acquired once the new swapchain exists, but frames up to frame may still render
+// to or present them. Presentation is not covered by the frame fences, the frames in flight after frame usually give
+// the presentation engine enough time to let go of the old swapchain
+static void VulkanSwapchain_Retire(VulkanSwapchain* swapchain, VulkanDeletionQueue* deletionQueue, u64 frame) {
+	for (u32 i = 0; i < swapchain->ImageCount; i++) {
+		if (swapchain->Framebuffers) {
+			VulkanDeletionQueue_PushFramebuffer(deletionQueue, frame, swapchain->Framebuffers[i]);
+		}
+		VulkanDeletionQueue_PushImageView(deletionQueue, frame, swapchain->ImageViews[i]);
+	}
+	free(swapchain->Framebuffers);
+	free(swapchain->ImageViews);
+	free(swapchain->Images);
+
+	VulkanDeletionQueue_PushPoolImage(deletionQueue, frame, swapchain->ImagePool, &swapchain->DepthImage);
+	VulkanDeletionQueue_PushSwapchain(deletionQueue, frame, swapchain->Swapchain);
+}
+
+VulkanSwapchainResize VulkanSwapchain_TryResize(VulkanSwapchain* swapchain, VulkanDeletionQueue* deletionQueue, u64 frame, b8 outOfDate) {
 	VkSurfaceCapabilitiesKHR surfaceCapabilities = {};
-	VkCheck(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(swapchain->PhysicalDevice, swapchain->Surface, &surfaceCapabilities));
+	if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(swapchain->PhysicalDevice, swapchain->Surface, &surfaceCapabilities) != VK_SUCCESS) {
+		return VulkanSwapchainResize_Failed;
+	}
 
-	if (swapchain->Extent.width == surfaceCapabilities.currentExtent.width && swapchain->Extent.height == surfaceCapabilities.currentExtent.height) {
-		return false;
+	VkExtent2D extent = surfaceCapabilities.currentExtent;
+	if (extent.width == ~0u || extent.height == ~0u) {
+		Window_GetSize(swapchain->Window, &extent.width, &extent.height);
 	}
 
-	VulkanSwapchain oldSwapchain = *swapchain;
+	// NOTE: A minimized window has no area, a swapchain can not be created until it is restored
+	if (extent.width == 0 || extent.height == 0) {
+		return VulkanSwapchainResize_None;
+	}
 
-	if (!VulkanSwapchain_Create(
+	if (!outOfDate && swapchain->Extent.width == extent.width && swapchain->Extent.height == extent.height) {
+		return VulkanSwapchainResize_None;
+	}
+
+	// NOTE: The old swapchain is handed to the driver as oldSwapchain, which retires it even if creating the new one fails
+	VulkanSwapchain oldSwapchain = *swapchain;
+	b8 created = VulkanSwapchain_Create(
 		swapchain,
 		swapchain->PhysicalDevice,
 		swapchain->Device,
 		swapchain->Surface,
 		swapchain->RenderPass,
 		swapchain->Format,
+		swapchain->ImagePool,
+		swapchain->DepthFormat,
+		swapchain->RequestedPresentMode,
+		swapchain->RequestedImageCount,
 		swapchain->Window,
 		swapchain->GraphicsQueueFamilyIndex,
 		swapchain->PresentQueueFamilyIndex,
-		surfaceCapabilities.currentExtent.width,
-		surfaceCapabilities.currentExtent.height)
-	) {
-		return false;
-	}
+		extent.width,
+		extent.height
+	);
 
-	VkCheck(vkDeviceWaitIdle(swapchain->Device));
+	VulkanSwapchain_Retire(&oldSwapchain, deletionQueue, frame);
+	return created ? VulkanSwapchainResize_Resized : VulkanSwapchainResize_Failed;
+}
 
-	VulkanSwapchain_Destroy(&oldSwapchain);
+static const struct {
+	const char* Name;
+	VkPresentModeKHR PresentMode;
+} PresentModeNames[] = {
+	{ "fifo", VK_PRESENT_MODE_FIFO_KHR },
+	{ "fifo-relaxed", VK_PRESENT_MODE_FIFO_RELAXED_KHR },
+	{ "mailbox", VK_PRESENT_MODE_MAILBOX_KHR },
+	{ "immediate", VK_PRESENT_MODE_IMMEDIATE_KHR },
+};
+
+b8 VulkanSwapchain_ParsePresentMode(const char* name, VkPresentModeKHR* presentMode) {
+	for (u32 i = 0; i < sizeof(PresentModeNames) / sizeof(PresentModeNames[0]); i++) {
+		if (strcmp(name, PresentModeNames[i].Name) == 0) {
+			*presentMode = PresentModeNames[i].PresentMode;
+			return true;
+		}
+	}
+	return false;
+}
 
-	return true;
+const char* VulkanSwapchain_GetPresentModeName(VkPresentModeKHR presentMode) {
+	for (u32 i = 0; i < sizeof(PresentModeNames) / sizeof(PresentModeNames[0]); i++) {
+		if (PresentModeNames[i].PresentMode == presentMode) {
+			return PresentModeNames[i].Name;
+		}
+	}
+	return "unknown";
 }
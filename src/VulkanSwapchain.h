@@ -2,9 +2,20 @@
 
 #include "Typedefs.h"
 #include "Window.h"
+#include "VulkanImagePool.h"
+#include "VulkanDeletionQueue.h"
 
 #include <vulkan/vulkan.h>
 
+// NOTE: Picks MAILBOX when the surface supports it, any other requested mode that is not supported falls back to FIFO
+#define VULKAN_SWAPCHAIN_PRESENT_MODE_DEFAULT VK_PRESENT_MODE_MAX_ENUM_KHR
+
+typedef enum VulkanSwapchainResize_t {
+	VulkanSwapchainResize_None,
+	VulkanSwapchainResize_Resized,
+	VulkanSwapchainResize_Failed,
+} VulkanSwapchainResize;
+
 typedef struct VulkanSwapchain_t {
 	VkSwapchainKHR Swapchain;
 	VkPhysicalDevice PhysicalDevice;
@@ -18,11 +29,19 @@ typedef struct VulkanSwapchain_t {
 	u32 ImageCount;
 	VkImage* Images;
 	VkImageView* ImageViews;
-	VkFramebuffer* Framebuffers;
+	VkFramebuffer* Framebuffers; // NULL when RenderPass is VK_NULL_HANDLE, the images are then used with dynamic rendering
+
+	// NOTE: One depth buffer shared by every image, it is recreated with the swapchain
+	VulkanImagePool* ImagePool;
+	VkFormat DepthFormat;
+	VulkanImage DepthImage;
 
 	VkSurfaceFormatKHR Format;
+	VkPresentModeKHR RequestedPresentMode;
+	u32 RequestedImageCount; // 0 asks for one more than the surface's minimum, otherwise clamped to what the surface allows
 	VkPresentModeKHR PresentMode;
 	VkExtent2D Extent;
+	VkImageUsageFlags ImageUsage;
 	VkSurfaceTransformFlagsKHR Transform;
 	VkCompositeAlphaFlagsKHR CompositeAlpha;
 } VulkanSwapchain;
@@ -35,6 +54,10 @@ b8 VulkanSwapchain_Create(
 	VkSurfaceKHR surface,
 	VkRenderPass renderPass,
 	VkSurfaceFormatKHR format,
+	VulkanImagePool* imagePool,
+	VkFormat depthFormat,
+	VkPresentModeKHR requestedPresentMode,
+	u32 requestedImageCount,
 	Window window,
 	u32 graphicsQueueFamilyIndex,
 	u32 presentQueueFamilyIndex,
@@ -44,4 +67,12 @@ b8 VulkanSwapchain_Create(
 
 void VulkanSwapchain_Destroy(VulkanSwapchain* swapchain);
 
-b8 VulkanSwapchain_TryResize(VulkanSwapchain* swapchain);
+// NOTE: Recreates the swapchain when the surface size changed, or always when outOfDate is set because acquiring or
+// presenting reported VK_ERROR_OUT_OF_DATE_KHR or VK_SUBOPTIMAL_KHR. Nothing waits for the device, the old swapchain and
+// everything it owned goes to deletionQueue with frame, the last frame that may have used it. Nothing is recreated while
+// the window is minimized
+VulkanSwapchainResize VulkanSwapchain_TryResize(VulkanSwapchain* swapchain, VulkanDeletionQueue* deletionQueue, u64 frame, b8 outOfDate);
+
+// NOTE: Names are the ones the command line takes: fifo, fifo-relaxed, mailbox and immediate
+b8 VulkanSwapchain_ParsePresentMode(const char* name, VkPresentModeKHR* presentMode);
+const char* VulkanSwapchain_GetPresentModeName(VkPresentModeKHR presentMode);
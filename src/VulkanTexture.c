@@ -0,0 +1,327 @@
+#include "VulkanTexture.h"
+#include "VulkanUtil.h"
+#include "VulkanBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void VulkanTexture_Barrier(
+	VkCommandBuffer commandBuffer,
+	VkImage image,
+	u32 baseMipLevel, u32 levelCount,
+	VkImageLayout oldLayout, VkImageLayout newLayout,
+	VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask,
+	VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask
+) {
+	vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, NULL, 0, NULL, 1, &(VkImageMemoryBarrier){
+		.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+		.srcAccessMask = srcAccessMask,
+		.dstAccessMask = dstAccessMask,
+		.oldLayout = oldLayout,
+		.newLayout = newLayout,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.image = image,
+		.subresourceRange = (VkImageSubresourceRange){
+			.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+			.baseMipLevel = baseMipLevel,
+			.levelCount = levelCount,
+			.layerCount = 1,
+		},
+	});
+}
+
+static void VulkanTexture_RecordGpuMips(VkCommandBuffer commandBuffer, const VulkanImage* texture) {
+	u32 width = texture->Width;
+	u32 height = texture->Height;
+
+	for (u32 level = 1; level < texture->MipLevels; level++) {
+		u32 mipWidth = width > 1 ? width / 2 : 1;
+		u32 mipHeight = height > 1 ? height / 2 : 1;
+
+		VulkanTexture_Barrier(
+			commandBuffer, texture->Image, level - 1, 1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+		);
+
+		vkCmdBlitImage(
+			commandBuffer,
+			texture->Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			texture->Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1, &(VkImageBlit){
+				.srcSubresource = (VkImageSubresourceLayers){
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.mipLevel = level - 1,
+					.layerCount = 1,
+				},
+				.srcOffsets = { { 0, 0, 0 }, { cast(s32) width, cast(s32) height, 1 } },
+				.dstSubresource = (VkImageSubresourceLayers){
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.mipLevel = level,
+					.layerCount = 1,
+				},
+				.dstOffsets = { { 0, 0, 0 }, { cast(s32) mipWidth, cast(s32) mipHeight, 1 } },
+			},
+			VK_FILTER_LINEAR
+		);
+
+		VulkanTexture_Barrier(
+			commandBuffer, texture->Image, level - 1, 1,
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+		);
+
+		width = mipWidth;
+		height = mipHeight;
+	}
+
+	VulkanTexture_Barrier(
+		commandBuffer, texture->Image, texture->MipLevels - 1, 1,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+	);
+}
+
+// NOTE: Copies the regions out of staging and transitions every level to SHADER_READ_ONLY_OPTIMAL, then waits for the queue
+static b8 VulkanTexture_Submit(
+	VulkanImage* texture,
+	VulkanImagePool* pool,
+	VkQueue queue,
+	u32 queueFamilyIndex,
+	const VulkanBuffer* staging,
+	const VkBufferImageCopy* regions,
+	u32 regionCount,
+	b8 gpuMips
+) {
+	VkDevice device = pool->Device;
+	u32 mipLevels = texture->MipLevels;
+
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkFence fence = VK_NULL_HANDLE;
+
+	b8 result = vkCreateCommandPool(device, &(VkCommandPoolCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+		.queueFamilyIndex = queueFamilyIndex,
+	}, NULL, &commandPool) == VK_SUCCESS &&
+		vkAllocateCommandBuffers(device, &(VkCommandBufferAllocateInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			.commandPool = commandPool,
+			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+			.commandBufferCount = 1,
+		}, &commandBuffer) == VK_SUCCESS &&
+		vkCreateFence(device, &(VkFenceCreateInfo){
+			.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+		}, NULL, &fence) == VK_SUCCESS &&
+		vkBeginCommandBuffer(commandBuffer, &(VkCommandBufferBeginInfo){
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		}) == VK_SUCCESS;
+
+	if (result) {
+		VulkanTexture_Barrier(
+			commandBuffer, texture->Image, 0, mipLevels,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+		);
+
+		vkCmdCopyBufferToImage(commandBuffer, staging->Buffer, texture->Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, regions);
+
+		if (gpuMips) {
+			VulkanTexture_RecordGpuMips(commandBuffer, texture);
+		} else {
+			VulkanTexture_Barrier(
+				commandBuffer, texture->Image, 0, mipLevels,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+			);
+		}
+
+		result = vkEndCommandBuffer(commandBuffer) == VK_SUCCESS &&
+			vkQueueSubmit(queue, 1, &(VkSubmitInfo){
+				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+				.commandBufferCount = 1,
+				.pCommandBuffers = &commandBuffer,
+			}, fence) == VK_SUCCESS &&
+			vkWaitForFences(device, 1, &fence, VK_TRUE, ~0ull) == VK_SUCCESS;
+	}
+
+	if (fence != VK_NULL_HANDLE) {
+		vkDestroyFence(device, fence, NULL);
+	}
+
+	if (commandPool != VK_NULL_HANDLE) {
+		vkDestroyCommandPool(device, commandPool, NULL);
+	}
+
+	return result;
+}
+
+b8 VulkanTexture_Create(
+	VulkanImage* texture,
+	VulkanImagePool* pool,
+	VkQueue queue,
+	u32 queueFamilyIndex,
+	const Image* source,
+	b8 srgb
+) {
+	VkDevice device = pool->Device;
+	VkFormat format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+	u32 mipLevels = Image_GetMipCount(source->Width, source->Height);
+
+	VkFormatProperties formatProperties = {};
+	vkGetPhysicalDeviceFormatProperties(pool->PhysicalDevice, format, &formatProperties);
+
+	const VkFormatFeatureFlags BlitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+	b8 gpuMips = (formatProperties.optimalTilingFeatures & BlitFeatures) == BlitFeatures;
+
+	// NOTE: Without blit support the whole chain is built on the CPU and copied level by level
+	Image* mips = NULL;
+	u64 stagingSize = cast(u64) source->Width * source->Height * 4;
+	if (!gpuMips && mipLevels > 1) {
+		mips = malloc((mipLevels - 1) * sizeof(mips[0]));
+		if (!mips) {
+			return false;
+		}
+
+		if (!Image_GenerateMips(source, mips, mipLevels - 1, srgb)) {
+			free(mips);
+			return false;
+		}
+
+		for (u32 i = 0; i < mipLevels - 1; i++) {
+			stagingSize += cast(u64) mips[i].Width * mips[i].Height * 4;
+		}
+	}
+
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	if (gpuMips) {
+		usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
+
+	VulkanBuffer staging = {};
+	b8 result = VulkanImagePool_CreateImage(pool, texture, source->Width, source->Height, mipLevels, format, usage) &&
+		VulkanBuffer_Create(&staging, device, pool->PhysicalDevice, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+	VkBufferImageCopy regions[32] = {};
+	u32 regionCount = 0;
+	if (result) {
+		u64 offset = 0;
+		const Image* level = source;
+		for (u32 i = 0; i < (mips ? mipLevels : 1); i++) {
+			if (i > 0) {
+				level = &mips[i - 1];
+			}
+
+			u64 levelSize = cast(u64) level->Width * level->Height * 4;
+			memcpy(cast(u8*) staging.Data + offset, level->Pixels, levelSize);
+
+			regions[regionCount++] = (VkBufferImageCopy){
+				.bufferOffset = offset,
+				.imageSubresource = (VkImageSubresourceLayers){
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.mipLevel = i,
+					.layerCount = 1,
+				},
+				.imageExtent = (VkExtent3D){ level->Width, level->Height, 1 },
+			};
+
+			offset += levelSize;
+		}
+	}
+
+	if (mips) {
+		for (u32 i = 0; i < mipLevels - 1; i++) {
+			Image_Destroy(&mips[i]);
+		}
+		free(mips);
+	}
+
+	result = result && VulkanTexture_Submit(texture, pool, queue, queueFamilyIndex, &staging, regions, regionCount, gpuMips);
+
+	if (staging.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&staging);
+	}
+
+	if (!result) {
+		VulkanImagePool_DestroyImage(pool, texture);
+	}
+
+	return result;
+}
+
+VkFormat VulkanTexture_GetFileFormat(TextureFormat format, b8 srgb) {
+	switch (format) {
+		case TextureFormat_RGBA8: return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+		case TextureFormat_BC1: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case TextureFormat_BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case TextureFormat_BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+		default: return VK_FORMAT_UNDEFINED;
+	}
+}
+
+b8 VulkanTexture_IsFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format) {
+	if (format == VK_FORMAT_UNDEFINED) {
+		return false;
+	}
+
+	VkFormatProperties formatProperties = {};
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+
+	const VkFormatFeatureFlags RequiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+	return (formatProperties.optimalTilingFeatures & RequiredFeatures) == RequiredFeatures;
+}
+
+b8 VulkanTexture_CreateFromFile(
+	VulkanImage* texture,
+	VulkanImagePool* pool,
+	VkQueue queue,
+	u32 queueFamilyIndex,
+	const TextureFile* file
+) {
+	VkFormat format = VulkanTexture_GetFileFormat(file->Format, file->Srgb);
+	if (!VulkanTexture_IsFormatSupported(pool->PhysicalDevice, format)) {
+		return false;
+	}
+
+	VulkanBuffer staging = {};
+	b8 result = VulkanImagePool_CreateImage(pool, texture, file->Width, file->Height, file->LevelCount, format, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) &&
+		VulkanBuffer_Create(&staging, pool->Device, pool->PhysicalDevice, file->DataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+	// NOTE: The levels are already laid out back to back in the upload format, so the file data is the staging data
+	VkBufferImageCopy regions[TEXTURE_FILE_MAX_LEVELS] = {};
+	if (result) {
+		memcpy(staging.Data, file->Data, file->DataSize);
+
+		for (u32 i = 0; i < file->LevelCount; i++) {
+			regions[i] = (VkBufferImageCopy){
+				.bufferOffset = file->Levels[i].Offset,
+				.imageSubresource = (VkImageSubresourceLayers){
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.mipLevel = i,
+					.layerCount = 1,
+				},
+				.imageExtent = (VkExtent3D){ file->Levels[i].Width, file->Levels[i].Height, 1 },
+			};
+		}
+	}
+
+	result = result && VulkanTexture_Submit(texture, pool, queue, queueFamilyIndex, &staging, regions, file->LevelCount, false);
+
+	if (staging.Buffer != VK_NULL_HANDLE) {
+		VulkanBuffer_Destroy(&staging);
+	}
+
+	if (!result) {
+		VulkanImagePool_DestroyImage(pool, texture);
+	}
+
+	return result;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Typedefs.h"
+#include "ImageLoader.h"
+#include "TextureFile.h"
+#include "VulkanImagePool.h"
+
+#include <vulkan/vulkan.h>
+
+// NOTE: Uploads source with a full mip chain through a staging buffer and leaves it in SHADER_READ_ONLY_OPTIMAL.
+// The mips are blitted on the GPU when the format supports linear blits, otherwise they are generated on the CPU.
+// Blocks until the upload has finished
+b8 VulkanTexture_Create(
+	VulkanImage* texture,
+	VulkanImagePool* pool,
+	VkQueue queue,
+	u32 queueFamilyIndex,
+	const Image* source,
+	b8 srgb
+);
+
+VkFormat VulkanTexture_GetFileFormat(TextureFormat format, b8 srgb);
+// NOTE: Block compressed formats also need the textureCompressionBC device feature, which enables every BC format at once
+b8 VulkanTexture_IsFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+
+// NOTE: Uploads a cooked texture as is, returns false before creating anything when the device cannot sample its format
+b8 VulkanTexture_CreateFromFile(
+	VulkanImage* texture,
+	VulkanImagePool* pool,
+	VkQueue queue,
+	u32 queueFamilyIndex,
+	const TextureFile* file
+);
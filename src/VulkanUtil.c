@@ -13,7 +13,10 @@
 	#error This platform is not supported
 #endif
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 
 static b8 HasRequiredLayers(
 	const char** requiredLayers, u32 requiredLayerCount,
@@ -59,6 +62,22 @@ static b8 HasRequiredExtensions(
 	return true;
 }
 
+static b8 HasRequiredFeatures12(const VkPhysicalDeviceVulkan12Features* requiredFeatures, const VkPhysicalDeviceVulkan12Features* supportedFeatures) {
+	// NOTE: Every member after sType and pNext is a VkBool32
+	const u64 FirstFeatureOffset = offsetof(VkPhysicalDeviceVulkan12Features, samplerMirrorClampToEdge);
+	const u64 FeatureCount = (sizeof(VkPhysicalDeviceVulkan12Features) - FirstFeatureOffset) / sizeof(VkBool32);
+
+	const VkBool32* required = cast(const VkBool32*) (cast(const u8*) requiredFeatures + FirstFeatureOffset);
+	const VkBool32* supported = cast(const VkBool32*) (cast(const u8*) supportedFeatures + FirstFeatureOffset);
+	for (u64 i = 0; i < FeatureCount; i++) {
+		if (required[i] && !supported[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 b8 CreateVulkanInstance(
 	VkInstance* instance,
 	u32 version,
@@ -168,6 +187,37 @@ static b8 GetQueueFamilies(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface
 	return *graphicsQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED && *presentQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED;
 }
 
+// NOTE: Prefers a transfer only family (the copy engine), then any non graphics family that can transfer, then a second queue
+// in the graphics family. transferQueueIndex is 0 when the transfer queue ends up being the graphics queue itself
+static void GetTransferQueue(VkPhysicalDevice physicalDevice, u32 graphicsQueueFamilyIndex, u32* transferQueueFamilyIndex, u32* transferQueueIndex) {
+	u32 queueFamilyPropertiesCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, NULL);
+	VkQueueFamilyProperties queueFamilyProperties[queueFamilyPropertiesCount];
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertiesCount, queueFamilyProperties);
+
+	*transferQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	*transferQueueIndex = 0;
+
+	for (u32 i = 0; i < queueFamilyPropertiesCount; i++) {
+		VkQueueFlags flags = queueFamilyProperties[i].queueFlags;
+		if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+			*transferQueueFamilyIndex = i;
+			return;
+		}
+	}
+
+	for (u32 i = 0; i < queueFamilyPropertiesCount; i++) {
+		VkQueueFlags flags = queueFamilyProperties[i].queueFlags;
+		if ((flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+			*transferQueueFamilyIndex = i;
+			return;
+		}
+	}
+
+	*transferQueueFamilyIndex = graphicsQueueFamilyIndex;
+	*transferQueueIndex = queueFamilyProperties[graphicsQueueFamilyIndex].queueCount > 1 ? 1 : 0;
+}
+
 b8 ChooseVulkanPhysicalDevice(
 	VkPhysicalDevice* physicalDevice,
 	VkInstance instance,
@@ -175,8 +225,11 @@ b8 ChooseVulkanPhysicalDevice(
 	u32 version,
 	const char** layers, u32 layerCount,
 	const char** extensions, u32 extensionCount,
+	const VkPhysicalDeviceVulkan12Features* features12,
 	u32* graphicsQueueFamilyIndex,
-	u32* presentQueueFamilyIndex
+	u32* presentQueueFamilyIndex,
+	u32* transferQueueFamilyIndex,
+	u32* transferQueueIndex
 ) {
 	*physicalDevice = VK_NULL_HANDLE;
 
@@ -218,9 +271,24 @@ b8 ChooseVulkanPhysicalDevice(
 			continue;
 		}
 
+		if (features12) {
+			VkPhysicalDeviceVulkan12Features supportedFeatures12 = {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+			};
+			vkGetPhysicalDeviceFeatures2(physicalDevices[i], &(VkPhysicalDeviceFeatures2){
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = &supportedFeatures12,
+			});
+
+			if (!HasRequiredFeatures12(features12, &supportedFeatures12)) {
+				continue;
+			}
+		}
+
 		*physicalDevice = physicalDevices[i];
 		*graphicsQueueFamilyIndex = tempGraphicsQueueFamilyIndex;
 		*presentQueueFamilyIndex = tempPresentQueueFamilyIndex;
+		GetTransferQueue(physicalDevices[i], tempGraphicsQueueFamilyIndex, transferQueueFamilyIndex, transferQueueIndex);
 
 		if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
 			break;
@@ -235,37 +303,69 @@ b8 CreateVulkanDevice(
 	VkPhysicalDevice physicalDevice,
 	const char** layers, u32 layerCount,
 	const char** extensions, u32 extensionCount,
+	const VkPhysicalDeviceFeatures* features,
+	const VkPhysicalDeviceVulkan12Features* features12,
 	u32 graphicsQueueFamilyIndex,
-	u32 presentQueueFamilyIndex
+	u32 presentQueueFamilyIndex,
+	u32 transferQueueFamilyIndex,
+	u32 transferQueueIndex
 ) {
 	*device = VK_NULL_HANDLE;
 
-	VkCheck(vkCreateDevice(physicalDevice, &(VkDeviceCreateInfo){
-		.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-		.queueCreateInfoCount = graphicsQueueFamilyIndex == presentQueueFamilyIndex ? 1 : 2,
-		.pQueueCreateInfos = (VkDeviceQueueCreateInfo[2]){
-			{
-				.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-				.queueFamilyIndex = graphicsQueueFamilyIndex,
-				.queueCount = 1,
-				.pQueuePriorities = (float[1]){ 1.0f },
-			},
-			{
+	// NOTE: One create info per unique family, the transfer queue can be the second queue of the graphics family
+	const u32 Families[3] = { graphicsQueueFamilyIndex, presentQueueFamilyIndex, transferQueueFamilyIndex };
+	const u32 QueueIndices[3] = { 0, 0, transferQueueIndex };
+	const float QueuePriorities[2] = { 1.0f, 1.0f };
+
+	VkDeviceQueueCreateInfo queueCreateInfos[3] = {};
+	u32 queueCreateInfoCount = 0;
+	for (u32 i = 0; i < 3; i++) {
+		if (Families[i] == VK_QUEUE_FAMILY_IGNORED) {
+			continue;
+		}
+
+		u32 j = 0;
+		while (j < queueCreateInfoCount && queueCreateInfos[j].queueFamilyIndex != Families[i]) {
+			j++;
+		}
+
+		if (j == queueCreateInfoCount) {
+			queueCreateInfos[queueCreateInfoCount++] = (VkDeviceQueueCreateInfo){
 				.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-				.queueFamilyIndex = presentQueueFamilyIndex,
+				.queueFamilyIndex = Families[i],
 				.queueCount = 1,
-				.pQueuePriorities = (float[1]){ 1.0f },
-			}
-		},
+				.pQueuePriorities = QueuePriorities,
+			};
+		}
+
+		if (QueueIndices[i] + 1 > queueCreateInfos[j].queueCount) {
+			queueCreateInfos[j].queueCount = QueueIndices[i] + 1;
+		}
+	}
+
+	VkCheck(vkCreateDevice(physicalDevice, &(VkDeviceCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+		.pNext = features12,
+		.queueCreateInfoCount = queueCreateInfoCount,
+		.pQueueCreateInfos = queueCreateInfos,
 		.enabledLayerCount = layerCount,
 		.ppEnabledLayerNames = layers,
 		.enabledExtensionCount = extensionCount,
 		.ppEnabledExtensionNames = extensions,
+		.pEnabledFeatures = features,
 	}, NULL, device));
 
 	return device != VK_NULL_HANDLE;
 }
 
+b8 HasVulkanDeviceExtension(VkPhysicalDevice physicalDevice, const char* extension) {
+	u32 extensionPropertiesCount = 0;
+	VkCheck(vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionPropertiesCount, NULL));
+	VkExtensionProperties extensionProperties[extensionPropertiesCount];
+	VkCheck(vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionPropertiesCount, extensionProperties));
+	return HasRequiredExtensions(&extension, 1, extensionProperties, extensionPropertiesCount);
+}
+
 b8 ChooseVulkanSurfaceFormat(VkSurfaceFormatKHR* format, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface) {
 	u32 surfaceFormatCount = 0;
 	VkCheck(vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &surfaceFormatCount, NULL));
@@ -294,3 +394,97 @@ b8 ChooseVulkanSurfaceFormat(VkSurfaceFormatKHR* format, VkPhysicalDevice physic
 	*format = surfaceFormats[0];
 	return true;
 }
+
+b8 ChooseVulkanDepthFormat(VkFormat* format, VkPhysicalDevice physicalDevice) {
+	const VkFormat Candidates[] = {
+		VK_FORMAT_D32_SFLOAT,
+		VK_FORMAT_X8_D24_UNORM_PACK32,
+		VK_FORMAT_D16_UNORM,
+	};
+	const VkFormatFeatureFlags RequiredFeatures = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+
+	for (u32 i = 0; i < sizeof(Candidates) / sizeof(Candidates[0]); i++) {
+		VkFormatProperties properties = {};
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, Candidates[i], &properties);
+		if ((properties.optimalTilingFeatures & RequiredFeatures) == RequiredFeatures) {
+			*format = Candidates[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+VkImageAspectFlags GetVulkanFormatAspect(VkFormat format) {
+	switch (format) {
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+}
+
+b8 HasVulkanDynamicRendering(VkPhysicalDevice physicalDevice) {
+	if (!HasVulkanDeviceExtension(physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+		return false;
+	}
+
+	VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures = {
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+	};
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &(VkPhysicalDeviceFeatures2){
+		.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+		.pNext = &dynamicRenderingFeatures,
+	});
+	return dynamicRenderingFeatures.dynamicRendering;
+}
+
+b8 LoadVulkanDynamicRendering(VulkanDynamicRendering* dynamicRendering, VkDevice device) {
+	dynamicRendering->CmdBeginRendering = cast(PFN_vkCmdBeginRenderingKHR) vkGetDeviceProcAddr(device, "vkCmdBeginRenderingKHR");
+	dynamicRendering->CmdEndRendering = cast(PFN_vkCmdEndRenderingKHR) vkGetDeviceProcAddr(device, "vkCmdEndRenderingKHR");
+	return dynamicRendering->CmdBeginRendering && dynamicRendering->CmdEndRendering;
+}
+
+b8 CreateVulkanShaderModuleFromFile(VkShaderModule* shaderModule, VkDevice device, const char* filepath) {
+	*shaderModule = VK_NULL_HANDLE;
+
+	FILE* file = fopen(filepath, "rb");
+	if (!file) {
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	u64 length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	// NOTE: SPIR-V is a stream of 32 bit words
+	if (length == 0 || length % sizeof(u32) != 0) {
+		fclose(file);
+		return false;
+	}
+
+	u32* code = malloc(length);
+	if (!code) {
+		fclose(file);
+		return false;
+	}
+
+	b8 read = fread(code, 1, length, file) == length;
+	fclose(file);
+
+	if (!read) {
+		free(code);
+		return false;
+	}
+
+	VkResult result = vkCreateShaderModule(device, &(VkShaderModuleCreateInfo){
+		.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+		.codeSize = length,
+		.pCode = code,
+	}, NULL, shaderModule);
+
+	free(code);
+	return result == VK_SUCCESS && *shaderModule != VK_NULL_HANDLE;
+}
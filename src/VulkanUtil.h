@@ -24,8 +24,11 @@ b8 ChooseVulkanPhysicalDevice(
 	u32 version,
 	const char** layers, u32 layerCount,
 	const char** extensions, u32 extensionCount,
+	const VkPhysicalDeviceVulkan12Features* features12,
 	u32* graphicsQueueFamilyIndex,
-	u32* presentQueueFamilyIndex
+	u32* presentQueueFamilyIndex,
+	u32* transferQueueFamilyIndex,
+	u32* transferQueueIndex
 );
 
 b8 CreateVulkanDevice(
@@ -33,8 +36,32 @@ b8 CreateVulkanDevice(
 	VkPhysicalDevice physicalDevice,
 	const char** layers, u32 layerCount,
 	const char** extensions, u32 extensionCount,
+	const VkPhysicalDeviceFeatures* features,
+	const VkPhysicalDeviceVulkan12Features* features12,
 	u32 graphicsQueueFamilyIndex,
-	u32 presentQueueFamilyIndex
+	u32 presentQueueFamilyIndex,
+	u32 transferQueueFamilyIndex,
+	u32 transferQueueIndex
 );
 
+// NOTE: For optional extensions, the required ones are checked by ChooseVulkanPhysicalDevice
+b8 HasVulkanDeviceExtension(VkPhysicalDevice physicalDevice, const char* extension);
+
 b8 ChooseVulkanSurfaceFormat(VkSurfaceFormatKHR* format, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
+// NOTE: The depth buffer is also sampled after the frame, so the format has to support both
+b8 ChooseVulkanDepthFormat(VkFormat* format, VkPhysicalDevice physicalDevice);
+// NOTE: Reads a compiled SPIR-V file
+b8 CreateVulkanShaderModuleFromFile(VkShaderModule* shaderModule, VkDevice device, const char* filepath);
+
+// NOTE: Only knows the depth formats ChooseVulkanDepthFormat picks from, everything else is treated as color
+VkImageAspectFlags GetVulkanFormatAspect(VkFormat format);
+
+// NOTE: VK_KHR_dynamic_rendering is not core in vulkan 1.2, so its commands are loaded from the device it was enabled on
+typedef struct VulkanDynamicRendering_t {
+	PFN_vkCmdBeginRenderingKHR CmdBeginRendering;
+	PFN_vkCmdEndRenderingKHR CmdEndRendering;
+} VulkanDynamicRendering;
+
+// NOTE: Checks both the extension and its feature, which have to be enabled together
+b8 HasVulkanDynamicRendering(VkPhysicalDevice physicalDevice);
+b8 LoadVulkanDynamicRendering(VulkanDynamicRendering* dynamicRendering, VkDevice device);
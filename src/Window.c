@@ -125,6 +125,10 @@ b8 Window_PollEvents() {
 	return true;
 }
 
+void Window_WaitEvents() {
+	WaitMessage();
+}
+
 #else
 	#error This platform is not supported
 #endif
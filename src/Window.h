@@ -9,3 +9,5 @@ void Window_Destroy(Window window);
 void Window_Show(Window window);
 void Window_GetSize(Window window, u32* width, u32* height);
 b8 Window_PollEvents();
+// NOTE: Blocks until the window has a message, Window_PollEvents handles it afterwards
+void Window_WaitEvents();
@@ -1,9 +1,214 @@
 #version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) out vec4 o_Color;
 
-layout(location = 0) in vec4 v_Color;
+layout(location = 0) in vec3 v_Normal;
+layout(location = 1) in vec2 v_TexCoord;
+layout(location = 2) flat in uint v_MaterialIndex;
+layout(location = 3) in vec3 v_WorldPosition;
+
+// NOTE: Matches the VULKAN_LIGHT_CULLER grid constants in VulkanLightCuller.h
+const uvec3 LightGridSize = uvec3(16, 9, 24);
+const uint MaxClusterLights = 255;
+// NOTE: Matches VULKAN_SHADOW_MAP_CASCADE_COUNT in VulkanShadowMap.h
+const uint ShadowCascadeCount = 4;
+
+struct Material {
+	vec4 Ambient;  // xyz Ka
+	vec4 Diffuse;  // xyz Kd, w d
+	vec4 Specular; // xyz Ks, w Ns
+	vec4 Emission; // xyz Ke, w Ni
+	uint DiffuseTexture; // ~0u when untextured
+	uint DiffuseSampler;
+	uvec2 Padding;
+};
+
+struct Light {
+	vec3 Position;
+	float Range;
+	vec3 Color;
+	float SpotCosOuter; // -1 for point lights
+	vec3 Direction;
+	float SpotCosInner;
+};
+
+struct LightCluster {
+	uint Count;
+	uint Indices[MaxClusterLights];
+};
+
+struct ShadowCascade {
+	mat4 ViewProjection;
+	vec4 AtlasRect; // xy offset and zw size of the cascade's tile in atlas uv
+	float TexelSize;
+	float Padding0;
+	float Padding1;
+	float Padding2;
+};
+
+// NOTE: The light grid and shadow map are found through the frame's uniform buffer, LightGridHandle is ~0u when there are no
+// lights and ShadowBufferHandle when there are no shadows
+layout(std430, set = 0, binding = 0) readonly buffer UniformBuffer {
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+	uint LightBufferHandle;
+	uint LightGridHandle;
+	float LightDepthNear;
+	float LightDepthFar;
+	vec2 RenderSize;
+	uint ShadowBufferHandle;
+	uint Padding;
+	vec4 LightDirection; // xyz towards the directional light
+} UniformBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer LightBuffer {
+	Light Lights[];
+} LightBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer LightGridBuffer {
+	uvec4 Stats;
+	LightCluster Clusters[];
+} LightGridBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer ShadowBuffer {
+	ShadowCascade Cascades[ShadowCascadeCount];
+	vec4 SplitDepths;
+	float DepthNear;
+	float DepthFar;
+	uint AtlasHandle;
+	uint SamplerHandle;
+} ShadowBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer MaterialBuffer {
+	Material Materials[];
+} MaterialBuffers[];
+
+layout(set = 0, binding = 1) uniform texture2D Textures[];
+layout(set = 0, binding = 2) uniform sampler Samplers[];
+
+layout(push_constant) uniform PushConstants {
+	layout(offset = 64) uint UniformBufferHandle;
+	uint MaterialBufferHandle;
+};
+
+const vec3 ViewDirection = vec3(0.0, 0.0, 1.0);
+const vec3 AmbientLight = vec3(0.1);
+
+// NOTE: Has to match how VulkanLightCuller_BuildBounds lays out the froxels, tiles over the drawn part of the target and
+// linear slices of view z
+uint GetLightCluster(vec3 viewPosition) {
+	vec2 renderSize = UniformBuffers[UniformBufferHandle].RenderSize;
+	uvec2 tile = min(uvec2(gl_FragCoord.xy / renderSize * vec2(LightGridSize.xy)), LightGridSize.xy - 1u);
+
+	float depthNear = UniformBuffers[UniformBufferHandle].LightDepthNear;
+	float depthFar = UniformBuffers[UniformBufferHandle].LightDepthFar;
+	float slice = (viewPosition.z - depthNear) / (depthFar - depthNear) * float(LightGridSize.z);
+	uint z = uint(clamp(slice, 0.0, float(LightGridSize.z - 1u)));
+
+	return (z * LightGridSize.y + tile.y) * LightGridSize.x + tile.x;
+}
+
+// NOTE: Has to match how VulkanShadowMap_BeginFrame splits the view, the first cascade whose split the fragment is in front of.
+// The position is pushed out along the normal by a texel and a half of that cascade, which keeps lit surfaces from shadowing
+// themselves where the slope scaled bias is not enough
+float GetShadow(uint shadowBufferHandle, vec3 position, vec3 normal, float viewDepth) {
+	float depthNear = ShadowBuffers[shadowBufferHandle].DepthNear;
+	float depthFar = ShadowBuffers[shadowBufferHandle].DepthFar;
+	float depth = (viewDepth - depthNear) / (depthFar - depthNear);
+
+	uint cascadeIndex = 0;
+	while (cascadeIndex < ShadowCascadeCount - 1u && depth > ShadowBuffers[shadowBufferHandle].SplitDepths[cascadeIndex]) {
+		cascadeIndex++;
+	}
+
+	ShadowCascade cascade = ShadowBuffers[shadowBufferHandle].Cascades[cascadeIndex];
+	vec4 lightPosition = cascade.ViewProjection * vec4(position + normal * cascade.TexelSize * 1.5, 1.0);
+	vec2 uv = lightPosition.xy * 0.5 + 0.5;
+	if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || lightPosition.z > 1.0) {
+		return 1.0;
+	}
+
+	// NOTE: The linear filter reads a texel around uv, so it is kept half a texel inside the tile to never blend in the next cascade
+	uint atlasHandle = ShadowBuffers[shadowBufferHandle].AtlasHandle;
+	uint samplerHandle = ShadowBuffers[shadowBufferHandle].SamplerHandle;
+	vec2 halfTexel = 0.5 / vec2(textureSize(sampler2DShadow(Textures[atlasHandle], Samplers[samplerHandle]), 0));
+	uv = clamp(cascade.AtlasRect.xy + uv * cascade.AtlasRect.zw, cascade.AtlasRect.xy + halfTexel, cascade.AtlasRect.xy + cascade.AtlasRect.zw - halfTexel);
+
+	return texture(sampler2DShadow(Textures[atlasHandle], Samplers[samplerHandle]), vec3(uv, lightPosition.z));
+}
+
+// NOTE: Blinn-Phong with the material's Kd, Ks and Ns, fading out smoothly so the light ends exactly at its range
+vec3 ShadeLight(Light light, vec3 position, vec3 normal, vec3 albedo, vec3 specularColor, float shininess) {
+	vec3 toLight = light.Position - position;
+	float lightDistance = length(toLight);
+	if (lightDistance >= light.Range) {
+		return vec3(0.0);
+	}
+
+	vec3 lightDirection = toLight / max(lightDistance, 1e-5);
+	float ratio = lightDistance / light.Range;
+	float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+	float attenuation = window * window;
+
+	if (light.SpotCosOuter > -1.0) {
+		attenuation *= smoothstep(light.SpotCosOuter, light.SpotCosInner, dot(-lightDirection, light.Direction));
+	}
+
+	float diffuse = max(dot(normal, lightDirection), 0.0);
+	vec3 halfVector = normalize(lightDirection + ViewDirection);
+	float specular = diffuse > 0.0 ? pow(max(dot(normal, halfVector), 0.0), shininess) : 0.0;
+
+	return light.Color * attenuation * (albedo * diffuse + specularColor * specular);
+}
 
 void main() {
-	o_Color = v_Color;
+	Material material = MaterialBuffers[MaterialBufferHandle].Materials[v_MaterialIndex];
+
+	// NOTE: The material index is per vertex, so the texture can differ inside one draw
+	vec3 albedo = material.Diffuse.xyz;
+	if (material.DiffuseTexture != ~0u) {
+		// NOTE: OBJ texture coordinates start at the bottom left, vulkan images at the top left
+		vec2 texCoord = vec2(v_TexCoord.x, 1.0 - v_TexCoord.y);
+		albedo *= texture(sampler2D(Textures[nonuniformEXT(material.DiffuseTexture)], Samplers[nonuniformEXT(material.DiffuseSampler)]), texCoord).rgb;
+	}
+
+	vec3 normal = normalize(v_Normal);
+	vec3 lightDirection = UniformBuffers[UniformBufferHandle].LightDirection.xyz;
+	vec3 halfVector = normalize(lightDirection + ViewDirection);
+	vec3 viewPosition = (UniformBuffers[UniformBufferHandle].ViewMatrix * vec4(v_WorldPosition, 1.0)).xyz;
+
+	float diffuse = max(dot(normal, lightDirection), 0.0);
+	float specular = diffuse > 0.0 ? pow(max(dot(normal, halfVector), 0.0), max(material.Specular.w, 1.0)) : 0.0;
+
+	// NOTE: Only the directional light casts shadows
+	uint shadowBufferHandle = UniformBuffers[UniformBufferHandle].ShadowBufferHandle;
+	if (shadowBufferHandle != ~0u && diffuse > 0.0) {
+		float shadow = GetShadow(shadowBufferHandle, v_WorldPosition, normal, viewPosition.z);
+		diffuse *= shadow;
+		specular *= shadow;
+	}
+
+	vec3 color =
+		material.Ambient.xyz * AmbientLight +
+		albedo * diffuse +
+		material.Specular.xyz * specular +
+		material.Emission.xyz;
+
+	// NOTE: The lights are in world space like the normal, only the froxel lookup needs the view depth
+	uint lightGridHandle = UniformBuffers[UniformBufferHandle].LightGridHandle;
+	if (lightGridHandle != ~0u) {
+		uint lightBufferHandle = UniformBuffers[UniformBufferHandle].LightBufferHandle;
+		uint clusterIndex = GetLightCluster(viewPosition);
+		float shininess = max(material.Specular.w, 1.0);
+
+		uint lightCount = LightGridBuffers[lightGridHandle].Clusters[clusterIndex].Count;
+		for (uint i = 0; i < lightCount; i++) {
+			uint lightIndex = LightGridBuffers[lightGridHandle].Clusters[clusterIndex].Indices[i];
+			Light light = LightBuffers[lightBufferHandle].Lights[lightIndex];
+			color += ShadeLight(light, v_WorldPosition, normal, albedo, material.Specular.xyz, shininess);
+		}
+	}
+
+	o_Color = vec4(color, material.Diffuse.w);
 }
@@ -0,0 +1,42 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in uint a_MaterialIndex;
+
+layout(location = 0) out vec3 v_Normal;
+layout(location = 1) out vec2 v_TexCoord;
+layout(location = 2) flat out uint v_MaterialIndex;
+layout(location = 3) out vec3 v_WorldPosition;
+
+// NOTE: Every storage buffer lives in the one bindless array, the push constants select which ones to read
+layout(std430, set = 0, binding = 0) readonly buffer UniformBuffer {
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+} UniformBuffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer ObjectBuffer {
+	mat4 ModelMatrices[];
+} ObjectBuffers[];
+
+// NOTE: The cluster draws are indirect, so the model matrix comes from the object buffer, indexed by the draw's first instance
+layout(push_constant) uniform PushConstants {
+	layout(offset = 64) uint UniformBufferHandle;
+	uint MaterialBufferHandle;
+	layout(offset = 100) uint ObjectBufferHandle;
+};
+
+void main() {
+	mat4 modelMatrix = ObjectBuffers[ObjectBufferHandle].ModelMatrices[gl_InstanceIndex];
+	mat4 viewMatrix = UniformBuffers[UniformBufferHandle].ViewMatrix;
+	mat4 projectionMatrix = UniformBuffers[UniformBufferHandle].ProjectionMatrix;
+
+	vec4 worldPosition = modelMatrix * vec4(a_Position, 1.0);
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	v_Normal = mat3(modelMatrix) * a_Normal;
+	v_TexCoord = a_TexCoord;
+	v_MaterialIndex = a_MaterialIndex;
+	v_WorldPosition = worldPosition.xyz;
+}
@@ -0,0 +1,57 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_EXT_buffer_reference : require
+
+layout(location = 0) out vec3 v_Normal;
+layout(location = 1) out vec2 v_TexCoord;
+layout(location = 2) flat out uint v_MaterialIndex;
+layout(location = 3) out vec3 v_WorldPosition;
+
+layout(std430, set = 0, binding = 0) readonly buffer UniformBuffer {
+	mat4 ViewMatrix;
+	mat4 ProjectionMatrix;
+} UniformBuffers[];
+
+// NOTE: The vertices are read as raw words, so any vertex layout works as long as the push constants describe it
+layout(std430, buffer_reference, buffer_reference_align = 4) readonly buffer VertexData {
+	uint Words[];
+};
+
+// NOTE: The model matrix is pushed for every draw, the handles once per command buffer
+layout(push_constant) uniform PushConstants {
+	mat4 ModelMatrix;
+	uint UniformBufferHandle;
+	uint MaterialBufferHandle;
+
+	VertexData Vertices;
+	uint VertexStride;
+	uint PositionOffset;
+	uint NormalOffset;
+	uint TexCoordOffset;
+	uint MaterialIndexOffset;
+};
+
+float LoadFloat(uint word) {
+	return uintBitsToFloat(Vertices.Words[word]);
+}
+
+void main() {
+	// NOTE: gl_VertexIndex already includes the vertexOffset of the draw, so merged buffers work without extra offsets
+	uint vertex = gl_VertexIndex * VertexStride;
+
+	vec3 position = vec3(LoadFloat(vertex + PositionOffset), LoadFloat(vertex + PositionOffset + 1), LoadFloat(vertex + PositionOffset + 2));
+	vec3 normal = vec3(LoadFloat(vertex + NormalOffset), LoadFloat(vertex + NormalOffset + 1), LoadFloat(vertex + NormalOffset + 2));
+	vec2 texCoord = vec2(LoadFloat(vertex + TexCoordOffset), LoadFloat(vertex + TexCoordOffset + 1));
+	uint materialIndex = Vertices.Words[vertex + MaterialIndexOffset];
+
+	mat4 modelMatrix = ModelMatrix;
+	mat4 viewMatrix = UniformBuffers[UniformBufferHandle].ViewMatrix;
+	mat4 projectionMatrix = UniformBuffers[UniformBufferHandle].ProjectionMatrix;
+
+	vec4 worldPosition = modelMatrix * vec4(position, 1.0);
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	v_Normal = mat3(modelMatrix) * normal;
+	v_TexCoord = texCoord;
+	v_MaterialIndex = materialIndex;
+	v_WorldPosition = worldPosition.xyz;
+}